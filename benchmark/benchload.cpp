@@ -0,0 +1,139 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "cpu.h"
+#include "datareader.h"
+#include "net.h"
+
+#include "benchncnn_param_data.h"
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* format, void* p) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+static int g_loop_count = 4;
+
+// the fastest load_model of the model in ms
+static double benchmark_load(const char* param_data, const ncnn::Option& opt)
+{
+    double time_min = DBL_MAX;
+
+    for (int i = 0; i < g_loop_count; i++)
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        net.load_param_mem(param_data);
+
+        DataReaderFromEmpty dr;
+
+        double start = ncnn::get_current_time();
+
+        int ret = net.load_model(dr);
+
+        double end = ncnn::get_current_time();
+
+        if (ret != 0)
+            return -1;
+
+        time_min = std::min(time_min, end - start);
+    }
+
+    return time_min;
+}
+
+static void benchmark(const char* comment, const char* param_data, const ncnn::Option& opt, int load_threads)
+{
+    ncnn::Option opt_serial = opt;
+    opt_serial.num_load_threads = 1;
+
+    ncnn::Option opt_parallel = opt;
+    opt_parallel.num_load_threads = load_threads;
+
+    double time_serial = benchmark_load(param_data, opt_serial);
+    double time_parallel = benchmark_load(param_data, opt_parallel);
+
+    if (time_serial < 0 || time_parallel < 0)
+    {
+        fprintf(stderr, "%20s  load failed\n", comment);
+        return;
+    }
+
+    fprintf(stderr, "%20s  serial = %8.2f  parallel = %8.2f  speedup = %5.2f\n", comment, time_serial, time_parallel, time_serial / time_parallel);
+}
+
+int main(int argc, char** argv)
+{
+    int loop_count = 4;
+    int num_threads = ncnn::get_physical_big_cpu_count();
+    int load_threads = 0;
+
+    if (argc >= 2)
+    {
+        loop_count = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        num_threads = atoi(argv[2]);
+    }
+    if (argc >= 4)
+    {
+        load_threads = atoi(argv[3]);
+    }
+
+    if (loop_count <= 0 || num_threads <= 0 || load_threads < 0)
+    {
+        fprintf(stderr, "Usage: benchload [loop count] [num threads] [load threads]\n");
+        return -1;
+    }
+
+    if (load_threads == 0)
+        load_threads = num_threads;
+
+    g_loop_count = loop_count;
+
+    ncnn::Option opt;
+    opt.lightmode = true;
+    opt.num_threads = num_threads;
+    opt.use_vulkan_compute = false;
+
+    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    fprintf(stderr, "num_threads = %d\n", num_threads);
+    fprintf(stderr, "load_threads = %d\n", load_threads);
+
+    benchmark("squeezenet", squeezenet_param_data, opt, load_threads);
+    benchmark("squeezenet_int8", squeezenet_int8_param_data, opt, load_threads);
+    benchmark("mobilenet", mobilenet_param_data, opt, load_threads);
+    benchmark("mobilenet_int8", mobilenet_int8_param_data, opt, load_threads);
+    benchmark("mobilenet_v2", mobilenet_v2_param_data, opt, load_threads);
+    benchmark("mobilenet_v3", mobilenet_v3_param_data, opt, load_threads);
+    benchmark("shufflenet_v2", shufflenet_v2_param_data, opt, load_threads);
+    benchmark("efficientnet_b0", efficientnet_b0_param_data, opt, load_threads);
+    benchmark("googlenet", googlenet_param_data, opt, load_threads);
+    benchmark("resnet18", resnet18_param_data, opt, load_threads);
+    benchmark("alexnet", alexnet_param_data, opt, load_threads);
+    benchmark("vgg16", vgg16_param_data, opt, load_threads);
+    benchmark("vgg16_int8", vgg16_int8_param_data, opt, load_threads);
+    benchmark("resnet50", resnet50_param_data, opt, load_threads);
+    benchmark("resnet50_int8", resnet50_int8_param_data, opt, load_threads);
+    benchmark("mobilenetv2_yolov3", mobilenetv2_yolov3_param_data, opt, load_threads);
+    benchmark("yolov4-tiny", yolov4_tiny_param_data, opt, load_threads);
+    benchmark("vision_transformer", vision_transformer_param_data, opt, load_threads);
+
+    return 0;
+}
@@ -14,6 +14,8 @@
 #include "datareader.h"
 #include "net.h"
 #include "gpu.h"
+#include "profiler.h"
+#include "tuningcache.h"
 
 #include "benchncnn_param_data.h"
 
@@ -38,10 +40,24 @@ public:
 static int g_warmup_loop_count = 8;
 static int g_loop_count = 4;
 static bool g_enable_cooling_down = true;
+static int g_parallel_branches = 0;
+static bool g_use_size_class_allocator = false;
 
 static ncnn::UnlockedPoolAllocator g_blob_pool_allocator;
 static ncnn::PoolAllocator g_workspace_pool_allocator;
 
+// concurrent branches allocate blobs from multiple threads
+static ncnn::PoolAllocator g_blob_locked_pool_allocator;
+
+static ncnn::SizeClassPoolAllocator g_blob_size_class_allocator;
+static ncnn::SizeClassPoolAllocator g_workspace_size_class_allocator;
+
+static const char* g_tuning_path = 0;
+static ncnn::TuningCache g_tuning_cache;
+
+static const char* g_profile_path = 0;
+static ncnn::Profiler g_profiler;
+
 #if NCNN_VULKAN
 static ncnn::VulkanDevice* g_vkdev = 0;
 static ncnn::VkAllocator* g_blob_vkallocator = 0;
@@ -59,7 +75,10 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
     }
 
     g_blob_pool_allocator.clear();
+    g_blob_locked_pool_allocator.clear();
     g_workspace_pool_allocator.clear();
+    g_blob_size_class_allocator.clear();
+    g_workspace_size_class_allocator.clear();
 
 #if NCNN_VULKAN
     if (opt.use_vulkan_compute)
@@ -118,6 +137,7 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
     for (int i = 0; i < g_warmup_loop_count; i++)
     {
         ncnn::Extractor ex = net.create_extractor();
+        ex.set_parallel_branches(g_parallel_branches);
         for (size_t j = 0; j < input_names.size(); ++j)
         {
             ncnn::Mat in = _in[j];
@@ -140,6 +160,7 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
         double start = ncnn::get_current_time();
         {
             ncnn::Extractor ex = net.create_extractor();
+            ex.set_parallel_branches(g_parallel_branches);
             for (size_t j = 0; j < input_names.size(); ++j)
             {
                 ncnn::Mat in = _in[j];
@@ -165,6 +186,25 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
     time_avg /= g_loop_count;
 
     fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f\n", comment, time_min, time_max, time_avg);
+
+    if (g_profile_path)
+    {
+        // one more run outside the timed loops
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_parallel_branches(g_parallel_branches);
+        ex.set_profiler(&g_profiler);
+        for (size_t j = 0; j < input_names.size(); ++j)
+        {
+            ncnn::Mat in = _in[j];
+            ex.input(input_names[j], in);
+        }
+
+        for (size_t j = 0; j < output_names.size(); ++j)
+        {
+            ncnn::Mat out;
+            ex.extract(output_names[j], out);
+        }
+    }
 }
 
 void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& opt, const char* model_param_data = NULL)
@@ -179,6 +219,10 @@ void show_usage()
     fprintf(stderr, "Usage: benchncnn [loop count] [num threads] [powersave] [gpu device] [cooling down] [(key=value)...]\n");
     fprintf(stderr, "  param=model.param\n");
     fprintf(stderr, "  shape=[227,227,3],...\n");
+    fprintf(stderr, "  branches=4\n");
+    fprintf(stderr, "  allocator=pool|sizeclass\n");
+    fprintf(stderr, "  tuning=tuning.txt\n");
+    fprintf(stderr, "  profile=trace.json\n");
 }
 
 static std::vector<ncnn::Mat> parse_shape_list(char* s)
@@ -310,6 +354,14 @@ int main(int argc, char** argv)
             model = value;
         if (strcmp(key, "shape") == 0)
             inputs = parse_shape_list(value);
+        if (strcmp(key, "branches") == 0)
+            g_parallel_branches = atoi(value);
+        if (strcmp(key, "allocator") == 0)
+            g_use_size_class_allocator = strcmp(value, "sizeclass") == 0;
+        if (strcmp(key, "tuning") == 0)
+            g_tuning_path = value;
+        if (strcmp(key, "profile") == 0)
+            g_profile_path = value;
     }
 
     if (model && inputs.empty())
@@ -331,6 +383,7 @@ int main(int argc, char** argv)
     g_loop_count = loop_count;
 
     g_blob_pool_allocator.set_size_compare_ratio(0.f);
+    g_blob_locked_pool_allocator.set_size_compare_ratio(0.f);
     g_workspace_pool_allocator.set_size_compare_ratio(0.f);
 
 #if NCNN_VULKAN
@@ -354,8 +407,13 @@ int main(int argc, char** argv)
     ncnn::Option opt;
     opt.lightmode = true;
     opt.num_threads = num_threads;
-    opt.blob_allocator = &g_blob_pool_allocator;
+    opt.blob_allocator = g_parallel_branches > 1 ? (ncnn::Allocator*)&g_blob_locked_pool_allocator : (ncnn::Allocator*)&g_blob_pool_allocator;
     opt.workspace_allocator = &g_workspace_pool_allocator;
+    if (g_use_size_class_allocator)
+    {
+        opt.blob_allocator = &g_blob_size_class_allocator;
+        opt.workspace_allocator = &g_workspace_size_class_allocator;
+    }
 #if NCNN_VULKAN
     opt.blob_vkallocator = g_blob_vkallocator;
     opt.workspace_vkallocator = g_blob_vkallocator;
@@ -372,11 +430,29 @@ int main(int argc, char** argv)
     opt.use_int8_arithmetic = true;
     opt.use_packing_layout = true;
 
+    if (g_tuning_path)
+    {
+        // reuse the recorded kernels, or measure them during warmup and record them at exit
+        FILE* fp = fopen(g_tuning_path, "rb");
+        if (!fp || g_tuning_cache.load(fp) != 0)
+        {
+            g_tuning_cache.set_autotune(true);
+        }
+        if (fp)
+            fclose(fp);
+
+        opt.tuning_cache = &g_tuning_cache;
+    }
+
     fprintf(stderr, "loop_count = %d\n", g_loop_count);
     fprintf(stderr, "num_threads = %d\n", num_threads);
     fprintf(stderr, "powersave = %d\n", ncnn::get_cpu_powersave());
     fprintf(stderr, "gpu_device = %d\n", gpu_device);
     fprintf(stderr, "cooling_down = %d\n", (int)g_enable_cooling_down);
+    fprintf(stderr, "branches = %d\n", g_parallel_branches);
+    fprintf(stderr, "allocator = %s\n", g_use_size_class_allocator ? "sizeclass" : "pool");
+    if (g_tuning_path)
+        fprintf(stderr, "tuning = %s %s\n", g_tuning_path, g_tuning_cache.autotune() ? "autotune" : "loaded");
 
     if (model != 0)
     {
@@ -458,6 +534,24 @@ int main(int argc, char** argv)
 
         benchmark("FastestDet", ncnn::Mat(352, 352, 3), opt, FastestDet_param_data);
     }
+
+    if (g_use_size_class_allocator)
+    {
+        fprintf(stderr, "blob allocator       allocations = %zu  bytes = %zu  hit rate = %.2f%%\n", g_blob_size_class_allocator.allocation_count(), g_blob_size_class_allocator.allocation_bytes(), g_blob_size_class_allocator.hit_rate() * 100);
+        fprintf(stderr, "workspace allocator  allocations = %zu  bytes = %zu  hit rate = %.2f%%\n", g_workspace_size_class_allocator.allocation_count(), g_workspace_size_class_allocator.allocation_bytes(), g_workspace_size_class_allocator.hit_rate() * 100);
+    }
+
+    if (g_tuning_path && g_tuning_cache.autotune())
+    {
+        if (g_tuning_cache.save(g_tuning_path) == 0)
+            fprintf(stderr, "tuning %d kernel choices saved to %s\n", g_tuning_cache.size(), g_tuning_path);
+    }
+
+    if (g_profile_path)
+    {
+        if (g_profiler.save_chrome_trace(g_profile_path) == 0)
+            fprintf(stderr, "profile %d layer events saved to %s\n", g_profiler.event_count(), g_profile_path);
+    }
 #if NCNN_VULKAN
     delete g_blob_vkallocator;
     delete g_staging_vkallocator;
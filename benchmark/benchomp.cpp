@@ -0,0 +1,182 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "cpu.h"
+#include "platform.h"
+
+#if NCNN_SIMPLEOMP
+#include "simpleomp.h"
+#else
+#include <omp.h>
+#endif
+
+#ifndef NCNN_SIMPLESTL
+#include <algorithm>
+#include <vector>
+#endif
+
+static int g_loop_count = 8;
+static int g_num_threads = 4;
+static int g_iterations = 4096;
+
+// relative cost of iteration i
+typedef int (*cost_func)(int i, int n);
+
+static int cost_balanced(int /*i*/, int /*n*/)
+{
+    return 16;
+}
+
+static int cost_linear(int i, int n)
+{
+    // the last iterations are the heaviest
+    return 1 + i * 32 / n;
+}
+
+static int cost_spiky(int i, int /*n*/)
+{
+    // every 16th iteration is 32x heavier, clustered at random spots
+    unsigned int h = (unsigned int)i * 2654435761u;
+    return (h >> 28) == 0 ? 256 : 8;
+}
+
+static float work(int cost, float v)
+{
+    for (int k = 0; k < cost * 64; k++)
+    {
+        v = v * 0.999f + 0.001f;
+    }
+    return v;
+}
+
+static void run_static(cost_func cost, int n, float* out, int* hits)
+{
+    #pragma omp parallel for num_threads(g_num_threads)
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = work(cost(i, n), out[i]);
+        hits[i]++;
+    }
+}
+
+static void run_runtime(cost_func cost, int n, float* out, int* hits)
+{
+    #pragma omp parallel for num_threads(g_num_threads) schedule(runtime)
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = work(cost(i, n), out[i]);
+        hits[i]++;
+    }
+}
+
+static void benchmark(const char* comment, cost_func cost, int kind, int chunk)
+{
+    const int n = g_iterations;
+
+    std::vector<float> out(n, 1.f);
+    std::vector<int> hits(n, 0);
+
+    if (kind != 0)
+    {
+        omp_set_schedule((omp_sched_t)kind, chunk);
+    }
+
+    double time_min = DBL_MAX;
+    double time_max = -DBL_MAX;
+    double time_avg = 0;
+
+    // one warm up run
+    for (int i = 0; i < g_loop_count + 1; i++)
+    {
+        double start = ncnn::get_current_time();
+
+        if (kind == 0)
+            run_static(cost, n, &out[0], &hits[0]);
+        else
+            run_runtime(cost, n, &out[0], &hits[0]);
+
+        double end = ncnn::get_current_time();
+
+        if (i == 0)
+            continue;
+
+        double time = end - start;
+
+        time_min = std::min(time_min, time);
+        time_max = std::max(time_max, time);
+        time_avg += time;
+    }
+
+    time_avg /= g_loop_count;
+
+    // every iteration must run exactly once per loop
+    for (int i = 0; i < n; i++)
+    {
+        if (hits[i] != g_loop_count + 1)
+        {
+            fprintf(stderr, "%20s  iteration %d ran %d times, expect %d\n", comment, i, hits[i], g_loop_count + 1);
+            return;
+        }
+    }
+
+    fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f\n", comment, time_min, time_max, time_avg);
+}
+
+static void benchmark_schedules(const char* workload, cost_func cost)
+{
+    char comment[64];
+
+    sprintf(comment, "%s_static", workload);
+    benchmark(comment, cost, 0, 0);
+
+    sprintf(comment, "%s_dynamic", workload);
+    benchmark(comment, cost, omp_sched_dynamic, 4);
+
+    sprintf(comment, "%s_guided", workload);
+    benchmark(comment, cost, omp_sched_guided, 1);
+
+    sprintf(comment, "%s_auto", workload);
+    benchmark(comment, cost, omp_sched_auto, 0);
+}
+
+int main(int argc, char** argv)
+{
+    g_num_threads = ncnn::get_cpu_count();
+
+    if (argc >= 2)
+    {
+        g_loop_count = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        g_num_threads = atoi(argv[2]);
+    }
+    if (argc >= 4)
+    {
+        g_iterations = atoi(argv[3]);
+    }
+
+    if (g_loop_count <= 0 || g_num_threads <= 0 || g_iterations <= 0)
+    {
+        fprintf(stderr, "Usage: benchomp [loop count] [num threads] [iterations]\n");
+        return -1;
+    }
+
+    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    fprintf(stderr, "num_threads = %d\n", g_num_threads);
+    fprintf(stderr, "iterations = %d\n", g_iterations);
+
+    benchmark_schedules("balanced", cost_balanced);
+
+    benchmark_schedules("linear", cost_linear);
+
+    benchmark_schedules("spiky", cost_spiky);
+
+    return 0;
+}
@@ -0,0 +1,438 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "benchmark.h"
+#include "mat.h"
+#include "platform.h"
+
+#ifndef NCNN_SIMPLESTL
+#include <algorithm>
+#include <vector>
+#endif
+
+static int g_loop_count = 16;
+static int g_width = 1920;
+static int g_height = 1080;
+
+// plain c loops computing exactly what the scalar fallbacks in src/mat_pixel*.cpp compute
+
+static void ref_from_rgb(const unsigned char* rgb, int w, int h, ncnn::Mat& m)
+{
+    // fresh allocation each call, like Mat::from_pixels
+    m = ncnn::Mat(w, h, 3);
+
+    for (int q = 0; q < 3; q++)
+    {
+        float* ptr = m.channel(q);
+        for (int i = 0; i < w * h; i++)
+        {
+            ptr[i] = rgb[i * 3 + q];
+        }
+    }
+}
+
+static void ref_to_rgb(const ncnn::Mat& m, unsigned char* rgb)
+{
+    for (int q = 0; q < 3; q++)
+    {
+        const float* ptr = m.channel(q);
+        for (int i = 0; i < m.w * m.h; i++)
+        {
+            rgb[i * 3 + q] = (unsigned char)std::min(std::max((int)ptr[i], 0), 255);
+        }
+    }
+}
+
+static void ref_from_rgb2gray(const unsigned char* rgb, int w, int h, ncnn::Mat& m)
+{
+    m = ncnn::Mat(w, h, 1);
+
+    float* ptr = m;
+    for (int i = 0; i < w * h; i++)
+    {
+        ptr[i] = (float)((rgb[i * 3] * 77 + rgb[i * 3 + 1] * 150 + rgb[i * 3 + 2] * 29) >> 8);
+    }
+}
+
+static void ref_resize_bilinear(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn)
+{
+    const int INTER_RESIZE_COEF_SCALE = 1 << 11;
+
+    std::vector<int> xofs(w);
+    std::vector<short> ialpha(w * 2);
+    std::vector<int> yofs(h);
+    std::vector<short> ibeta(h * 2);
+
+    for (int dx = 0; dx < w; dx++)
+    {
+        float fx = (float)((dx + 0.5) * srcw / w - 0.5);
+        int sx = (int)floor(fx);
+        fx -= sx;
+        if (sx < 0)
+        {
+            sx = 0;
+            fx = 0.f;
+        }
+        if (sx >= srcw - 1)
+        {
+            sx = srcw - 2;
+            fx = 1.f;
+        }
+        xofs[dx] = sx * cn;
+
+        float a0 = (1.f - fx) * INTER_RESIZE_COEF_SCALE;
+        float a1 = fx * INTER_RESIZE_COEF_SCALE;
+        ialpha[dx * 2] = (short)std::min(std::max((int)(a0 + (a0 >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX);
+        ialpha[dx * 2 + 1] = (short)std::min(std::max((int)(a1 + (a1 >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX);
+    }
+
+    for (int dy = 0; dy < h; dy++)
+    {
+        float fy = (float)((dy + 0.5) * srch / h - 0.5);
+        int sy = (int)floor(fy);
+        fy -= sy;
+        if (sy < 0)
+        {
+            sy = 0;
+            fy = 0.f;
+        }
+        if (sy >= srch - 1)
+        {
+            sy = srch - 2;
+            fy = 1.f;
+        }
+        yofs[dy] = sy;
+
+        float b0 = (1.f - fy) * INTER_RESIZE_COEF_SCALE;
+        float b1 = fy * INTER_RESIZE_COEF_SCALE;
+        ibeta[dy * 2] = (short)std::min(std::max((int)(b0 + (b0 >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX);
+        ibeta[dy * 2 + 1] = (short)std::min(std::max((int)(b1 + (b1 >= 0.f ? 0.5f : -0.5f)), SHRT_MIN), SHRT_MAX);
+    }
+
+    std::vector<short> rowsbuf0(w * cn);
+    std::vector<short> rowsbuf1(w * cn);
+    short* rows0 = &rowsbuf0[0];
+    short* rows1 = &rowsbuf1[0];
+
+    int prev_sy = -2;
+    for (int dy = 0; dy < h; dy++)
+    {
+        const int sy = yofs[dy];
+
+        // reuse the previous source rows like the library does
+        for (int r = 0; r < 2; r++)
+        {
+            if (sy == prev_sy && r == 0)
+                break;
+
+            if (sy == prev_sy + 1 && r == 0)
+            {
+                std::swap(rows0, rows1);
+                continue;
+            }
+
+            short* rows = r == 0 ? rows0 : rows1;
+            const unsigned char* S = src + srcw * cn * (sy + r);
+            for (int dx = 0; dx < w; dx++)
+            {
+                const unsigned char* Sp = S + xofs[dx];
+                for (int k = 0; k < cn; k++)
+                {
+                    rows[dx * cn + k] = (Sp[k] * ialpha[dx * 2] + Sp[k + cn] * ialpha[dx * 2 + 1]) >> 4;
+                }
+            }
+        }
+        prev_sy = sy;
+
+        const short b0 = ibeta[dy * 2];
+        const short b1 = ibeta[dy * 2 + 1];
+        unsigned char* Dp = dst + w * cn * dy;
+        for (int i = 0; i < w * cn; i++)
+        {
+            Dp[i] = (unsigned char)(((short)((b0 * rows0[i]) >> 16) + (short)((b1 * rows1[i]) >> 16) + 2) >> 2);
+        }
+    }
+}
+
+#if NCNN_PIXEL_ROTATE
+static void ref_rotate(const unsigned char* src, int srcw, int srch, unsigned char* dst, int cn, int type)
+{
+    const int w = type >= 5 ? srch : srcw;
+    const int h = type >= 5 ? srcw : srch;
+
+    for (int y = 0; y < srch; y++)
+    {
+        for (int x = 0; x < srcw; x++)
+        {
+            int dx = x;
+            int dy = y;
+            if (type == 2 || type == 3) dx = srcw - 1 - x;
+            if (type == 3 || type == 4) dy = srch - 1 - y;
+            if (type == 5) dx = y, dy = x;
+            if (type == 6) dx = srch - 1 - y, dy = x;
+            if (type == 7) dx = srch - 1 - y, dy = srcw - 1 - x;
+            if (type == 8) dx = y, dy = srcw - 1 - x;
+
+            const unsigned char* sp = src + (y * srcw + x) * cn;
+            unsigned char* dp = dst + (dy * w + dx) * cn;
+            for (int k = 0; k < cn; k++)
+            {
+                dp[k] = sp[k];
+            }
+        }
+    }
+
+    (void)h;
+}
+#endif // NCNN_PIXEL_ROTATE
+
+#if NCNN_PIXEL_AFFINE
+static void ref_warpaffine_bilinear(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, int cn, const float* tm, unsigned int v)
+{
+    const unsigned char* border_color = (const unsigned char*)&v;
+    const int srcstride = srcw * cn;
+
+    for (int y = 0; y < h; y++)
+    {
+        const float X0f = (tm[1] * y + tm[2]) * (1 << 10);
+        const float Y0f = (tm[4] * y + tm[5]) * (1 << 10);
+        const int X0 = (int)(X0f + (X0f >= 0.f ? 0.5f : -0.5f));
+        const int Y0 = (int)(Y0f + (Y0f >= 0.f ? 0.5f : -0.5f));
+
+        for (int x = 0; x < w; x++)
+        {
+            const float adf = tm[0] * x * (1 << 10);
+            const float bdf = tm[3] * x * (1 << 10);
+            const int X = X0 + (int)(adf + (adf >= 0.f ? 0.5f : -0.5f));
+            const int Y = Y0 + (int)(bdf + (bdf >= 0.f ? 0.5f : -0.5f));
+
+            const short sx = (short)std::min(std::max(X >> 10, SHRT_MIN), SHRT_MAX);
+            const short sy = (short)std::min(std::max(Y >> 10, SHRT_MIN), SHRT_MAX);
+
+            unsigned char* dp = dst + (y * w + x) * cn;
+
+            if (sx < -1 || sx >= srcw || sy < -1 || sy >= srch)
+            {
+                for (int k = 0; k < cn; k++)
+                    dp[k] = border_color[k];
+                continue;
+            }
+
+            const short alpha1 = X & ((1 << 10) - 1);
+            const short alpha0 = (1 << 10) - alpha1;
+            const short beta1 = Y & ((1 << 10) - 1);
+            const short beta0 = (1 << 10) - beta1;
+
+            const bool sx0_in = (unsigned short)sx < srcw;
+            const bool sx1_in = (unsigned short)(sx + 1) < srcw;
+            const bool sy0_in = (unsigned short)sy < srch;
+            const bool sy1_in = (unsigned short)(sy + 1) < srch;
+
+            const unsigned char* a0 = sx0_in && sy0_in ? src + srcstride * sy + sx * cn : border_color;
+            const unsigned char* a1 = sx1_in && sy0_in ? src + srcstride * sy + sx * cn + cn : border_color;
+            const unsigned char* b0 = sx0_in && sy1_in ? src + srcstride * (sy + 1) + sx * cn : border_color;
+            const unsigned char* b1 = sx1_in && sy1_in ? src + srcstride * (sy + 1) + sx * cn + cn : border_color;
+
+            for (int k = 0; k < cn; k++)
+            {
+                dp[k] = (unsigned char)(((((unsigned short)((a0[k] * alpha0 + a1[k] * alpha1) >> 5) * beta0)) + (((unsigned short)((b0[k] * alpha0 + b1[k] * alpha1) >> 5) * beta1))) >> 15);
+            }
+        }
+    }
+}
+#endif // NCNN_PIXEL_AFFINE
+
+// time one statement, keeping the fastest of g_loop_count runs after one warm up run
+#define BENCH_TIME(time_min, stmt)                                   \
+    do                                                               \
+    {                                                                \
+        time_min = DBL_MAX;                                          \
+        for (int bench_i = 0; bench_i < g_loop_count + 1; bench_i++) \
+        {                                                            \
+            double bench_start = ncnn::get_current_time();           \
+            stmt;                                                    \
+            double bench_end = ncnn::get_current_time();             \
+            if (bench_i == 0)                                        \
+                continue;                                            \
+            time_min = std::min(time_min, bench_end - bench_start);  \
+        }                                                            \
+    } while (0)
+
+static void report(const char* comment, double time_ncnn, double time_ref, bool same)
+{
+    fprintf(stderr, "%24s  ncnn = %8.3f  scalar = %8.3f  speedup = %5.2fx%s\n", comment, time_ncnn, time_ref, time_ref / time_ncnn, same ? "" : "  MISMATCH");
+}
+
+static bool same_mat(const ncnn::Mat& a, const ncnn::Mat& b)
+{
+    for (int q = 0; q < a.c; q++)
+    {
+        if (memcmp(a.channel(q), b.channel(q), a.w * a.h * sizeof(float)) != 0)
+            return false;
+    }
+    return true;
+}
+
+static void benchmark_convert(const std::vector<unsigned char>& rgb, int w, int h)
+{
+    ncnn::Mat m0;
+    ncnn::Mat m1;
+
+    double t0;
+    BENCH_TIME(t0, m0 = ncnn::Mat::from_pixels(&rgb[0], ncnn::Mat::PIXEL_RGB, w, h));
+    double t1;
+    BENCH_TIME(t1, ref_from_rgb(&rgb[0], w, h, m1));
+    report("from_pixels_rgb", t0, t1, same_mat(m0, m1));
+
+    std::vector<unsigned char> out0(w * h * 3);
+    std::vector<unsigned char> out1(w * h * 3);
+    BENCH_TIME(t0, m0.to_pixels(&out0[0], ncnn::Mat::PIXEL_RGB));
+    BENCH_TIME(t1, ref_to_rgb(m0, &out1[0]));
+    report("to_pixels_rgb", t0, t1, out0 == out1);
+
+    BENCH_TIME(t0, m0 = ncnn::Mat::from_pixels(&rgb[0], ncnn::Mat::PIXEL_RGB2GRAY, w, h));
+    BENCH_TIME(t1, ref_from_rgb2gray(&rgb[0], w, h, m1));
+    report("from_pixels_rgb2gray", t0, t1, same_mat(m0, m1));
+}
+
+typedef void (*resize_func)(const unsigned char*, int, int, unsigned char*, int, int);
+
+static void benchmark_resize(const std::vector<unsigned char>& src, int srcw, int srch, int w, int h)
+{
+    char comment[64];
+
+    const resize_func resize_funcs[4] = {ncnn::resize_bilinear_c1, ncnn::resize_bilinear_c2, ncnn::resize_bilinear_c3, ncnn::resize_bilinear_c4};
+
+    for (int cn = 1; cn <= 4; cn++)
+    {
+        std::vector<unsigned char> out0(w * h * cn);
+        std::vector<unsigned char> out1(w * h * cn);
+
+        double t0;
+        BENCH_TIME(t0, resize_funcs[cn - 1](&src[0], srcw, srch, &out0[0], w, h));
+        double t1;
+        BENCH_TIME(t1, ref_resize_bilinear(&src[0], srcw, srch, &out1[0], w, h, cn));
+
+        sprintf(comment, "resize_bilinear_c%d", cn);
+        report(comment, t0, t1, out0 == out1);
+    }
+}
+
+#if NCNN_PIXEL_ROTATE
+typedef void (*rotate_func)(const unsigned char*, int, int, unsigned char*, int, int, int);
+
+static void benchmark_rotate(const std::vector<unsigned char>& src, int srcw, int srch)
+{
+    char comment[64];
+
+    const rotate_func rotate_funcs[3] = {ncnn::kanna_rotate_c1, ncnn::kanna_rotate_c3, ncnn::kanna_rotate_c4};
+    const int cns[3] = {1, 3, 4};
+    const int types[3] = {2, 5, 6};
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            const int cn = cns[i];
+            const int type = types[j];
+            const int w = type >= 5 ? srch : srcw;
+            const int h = type >= 5 ? srcw : srch;
+
+            std::vector<unsigned char> out0(w * h * cn);
+            std::vector<unsigned char> out1(w * h * cn);
+
+            double t0;
+            BENCH_TIME(t0, rotate_funcs[i](&src[0], srcw, srch, &out0[0], w, h, type));
+            double t1;
+        BENCH_TIME(t1, ref_rotate(&src[0], srcw, srch, &out1[0], cn, type));
+
+            sprintf(comment, "kanna_rotate_c%d_%d", cn, type);
+            report(comment, t0, t1, out0 == out1);
+        }
+    }
+}
+#endif // NCNN_PIXEL_ROTATE
+
+#if NCNN_PIXEL_AFFINE
+typedef void (*warpaffine_func)(const unsigned char*, int, int, unsigned char*, int, int, const float*, int, unsigned int);
+
+static void benchmark_warpaffine(const std::vector<unsigned char>& src, int srcw, int srch, int w, int h)
+{
+    char comment[64];
+
+    const warpaffine_func warpaffine_funcs[4] = {ncnn::warpaffine_bilinear_c1, ncnn::warpaffine_bilinear_c2, ncnn::warpaffine_bilinear_c3, ncnn::warpaffine_bilinear_c4};
+
+    float tm[6];
+    ncnn::get_rotation_matrix(15.f, 0.8f, srcw / 2.f, srch / 2.f, tm);
+
+    for (int cn = 1; cn <= 4; cn++)
+    {
+        std::vector<unsigned char> out0(w * h * cn);
+        std::vector<unsigned char> out1(w * h * cn);
+
+        double t0;
+        BENCH_TIME(t0, warpaffine_funcs[cn - 1](&src[0], srcw, srch, &out0[0], w, h, tm, 0, 0));
+        double t1;
+        BENCH_TIME(t1, ref_warpaffine_bilinear(&src[0], srcw, srch, &out1[0], w, h, cn, tm, 0));
+
+        sprintf(comment, "warpaffine_bilinear_c%d", cn);
+        report(comment, t0, t1, out0 == out1);
+    }
+}
+#endif // NCNN_PIXEL_AFFINE
+
+int main(int argc, char** argv)
+{
+    if (argc >= 2)
+    {
+        g_loop_count = atoi(argv[1]);
+    }
+    if (argc >= 3)
+    {
+        g_width = atoi(argv[2]);
+    }
+    if (argc >= 4)
+    {
+        g_height = atoi(argv[3]);
+    }
+
+    if (g_loop_count <= 0 || g_width < 2 || g_height < 2)
+    {
+        fprintf(stderr, "Usage: benchpixel [loop count] [width] [height]\n");
+        return -1;
+    }
+
+    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    fprintf(stderr, "width = %d\n", g_width);
+    fprintf(stderr, "height = %d\n", g_height);
+
+    const int w = g_width;
+    const int h = g_height;
+
+    std::vector<unsigned char> pixels(w * h * 4);
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        pixels[i] = (unsigned char)(rand() % 256);
+    }
+
+    benchmark_convert(pixels, w, h);
+
+    // typical network input size
+    benchmark_resize(pixels, w, h, 640, 384);
+
+#if NCNN_PIXEL_ROTATE
+    benchmark_rotate(pixels, w, h);
+#endif
+
+#if NCNN_PIXEL_AFFINE
+    benchmark_warpaffine(pixels, w, h, 640, 384);
+#endif
+
+    return 0;
+}
@@ -179,6 +179,7 @@ PYBIND11_MODULE(ncnn, m)
     .def_readwrite("num_threads", &Option::num_threads)
     .def_readwrite("blob_allocator", &Option::blob_allocator)
     .def_readwrite("workspace_allocator", &Option::workspace_allocator)
+    .def_readwrite("num_load_threads", &Option::num_load_threads)
 #if NCNN_VULKAN
     .def_readwrite("blob_vkallocator", &Option::blob_vkallocator)
     .def_readwrite("workspace_vkallocator", &Option::workspace_vkallocator)
@@ -198,6 +199,7 @@ PYBIND11_MODULE(ncnn, m)
     .def_readwrite("use_fp16_packed", &Option::use_fp16_packed)
     .def_readwrite("use_fp16_storage", &Option::use_fp16_storage)
     .def_readwrite("use_fp16_arithmetic", &Option::use_fp16_arithmetic)
+    .def_readwrite("use_x86_fp16_storage", &Option::use_x86_fp16_storage)
     .def_readwrite("use_int8_packed", &Option::use_int8_packed)
     .def_readwrite("use_int8_storage", &Option::use_int8_storage)
     .def_readwrite("use_int8_arithmetic", &Option::use_int8_arithmetic)
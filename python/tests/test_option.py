@@ -28,6 +28,10 @@ def test_option():
     opt.workspace_allocator = allocator
     assert opt.workspace_allocator == allocator
 
+    assert opt.num_load_threads == 1
+    opt.num_load_threads = 4
+    assert opt.num_load_threads == 4
+
     assert opt.openmp_blocktime == 20
     opt.openmp_blocktime = 40
     assert opt.openmp_blocktime == 40
@@ -77,6 +81,10 @@ def test_option():
     opt.use_fp16_arithmetic = False
     assert opt.use_fp16_arithmetic == False
 
+    assert opt.use_x86_fp16_storage == False
+    opt.use_x86_fp16_storage = True
+    assert opt.use_x86_fp16_storage == True
+
     opt.use_int8_packed = True
     assert opt.use_int8_packed == True
     opt.use_int8_packed = False
@@ -6,6 +6,8 @@
 #include "gpu.h"
 #include "pipeline.h"
 
+#include <string.h>
+
 #if __ANDROID_API__ >= 26
 #include <android/hardware_buffer.h>
 #endif // __ANDROID_API__ >= 26
@@ -346,6 +348,568 @@ void UnlockedPoolAllocator::fastFree(void* ptr)
     ncnn::fastFree(ptr);
 }
 
+#if NCNN_THREADS && !(defined __riscv && !defined __riscv_atomic) && defined __GNUC__
+static NCNN_FORCEINLINE void* atomic_load_ptr(void** addr)
+{
+    return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+}
+
+static NCNN_FORCEINLINE void* atomic_exchange_ptr(void** addr, void* value)
+{
+    return __atomic_exchange_n(addr, value, __ATOMIC_ACQ_REL);
+}
+
+static NCNN_FORCEINLINE bool atomic_compare_exchange_ptr(void** addr, void* expected, void* desired)
+{
+    return __atomic_compare_exchange_n(addr, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+static NCNN_FORCEINLINE void atomic_add_size(size_t* addr, size_t delta)
+{
+    __atomic_fetch_add(addr, delta, __ATOMIC_RELAXED);
+}
+
+static NCNN_FORCEINLINE size_t atomic_load_size(const size_t* addr)
+{
+    return __atomic_load_n(addr, __ATOMIC_RELAXED);
+}
+#elif NCNN_THREADS && defined _MSC_VER
+static NCNN_FORCEINLINE void* atomic_load_ptr(void** addr)
+{
+    return InterlockedCompareExchangePointer(addr, 0, 0);
+}
+
+static NCNN_FORCEINLINE void* atomic_exchange_ptr(void** addr, void* value)
+{
+    return InterlockedExchangePointer(addr, value);
+}
+
+static NCNN_FORCEINLINE bool atomic_compare_exchange_ptr(void** addr, void* expected, void* desired)
+{
+    return InterlockedCompareExchangePointer(addr, desired, expected) == expected;
+}
+
+static NCNN_FORCEINLINE void atomic_add_size(size_t* addr, size_t delta)
+{
+#if defined _WIN64
+    InterlockedExchangeAdd64((volatile LONG64*)addr, (LONG64)delta);
+#else
+    InterlockedExchangeAdd((volatile LONG*)addr, (LONG)delta);
+#endif
+}
+
+static NCNN_FORCEINLINE size_t atomic_load_size(const size_t* addr)
+{
+    return *(const volatile size_t*)addr;
+}
+#else
+// no atomic builtins, serialize with a lock
+// the lock is a no-op without NCNN_THREADS
+static Mutex g_size_class_atomic_lock;
+
+static NCNN_FORCEINLINE void* atomic_load_ptr(void** addr)
+{
+    MutexLockGuard guard(g_size_class_atomic_lock);
+    return *addr;
+}
+
+static NCNN_FORCEINLINE void* atomic_exchange_ptr(void** addr, void* value)
+{
+    MutexLockGuard guard(g_size_class_atomic_lock);
+    void* tmp = *addr;
+    *addr = value;
+    return tmp;
+}
+
+static NCNN_FORCEINLINE bool atomic_compare_exchange_ptr(void** addr, void* expected, void* desired)
+{
+    MutexLockGuard guard(g_size_class_atomic_lock);
+    if (*addr != expected)
+        return false;
+
+    *addr = desired;
+    return true;
+}
+
+static NCNN_FORCEINLINE void atomic_add_size(size_t* addr, size_t delta)
+{
+    MutexLockGuard guard(g_size_class_atomic_lock);
+    *addr += delta;
+}
+
+static NCNN_FORCEINLINE size_t atomic_load_size(const size_t* addr)
+{
+    MutexLockGuard guard(g_size_class_atomic_lock);
+    return *addr;
+}
+#endif
+
+// 64 bytes, then 4 classes per power of two
+#define NCNN_SIZE_CLASS_COUNT ((int)sizeof(size_t) * 8 * 4)
+
+// blocks per size class in the lock-free shared tier
+#define NCNN_SIZE_CLASS_SHARED_SLOTS 16
+
+#define NCNN_SIZE_CLASS_MAGIC 0x5343504c
+
+static NCNN_FORCEINLINE int size_class_index(size_t size)
+{
+    if (size <= 64)
+        return 0;
+
+    const size_t s = size - 1;
+
+    // the highest set bit
+#if defined __GNUC__
+    const int p = 63 - __builtin_clzll((unsigned long long)s);
+#else
+    int p = 6;
+    while (s >> (p + 1))
+        p++;
+#endif
+
+    const int sub = (int)((s >> (p - 2)) & 3);
+
+    return (p - 6) * 4 + sub + 1;
+}
+
+static NCNN_FORCEINLINE size_t size_class_size(int index)
+{
+    if (index == 0)
+        return 64;
+
+    const int p = (index - 1) / 4 + 6;
+    const int sub = (index - 1) % 4;
+
+    return ((size_t)1 << p) + ((size_t)(sub + 1) << (p - 2));
+}
+
+// the header right before each block
+struct SizeClassBlockHeader
+{
+    // the magic mixed with the owner and the block address
+    size_t tag;
+    int index;
+    // whether the block is handed out
+    int payout;
+};
+
+class SizeClassPoolAllocatorPrivate;
+
+class SizeClassThreadCache
+{
+public:
+    SizeClassPoolAllocatorPrivate* owner;
+    std::vector<void*> bins[NCNN_SIZE_CLASS_COUNT];
+};
+
+// hands the cache back to the allocator when its thread exits
+static void size_class_thread_cache_exit(SizeClassThreadCache* cache);
+
+#if NCNN_THREADS && defined _WIN32
+static VOID NTAPI size_class_thread_cache_exit_callback(PVOID data)
+{
+    if (data)
+        size_class_thread_cache_exit((SizeClassThreadCache*)data);
+}
+
+// fiber local storage is the only win32 slot with an exit callback
+class SizeClassThreadCacheStorage
+{
+public:
+    SizeClassThreadCacheStorage() { key = FlsAlloc(size_class_thread_cache_exit_callback); }
+    // runs the exit callback for every thread still holding a cache
+    ~SizeClassThreadCacheStorage() { FlsFree(key); }
+    void set(SizeClassThreadCache* value) { FlsSetValue(key, (PVOID)value); }
+    SizeClassThreadCache* get() { return (SizeClassThreadCache*)FlsGetValue(key); }
+private:
+    DWORD key;
+};
+#elif NCNN_THREADS
+static void size_class_thread_cache_exit_callback(void* data)
+{
+    size_class_thread_cache_exit((SizeClassThreadCache*)data);
+}
+
+class SizeClassThreadCacheStorage
+{
+public:
+    SizeClassThreadCacheStorage() { pthread_key_create(&key, size_class_thread_cache_exit_callback); }
+    // the exit callback does not run for the remaining threads, the allocator frees their caches
+    ~SizeClassThreadCacheStorage() { pthread_key_delete(key); }
+    void set(SizeClassThreadCache* value) { pthread_setspecific(key, value); }
+    SizeClassThreadCache* get() { return (SizeClassThreadCache*)pthread_getspecific(key); }
+private:
+    pthread_key_t key;
+};
+#else
+class SizeClassThreadCacheStorage
+{
+public:
+    SizeClassThreadCacheStorage() { data = 0; }
+    void set(SizeClassThreadCache* value) { data = value; }
+    SizeClassThreadCache* get() { return data; }
+private:
+    SizeClassThreadCache* data;
+};
+#endif
+
+class SizeClassPoolAllocatorPrivate
+{
+public:
+    int thread_cache_size;
+
+    Mutex thread_caches_lock;
+    std::vector<SizeClassThreadCache*> thread_caches;
+
+    // lock-free shared tier, a null slot is empty
+    void* shared_slots[NCNN_SIZE_CLASS_COUNT][NCNN_SIZE_CLASS_SHARED_SLOTS];
+
+    // locked overflow tier
+    Mutex overflow_lock;
+    std::vector<void*> overflow_bins[NCNN_SIZE_CLASS_COUNT];
+    size_t overflow_counts[NCNN_SIZE_CLASS_COUNT];
+
+    int payout_count;
+
+    size_t allocation_count;
+    size_t allocation_bytes;
+    size_t hit_count;
+    size_t pooled_bytes;
+
+    SizeClassThreadCacheStorage* tls_thread_cache;
+
+    size_t block_tag(const void* header) const;
+    SizeClassThreadCache* get_thread_cache();
+    void* pop_pooled(int index);
+    void push_pooled(int index, void* ptr);
+};
+
+SizeClassThreadCache* SizeClassPoolAllocatorPrivate::get_thread_cache()
+{
+    SizeClassThreadCache* cache = tls_thread_cache->get();
+    if (!cache)
+    {
+        cache = new SizeClassThreadCache;
+        cache->owner = this;
+        tls_thread_cache->set(cache);
+
+        thread_caches_lock.lock();
+        thread_caches.push_back(cache);
+        thread_caches_lock.unlock();
+    }
+
+    return cache;
+}
+
+size_t SizeClassPoolAllocatorPrivate::block_tag(const void* header) const
+{
+    return (size_t)this ^ (size_t)header ^ NCNN_SIZE_CLASS_MAGIC;
+}
+
+static void size_class_thread_cache_exit(SizeClassThreadCache* cache)
+{
+    SizeClassPoolAllocatorPrivate* d = cache->owner;
+
+    // move the cached blocks to the overflow tier for the other threads
+    d->thread_caches_lock.lock();
+
+    for (size_t i = 0; i < d->thread_caches.size(); i++)
+    {
+        if (d->thread_caches[i] == cache)
+        {
+            d->thread_caches.erase(d->thread_caches.begin() + i);
+            break;
+        }
+    }
+
+    d->overflow_lock.lock();
+    for (int i = 0; i < NCNN_SIZE_CLASS_COUNT; i++)
+    {
+        std::vector<void*>& bin = cache->bins[i];
+        if (bin.empty())
+            continue;
+
+        std::vector<void*>& overflow_bin = d->overflow_bins[i];
+        overflow_bin.insert(overflow_bin.end(), bin.begin(), bin.end());
+        atomic_add_size(&d->overflow_counts[i], bin.size());
+    }
+    d->overflow_lock.unlock();
+
+    d->thread_caches_lock.unlock();
+
+    delete cache;
+}
+
+void* SizeClassPoolAllocatorPrivate::pop_pooled(int index)
+{
+    SizeClassThreadCache* cache = get_thread_cache();
+    std::vector<void*>& bin = cache->bins[index];
+    if (!bin.empty())
+    {
+        void* ptr = bin.back();
+        bin.pop_back();
+        return ptr;
+    }
+
+    void** slots = shared_slots[index];
+    for (int i = 0; i < NCNN_SIZE_CLASS_SHARED_SLOTS; i++)
+    {
+        if (!atomic_load_ptr(&slots[i]))
+            continue;
+
+        void* ptr = atomic_exchange_ptr(&slots[i], 0);
+        if (ptr)
+            return ptr;
+    }
+
+    if (atomic_load_size(&overflow_counts[index]) == 0)
+        return 0;
+
+    void* ptr = 0;
+
+    overflow_lock.lock();
+
+    std::vector<void*>& overflow_bin = overflow_bins[index];
+    if (!overflow_bin.empty())
+    {
+        ptr = overflow_bin.back();
+        overflow_bin.pop_back();
+        atomic_add_size(&overflow_counts[index], (size_t)0 - 1);
+    }
+
+    overflow_lock.unlock();
+
+    return ptr;
+}
+
+void SizeClassPoolAllocatorPrivate::push_pooled(int index, void* ptr)
+{
+    SizeClassThreadCache* cache = get_thread_cache();
+    std::vector<void*>& bin = cache->bins[index];
+    if ((int)bin.size() < thread_cache_size)
+    {
+        bin.push_back(ptr);
+        return;
+    }
+
+    void** slots = shared_slots[index];
+    for (int i = 0; i < NCNN_SIZE_CLASS_SHARED_SLOTS; i++)
+    {
+        if (atomic_load_ptr(&slots[i]))
+            continue;
+
+        if (atomic_compare_exchange_ptr(&slots[i], 0, ptr))
+            return;
+    }
+
+    overflow_lock.lock();
+
+    std::vector<void*>& overflow_bin = overflow_bins[index];
+    overflow_bin.push_back(ptr);
+    atomic_add_size(&overflow_counts[index], 1);
+
+    overflow_lock.unlock();
+}
+
+SizeClassPoolAllocator::SizeClassPoolAllocator()
+    : Allocator(), d(new SizeClassPoolAllocatorPrivate)
+{
+    d->tls_thread_cache = new SizeClassThreadCacheStorage;
+
+    d->thread_cache_size = 4;
+
+    memset(d->shared_slots, 0, sizeof(d->shared_slots));
+    memset(d->overflow_counts, 0, sizeof(d->overflow_counts));
+
+    d->payout_count = 0;
+
+    d->allocation_count = 0;
+    d->allocation_bytes = 0;
+    d->hit_count = 0;
+    d->pooled_bytes = 0;
+}
+
+SizeClassPoolAllocator::~SizeClassPoolAllocator()
+{
+    // no more exit callbacks past this point
+    delete d->tls_thread_cache;
+
+    clear();
+
+    if (d->payout_count != 0)
+    {
+        NCNN_LOGE("FATAL ERROR! size class pool allocator destroyed too early, %d blocks still in use", d->payout_count);
+    }
+
+    for (size_t i = 0; i < d->thread_caches.size(); i++)
+    {
+        delete d->thread_caches[i];
+    }
+
+    delete d;
+}
+
+SizeClassPoolAllocator::SizeClassPoolAllocator(const SizeClassPoolAllocator&)
+    : d(0)
+{
+}
+
+SizeClassPoolAllocator& SizeClassPoolAllocator::operator=(const SizeClassPoolAllocator&)
+{
+    return *this;
+}
+
+void SizeClassPoolAllocator::set_thread_cache_size(int size)
+{
+    if (size < 0)
+    {
+        NCNN_LOGE("invalid thread cache size %d", size);
+        return;
+    }
+
+    d->thread_cache_size = size;
+}
+
+void SizeClassPoolAllocator::clear()
+{
+    d->thread_caches_lock.lock();
+    for (size_t i = 0; i < d->thread_caches.size(); i++)
+    {
+        SizeClassThreadCache* cache = d->thread_caches[i];
+        for (int j = 0; j < NCNN_SIZE_CLASS_COUNT; j++)
+        {
+            std::vector<void*>& bin = cache->bins[j];
+            for (size_t k = 0; k < bin.size(); k++)
+            {
+                ncnn::fastFree((unsigned char*)bin[k] - NCNN_MALLOC_ALIGN);
+            }
+            bin.clear();
+        }
+    }
+    d->thread_caches_lock.unlock();
+
+    for (int i = 0; i < NCNN_SIZE_CLASS_COUNT; i++)
+    {
+        for (int j = 0; j < NCNN_SIZE_CLASS_SHARED_SLOTS; j++)
+        {
+            void* ptr = atomic_exchange_ptr(&d->shared_slots[i][j], 0);
+            if (ptr)
+                ncnn::fastFree((unsigned char*)ptr - NCNN_MALLOC_ALIGN);
+        }
+    }
+
+    d->overflow_lock.lock();
+    for (int i = 0; i < NCNN_SIZE_CLASS_COUNT; i++)
+    {
+        std::vector<void*>& overflow_bin = d->overflow_bins[i];
+        for (size_t j = 0; j < overflow_bin.size(); j++)
+        {
+            ncnn::fastFree((unsigned char*)overflow_bin[j] - NCNN_MALLOC_ALIGN);
+        }
+        overflow_bin.clear();
+        d->overflow_counts[i] = 0;
+    }
+    d->overflow_lock.unlock();
+
+    d->pooled_bytes = 0;
+}
+
+void* SizeClassPoolAllocator::fastMalloc(size_t size)
+{
+    const int index = size_class_index(size);
+    const size_t class_size = size_class_size(index);
+
+    atomic_add_size(&d->allocation_count, 1);
+    atomic_add_size(&d->allocation_bytes, size);
+
+    void* ptr = d->pop_pooled(index);
+    if (ptr)
+    {
+        SizeClassBlockHeader* header = (SizeClassBlockHeader*)((unsigned char*)ptr - NCNN_MALLOC_ALIGN);
+        header->payout = 1;
+
+        atomic_add_size(&d->hit_count, 1);
+        atomic_add_size(&d->pooled_bytes, (size_t)0 - class_size);
+        NCNN_XADD(&d->payout_count, 1);
+        return ptr;
+    }
+
+    // new
+    unsigned char* data = (unsigned char*)ncnn::fastMalloc(class_size + NCNN_MALLOC_ALIGN);
+    if (!data)
+        return 0;
+
+    SizeClassBlockHeader* header = (SizeClassBlockHeader*)data;
+    header->tag = d->block_tag(header);
+    header->index = index;
+    header->payout = 1;
+
+    NCNN_XADD(&d->payout_count, 1);
+
+    return data + NCNN_MALLOC_ALIGN;
+}
+
+void SizeClassPoolAllocator::fastFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    // only blocks of this allocator carry its tag
+    SizeClassBlockHeader* header = (SizeClassBlockHeader*)((unsigned char*)ptr - NCNN_MALLOC_ALIGN);
+    if (header->tag != d->block_tag(header) || header->index < 0 || header->index >= NCNN_SIZE_CLASS_COUNT)
+    {
+        NCNN_LOGE("FATAL ERROR! size class pool allocator get wild %p", ptr);
+        ncnn::fastFree(ptr);
+        return;
+    }
+
+    if (!header->payout)
+    {
+        NCNN_LOGE("FATAL ERROR! size class pool allocator get double free %p", ptr);
+        return;
+    }
+
+    header->payout = 0;
+
+    const int index = header->index;
+
+    NCNN_XADD(&d->payout_count, -1);
+    atomic_add_size(&d->pooled_bytes, size_class_size(index));
+
+    // return to budgets
+    d->push_pooled(index, ptr);
+}
+
+size_t SizeClassPoolAllocator::allocation_count() const
+{
+    return atomic_load_size(&d->allocation_count);
+}
+
+size_t SizeClassPoolAllocator::allocation_bytes() const
+{
+    return atomic_load_size(&d->allocation_bytes);
+}
+
+size_t SizeClassPoolAllocator::hit_count() const
+{
+    return atomic_load_size(&d->hit_count);
+}
+
+float SizeClassPoolAllocator::hit_rate() const
+{
+    const size_t count = allocation_count();
+    if (count == 0)
+        return 0.f;
+
+    return (float)((double)hit_count() / count);
+}
+
+size_t SizeClassPoolAllocator::pooled_bytes() const
+{
+    return atomic_load_size(&d->pooled_bytes);
+}
+
 #if NCNN_VULKAN
 VkAllocator::VkAllocator(const VulkanDevice* _vkdev)
     : vkdev(_vkdev)
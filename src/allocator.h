@@ -205,6 +205,48 @@ private:
     UnlockedPoolAllocatorPrivate* const d;
 };
 
+class SizeClassPoolAllocatorPrivate;
+// pooled allocator with size-class bins, O(1) per allocation and thread-safe
+// sizes are rounded up to 4 classes per power of two, wasting at most 25%
+// freed blocks go to the cache of the calling thread first,
+// then to a lock-free shared tier, then to a locked overflow list
+// the cache of an exiting thread moves to the overflow list
+// fastFree rejects blocks that were not allocated by this allocator
+class NCNN_EXPORT SizeClassPoolAllocator : public Allocator
+{
+public:
+    SizeClassPoolAllocator();
+    ~SizeClassPoolAllocator();
+
+    // max blocks kept per size class in the cache of each thread
+    // default size = 4
+    void set_thread_cache_size(int size);
+
+    // release all budgets immediately
+    // must not race with fastMalloc or fastFree
+    void clear();
+
+    virtual void* fastMalloc(size_t size);
+    virtual void fastFree(void* ptr);
+
+public:
+    // statistics
+    size_t allocation_count() const;
+    size_t allocation_bytes() const;
+    // allocations served from the pool
+    size_t hit_count() const;
+    float hit_rate() const;
+    // bytes held by the pool, excluding blocks in use
+    size_t pooled_bytes() const;
+
+private:
+    SizeClassPoolAllocator(const SizeClassPoolAllocator&);
+    SizeClassPoolAllocator& operator=(const SizeClassPoolAllocator&);
+
+private:
+    SizeClassPoolAllocatorPrivate* const d;
+};
+
 #if NCNN_VULKAN
 
 class VulkanDevice;
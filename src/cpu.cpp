@@ -235,6 +235,8 @@ static int g_cpu_support_x86_avx512;
 static int g_cpu_support_x86_avx512_vnni;
 static int g_cpu_support_x86_avx512_bf16;
 static int g_cpu_support_x86_avx512_fp16;
+static int g_cpu_support_x86_amx_int8;
+static int g_cpu_support_x86_amx_bf16;
 #endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
 
 #if defined __ANDROID__ || defined __linux__
@@ -864,6 +866,69 @@ static int get_cpu_support_x86_avx512_fp16()
     return cpu_info[3] & (1u << 23);
 #endif
 }
+static int get_cpu_support_x86_amx_tile()
+{
+#if __APPLE__
+    return 0;
+#else
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid(0, cpu_info);
+
+    int nIds = cpu_info[0];
+    if (nIds < 7)
+        return 0;
+
+    x86_cpuid(1, cpu_info);
+    // check XSAVE OSXSAVE
+    if (!(cpu_info[2] & (1u << 26)) || !(cpu_info[2] & (1u << 27)))
+        return 0;
+
+    x86_cpuid_sublevel(7, 0, cpu_info);
+    if (!(cpu_info[3] & (1u << 24)))
+        return 0;
+
+    // check tilecfg and tiledata XSAVE enabled by kernel
+    if ((x86_get_xcr0() & 0x60000) != 0x60000)
+        return 0;
+
+#if (defined __ANDROID__ || defined __linux__) && defined SYS_arch_prctl
+    // linux keeps the tile data state disabled until the process asks for it
+    // ARCH_REQ_XCOMP_PERM = 0x1023, XFEATURE_XTILEDATA = 18
+    if (syscall(SYS_arch_prctl, 0x1023, 18) != 0)
+        return 0;
+#endif
+
+    return 1;
+#endif
+}
+
+static int get_cpu_support_x86_amx_int8()
+{
+#if __APPLE__
+    return 0;
+#else
+    if (!get_cpu_support_x86_amx_tile())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid_sublevel(7, 0, cpu_info);
+    return cpu_info[3] & (1u << 25);
+#endif
+}
+
+static int get_cpu_support_x86_amx_bf16()
+{
+#if __APPLE__
+    return 0;
+#else
+    if (!get_cpu_support_x86_amx_tile())
+        return 0;
+
+    unsigned int cpu_info[4] = {0};
+    x86_cpuid_sublevel(7, 0, cpu_info);
+    return cpu_info[3] & (1u << 22);
+#endif
+}
 #endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
 
 static int get_cpucount()
@@ -2232,6 +2297,8 @@ static void initialize_global_cpu_info()
     g_cpu_support_x86_avx512_vnni = get_cpu_support_x86_avx512_vnni();
     g_cpu_support_x86_avx512_bf16 = get_cpu_support_x86_avx512_bf16();
     g_cpu_support_x86_avx512_fp16 = get_cpu_support_x86_avx512_fp16();
+    g_cpu_support_x86_amx_int8 = get_cpu_support_x86_amx_int8();
+    g_cpu_support_x86_amx_bf16 = get_cpu_support_x86_amx_bf16();
 #endif // defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
 
 #if defined __ANDROID__ || defined __linux__
@@ -2790,6 +2857,26 @@ int cpu_support_x86_avx512_fp16()
 #endif
 }
 
+int cpu_support_x86_amx_int8()
+{
+    try_initialize_global_cpu_info();
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_amx_int8;
+#else
+    return 0;
+#endif
+}
+
+int cpu_support_x86_amx_bf16()
+{
+    try_initialize_global_cpu_info();
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    return g_cpu_support_x86_amx_bf16;
+#else
+    return 0;
+#endif
+}
+
 int cpu_support_mips_msa()
 {
     try_initialize_global_cpu_info();
@@ -3107,6 +3194,41 @@ int set_cpu_thread_affinity(const CpuSet& thread_affinity_mask)
 #endif
 }
 
+int get_cpu_thread_affinity(CpuSet& thread_affinity_mask)
+{
+    try_initialize_global_cpu_info();
+#if defined _WIN32
+    // there is no getter, the previous mask comes back from setting one
+    HANDLE thread = GetCurrentThread();
+    DWORD_PTR prev_mask = SetThreadAffinityMask(thread, g_cpu_affinity_mask_all.mask);
+    if (prev_mask == 0)
+        return -1;
+
+    SetThreadAffinityMask(thread, prev_mask);
+
+    thread_affinity_mask.mask = prev_mask;
+    return 0;
+#elif defined __ANDROID__ || defined __linux__
+#if defined(__BIONIC__) && !defined(__OHOS__)
+    pid_t pid = gettid();
+#else
+    pid_t pid = syscall(SYS_gettid);
+#endif
+
+    thread_affinity_mask.disable_all();
+
+    int syscallret = syscall(__NR_sched_getaffinity, pid, sizeof(cpu_set_t), &thread_affinity_mask.cpu_set);
+    if (syscallret < 0)
+        return -1;
+
+    return 0;
+#else
+    // TODO
+    (void)thread_affinity_mask;
+    return -1;
+#endif
+}
+
 int is_current_thread_running_on_a53_a55()
 {
     try_initialize_global_cpu_info();
@@ -96,6 +96,10 @@ NCNN_EXPORT int cpu_support_x86_avx512_vnni();
 NCNN_EXPORT int cpu_support_x86_avx512_bf16();
 // avx512_fp16 = x86 avx512 fp16
 NCNN_EXPORT int cpu_support_x86_avx512_fp16();
+// amx_int8 = x86 amx tile + amx int8, with tile state permitted by the os
+NCNN_EXPORT int cpu_support_x86_amx_int8();
+// amx_bf16 = x86 amx tile + amx bf16, with tile state permitted by the os
+NCNN_EXPORT int cpu_support_x86_amx_bf16();
 
 // lsx = loongarch lsx
 NCNN_EXPORT int cpu_support_loongarch_lsx();
@@ -148,6 +152,10 @@ NCNN_EXPORT const CpuSet& get_cpu_thread_affinity_mask(int powersave);
 // set explicit thread affinity
 NCNN_EXPORT int set_cpu_thread_affinity(const CpuSet& thread_affinity_mask);
 
+// get the affinity of the calling thread
+// return 0 if success
+NCNN_EXPORT int get_cpu_thread_affinity(CpuSet& thread_affinity_mask);
+
 // runtime thread affinity info
 NCNN_EXPORT int is_current_thread_running_on_a53_a55();
 
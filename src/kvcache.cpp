@@ -0,0 +1,225 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "kvcache.h"
+
+#include <string.h>
+
+namespace ncnn {
+
+class KVCacheEntry
+{
+public:
+    const Layer* layer;
+
+    // [num_group][capacity][embed_dim]
+    Mat key;
+    Mat value;
+
+    // cached tokens are rows start .. start + seqlen
+    int start;
+    int seqlen;
+};
+
+class KVCachePrivate
+{
+public:
+    KVCacheEntry* find(const Layer* layer) const;
+
+    int capacity;
+    int window;
+
+    // entries are never moved, so layers only lock for the lookup
+    mutable Mutex lock;
+    std::vector<KVCacheEntry*> entries;
+};
+
+KVCacheEntry* KVCachePrivate::find(const Layer* layer) const
+{
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (entries[i]->layer == layer)
+            return entries[i];
+    }
+
+    return 0;
+}
+
+static Mat view_rows(const Mat& m, int start, int count)
+{
+    // external data, the rows of each channel stay m.cstep apart
+    Mat v(m.w, count, m.c, (unsigned char*)m.data + (size_t)start * m.w * m.elemsize, m.elemsize);
+    v.cstep = m.cstep;
+    return v;
+}
+
+static void copy_rows(const Mat& src, int src_start, Mat& dst, int dst_start, int count)
+{
+    const size_t size = (size_t)count * src.w * src.elemsize;
+    for (int q = 0; q < src.c; q++)
+    {
+        const unsigned char* ptr = src.channel(q).row<const unsigned char>(src_start);
+        unsigned char* outptr = dst.channel(q).row<unsigned char>(dst_start);
+        memmove(outptr, ptr, size);
+    }
+}
+
+KVCache::KVCache(int capacity, int window)
+    : d(new KVCachePrivate)
+{
+    d->capacity = capacity > 0 ? capacity : 1;
+    d->window = window;
+}
+
+KVCache::~KVCache()
+{
+    release();
+
+    delete d;
+}
+
+KVCache::KVCache(const KVCache&)
+    : d(0)
+{
+}
+
+KVCache& KVCache::operator=(const KVCache&)
+{
+    return *this;
+}
+
+void KVCache::clear()
+{
+    d->lock.lock();
+    for (size_t i = 0; i < d->entries.size(); i++)
+    {
+        d->entries[i]->start = 0;
+        d->entries[i]->seqlen = 0;
+    }
+    d->lock.unlock();
+}
+
+void KVCache::release()
+{
+    d->lock.lock();
+    for (size_t i = 0; i < d->entries.size(); i++)
+    {
+        delete d->entries[i];
+    }
+    d->entries.clear();
+    d->lock.unlock();
+}
+
+int KVCache::seqlen(const Layer* layer) const
+{
+    d->lock.lock();
+    const KVCacheEntry* e = d->find(layer);
+    d->lock.unlock();
+
+    if (!e)
+        return 0;
+
+    return d->window > 0 ? std::min(e->seqlen, d->window) : e->seqlen;
+}
+
+size_t KVCache::memory_bytes() const
+{
+    size_t bytes = 0;
+
+    d->lock.lock();
+    for (size_t i = 0; i < d->entries.size(); i++)
+    {
+        const KVCacheEntry* e = d->entries[i];
+        bytes += e->key.total() * e->key.elemsize;
+        bytes += e->value.total() * e->value.elemsize;
+    }
+    d->lock.unlock();
+
+    return bytes;
+}
+
+int KVCache::append(const Layer* layer, const Mat& cur_key, const Mat& cur_value, Mat& key, Mat& value)
+{
+    if (cur_key.dims != 3 || cur_value.dims != 3 || cur_key.elempack != 1 || cur_value.elempack != 1 || cur_key.h != cur_value.h || cur_key.c != cur_value.c)
+    {
+        NCNN_LOGE("kv cache expects unpacked key and value of the same seqlen and groups");
+        return -1;
+    }
+
+    d->lock.lock();
+    KVCacheEntry* e = d->find(layer);
+    if (!e)
+    {
+        e = new KVCacheEntry;
+        e->layer = layer;
+        e->start = 0;
+        e->seqlen = 0;
+        d->entries.push_back(e);
+    }
+    d->lock.unlock();
+
+    if (!e->key.empty() && (e->key.w != cur_key.w || e->key.c != cur_key.c || e->key.elemsize != cur_key.elemsize || e->value.w != cur_value.w || e->value.elemsize != cur_value.elemsize))
+    {
+        NCNN_LOGE("kv cache shape changed within one sequence, call clear first");
+        return -1;
+    }
+
+    const int window = d->window;
+    const int cur_seqlen = cur_key.h;
+
+    // evict the tokens that slid out of the window
+    if (window > 0 && e->seqlen > window)
+    {
+        e->start += e->seqlen - window;
+        e->seqlen = window;
+    }
+
+    const int seqlen = e->seqlen + cur_seqlen;
+
+    if (e->key.empty() || e->start + seqlen > e->key.h)
+    {
+        const int capacity = e->key.empty() ? 0 : e->key.h;
+
+        if (window > 0 && seqlen * 2 <= capacity)
+        {
+            // the window only moves forward, compact it to the front
+            // at least half the capacity is free afterwards, so this is amortized O(1) per token
+            copy_rows(e->key, e->start, e->key, 0, e->seqlen);
+            copy_rows(e->value, e->start, e->value, 0, e->seqlen);
+        }
+        else
+        {
+            int new_capacity = std::max(std::max(capacity * 2, d->capacity), seqlen);
+            if (window > 0)
+                new_capacity = std::max(new_capacity, seqlen * 2);
+
+            Mat new_key(cur_key.w, new_capacity, cur_key.c, cur_key.elemsize);
+            Mat new_value(cur_value.w, new_capacity, cur_value.c, cur_value.elemsize);
+            if (new_key.empty() || new_value.empty())
+                return -100;
+
+            if (e->seqlen > 0)
+            {
+                copy_rows(e->key, e->start, new_key, 0, e->seqlen);
+                copy_rows(e->value, e->start, new_value, 0, e->seqlen);
+            }
+
+            e->key = new_key;
+            e->value = new_value;
+        }
+
+        e->start = 0;
+    }
+
+    copy_rows(cur_key, 0, e->key, e->start + e->seqlen, cur_seqlen);
+    copy_rows(cur_value, 0, e->value, e->start + e->seqlen, cur_seqlen);
+
+    e->seqlen = seqlen;
+
+    key = view_rows(e->key, e->start, seqlen);
+    value = view_rows(e->value, e->start, seqlen);
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,59 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_KVCACHE_H
+#define NCNN_KVCACHE_H
+
+#include "mat.h"
+#include "platform.h"
+
+namespace ncnn {
+
+class Layer;
+
+class KVCachePrivate;
+// keys and values of past tokens kept across forward calls for autoregressive decoding
+// SDPA layers with kv_cache=1 append the new tokens in place and attend to the whole history,
+// the past_key and past_value bottom blobs are ignored and may be left unset
+// each token costs O(1) copies instead of concatenating the history every step
+// attach the same cache to every extractor of one sequence, cpu layers only
+class NCNN_EXPORT KVCache
+{
+public:
+    // memory for capacity tokens per layer is reserved on first use and doubled when exceeded
+    // window > 0 keeps only the most recent window tokens (sliding window attention),
+    // new tokens attend to at most window past tokens
+    KVCache(int capacity = 256, int window = 0);
+    ~KVCache();
+
+    // start a new sequence, memory is kept for reuse
+    void clear();
+
+    // release all memory
+    void release();
+
+    // number of tokens cached for layer, 0 before its first forward
+    int seqlen(const Layer* layer) const;
+
+    // bytes reserved for all layers
+    size_t memory_bytes() const;
+
+public:
+    // append cur_key (embed_dim, cur_seqlen, num_group) and cur_value to the history of layer
+    // key and value become views of the history including the new tokens,
+    // they stay valid until the next append to the same layer or clear
+    // different layers may append concurrently
+    // return 0 on success
+    int append(const Layer* layer, const Mat& cur_key, const Mat& cur_value, Mat& key, Mat& value);
+
+private:
+    KVCache(const KVCache&);
+    KVCache& operator=(const KVCache&);
+
+private:
+    KVCachePrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_KVCACHE_H
@@ -27,8 +27,12 @@ Layer::Layer()
     support_any_packing = false;
     support_vulkan_any_packing = false;
 
+    support_batch = false;
+
     featmask = 0;
 
+    shape_cache = 0;
+
 #if NCNN_VULKAN
     vkdev = 0;
 #endif // NCNN_VULKAN
@@ -61,6 +65,11 @@ int Layer::destroy_pipeline(const Option& /*opt*/)
     return 0;
 }
 
+int Layer::get_pipeline_weights(std::vector<Mat*>& /*weights*/)
+{
+    return 0;
+}
+
 int Layer::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     if (!support_inplace)
@@ -240,6 +249,9 @@ public:
         support_fp16_storage = layer_cpu->support_fp16_storage;
         support_int8_storage = layer_cpu->support_int8_storage;
         support_any_packing = layer_cpu->support_any_packing;
+        support_batch = layer_cpu->support_batch;
+
+        shape_cache = layer_cpu->shape_cache;
 
         support_vulkan = false;
         support_tensor_storage = false;
@@ -345,11 +357,27 @@ public:
 #if NCNN_VULKAN
         if (layer_vulkan)
         {
-            return layer_vulkan->destroy_pipeline(opt);
+            int ret = layer_vulkan->destroy_pipeline(opt);
+            get_layer_properties();
+            return ret;
+        }
+#endif // NCNN_VULKAN
+
+        int ret = layer_cpu->destroy_pipeline(opt);
+        get_layer_properties();
+        return ret;
+    }
+
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights)
+    {
+#if NCNN_VULKAN
+        if (layer_vulkan)
+        {
+            return layer_vulkan->get_pipeline_weights(weights);
         }
 #endif // NCNN_VULKAN
 
-        return layer_cpu->destroy_pipeline(opt);
+        return layer_cpu->get_pipeline_weights(weights);
     }
 
 public:
@@ -9,6 +9,7 @@
 #include "option.h"
 #include "paramdict.h"
 #include "platform.h"
+#include "shapecache.h"
 
 #if NCNN_VULKAN
 #include "command.h"
@@ -41,6 +42,12 @@ public:
     // return 0 if success
     virtual int destroy_pipeline(const Option& opt);
 
+    // the weights create_pipeline derives from the model weights, see WeightCache
+    // load_model fills the ones recorded by an earlier load before create_pipeline,
+    // which skips preparing the weights already present
+    // return 0 if success
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
+
 public:
     // one input and one output blob
     bool one_blob_only;
@@ -75,7 +82,10 @@ public:
     // vulkan accept input blob with any elempack
     bool support_vulkan_any_packing;
 
-    bool support_reserved_1;
+    // accept samples stacked as rows of a 2d blob
+    // each row is forwarded independently of the others
+    bool support_batch;
+
     bool support_reserved_2;
     bool support_reserved_3;
     bool support_reserved_4;
@@ -88,6 +98,10 @@ public:
     // feature disabled set
     int featmask;
 
+    // kernel and tile choices per input shape
+    // owned by the layer between create_pipeline and destroy_pipeline, null if unused
+    ShapeCache* shape_cache;
+
 public:
     // implement inference
     // return 0 if success
@@ -10,6 +10,8 @@
 
 #include "arm_usability.h"
 
+#include "weight_quant.h"
+
 #include "cpu.h"
 
 namespace ncnn {
@@ -4235,6 +4237,18 @@ static int gemm_AT_BT_arm(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_b
 
 int Gemm_arm::create_pipeline(const Option& opt)
 {
+    if (weight_quant_bits)
+    {
+        // no weight-only quantized kernel here, decode the weights once and run the fp32 path
+        Mat B_data_fp32;
+        if (weight_quant_unpack(B_data, B_data_quant_scales, B_data_fp32, constantK * constantN, constantK, weight_quant_group_size, weight_quant_bits) != 0)
+            return -100;
+
+        B_data = B_data_fp32.reshape(constantK, constantN);
+        B_data_quant_scales.release();
+        weight_quant_bits = 0;
+    }
+
 #if NCNN_INT8
     if (int8_scale_term)
     {
@@ -3,6 +3,8 @@
 
 #include "gemm.h"
 
+#include "weight_quant.h"
+
 namespace ncnn {
 
 Gemm::Gemm()
@@ -32,6 +34,8 @@ int Gemm::load_param(const ParamDict& pd)
     constant_TILE_M = pd.get(20, 0);
     constant_TILE_N = pd.get(21, 0);
     constant_TILE_K = pd.get(22, 0);
+    weight_quant_bits = pd.get(23, 0);
+    weight_quant_group_size = pd.get(24, 32);
 
     if (int8_scale_term)
     {
@@ -59,6 +63,25 @@ int Gemm::load_param(const ParamDict& pd)
         return -1;
     }
 
+    if (weight_quant_bits != 0 && weight_quant_bits != 4 && weight_quant_bits != 8)
+    {
+        NCNN_LOGE("unsupported weight_quant_bits %d", weight_quant_bits);
+        return -1;
+    }
+
+    if (weight_quant_bits && (weight_quant_group_size <= 0 || (weight_quant_bits == 4 && weight_quant_group_size % 2 != 0)))
+    {
+        NCNN_LOGE("weight_quant_group_size %d must be positive and even for int4", weight_quant_group_size);
+        return -1;
+    }
+
+    if (weight_quant_bits && (constantB == 0 || transB == 0 || int8_scale_term))
+    {
+        // groups run along K, which is the row of B only when transB enabled
+        NCNN_LOGE("weight_quant_bits requires constantB and transB, without int8_scale_term");
+        return -1;
+    }
+
     if (constantA == 0 && constantB == 1 && constantC == 1)
         one_blob_only = true;
 
@@ -68,6 +91,10 @@ int Gemm::load_param(const ParamDict& pd)
     if (constantA == 1 && constantB == 1 && constantC == 0)
         one_blob_only = true;
 
+    // rows of A are independent when B is constant and C does not depend on M
+    support_batch = constantA == 0 && constantB == 1 && constantC == 1 && transA == 0 && output_N1M == 0 && output_transpose == 0
+                    && (constant_broadcast_type_C == -1 || constant_broadcast_type_C == 0 || constant_broadcast_type_C == 4);
+
     return 0;
 }
 
@@ -87,10 +114,22 @@ int Gemm::load_model(const ModelBin& mb)
     {
         if (transB == 0)
             B_data = mb.load(constantN, constantK, 0);
+        else if (weight_quant_bits)
+            B_data = mb.load(constantK * constantN, 0);
         else
             B_data = mb.load(constantK, constantN, 0);
         if (B_data.empty())
             return -100;
+
+        if (weight_quant_bits && B_data.elemsize != (size_t)1u)
+        {
+            // runtime quantize the fp32 B_data
+            Mat B_data_quant;
+            if (weight_quant_pack(B_data, B_data_quant, B_data_quant_scales, constantK, weight_quant_group_size, weight_quant_bits) != 0)
+                return -100;
+
+            B_data = B_data_quant;
+        }
     }
 
     if (constantC == 1 && constant_broadcast_type_C != -1)
@@ -109,6 +148,20 @@ int Gemm::load_model(const ModelBin& mb)
             return -100;
     }
 
+    if (weight_quant_bits && B_data.elemsize == (size_t)1u)
+    {
+        // packed group quantized B_data, the group scales follow C_data
+        if ((size_t)B_data.w != weight_quant_data_size((size_t)constantK * constantN, weight_quant_bits))
+        {
+            NCNN_LOGE("B_data size %d mismatch weight_quant_bits %d", B_data.w, weight_quant_bits);
+            return -1;
+        }
+
+        B_data_quant_scales = mb.load(weight_quant_num_group(constantK, weight_quant_group_size) * constantN, 1);
+        if (B_data_quant_scales.empty())
+            return -100;
+    }
+
 #if NCNN_INT8
     if (int8_scale_term)
     {
@@ -292,7 +345,17 @@ int Gemm::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_bl
 #endif // NCNN_INT8
 
     const Mat& A0 = constantA ? A_data : bottom_blobs[0];
-    const Mat& B0 = constantB ? B_data : constantA ? bottom_blobs[0] : bottom_blobs[1];
+    Mat B0 = constantB ? B_data : constantA ? bottom_blobs[0] : bottom_blobs[1];
+
+    if (weight_quant_bits)
+    {
+        // the reference decodes the packed B_data on every forward
+        Mat B_data_fp32;
+        if (weight_quant_unpack(B_data, B_data_quant_scales, B_data_fp32, constantK * constantN, constantK, weight_quant_group_size, weight_quant_bits, opt.workspace_allocator) != 0)
+            return -100;
+
+        B0 = B_data_fp32.reshape(constantK, constantN);
+    }
 
     size_t elemsize = A0.elemsize;
 
@@ -50,11 +50,18 @@ public:
     int constant_TILE_N;
     int constant_TILE_K;
 
+    // weight-only quantization of constant B, 0=none 4=int4 8=int8
+    int weight_quant_bits;
+    int weight_quant_group_size;
+
     // constant A / B / C
     Mat A_data;
     Mat B_data;
     Mat C_data;
 
+    // constantN x ceil(constantK / weight_quant_group_size)
+    Mat B_data_quant_scales;
+
 #if NCNN_INT8
     Mat A_data_int8_scales;
     float B_data_int8_scale;
@@ -6,6 +6,7 @@
 #include "layer_type.h"
 
 #include "fused_activation.h"
+#include "weight_quant.h"
 
 namespace ncnn {
 
@@ -13,6 +14,7 @@ InnerProduct::InnerProduct()
 {
     one_blob_only = true;
     support_inplace = false;
+    support_batch = true;
 }
 
 int InnerProduct::load_param(const ParamDict& pd)
@@ -23,6 +25,26 @@ int InnerProduct::load_param(const ParamDict& pd)
     int8_scale_term = pd.get(8, 0);
     activation_type = pd.get(9, 0);
     activation_params = pd.get(10, Mat());
+    weight_quant_bits = pd.get(23, 0);
+    weight_quant_group_size = pd.get(24, 32);
+
+    if (weight_quant_bits != 0 && weight_quant_bits != 4 && weight_quant_bits != 8)
+    {
+        NCNN_LOGE("unsupported weight_quant_bits %d", weight_quant_bits);
+        return -1;
+    }
+
+    if (weight_quant_bits && (weight_quant_group_size <= 0 || (weight_quant_bits == 4 && weight_quant_group_size % 2 != 0)))
+    {
+        NCNN_LOGE("weight_quant_group_size %d must be positive and even for int4", weight_quant_group_size);
+        return -1;
+    }
+
+    if (weight_quant_bits && int8_scale_term)
+    {
+        NCNN_LOGE("weight_quant_bits and int8_scale_term can not be used together");
+        return -1;
+    }
 
     if (int8_scale_term)
     {
@@ -58,6 +80,35 @@ int InnerProduct::load_model(const ModelBin& mb)
     }
 #endif // NCNN_INT8
 
+    if (weight_quant_bits)
+    {
+        const int num_input = weight_data_size / num_output;
+        const int num_group = weight_quant_num_group(num_input, weight_quant_group_size);
+
+        if (weight_data.elemsize == (size_t)1u)
+        {
+            // packed group quantized data, the group scales follow the bias
+            if ((size_t)weight_data.w != weight_quant_data_size(weight_data_size, weight_quant_bits))
+            {
+                NCNN_LOGE("weight_data size %d mismatch weight_quant_bits %d", weight_data.w, weight_quant_bits);
+                return -1;
+            }
+
+            weight_data_quant_scales = mb.load(num_group * num_output, 1);
+            if (weight_data_quant_scales.empty())
+                return -100;
+        }
+        else
+        {
+            // runtime quantize the fp32 weight data
+            Mat weight_data_quant;
+            if (weight_quant_pack(weight_data, weight_data_quant, weight_data_quant_scales, num_input, weight_quant_group_size, weight_quant_bits) != 0)
+                return -100;
+
+            weight_data = weight_data_quant;
+        }
+    }
+
 #if NCNN_INT8
     // runtime quantize the weight data
     if (weight_data.elemsize == (size_t)4u && int8_scale_term)
@@ -84,7 +135,7 @@ int InnerProduct::load_model(const ModelBin& mb)
 int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
 #if NCNN_INT8
-    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
+    if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u && !weight_quant_bits)
     {
         return forward_int8(bottom_blob, top_blob, opt);
     }
@@ -92,6 +143,14 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
     const int num_input = weight_data_size / num_output;
 
+    Mat weight_data_fp32 = weight_data;
+    if (weight_quant_bits)
+    {
+        // the reference decodes the packed weights on every forward
+        if (weight_quant_unpack(weight_data, weight_data_quant_scales, weight_data_fp32, weight_data_size, num_input, weight_quant_group_size, weight_quant_bits, opt.workspace_allocator) != 0)
+            return -100;
+    }
+
     int w = bottom_blob.w;
     int h = bottom_blob.h;
     int channels = bottom_blob.c;
@@ -113,7 +172,7 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
 
             for (int p = 0; p < num_output; p++)
             {
-                const float* kptr = (const float*)weight_data + w * p;
+                const float* kptr = (const float*)weight_data_fp32 + w * p;
 
                 float sum = 0.f;
 
@@ -148,7 +207,7 @@ int InnerProduct::forward(const Mat& bottom_blob, Mat& top_blob, const Option& o
         // channels
         for (int q = 0; q < channels; q++)
         {
-            const float* w = (const float*)weight_data + size * channels * p + size * q;
+            const float* w = (const float*)weight_data_fp32 + size * channels * p + size * q;
             const float* m = bottom_blob.channel(q);
 
             for (int i = 0; i < size; i++)
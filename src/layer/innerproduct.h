@@ -37,10 +37,17 @@ public:
     int activation_type;
     Mat activation_params;
 
+    // weight-only quantization, 0=none 4=int4 8=int8
+    int weight_quant_bits;
+    int weight_quant_group_size;
+
     // model
     Mat weight_data;
     Mat bias_data;
 
+    // num_output x ceil(num_input / weight_quant_group_size)
+    Mat weight_data_quant_scales;
+
 #if NCNN_INT8
     Mat weight_data_int8_scales;
     Mat bottom_blob_int8_scales;
@@ -12,6 +12,8 @@
 
 #include "mips_activation.h"
 
+#include "weight_quant.h"
+
 namespace ncnn {
 
 InnerProduct_mips::InnerProduct_mips()
@@ -25,6 +27,18 @@ InnerProduct_mips::InnerProduct_mips()
 
 int InnerProduct_mips::create_pipeline(const Option& opt)
 {
+    if (weight_quant_bits)
+    {
+        // no weight-only quantized kernel here, decode the weights once and run the fp32 path
+        Mat weight_data_fp32;
+        if (weight_quant_unpack(weight_data, weight_data_quant_scales, weight_data_fp32, weight_data_size, weight_data_size / num_output, weight_quant_group_size, weight_quant_bits) != 0)
+            return -100;
+
+        weight_data = weight_data_fp32;
+        weight_data_quant_scales.release();
+        weight_quant_bits = 0;
+    }
+
     {
         flatten = ncnn::create_layer_cpu(ncnn::LayerType::Flatten);
 
@@ -10,7 +10,7 @@ Noop::Noop()
 {
     support_inplace = true;
     support_packing = true;
-    support_fp16_storage = cpu_support_arm_asimdhp() || cpu_support_riscv_zvfh();
+    support_fp16_storage = cpu_support_arm_asimdhp() || cpu_support_riscv_zvfh() || cpu_support_x86_f16c();
     support_bf16_storage = true;
 }
 
@@ -9,6 +9,8 @@
 
 #include "riscv_usability.h"
 
+#include "weight_quant.h"
+
 #include "cpu.h"
 
 namespace ncnn {
@@ -1874,6 +1876,18 @@ int Gemm_riscv::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt
 
 int Gemm_riscv::create_pipeline(const Option& opt)
 {
+    if (weight_quant_bits)
+    {
+        // no weight-only quantized kernel here, decode the weights once and run the fp32 path
+        Mat B_data_fp32;
+        if (weight_quant_unpack(B_data, B_data_quant_scales, B_data_fp32, constantK * constantN, constantK, weight_quant_group_size, weight_quant_bits) != 0)
+            return -100;
+
+        B_data = B_data_fp32.reshape(constantK, constantN);
+        B_data_quant_scales.release();
+        weight_quant_bits = 0;
+    }
+
 #if NCNN_INT8
     if (int8_scale_term)
     {
@@ -6,6 +6,7 @@
 #include <float.h>
 
 #include "cpu.h"
+#include "kvcache.h"
 
 namespace ncnn {
 
@@ -46,7 +47,18 @@ int SDPA::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_bl
     const int cur_seqlen = cur_key.h;
     const int num_group = cur_key.c;
     const int out_embed_dim = cur_value.w;
-    const int past_seqlen = kv_cache ? past_key.h : 0;
+
+    // append to the history in place, past_key and past_value are ignored
+    Mat cached_key;
+    Mat cached_value;
+    if (kv_cache && opt.kv_cache)
+    {
+        int ret = opt.kv_cache->append(this, cur_key, cur_value, cached_key, cached_value);
+        if (ret != 0)
+            return ret;
+    }
+
+    const int past_seqlen = !cached_key.empty() ? cached_key.h - cur_seqlen : kv_cache ? past_key.h : 0;
     const int dst_seqlen = past_seqlen + cur_seqlen;
 
     // assert cur_key.w == embed_dim
@@ -67,7 +79,11 @@ int SDPA::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_bl
         return -100;
 
     Mat key = cur_key;
-    if (past_seqlen > 0)
+    if (!cached_key.empty())
+    {
+        key = cached_key;
+    }
+    else if (past_seqlen > 0)
     {
         key.create(embed_dim, dst_seqlen, num_group, 4u, opt.blob_allocator);
         if (key.empty())
@@ -87,7 +103,11 @@ int SDPA::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_bl
     }
 
     Mat value = cur_value;
-    if (past_seqlen > 0)
+    if (!cached_value.empty())
+    {
+        value = cached_value;
+    }
+    else if (past_seqlen > 0)
     {
         value.create(out_embed_dim, dst_seqlen, num_group, 4u, opt.blob_allocator);
         if (value.empty())
@@ -287,7 +307,18 @@ int SDPA::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& t
     const int cur_seqlen = cur_key.h;
     const int num_group = cur_key.c;
     const int out_embed_dim = cur_value.w;
-    const int past_seqlen = kv_cache ? past_key.h : 0;
+
+    // append to the history in place, past_key and past_value are ignored
+    Mat cached_key;
+    Mat cached_value;
+    if (kv_cache && opt.kv_cache)
+    {
+        int ret = opt.kv_cache->append(this, cur_key, cur_value, cached_key, cached_value);
+        if (ret != 0)
+            return ret;
+    }
+
+    const int past_seqlen = !cached_key.empty() ? cached_key.h - cur_seqlen : kv_cache ? past_key.h : 0;
     const int dst_seqlen = past_seqlen + cur_seqlen;
 
     // assert cur_key.w == embed_dim
@@ -328,7 +359,11 @@ int SDPA::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& t
         return -100;
 
     Mat key = cur_key;
-    if (past_seqlen > 0)
+    if (!cached_key.empty())
+    {
+        key = cached_key;
+    }
+    else if (past_seqlen > 0)
     {
         key.create(embed_dim, dst_seqlen, num_group, 4u, opt.blob_allocator);
         if (key.empty())
@@ -348,7 +383,11 @@ int SDPA::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& t
     }
 
     Mat value = cur_value;
-    if (past_seqlen > 0)
+    if (!cached_value.empty())
+    {
+        value = cached_value;
+    }
+    else if (past_seqlen > 0)
     {
         value.create(out_embed_dim, dst_seqlen, num_group, 4u, opt.blob_allocator);
         if (value.empty())
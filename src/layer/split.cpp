@@ -11,7 +11,7 @@ Split::Split()
     one_blob_only = false;
     support_inplace = false;
     support_packing = true;
-    support_fp16_storage = cpu_support_arm_asimdhp() || cpu_support_riscv_zvfh();
+    support_fp16_storage = cpu_support_arm_asimdhp() || cpu_support_riscv_zvfh() || cpu_support_x86_f16c();
     support_bf16_storage = true;
 }
 
@@ -5,6 +5,8 @@
 
 #include "layer_shader_type.h"
 
+#include "weight_quant.h"
+
 namespace ncnn {
 
 Gemm_vulkan::Gemm_vulkan()
@@ -43,6 +45,18 @@ int Gemm_vulkan::load_param(const ParamDict& pd)
 
 int Gemm_vulkan::create_pipeline(const Option& opt)
 {
+    if (weight_quant_bits)
+    {
+        // no weight-only quantized kernel here, decode the weights once and run the fp32 path
+        Mat B_data_fp32;
+        if (weight_quant_unpack(B_data, B_data_quant_scales, B_data_fp32, constantK * constantN, constantK, weight_quant_group_size, weight_quant_bits) != 0)
+            return -100;
+
+        B_data = B_data_fp32.reshape(constantK, constantN);
+        B_data_quant_scales.release();
+        weight_quant_bits = 0;
+    }
+
     // const Mat& shape = top_shapes.empty() ? Mat() : top_shapes[0];
 
     // int elempack = 1;
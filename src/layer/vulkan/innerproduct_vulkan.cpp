@@ -6,6 +6,8 @@
 #include "layer_shader_type.h"
 #include "layer_type.h"
 
+#include "weight_quant.h"
+
 namespace ncnn {
 
 InnerProduct_vulkan::InnerProduct_vulkan()
@@ -25,6 +27,18 @@ InnerProduct_vulkan::InnerProduct_vulkan()
 
 int InnerProduct_vulkan::create_pipeline(const Option& _opt)
 {
+    if (weight_quant_bits)
+    {
+        // no weight-only quantized kernel here, decode the weights once and run the fp32 path
+        Mat weight_data_fp32;
+        if (weight_quant_unpack(weight_data, weight_data_quant_scales, weight_data_fp32, weight_data_size, weight_data_size / num_output, weight_quant_group_size, weight_quant_bits) != 0)
+            return -100;
+
+        weight_data = weight_data_fp32;
+        weight_data_quant_scales.release();
+        weight_quant_bits = 0;
+    }
+
     Option opt = _opt;
     const Mat& shape = bottom_shapes.empty() ? Mat() : bottom_shapes[0];
     const Mat& out_shape = top_shapes.empty() ? Mat() : top_shapes[0];
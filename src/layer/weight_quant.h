@@ -0,0 +1,121 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef WEIGHT_QUANT_H
+#define WEIGHT_QUANT_H
+
+#include "mat.h"
+
+#include <math.h>
+#include <string.h>
+
+// weight-only quantization, activations stay fp32
+// each row of row_size weights is split into groups of group_size along the row,
+// every group is quantized symmetrically to int4 or int8 with its own fp32 scale
+// layers keep the packed values and the scales as loaded, backends without a quantized kernel decode them once
+
+static inline int weight_quant_num_group(int row_size, int group_size)
+{
+    return (row_size + group_size - 1) / group_size;
+}
+
+// quantize one group to [-qmax, qmax] and return its scale
+static inline float weight_quant_group(const float* ptr, int size, int bits, signed char* qptr)
+{
+    const int qmax = (1 << (bits - 1)) - 1;
+
+    float absmax = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        absmax = std::max(absmax, (float)fabs(ptr[i]));
+    }
+
+    const float scale = absmax == 0.f ? 1.f : absmax / qmax;
+
+    for (int i = 0; i < size; i++)
+    {
+        int v = (int)round(ptr[i] / scale);
+        qptr[i] = (signed char)std::min(std::max(v, -qmax), qmax);
+    }
+
+    return scale;
+}
+
+// bytes of size packed values, int4 values are packed two per byte low nibble first
+static inline size_t weight_quant_data_size(size_t size, int bits)
+{
+    return bits == 8 ? size : (size + 1) / 2;
+}
+
+// the value i of the packed data
+static inline int weight_quant_value(const signed char* qdata, size_t i, int bits)
+{
+    if (bits == 8)
+        return qdata[i];
+
+    const int v = i % 2 == 0 ? qdata[i / 2] & 15 : (qdata[i / 2] >> 4) & 15;
+    return (v ^ 8) - 8;
+}
+
+// quantize fp32 weights of row_size columns into packed data and rows x num_group scales
+static inline int weight_quant_pack(const ncnn::Mat& weight, ncnn::Mat& qdata, ncnn::Mat& scales, int row_size, int group_size, int bits)
+{
+    const int size = (int)weight.total();
+    const int rows = size / row_size;
+    const int num_group = weight_quant_num_group(row_size, group_size);
+
+    qdata.create((int)weight_quant_data_size(size, bits), (size_t)1u);
+    scales.create(rows * num_group);
+    if (qdata.empty() || scales.empty())
+        return -100;
+
+    std::vector<signed char> q(row_size);
+
+    unsigned char* qptr = qdata;
+    memset(qptr, 0, qdata.w);
+
+    for (int i = 0; i < rows; i++)
+    {
+        const float* ptr = (const float*)weight + (size_t)i * row_size;
+
+        for (int g = 0; g < num_group; g++)
+        {
+            const int k0 = g * group_size;
+            scales[i * num_group + g] = weight_quant_group(ptr + k0, std::min(group_size, row_size - k0), bits, &q[k0]);
+        }
+
+        for (int j = 0; j < row_size; j++)
+        {
+            const size_t k = (size_t)i * row_size + j;
+            if (bits == 8)
+                qptr[k] = (unsigned char)q[j];
+            else
+                qptr[k / 2] |= (unsigned char)((q[j] & 15) << (k % 2 * 4));
+        }
+    }
+
+    return 0;
+}
+
+// decode the packed data back to fp32
+static inline int weight_quant_unpack(const ncnn::Mat& qdata, const ncnn::Mat& scales, ncnn::Mat& weight, int size, int row_size, int group_size, int bits, ncnn::Allocator* allocator = 0)
+{
+    const int num_group = weight_quant_num_group(row_size, group_size);
+
+    weight.create(size, (size_t)4u, allocator);
+    if (weight.empty())
+        return -100;
+
+    const signed char* qptr = qdata;
+    const float* sptr = scales;
+    float* ptr = weight;
+
+    for (int i = 0; i < size; i++)
+    {
+        ptr[i] = weight_quant_value(qptr, i, bits) * sptr[i / row_size * num_group + i % row_size / group_size];
+    }
+
+    return 0;
+}
+
+#endif // WEIGHT_QUANT_H
@@ -0,0 +1,154 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512FP16 && __AVX512F__ && !__AVX512FP16__
+int binary_op_vector_fp16sa_avx512fp16(const unsigned short* ptr, const unsigned short* ptr1, unsigned short* outptr, int aw, int bw, int ap, int bp, int op_type);
+#endif
+
+#if __AVX512FP16__
+namespace BinaryOp_x86_fp16sa_functor {
+
+struct binary_op_add
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_add_ph(x, y);
+    }
+};
+
+struct binary_op_sub
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_sub_ph(x, y);
+    }
+};
+
+struct binary_op_mul
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_mul_ph(x, y);
+    }
+};
+
+struct binary_op_div
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_div_ph(x, y);
+    }
+};
+
+struct binary_op_max
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_max_ph(x, y);
+    }
+};
+
+struct binary_op_min
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_min_ph(x, y);
+    }
+};
+
+struct binary_op_rsub
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_sub_ph(y, x);
+    }
+};
+
+struct binary_op_rdiv
+{
+    NCNN_FORCEINLINE __m512h func_pack32(const __m512h& x, const __m512h& y) const
+    {
+        return _mm512_div_ph(y, x);
+    }
+};
+
+} // namespace BinaryOp_x86_fp16sa_functor
+
+// a single pixel of elempack lanes repeated over 32 lanes
+static NCNN_FORCEINLINE __m512h binary_op_broadcast_pack32_fp16sa(const unsigned short* ptr, int elempack)
+{
+    unsigned short tmp[32];
+    for (int i = 0; i < 32; i++)
+    {
+        tmp[i] = ptr[i % elempack];
+    }
+    return _mm512_castsi512_ph(_mm512_loadu_si512((const __m512i*)tmp));
+}
+
+template<typename Op>
+static void binary_op_vector_fp16sa(const unsigned short* ptr, const unsigned short* ptr1, unsigned short* outptr, int aw, int bw, int elempack)
+{
+    const Op op;
+
+    const int size = std::max(aw, bw) * elempack;
+
+    const __m512h _a_bcast = aw == 1 ? binary_op_broadcast_pack32_fp16sa(ptr, elempack) : _mm512_setzero_ph();
+    const __m512h _b_bcast = bw == 1 ? binary_op_broadcast_pack32_fp16sa(ptr1, elempack) : _mm512_setzero_ph();
+
+    int i = 0;
+    for (; i + 31 < size; i += 32)
+    {
+        __m512h _p = aw == 1 ? _a_bcast : _mm512_castsi512_ph(_mm512_loadu_si512((const __m512i*)(ptr + i)));
+        __m512h _b = bw == 1 ? _b_bcast : _mm512_castsi512_ph(_mm512_loadu_si512((const __m512i*)(ptr1 + i)));
+        __m512h _outp = op.func_pack32(_p, _b);
+        _mm512_storeu_si512((__m512i*)(outptr + i), _mm512_castph_si512(_outp));
+    }
+    if (i < size)
+    {
+        const __mmask32 _mask = (__mmask32)((1u << (size - i)) - 1);
+        __m512h _p = aw == 1 ? _a_bcast : _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(_mask, ptr + i));
+        __m512h _b = bw == 1 ? _b_bcast : _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(_mask, ptr1 + i));
+        __m512h _outp = op.func_pack32(_p, _b);
+        _mm512_mask_storeu_epi16(outptr + i, _mask, _mm512_castph_si512(_outp));
+    }
+}
+#endif // __AVX512FP16__
+
+// fp16 arithmetic on fp16 storage for the plain elementwise operations
+// returns -1 for the cases left to the fp32 kernels
+static int binary_op_vector_fp16sa(const unsigned short* ptr, const unsigned short* ptr1, unsigned short* outptr, int aw, int bw, int ap, int bp, int op_type)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512FP16 && __AVX512F__ && !__AVX512FP16__
+    if (ncnn::cpu_support_x86_avx512_fp16())
+    {
+        return binary_op_vector_fp16sa_avx512fp16(ptr, ptr1, outptr, aw, bw, ap, bp, op_type);
+    }
+#endif
+
+#if __AVX512FP16__
+    if (ap != bp || (aw != bw && aw != 1 && bw != 1))
+        return -1;
+
+    using namespace BinaryOp_x86_fp16sa_functor;
+
+    if (op_type == BinaryOp::Operation_ADD) return binary_op_vector_fp16sa<binary_op_add>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_SUB) return binary_op_vector_fp16sa<binary_op_sub>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_MUL) return binary_op_vector_fp16sa<binary_op_mul>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_DIV) return binary_op_vector_fp16sa<binary_op_div>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_MAX) return binary_op_vector_fp16sa<binary_op_max>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_MIN) return binary_op_vector_fp16sa<binary_op_min>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_RSUB) return binary_op_vector_fp16sa<binary_op_rsub>(ptr, ptr1, outptr, aw, bw, ap), 0;
+    if (op_type == BinaryOp::Operation_RDIV) return binary_op_vector_fp16sa<binary_op_rdiv>(ptr, ptr1, outptr, aw, bw, ap), 0;
+#else
+    (void)ptr;
+    (void)ptr1;
+    (void)outptr;
+    (void)aw;
+    (void)bw;
+    (void)ap;
+    (void)bp;
+    (void)op_type;
+#endif // __AVX512FP16__
+
+    return -1;
+}
@@ -15,13 +15,20 @@
 #endif // __AVX__
 #endif // __SSE2__
 
+#include "cpu.h"
+
 namespace ncnn {
 
+#include "binaryop_fp16sa.h"
+
 BinaryOp_x86::BinaryOp_x86()
 {
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_F16C && __F16C__
+    support_fp16_storage = true;
+#endif
 }
 
 template<typename Op>
@@ -796,6 +803,103 @@ static void binary_op_vector(const float* ptr, const float* ptr1, float* outptr,
     // should never reach here
 }
 
+static void binary_op_vector(const float* ptr, const float* ptr1, float* outptr, int aw, int bw, int ap, int bp, int op_type, const Option& /*opt*/)
+{
+    binary_op_vector(ptr, ptr1, outptr, aw, bw, ap, bp, op_type);
+}
+
+static void binary_op_vector_scalar(const float* ptr, float b, float* outptr, int size, int op_type, const Option& /*opt*/)
+{
+    binary_op_vector(ptr, &b, outptr, size, 1, 1, 1, op_type);
+}
+
+static void binary_op_cast_fp16_to_fp32(const unsigned short* ptr, float* outptr, int size)
+{
+    int i = 0;
+#if __F16C__
+    for (; i + 7 < size; i += 8)
+    {
+        _mm256_storeu_ps(outptr + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(ptr + i))));
+    }
+#endif // __F16C__
+    for (; i < size; i++)
+    {
+        outptr[i] = float16_to_float32(ptr[i]);
+    }
+}
+
+static void binary_op_cast_fp32_to_fp16(const float* ptr, unsigned short* outptr, int size)
+{
+    int i = 0;
+#if __F16C__
+    for (; i + 7 < size; i += 8)
+    {
+        _mm_storeu_si128((__m128i*)(outptr + i), _mm256_cvtps_ph(_mm256_loadu_ps(ptr + i), _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC));
+    }
+#endif // __F16C__
+    for (; i < size; i++)
+    {
+        outptr[i] = float32_to_float16(ptr[i]);
+    }
+}
+
+// fp16 storage, stage a few pixels at a time through fp32 and reuse the fp32 kernels
+static void binary_op_vector(const unsigned short* ptr, const unsigned short* ptr1, unsigned short* outptr, int aw, int bw, int ap, int bp, int op_type, const Option& opt)
+{
+    if (opt.use_fp16_arithmetic)
+    {
+        if (binary_op_vector_fp16sa(ptr, ptr1, outptr, aw, bw, ap, bp, op_type) == 0)
+            return;
+    }
+
+    const int w = std::max(aw, bw);
+    const int elempack = std::max(ap, bp);
+
+    const int TILE_W = 64;
+
+    float tmpa[TILE_W * 16];
+    float tmpb[TILE_W * 16];
+    float tmpout[TILE_W * 16];
+
+    if (aw == 1)
+        binary_op_cast_fp16_to_fp32(ptr, tmpa, ap);
+    if (bw == 1)
+        binary_op_cast_fp16_to_fp32(ptr1, tmpb, bp);
+
+    for (int x = 0; x < w; x += TILE_W)
+    {
+        const int n = std::min(w - x, TILE_W);
+
+        if (aw != 1)
+            binary_op_cast_fp16_to_fp32(ptr + x * ap, tmpa, n * ap);
+        if (bw != 1)
+            binary_op_cast_fp16_to_fp32(ptr1 + x * bp, tmpb, n * bp);
+
+        binary_op_vector(tmpa, tmpb, tmpout, aw == 1 ? 1 : n, bw == 1 ? 1 : n, ap, bp, op_type);
+
+        binary_op_cast_fp32_to_fp16(tmpout, outptr + x * elempack, n * elempack);
+    }
+}
+
+static void binary_op_vector_scalar(const unsigned short* ptr, float b, unsigned short* outptr, int size, int op_type, const Option& /*opt*/)
+{
+    const int TILE_SIZE = 1024;
+
+    float tmp[TILE_SIZE];
+
+    for (int i = 0; i < size; i += TILE_SIZE)
+    {
+        const int n = std::min(size - i, TILE_SIZE);
+
+        binary_op_cast_fp16_to_fp32(ptr + i, tmp, n);
+
+        binary_op_vector(tmp, &b, tmp, n, 1, 1, 1, op_type);
+
+        binary_op_cast_fp32_to_fp16(tmp, outptr + i, n);
+    }
+}
+
+template<typename T>
 static void binary_op_scalar(const Mat& a, float b, Mat& c, int op_type, const Option& opt)
 {
     const int channels = a.c;
@@ -804,13 +908,14 @@ static void binary_op_scalar(const Mat& a, float b, Mat& c, int op_type, const O
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int q = 0; q < channels; q++)
     {
-        const float* ptr = a.channel(q);
-        float* outptr = c.channel(q);
+        const T* ptr = a.channel(q);
+        T* outptr = c.channel(q);
 
-        binary_op_vector(ptr, &b, outptr, size, 1, 1, 1, op_type);
+        binary_op_vector_scalar(ptr, b, outptr, size, op_type, opt);
     }
 }
 
+template<typename T>
 static void binary_op_no_broadcast(const Mat& a, const Mat& b, Mat& c, int op_type, const Option& opt)
 {
     const int channels = a.c;
@@ -819,24 +924,26 @@ static void binary_op_no_broadcast(const Mat& a, const Mat& b, Mat& c, int op_ty
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int q = 0; q < channels; q++)
     {
-        const float* ptr = a.channel(q);
-        const float* ptr1 = b.channel(q);
-        float* outptr = c.channel(q);
+        const T* ptr = a.channel(q);
+        const T* ptr1 = b.channel(q);
+        T* outptr = c.channel(q);
 
-        binary_op_vector(ptr, ptr1, outptr, size, size, 1, 1, op_type);
+        binary_op_vector(ptr, ptr1, outptr, size, size, 1, 1, op_type, opt);
     }
 }
 
+template<typename T>
 static void binary_op_broadcast(const Mat& a, const Mat& b, Mat& c, int op_type, const Option& opt)
 {
     if (b.w * b.h * b.d * b.c * b.elempack == 1)
     {
-        return binary_op_scalar(a, b[0], c, op_type, opt);
+        const float b0 = b.elembits() == 16 ? float16_to_float32(((const unsigned short*)b.data)[0]) : b[0];
+        return binary_op_scalar<T>(a, b0, c, op_type, opt);
     }
 
     if (a.dims == b.dims && a.w == b.w && a.h == b.h && a.d == b.d && a.c == b.c && a.elempack == b.elempack)
     {
-        return binary_op_no_broadcast(a, b, c, op_type, opt);
+        return binary_op_no_broadcast<T>(a, b, c, op_type, opt);
     }
 
     const int dims = c.dims;
@@ -851,11 +958,11 @@ static void binary_op_broadcast(const Mat& a, const Mat& b, Mat& c, int op_type,
             const int y0 = std::min(y, a.h - 1);
             const int y1 = std::min(y, b.h - 1);
 
-            const float* ptr = a.row(y0);
-            const float* ptr1 = b.row(y1);
-            float* outptr = c.row(y);
+            const T* ptr = a.row<const T>(y0);
+            const T* ptr1 = b.row<const T>(y1);
+            T* outptr = c.row<T>(y);
 
-            binary_op_vector(ptr, ptr1, outptr, a.w, b.w, a.elempack, b.elempack, op_type);
+            binary_op_vector(ptr, ptr1, outptr, a.w, b.w, a.elempack, b.elempack, op_type, opt);
         }
     }
 
@@ -871,11 +978,11 @@ static void binary_op_broadcast(const Mat& a, const Mat& b, Mat& c, int op_type,
 
             if (b.d * b.h * b.w == 1)
             {
-                const float* ptr = a.channel(q0);
-                const float* ptr1 = b.channel(q1);
-                float* outptr = c.channel(q);
+                const T* ptr = a.channel(q0);
+                const T* ptr1 = b.channel(q1);
+                T* outptr = c.channel(q);
 
-                binary_op_vector(ptr, ptr1, outptr, a.w * a.h * a.d, 1, a.elempack, b.elempack, op_type);
+                binary_op_vector(ptr, ptr1, outptr, a.w * a.h * a.d, 1, a.elempack, b.elempack, op_type, opt);
                 continue;
             }
 
@@ -886,11 +993,11 @@ static void binary_op_broadcast(const Mat& a, const Mat& b, Mat& c, int op_type,
                     const int z0 = std::min(z, a.d - 1);
                     const int z1 = std::min(z, b.d - 1);
 
-                    const float* ptr = a.channel(q0).depth(z0);
-                    const float* ptr1 = b.channel(q1).depth(z1);
-                    float* outptr = c.channel(q).depth(z);
+                    const T* ptr = a.channel(q0).depth(z0);
+                    const T* ptr1 = b.channel(q1).depth(z1);
+                    T* outptr = c.channel(q).depth(z);
 
-                    binary_op_vector(ptr, ptr1, outptr, a.w * a.h, 1, a.elempack, b.elempack, op_type);
+                    binary_op_vector(ptr, ptr1, outptr, a.w * a.h, 1, a.elempack, b.elempack, op_type, opt);
                 }
                 continue;
             }
@@ -905,17 +1012,18 @@ static void binary_op_broadcast(const Mat& a, const Mat& b, Mat& c, int op_type,
                     const int y0 = std::min(y, a.h - 1);
                     const int y1 = std::min(y, b.h - 1);
 
-                    const float* ptr = a.channel(q0).depth(z0).row(y0);
-                    const float* ptr1 = b.channel(q1).depth(z1).row(y1);
-                    float* outptr = c.channel(q).depth(z).row(y);
+                    const T* ptr = a.channel(q0).depth(z0).row<const T>(y0);
+                    const T* ptr1 = b.channel(q1).depth(z1).row<const T>(y1);
+                    T* outptr = c.channel(q).depth(z).row<T>(y);
 
-                    binary_op_vector(ptr, ptr1, outptr, a.w, b.w, a.elempack, b.elempack, op_type);
+                    binary_op_vector(ptr, ptr1, outptr, a.w, b.w, a.elempack, b.elempack, op_type, opt);
                 }
             }
         }
     }
 }
 
+template<typename T>
 static void binary_op_scalar_inplace(Mat& a, float b, int op_type, const Option& opt)
 {
     const int channels = a.c;
@@ -924,9 +1032,9 @@ static void binary_op_scalar_inplace(Mat& a, float b, int op_type, const Option&
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int q = 0; q < channels; q++)
     {
-        float* ptr = a.channel(q);
+        T* ptr = a.channel(q);
 
-        binary_op_vector(ptr, &b, ptr, size, 1, 1, 1, op_type);
+        binary_op_vector_scalar(ptr, b, ptr, size, op_type, opt);
     }
 }
 
@@ -945,8 +1053,30 @@ static int get_reverse_op_type(int op_type)
 
 int BinaryOp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
-    const Mat& A = bottom_blobs[0];
-    const Mat& B = bottom_blobs[1];
+    Mat A = bottom_blobs[0];
+    Mat B = bottom_blobs[1];
+
+    // mixed fp16 and fp32 inputs run in fp32
+    if (A.elembits() != B.elembits())
+    {
+        if (A.elembits() == 16)
+        {
+            Mat A_fp32;
+            cast_float16_to_float32(A, A_fp32, opt);
+            if (A_fp32.empty())
+                return -100;
+            A = A_fp32;
+        }
+        if (B.elembits() == 16)
+        {
+            Mat B_fp32;
+            cast_float16_to_float32(B, B_fp32, opt);
+            if (B_fp32.empty())
+                return -100;
+            B = B_fp32;
+        }
+    }
+
     const int outdims = std::max(A.dims, B.dims);
 
     Mat A2 = A;
@@ -1080,13 +1210,20 @@ int BinaryOp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>
     const bool a_pack_is_lower = A2.elempack < B2.elempack;
     const bool a_pack_is_equal = A2.elempack == B2.elempack;
     const bool a_size_is_lower = A2.w * A2.h * A2.d * A2.c * A2.elempack < B2.w * B2.h * B2.d * B2.c * B2.elempack;
+    const bool use_fp16 = top_blob.elembits() == 16;
     if (a_pack_is_lower || (a_pack_is_equal && a_size_is_lower))
     {
-        binary_op_broadcast(B2, A2, top_blob, get_reverse_op_type(op_type), opt);
+        if (use_fp16)
+            binary_op_broadcast<unsigned short>(B2, A2, top_blob, get_reverse_op_type(op_type), opt);
+        else
+            binary_op_broadcast<float>(B2, A2, top_blob, get_reverse_op_type(op_type), opt);
     }
     else
     {
-        binary_op_broadcast(A2, B2, top_blob, op_type, opt);
+        if (use_fp16)
+            binary_op_broadcast<unsigned short>(A2, B2, top_blob, op_type, opt);
+        else
+            binary_op_broadcast<float>(A2, B2, top_blob, op_type, opt);
     }
 
     return 0;
@@ -1094,7 +1231,10 @@ int BinaryOp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>
 
 int BinaryOp_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
 {
-    binary_op_scalar_inplace(bottom_top_blob, b, op_type, opt);
+    if (bottom_top_blob.elembits() == 16)
+        binary_op_scalar_inplace<unsigned short>(bottom_top_blob, b, op_type, opt);
+    else
+        binary_op_scalar_inplace<float>(bottom_top_blob, b, op_type, opt);
 
     return 0;
 }
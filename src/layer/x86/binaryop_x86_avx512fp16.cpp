@@ -0,0 +1,21 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "binaryop_x86.h"
+
+#include <immintrin.h>
+
+#include "cpu.h"
+#include "mat.h"
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "binaryop_fp16sa.h"
+
+int binary_op_vector_fp16sa_avx512fp16(const unsigned short* ptr, const unsigned short* ptr1, unsigned short* outptr, int aw, int bw, int ap, int bp, int op_type)
+{
+    return binary_op_vector_fp16sa(ptr, ptr1, outptr, aw, bw, ap, bp, op_type);
+}
+
+} // namespace ncnn
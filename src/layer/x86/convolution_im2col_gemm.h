@@ -4595,7 +4595,7 @@ static void convolution_im2col_gemm_transform_kernel(const Mat& kernel, Mat& AT,
     }
 }
 
-static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const Mat& AT, const Mat& bias, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int nT, const Option& opt)
+static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const Mat& AT, const Mat& bias, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int TILE_M, int TILE_N, int TILE_K, int nT, const Option& opt)
 {
     const int maxk = kernel_w * kernel_h;
 
@@ -4603,9 +4603,6 @@ static int convolution_im2col_gemm(const Mat& bottom_blob, Mat& top_blob, const
     const int N = top_blob.w * top_blob.h;
     const int K = bottom_blob.c * bottom_blob.elempack * maxk;
 
-    int TILE_M, TILE_N, TILE_K;
-    convolution_im2col_gemm_get_optimal_tile_mnk(M, N, K, TILE_M, TILE_N, TILE_K, nT);
-
     const int nn_M = (M + TILE_M - 1) / TILE_M;
     const int nn_N = (N + TILE_N - 1) / TILE_N;
     const int nn_K = (K + TILE_K - 1) / TILE_K;
@@ -0,0 +1,299 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__ && !__AMX_BF16__
+int convolution_im2col_gemm_bf16s_amxbf16(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, int nT, const Option& opt);
+#endif
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+int convolution_im2col_gemm_bf16s_avx512bf16(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, int nT, const Option& opt);
+#endif
+
+// weight_data_tm holds num_output rows of num_input * maxk bf16 weights, the natural weight order
+// the tile kernel wants whole blocks of 16 rows and 32 k, the rows and the row length are zero padded then
+static void convolution_im2col_gemm_transform_kernel_bf16s(const Mat& weight_data, Mat& weight_data_tm, int num_input, int num_output, int kernel_w, int kernel_h, const Option& opt)
+{
+    const int K = num_input * kernel_w * kernel_h;
+
+    const int use_amx = gemm_dot_bf16s_amx_supported();
+    const int Kp = use_amx ? (K + 31) / 32 * 32 : K;
+    const int num_output_p = use_amx ? (num_output + 15) / 16 * 16 : num_output;
+
+    weight_data_tm.create(Kp, num_output_p, (size_t)2u);
+    if (weight_data_tm.empty())
+        return;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output_p; p++)
+    {
+        unsigned short* outptr = weight_data_tm.row<unsigned short>(p);
+
+        int k = 0;
+        if (p < num_output)
+        {
+            const float* kptr = (const float*)weight_data + K * p;
+            for (; k < K; k++)
+            {
+                outptr[k] = float32_to_bfloat16(kptr[k]);
+            }
+        }
+        for (; k < Kp; k++)
+        {
+            outptr[k] = 0;
+        }
+    }
+}
+
+#if __AMX_BF16__
+// every output pixel gathers its K input values straight into the zero padded B panels of the tile kernel
+// the tile state is configured once per thread, the gathered pixels are reused across the output channel tiles
+static int convolution_im2col_gemm_bf16s_amx(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, int nT, const Option& opt)
+{
+    const int w = bottom_blob.w;
+    const int inch = bottom_blob.c;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+    const int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+    const int Kp = weight_data_tm.w;
+    const int N = outw * outh;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    // output pixels per tile, split the output channels in blocks of 16 too when there are fewer tiles than threads
+    const int TILE_N = 64;
+    const int nn_N = (N + TILE_N - 1) / TILE_N;
+
+    int TILE_M = outch;
+    if (nn_N < nT)
+    {
+        const int nn_M_want = (nT + nn_N - 1) / nn_N;
+        TILE_M = (outch + nn_M_want - 1) / nn_M_want;
+        TILE_M = (TILE_M + 15) / 16 * 16;
+    }
+    const int nn_M = (outch + TILE_M - 1) / TILE_M;
+
+    const int nn = nn_N * nn_M;
+    nT = std::min(nT, nn);
+
+    Mat col(Kp * TILE_N, 1, nT, 2u, opt.workspace_allocator);
+    if (col.empty())
+        return -100;
+
+    const float* bias_data_ptr = bias_data.empty() ? 0 : (const float*)bias_data;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
+    {
+        const int start = (int)((long long)nn * t / nT);
+        const int end = (int)((long long)nn * (t + 1) / nT);
+
+        unsigned short* col_tile = col.channel(t);
+
+        float sums[16 * 16];
+
+        amx_tile_config_16x64(3);
+
+        for (int ppij = start; ppij < end; ppij++)
+        {
+            const int j = ppij / nn_M * TILE_N;
+            const int i = ppij % nn_M * TILE_M;
+
+            const int max_jj = std::min(N - j, TILE_N);
+            const int max_ii = std::min(outch - i, TILE_M);
+
+            if (ppij == start || i == 0)
+            {
+                // pixel jj sits in panel jj / 16, k pairs of 16 pixels per 64 bytes
+                for (int jj = 0; jj < (max_jj + 15) / 16 * 16; jj++)
+                {
+                    unsigned short* outptr = col_tile + jj / 16 * 16 * Kp + jj % 16 * 2;
+
+                    int k = 0;
+                    if (jj < max_jj)
+                    {
+                        const int y = (j + jj) / outw;
+                        const int x = (j + jj) % outw;
+
+                        for (int q = 0; q < inch; q++)
+                        {
+                            const unsigned short* sptr = bottom_blob.channel(q).row<const unsigned short>(y * stride_h) + x * stride_w;
+
+                            for (int kk = 0; kk < maxk; kk++)
+                            {
+                                outptr[k / 2 * 32 + k % 2] = sptr[space_ofs[kk]];
+                                k++;
+                            }
+                        }
+                    }
+                    for (; k < Kp; k++)
+                    {
+                        outptr[k / 2 * 32 + k % 2] = 0;
+                    }
+                }
+            }
+
+            for (int ii = 0; ii < max_ii; ii += 16)
+            {
+                const int max_i = std::min(max_ii - ii, 16);
+
+                for (int jj = 0; jj < max_jj; jj += 16)
+                {
+                    const int max_j = std::min(max_jj - jj, 16);
+
+                    gemm_dot_bf16s_block_amx(weight_data_tm.row<const unsigned short>(i + ii), Kp, col_tile + jj * Kp, Kp, sums);
+
+                    for (int r = 0; r < max_i; r++)
+                    {
+                        const int p = i + ii + r;
+                        unsigned short* outptr = (unsigned short*)top_blob.channel(p) + j + jj;
+
+                        for (int c = 0; c < max_j; c++)
+                        {
+                            float v = sums[r * 16 + c];
+                            if (bias_data_ptr)
+                                v += bias_data_ptr[p];
+
+                            outptr[c] = float32_to_bfloat16(activation_ss(v, activation_type, activation_params));
+                        }
+                    }
+                }
+            }
+        }
+
+        _tile_release();
+    }
+
+    return 0;
+}
+#endif // __AMX_BF16__
+
+// bottom_blob is the padded bf16 input with elempack 1, top_blob is bf16 with elempack 1
+// every output pixel gathers its K input values into one contiguous row, then dot products against the weight rows
+static int convolution_im2col_gemm_bf16s(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, int nT, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__ && !__AMX_BF16__
+    if (ncnn::cpu_support_x86_amx_bf16())
+    {
+        return convolution_im2col_gemm_bf16s_amxbf16(bottom_blob, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, nT, opt);
+    }
+#endif
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+    if (ncnn::cpu_support_x86_avx512_bf16())
+    {
+        return convolution_im2col_gemm_bf16s_avx512bf16(bottom_blob, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, nT, opt);
+    }
+#endif
+
+#if __AMX_BF16__
+    if (gemm_dot_bf16s_amx_supported())
+    {
+        return convolution_im2col_gemm_bf16s_amx(bottom_blob, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, nT, opt);
+    }
+#endif // __AMX_BF16__
+
+    const int w = bottom_blob.w;
+    const int inch = bottom_blob.c;
+
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+    const int outch = top_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+    const int K = inch * maxk;
+    const int N = outw * outh;
+
+    // kernel offsets
+    std::vector<int> _space_ofs(maxk);
+    int* space_ofs = &_space_ofs[0];
+    {
+        int p1 = 0;
+        int p2 = 0;
+        int gap = w * dilation_h - kernel_w * dilation_w;
+        for (int i = 0; i < kernel_h; i++)
+        {
+            for (int j = 0; j < kernel_w; j++)
+            {
+                space_ofs[p1] = p2;
+                p1++;
+                p2 += dilation_w;
+            }
+            p2 += gap;
+        }
+    }
+
+    // output pixels per tile, split the output channels too when there are fewer tiles than threads
+    const int TILE_N = 64;
+    const int nn_N = (N + TILE_N - 1) / TILE_N;
+
+    int TILE_M = outch;
+    if (nn_N < nT)
+    {
+        const int nn_M_want = (nT + nn_N - 1) / nn_N;
+        TILE_M = std::max((outch + nn_M_want - 1) / nn_M_want, 4);
+        TILE_M = (TILE_M + 3) / 4 * 4;
+    }
+    const int nn_M = (outch + TILE_M - 1) / TILE_M;
+
+    Mat col(K, TILE_N, nT, 2u, opt.workspace_allocator);
+    if (col.empty())
+        return -100;
+
+    const float* bias_data_ptr = bias_data.empty() ? 0 : (const float*)bias_data;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int ppij = 0; ppij < nn_N * nn_M; ppij++)
+    {
+        const int j = ppij / nn_M * TILE_N;
+        const int i = ppij % nn_M * TILE_M;
+
+        const int max_jj = std::min(N - j, TILE_N);
+        const int max_ii = std::min(outch - i, TILE_M);
+
+        Mat col_tile = col.channel(get_omp_thread_num());
+
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            const int y = (j + jj) / outw;
+            const int x = (j + jj) % outw;
+
+            unsigned short* outptr = col_tile.row<unsigned short>(jj);
+
+            for (int q = 0; q < inch; q++)
+            {
+                const unsigned short* sptr = bottom_blob.channel(q).row<const unsigned short>(y * stride_h) + x * stride_w;
+
+                for (int k = 0; k < maxk; k++)
+                {
+                    outptr[k] = sptr[space_ofs[k]];
+                }
+
+                outptr += maxk;
+            }
+        }
+
+        unsigned short* outptr = (unsigned short*)top_blob.channel(i) + j;
+
+        gemm_dot_bf16s_tile(weight_data_tm.row<const unsigned short>(i), weight_data_tm.w, col_tile, K, outptr, top_blob.cstep, 1, bias_data_ptr ? bias_data_ptr + i : 0, 1, 0, max_ii, max_jj, K, 1.f, activation_type, activation_params);
+    }
+
+    return 0;
+}
@@ -21,6 +21,7 @@
 #include "benchmark.h"
 #include "cpu.h"
 #include "layer_type.h"
+#include "tuningcache.h"
 
 namespace ncnn {
 
@@ -31,6 +32,11 @@ namespace ncnn {
 #include "convolution_packed.h"
 #include "convolution_im2col_gemm.h"
 
+#if NCNN_BF16
+#include "gemm_bf16s.h"
+#include "convolution_im2col_gemm_bf16s.h"
+#endif // NCNN_BF16
+
 #if NCNN_INT8
 #include "convolution_3x3_int8.h"
 
@@ -60,6 +66,9 @@ Convolution_x86::Convolution_x86()
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_BF16
+    support_bf16_storage = true;
+#endif
 
     activation = 0;
     nT = 0;
@@ -102,6 +111,18 @@ static void convolution_transform_kernel_packed_sse(const Mat& weight_data, Mat&
     }
 }
 
+// kernels picked by forward for an input shape
+// the values are stored in tuning files, append only
+enum
+{
+    conv_kernel_packed = 0,
+    conv_kernel_winograd23 = 1,
+    conv_kernel_winograd43 = 2,
+    conv_kernel_winograd63 = 3,
+    conv_kernel_im2col_gemm = 4,
+    conv_kernel_count
+};
+
 static bool test_prefer_winograd63(int num_input, int num_output, int w, int h)
 {
     // winograd selection strategy (profiled on i7-7700 single thread)
@@ -269,7 +290,10 @@ static bool test_prefer_winograd23(int num_input, int num_output, int w, int h)
 int Convolution_x86::create_pipeline(const Option& opt)
 {
     if (dynamic_weight)
+    {
+        support_bf16_storage = false;
         return 0;
+    }
 
     activation = create_activation_layer(activation_type, activation_params, opt);
     nT = opt.num_threads;
@@ -277,10 +301,20 @@ int Convolution_x86::create_pipeline(const Option& opt)
 #if NCNN_INT8
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
+        support_bf16_storage = false;
         return create_pipeline_int8_x86(opt);
     }
 #endif
 
+#if NCNN_BF16
+    if (opt.use_bf16_storage && support_bf16_storage)
+    {
+        return create_pipeline_bf16s(opt);
+    }
+#endif
+
+    shape_cache = new ShapeCache;
+
     int kernel_size = kernel_w * kernel_h;
     int num_input = weight_data_size / kernel_size / num_output;
 
@@ -348,19 +382,25 @@ int Convolution_x86::create_pipeline(const Option& opt)
     }
 #endif // __SSE2__
 
+    // kernels to prepare weights for
+    int kernel_mask = 0;
+
     bool prefer_winograd = (opt.use_winograd23_convolution || opt.use_winograd43_convolution || opt.use_winograd63_convolution) && (num_input > 8 || num_output > 8);
 
+    int l2_cache_size = get_cpu_level2_cache_size();
+    bool prefer_sgemm = num_input * num_output * kernel_w * kernel_h * dilation_w * dilation_h * stride_w * stride_h * (int)sizeof(float) * 2 > l2_cache_size || (num_input > 16 || num_output > 16);
+
     if (opt.use_winograd_convolution && prefer_winograd && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
     {
         if ((bottom_shapes.empty() || bottom_shapes[0].w == 0 || bottom_shapes[0].h == 0) && (top_shapes.empty() || top_shapes[0].w == 0 || top_shapes[0].h == 0))
         {
             // dynamic shape
             if ((opt.use_winograd63_convolution) && (num_input <= 32 && num_output <= 32))
-                conv3x3s1_winograd63_transform_kernel(weight_data, weight_winograd63_data, num_input, num_output, opt);
+                kernel_mask |= 1 << conv_kernel_winograd63;
             else if (opt.use_winograd43_convolution)
-                conv3x3s1_winograd43_transform_kernel(weight_data, weight_winograd43_data, num_input, num_output, opt);
+                kernel_mask |= 1 << conv_kernel_winograd43;
             else
-                conv3x3s1_winograd23_transform_kernel(weight_data, weight_winograd23_data, num_input, num_output, opt);
+                kernel_mask |= 1 << conv_kernel_winograd23;
         }
         else
         {
@@ -425,35 +465,68 @@ int Convolution_x86::create_pipeline(const Option& opt)
 
             if (prefer_winograd23)
             {
-                conv3x3s1_winograd23_transform_kernel(weight_data, weight_winograd23_data, num_input, num_output, opt);
+                kernel_mask |= 1 << conv_kernel_winograd23;
             }
             else if (prefer_winograd43)
             {
-                conv3x3s1_winograd43_transform_kernel(weight_data, weight_winograd43_data, num_input, num_output, opt);
+                kernel_mask |= 1 << conv_kernel_winograd43;
             }
             else if (prefer_winograd63)
             {
-                conv3x3s1_winograd63_transform_kernel(weight_data, weight_winograd63_data, num_input, num_output, opt);
+                kernel_mask |= 1 << conv_kernel_winograd63;
             }
             else
             {
                 // should never reach here
             }
         }
+    }
+    else if ((opt.use_sgemm_convolution && prefer_sgemm) || (kernel_w == 1 && kernel_h == 1))
+    {
+        kernel_mask |= 1 << conv_kernel_im2col_gemm;
+    }
+    else
+    {
+        kernel_mask |= 1 << conv_kernel_packed;
+    }
 
+    if (opt.tuning_cache)
+    {
+        // prepare every candidate for timing, or the recorded winners only
+        if (opt.tuning_cache->autotune())
+        {
+            kernel_mask |= get_candidate_kernels(opt);
+        }
+        else
+        {
+            int config[TuningCache::key_size];
+            get_tuning_config(num_input, config);
+            kernel_mask |= opt.tuning_cache->find_kernels(config) & get_candidate_kernels(opt);
+        }
+    }
+
+    // the weights restored from opt.weight_cache are kept as they are
+    if ((kernel_mask & (1 << conv_kernel_winograd23)) && weight_winograd23_data.empty())
+        conv3x3s1_winograd23_transform_kernel(weight_data, weight_winograd23_data, num_input, num_output, opt);
+    if ((kernel_mask & (1 << conv_kernel_winograd43)) && weight_winograd43_data.empty())
+        conv3x3s1_winograd43_transform_kernel(weight_data, weight_winograd43_data, num_input, num_output, opt);
+    if ((kernel_mask & (1 << conv_kernel_winograd63)) && weight_winograd63_data.empty())
+        conv3x3s1_winograd63_transform_kernel(weight_data, weight_winograd63_data, num_input, num_output, opt);
+
+    if ((kernel_mask & (1 << conv_kernel_im2col_gemm)) && weight_sgemm_data.empty())
+        convolution_im2col_gemm_transform_kernel(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h, opt);
+
+    if (!(kernel_mask & (1 << conv_kernel_packed)))
+    {
         if (opt.lightmode)
             weight_data.release();
 
         return 0;
     }
 
-    int l2_cache_size = get_cpu_level2_cache_size();
-    bool prefer_sgemm = num_input * num_output * kernel_w * kernel_h * dilation_w * dilation_h * stride_w * stride_h * (int)sizeof(float) * 2 > l2_cache_size || (num_input > 16 || num_output > 16);
-
-    if ((opt.use_sgemm_convolution && prefer_sgemm) || (kernel_w == 1 && kernel_h == 1))
+    if (!weight_data_tm.empty())
     {
-        convolution_im2col_gemm_transform_kernel(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h, opt);
-
+        // restored from opt.weight_cache
         if (opt.lightmode)
             weight_data.release();
 
@@ -498,112 +571,188 @@ int Convolution_x86::destroy_pipeline(const Option& opt)
         convolution_dilation1 = 0;
     }
 
+    delete shape_cache;
+    shape_cache = 0;
+
     return 0;
 }
 
-int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+int Convolution_x86::get_pipeline_weights(std::vector<Mat*>& weights)
 {
-#if NCNN_INT8
-    if (opt.use_int8_inference && int8_scale_term)
+    if (dynamic_weight)
+        return 0;
+
+    weights.push_back(&weight_data_tm);
+    weights.push_back(&weight_sgemm_data);
+    weights.push_back(&weight_winograd23_data);
+    weights.push_back(&weight_winograd43_data);
+    weights.push_back(&weight_winograd63_data);
+
+    return 0;
+}
+
+// option bits that change the kernel choice
+static int get_kernel_option_bits(const Option& opt)
+{
+    return opt.use_winograd_convolution
+           | opt.use_winograd23_convolution << 1
+           | opt.use_winograd43_convolution << 2
+           | opt.use_winograd63_convolution << 3
+           | opt.use_sgemm_convolution << 4
+           | opt.use_packing_layout << 5;
+}
+
+static void get_kernel_tiles(int conv_kernel, int num_input, int num_output, int maxk, int outw, int outh, int _nT, int* spec)
+{
+    int TILE_M = 0;
+    int TILE_N = 0;
+    int TILE_K = 0;
+
+    // winograd tile count of each output map
+    if (conv_kernel == conv_kernel_winograd23)
+        get_optimal_tile_mnk(num_output, ((outw + 1) / 2) * ((outh + 1) / 2), num_input, TILE_M, TILE_N, TILE_K, _nT);
+    if (conv_kernel == conv_kernel_winograd43)
+        get_optimal_tile_mnk(num_output, ((outw + 3) / 4) * ((outh + 3) / 4), num_input, TILE_M, TILE_N, TILE_K, _nT);
+    if (conv_kernel == conv_kernel_winograd63)
+        get_optimal_tile_mnk(num_output, ((outw + 5) / 6) * ((outh + 5) / 6), num_input, TILE_M, TILE_N, TILE_K, _nT);
+    if (conv_kernel == conv_kernel_im2col_gemm)
+        convolution_im2col_gemm_get_optimal_tile_mnk(num_output, outw * outh, num_input * maxk, TILE_M, TILE_N, TILE_K, _nT);
+
+    spec[0] = conv_kernel;
+    spec[1] = TILE_M;
+    spec[2] = TILE_N;
+    spec[3] = TILE_K;
+}
+
+void Convolution_x86::get_tuning_config(int num_input, int* key) const
+{
+    // kernels of different isa builds rank differently
+#if __AVX512F__
+    const int vector_width = 16;
+#elif __AVX__
+    const int vector_width = 8;
+#elif __SSE2__
+    const int vector_width = 4;
+#else
+    const int vector_width = 1;
+#endif
+
+    memset(key, 0, TuningCache::key_size * sizeof(int));
+
+    key[0] = LayerType::Convolution;
+    key[1] = num_input;
+    key[2] = num_output;
+    key[3] = kernel_w;
+    key[4] = kernel_h;
+    key[5] = dilation_w;
+    key[6] = dilation_h;
+    key[7] = stride_w;
+    key[8] = stride_h;
+    key[9] = vector_width;
+}
+
+int Convolution_x86::get_candidate_kernels(const Option& opt) const
+{
+    int mask = 1 << conv_kernel_packed;
+
+    if (opt.use_winograd_convolution && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
     {
-        return forward_int8_x86(bottom_blob, top_blob, opt);
+        if (opt.use_winograd23_convolution)
+            mask |= 1 << conv_kernel_winograd23;
+        if (opt.use_winograd43_convolution)
+            mask |= 1 << conv_kernel_winograd43;
+        if (opt.use_winograd63_convolution)
+            mask |= 1 << conv_kernel_winograd63;
     }
-#endif
 
-    // flattened blob, implement as InnerProduct
-    if (bottom_blob.dims == 1 && kernel_w == 1 && kernel_h == 1)
+    if (opt.use_sgemm_convolution || (kernel_w == 1 && kernel_h == 1))
+        mask |= 1 << conv_kernel_im2col_gemm;
+
+    return mask;
+}
+
+bool Convolution_x86::kernel_available(int conv_kernel) const
+{
+    if (conv_kernel == conv_kernel_packed)
+        return !weight_data_tm.empty();
+    if (conv_kernel == conv_kernel_winograd23)
+        return !weight_winograd23_data.empty();
+    if (conv_kernel == conv_kernel_winograd43)
+        return !weight_winograd43_data.empty();
+    if (conv_kernel == conv_kernel_winograd63)
+        return !weight_winograd63_data.empty();
+    if (conv_kernel == conv_kernel_im2col_gemm)
+        return !weight_sgemm_data.empty();
+
+    return false;
+}
+
+int Convolution_x86::autotune_kernel(const Mat& bottom_blob_bordered, Mat& top_blob, int num_input, int _nT, const Option& opt, const int* tuning_key) const
+{
+    const int maxk = kernel_w * kernel_h;
+
+    int best_kernel = -1;
+    double best_time = 0;
+    for (int k = 0; k < conv_kernel_count; k++)
     {
-        Mat bottom_blob_3d;
-        if (bottom_blob.elemsize % 16 == 0)
-        {
-            bottom_blob_3d = bottom_blob;
-            bottom_blob_3d.dims = 3;
-            bottom_blob_3d.w = 1;
-            bottom_blob_3d.h = 1;
-            bottom_blob_3d.c = bottom_blob.w;
-            bottom_blob_3d.cstep = 1;
-        }
-        else
+        if (!kernel_available(k))
+            continue;
+
+        int spec[ShapeCache::value_size] = {0};
+        get_kernel_tiles(k, num_input, num_output, maxk, top_blob.w, top_blob.h, _nT, spec);
+
+        // the first run warms up caches and the workspace allocator
+        double time = 0;
+        int ret = 0;
+        for (int i = 0; i < 3 && ret == 0; i++)
         {
-            bottom_blob_3d = bottom_blob.reshape(1, 1, bottom_blob.w, opt.workspace_allocator);
-            if (bottom_blob_3d.empty())
-                return -100;
+            double start = get_current_time();
+            ret = forward_kernel(bottom_blob_bordered, top_blob, spec, _nT, opt);
+            double end = get_current_time();
+
+            if (i == 1 || (i > 1 && end - start < time))
+                time = end - start;
         }
 
-        Mat top_blob_3d;
-        int ret = forward(bottom_blob_3d, top_blob_3d, opt);
         if (ret != 0)
-            return ret;
+            continue;
 
-        if (top_blob_3d.elemsize % 16 == 0)
+        if (best_kernel == -1 || time < best_time)
         {
-            top_blob = top_blob_3d;
-            top_blob.dims = 1;
-            top_blob.w = top_blob_3d.c;
-            top_blob.h = 1;
-            top_blob.c = 1;
-            top_blob.cstep = top_blob_3d.c;
-        }
-        else
-        {
-            top_blob = top_blob_3d.reshape(top_blob_3d.c, opt.blob_allocator);
-            if (top_blob.empty())
-                return -100;
+            best_kernel = k;
+            best_time = time;
         }
+    }
 
-        return 0;
+    if (best_kernel != -1)
+    {
+        opt.tuning_cache->insert(tuning_key, best_kernel, (float)best_time);
     }
 
-    int w = bottom_blob.w;
-    int h = bottom_blob.h;
-    int channels = bottom_blob.c;
-    size_t elemsize = bottom_blob.elemsize;
-    int elempack = bottom_blob.elempack;
+    return best_kernel;
+}
 
-    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
-    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+void Convolution_x86::resolve_shape_spec(const Mat& bottom_blob_bordered, Mat& top_blob, int num_input, int _nT, const Option& opt, int* spec) const
+{
+    const int w = bottom_blob_bordered.w;
+    const int h = bottom_blob_bordered.h;
+    const int elempack = bottom_blob_bordered.elempack;
+    const int option_bits = get_kernel_option_bits(opt);
 
-    Mat bottom_blob_bordered;
-    make_padding(bottom_blob, bottom_blob_bordered, opt);
-    if (bottom_blob_bordered.empty())
-        return -100;
+    int key[ShapeCache::key_size] = {w, h, num_input, elempack, _nT, option_bits, 0, 0};
 
-    w = bottom_blob_bordered.w;
-    h = bottom_blob_bordered.h;
+    if (shape_cache && shape_cache->find(key, spec) == 0)
+        return;
 
-    int outw = (w - kernel_extent_w) / stride_w + 1;
-    int outh = (h - kernel_extent_h) / stride_h + 1;
-    int out_elempack = 1;
-#if __SSE2__
-    if (opt.use_packing_layout)
-    {
-#if __AVX512F__
-        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
-#elif __AVX__
-        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
-#else
-        out_elempack = num_output % 4 == 0 ? 4 : 1;
-#endif
-    }
-#endif // __SSE2__
-    size_t out_elemsize = elemsize / elempack * out_elempack;
-
-    top_blob.create(outw, outh, num_output / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
-    if (top_blob.empty())
-        return -100;
-
-    if (!opt.use_packing_layout && kernel_w == kernel_h && dilation_w != 1 && dilation_h == dilation_w && stride_w == 1 && stride_h == 1)
-    {
-        if (outw >= dilation_w && outh >= dilation_h)
-        {
-            return forwardDilation_x86(bottom_blob_bordered, top_blob, opt);
-        }
-    }
+    memset(spec, 0, ShapeCache::value_size * sizeof(int));
 
-    const int num_input = channels * elempack;
+    int conv_kernel = conv_kernel_packed;
 
     bool prefer_winograd = (opt.use_winograd23_convolution || opt.use_winograd43_convolution || opt.use_winograd63_convolution) && (num_input > 8 || num_output > 8);
 
+    int l2_cache_size = get_cpu_level2_cache_size();
+    bool prefer_sgemm = num_input * num_output * kernel_w * kernel_h * dilation_w * dilation_h * stride_w * stride_h * (int)sizeof(float) * 2 > l2_cache_size || (num_input > 16 || num_output > 16);
+
     if (opt.use_winograd_convolution && prefer_winograd && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
     {
         bool prefer_winograd63 = test_prefer_winograd63(num_input, num_output, w, h);
@@ -638,55 +787,73 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
             }
         }
 
-        int _nT = nT ? nT : opt.num_threads;
-        if (nT != 0 && opt.num_threads != nT)
-        {
-            // force num_threads the same as in create_pipeline
-            // so we could use pre-packed A/B from the same tile config
-            NCNN_LOGE("opt.num_threads %d changed, convolution winograd will use load-time value %d", opt.num_threads, nT);
-        }
-
-        int ret = 0;
         if (prefer_winograd23)
+            conv_kernel = conv_kernel_winograd23;
+        else if (prefer_winograd43)
+            conv_kernel = conv_kernel_winograd43;
+        else // if (prefer_winograd63)
+            conv_kernel = conv_kernel_winograd63;
+    }
+    else if ((opt.use_sgemm_convolution && prefer_sgemm) || (kernel_w == 1 && kernel_h == 1))
+    {
+        conv_kernel = conv_kernel_im2col_gemm;
+    }
+
+    if (opt.tuning_cache)
+    {
+        int tuning_key[TuningCache::key_size];
+        get_tuning_config(num_input, tuning_key);
+        tuning_key[TuningCache::config_size + 0] = w;
+        tuning_key[TuningCache::config_size + 1] = h;
+        tuning_key[TuningCache::config_size + 2] = elempack;
+        tuning_key[TuningCache::config_size + 3] = _nT;
+        tuning_key[TuningCache::config_size + 4] = option_bits;
+
+        int tuned_kernel = -1;
+        if (opt.tuning_cache->find(tuning_key, tuned_kernel) == 0 && kernel_available(tuned_kernel))
         {
-            ret = conv3x3s1_winograd23(bottom_blob_bordered, top_blob, weight_winograd23_data, bias_data, _nT, opt);
+            conv_kernel = tuned_kernel;
         }
-        else if (prefer_winograd43)
+        else if (opt.tuning_cache->autotune())
         {
-            ret = conv3x3s1_winograd43(bottom_blob_bordered, top_blob, weight_winograd43_data, bias_data, _nT, opt);
+            tuned_kernel = autotune_kernel(bottom_blob_bordered, top_blob, num_input, _nT, opt, tuning_key);
+            if (tuned_kernel != -1)
+                conv_kernel = tuned_kernel;
         }
-        else if (prefer_winograd63)
+    }
+
+    get_kernel_tiles(conv_kernel, num_input, num_output, kernel_w * kernel_h, top_blob.w, top_blob.h, _nT, spec);
+
+    if (shape_cache)
+        shape_cache->insert(key, spec);
+}
+
+int Convolution_x86::forward_kernel(const Mat& bottom_blob_bordered, Mat& top_blob, const int* spec, int _nT, const Option& opt) const
+{
+    const int conv_kernel = spec[0];
+    const int TILE_M = spec[1];
+    const int TILE_N = spec[2];
+    const int TILE_K = spec[3];
+
+    if (conv_kernel == conv_kernel_winograd23 || conv_kernel == conv_kernel_winograd43 || conv_kernel == conv_kernel_winograd63 || conv_kernel == conv_kernel_im2col_gemm)
+    {
+        int ret = 0;
+        if (conv_kernel == conv_kernel_winograd23)
         {
-            ret = conv3x3s1_winograd63(bottom_blob_bordered, top_blob, weight_winograd63_data, bias_data, _nT, opt);
+            ret = conv3x3s1_winograd23(bottom_blob_bordered, top_blob, weight_winograd23_data, bias_data, TILE_M, TILE_N, TILE_K, _nT, opt);
         }
-        else
+        else if (conv_kernel == conv_kernel_winograd43)
         {
-            // should never reach here
+            ret = conv3x3s1_winograd43(bottom_blob_bordered, top_blob, weight_winograd43_data, bias_data, TILE_M, TILE_N, TILE_K, _nT, opt);
         }
-        if (ret != 0)
-            return ret;
-
-        if (activation)
+        else if (conv_kernel == conv_kernel_winograd63)
         {
-            activation->forward_inplace(top_blob, opt);
+            ret = conv3x3s1_winograd63(bottom_blob_bordered, top_blob, weight_winograd63_data, bias_data, TILE_M, TILE_N, TILE_K, _nT, opt);
         }
-        return 0;
-    }
-
-    int l2_cache_size = get_cpu_level2_cache_size();
-    bool prefer_sgemm = num_input * num_output * kernel_w * kernel_h * dilation_w * dilation_h * stride_w * stride_h * (int)sizeof(float) * 2 > l2_cache_size || (num_input > 16 || num_output > 16);
-
-    if ((opt.use_sgemm_convolution && prefer_sgemm) || (kernel_w == 1 && kernel_h == 1))
-    {
-        int _nT = nT ? nT : opt.num_threads;
-        if (nT != 0 && opt.num_threads != nT)
+        else // if (conv_kernel == conv_kernel_im2col_gemm)
         {
-            // force num_threads the same as in create_pipeline
-            // so we could use pre-packed A/B from the same tile config
-            NCNN_LOGE("opt.num_threads %d changed, convolution gemm will use load-time value %d", opt.num_threads, nT);
+            ret = convolution_im2col_gemm(bottom_blob_bordered, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, TILE_M, TILE_N, TILE_K, _nT, opt);
         }
-
-        int ret = convolution_im2col_gemm(bottom_blob_bordered, top_blob, weight_sgemm_data, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, _nT, opt);
         if (ret != 0)
             return ret;
 
@@ -697,6 +864,9 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
         return 0;
     }
 
+    const int elempack = bottom_blob_bordered.elempack;
+    const int out_elempack = top_blob.elempack;
+
 #if __SSE2__
 #if __AVX__
 #if __AVX512F__
@@ -808,6 +978,129 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
     return 0;
 }
 
+int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+#if NCNN_INT8
+    if (opt.use_int8_inference && int8_scale_term)
+    {
+        return forward_int8_x86(bottom_blob, top_blob, opt);
+    }
+#endif
+
+    // flattened blob, implement as InnerProduct
+    if (bottom_blob.dims == 1 && kernel_w == 1 && kernel_h == 1)
+    {
+        Mat bottom_blob_3d;
+        if (bottom_blob.elemsize % 16 == 0)
+        {
+            bottom_blob_3d = bottom_blob;
+            bottom_blob_3d.dims = 3;
+            bottom_blob_3d.w = 1;
+            bottom_blob_3d.h = 1;
+            bottom_blob_3d.c = bottom_blob.w;
+            bottom_blob_3d.cstep = 1;
+        }
+        else
+        {
+            bottom_blob_3d = bottom_blob.reshape(1, 1, bottom_blob.w, opt.workspace_allocator);
+            if (bottom_blob_3d.empty())
+                return -100;
+        }
+
+        Mat top_blob_3d;
+        int ret = forward(bottom_blob_3d, top_blob_3d, opt);
+        if (ret != 0)
+            return ret;
+
+        if (top_blob_3d.elemsize % 16 == 0)
+        {
+            top_blob = top_blob_3d;
+            top_blob.dims = 1;
+            top_blob.w = top_blob_3d.c;
+            top_blob.h = 1;
+            top_blob.c = 1;
+            top_blob.cstep = top_blob_3d.c;
+        }
+        else
+        {
+            top_blob = top_blob_3d.reshape(top_blob_3d.c, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+        }
+
+        return 0;
+    }
+
+#if NCNN_BF16
+    if (opt.use_bf16_storage && support_bf16_storage)
+    {
+        return forward_bf16s(bottom_blob, top_blob, opt);
+    }
+#endif
+
+    int w = bottom_blob.w;
+    int h = bottom_blob.h;
+    int channels = bottom_blob.c;
+    size_t elemsize = bottom_blob.elemsize;
+    int elempack = bottom_blob.elempack;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    w = bottom_blob_bordered.w;
+    h = bottom_blob_bordered.h;
+
+    int outw = (w - kernel_extent_w) / stride_w + 1;
+    int outh = (h - kernel_extent_h) / stride_h + 1;
+    int out_elempack = 1;
+#if __SSE2__
+    if (opt.use_packing_layout)
+    {
+#if __AVX512F__
+        out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+        out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+        out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+    }
+#endif // __SSE2__
+    size_t out_elemsize = elemsize / elempack * out_elempack;
+
+    top_blob.create(outw, outh, num_output / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    if (!opt.use_packing_layout && kernel_w == kernel_h && dilation_w != 1 && dilation_h == dilation_w && stride_w == 1 && stride_h == 1)
+    {
+        if (outw >= dilation_w && outh >= dilation_h)
+        {
+            return forwardDilation_x86(bottom_blob_bordered, top_blob, opt);
+        }
+    }
+
+    const int num_input = channels * elempack;
+
+    int _nT = nT ? nT : opt.num_threads;
+
+    int spec[ShapeCache::value_size];
+    resolve_shape_spec(bottom_blob_bordered, top_blob, num_input, _nT, opt, spec);
+
+    if (nT != 0 && opt.num_threads != nT && spec[0] != conv_kernel_packed)
+    {
+        // force num_threads the same as in create_pipeline
+        // so we could use pre-packed A/B from the same tile config
+        NCNN_LOGE("opt.num_threads %d changed, convolution %s will use load-time value %d", opt.num_threads, spec[0] == conv_kernel_im2col_gemm ? "gemm" : "winograd", nT);
+    }
+
+    return forward_kernel(bottom_blob_bordered, top_blob, spec, _nT, opt);
+}
+
 int Convolution_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     const Mat& bottom_blob = bottom_blobs[0];
@@ -882,6 +1175,117 @@ int Convolution_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
     return 0;
 }
 
+#if NCNN_BF16
+int Convolution_x86::create_pipeline_bf16s(const Option& opt)
+{
+    const int maxk = kernel_w * kernel_h;
+    const int num_input = weight_data_size / maxk / num_output;
+
+    if (weight_data_tm.empty())
+    {
+        convolution_im2col_gemm_transform_kernel_bf16s(weight_data, weight_data_tm, num_input, num_output, kernel_w, kernel_h, opt);
+        if (weight_data_tm.empty())
+            return -100;
+    }
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int Convolution_x86::forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    // fp32 blobs come from layers running this convolution internally, the result goes back to fp32
+    const bool fp32_io = bottom_blob.elembits() == 32;
+
+    Mat bottom_blob_bf16 = bottom_blob;
+    if (fp32_io)
+    {
+        cast_float32_to_bfloat16(bottom_blob, bottom_blob_bf16, opt_ws);
+        if (bottom_blob_bf16.empty())
+            return -100;
+    }
+
+    Mat bottom_blob_unpacked = bottom_blob_bf16;
+    if (bottom_blob_bf16.elempack != 1)
+    {
+        convert_packing(bottom_blob_bf16, bottom_blob_unpacked, 1, opt_ws);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+    }
+
+    Mat bottom_blob_bordered;
+    make_padding(bottom_blob_unpacked, bottom_blob_bordered, opt);
+    if (bottom_blob_bordered.empty())
+        return -100;
+
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+    const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
+
+    const int outw = (bottom_blob_bordered.w - kernel_extent_w) / stride_w + 1;
+    const int outh = (bottom_blob_bordered.h - kernel_extent_h) / stride_h + 1;
+
+    Mat top_blob_bf16;
+    top_blob_bf16.create(outw, outh, num_output, 2u, fp32_io ? opt.workspace_allocator : opt.blob_allocator);
+    if (top_blob_bf16.empty())
+        return -100;
+
+    int ret = convolution_im2col_gemm_bf16s(bottom_blob_bordered, top_blob_bf16, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, opt.num_threads, opt);
+    if (ret != 0)
+        return ret;
+
+    if (fp32_io)
+    {
+        // back to the packed fp32 layout, top_blob may be a channel range of the caller's blob
+        int out_elempack = 1;
+#if __SSE2__
+        if (opt.use_packing_layout)
+        {
+#if __AVX512F__
+            out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+            out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+            out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+        }
+#endif // __SSE2__
+
+        top_blob.create(outw, outh, num_output / out_elempack, 4u * out_elempack, out_elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int size = outw * outh;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < num_output / out_elempack; q++)
+        {
+            float* outptr = top_blob.channel(q);
+
+            for (int k = 0; k < out_elempack; k++)
+            {
+                const unsigned short* ptr = top_blob_bf16.channel(q * out_elempack + k);
+
+                for (int i = 0; i < size; i++)
+                {
+                    outptr[i * out_elempack + k] = bfloat16_to_float32(ptr[i]);
+                }
+            }
+        }
+    }
+    else
+    {
+        top_blob = top_blob_bf16;
+    }
+
+    return 0;
+}
+#endif // NCNN_BF16
+
 #if NCNN_INT8
 int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
 {
@@ -892,18 +1296,20 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
 
     if (opt.use_winograd_convolution && prefer_winograd && kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
     {
-        if (opt.use_winograd43_convolution)
+        if (opt.use_winograd43_convolution && weight_winograd43_data.empty())
             conv3x3s1_winograd43_transform_kernel_int8(weight_data, weight_winograd43_data, num_input, num_output, opt);
-        else
+        else if (!opt.use_winograd43_convolution && weight_winograd23_data.empty())
             conv3x3s1_winograd23_transform_kernel_int8(weight_data, weight_winograd23_data, num_input, num_output, opt);
     }
     else if (opt.use_sgemm_convolution)
     {
-        convolution_im2col_gemm_transform_kernel_int8(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h, opt);
+        if (weight_sgemm_data.empty())
+            convolution_im2col_gemm_transform_kernel_int8(weight_data, weight_sgemm_data, num_input, num_output, kernel_w, kernel_h, opt);
     }
     else
     {
-        convolution_transform_kernel_packed_int8(weight_data, weight_data_tm, num_input, num_output, kernel_w, kernel_h);
+        if (weight_data_tm.empty())
+            convolution_transform_kernel_packed_int8(weight_data, weight_data_tm, num_input, num_output, kernel_w, kernel_h);
     }
 
     scale_in_data.create(num_output);
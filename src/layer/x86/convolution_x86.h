@@ -16,17 +16,33 @@ public:
     virtual int create_pipeline(const Option& opt);
     virtual int destroy_pipeline(const Option& opt);
 
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
 protected:
+#if NCNN_BF16
+    int create_pipeline_bf16s(const Option& opt);
+    int forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif
 #if NCNN_INT8
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #endif
     int forwardDilation_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+    // pick the kernel and gemm tiles for an input shape, cached in shape_cache
+    void resolve_shape_spec(const Mat& bottom_blob_bordered, Mat& top_blob, int num_input, int _nT, const Option& opt, int* spec) const;
+    int forward_kernel(const Mat& bottom_blob_bordered, Mat& top_blob, const int* spec, int _nT, const Option& opt) const;
+
+    // kernel autotuning with opt.tuning_cache
+    void get_tuning_config(int num_input, int* key) const;
+    int get_candidate_kernels(const Option& opt) const;
+    bool kernel_available(int conv_kernel) const;
+    int autotune_kernel(const Mat& bottom_blob_bordered, Mat& top_blob, int num_input, int _nT, const Option& opt, const int* tuning_key) const;
+
 public:
     Layer* activation;
 
@@ -77,6 +77,15 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
         }
 #endif // __SSE2__
 
+        if (elempack != 1 && !weight_data_tm.empty())
+        {
+            // restored from opt.weight_cache
+            if (opt.lightmode)
+                weight_data.release();
+
+            return 0;
+        }
+
 #if __SSE2__
 #if __AVX__
         // pack16
@@ -106,14 +115,16 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
 
         if (elempack == 1)
         {
-            // depth-wise specific
+            // depth-wise specific, keeping the weights restored from opt.weight_cache
             if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
             {
-                weight_data_tm = weight_data;
+                if (weight_data_tm.empty())
+                    weight_data_tm = weight_data;
             }
             else if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
             {
-                weight_data_tm = weight_data;
+                if (weight_data_tm.empty())
+                    weight_data_tm = weight_data;
             }
             else
             {
@@ -136,6 +147,23 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
     return 0;
 }
 
+int ConvolutionDepthWise_x86::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    if (dynamic_weight)
+        return 0;
+
+    const int maxk = kernel_w * kernel_h;
+    int channels = (weight_data_size / group) / maxk / (num_output / group) * group;
+
+    // group convolution keeps its weights in the group ops
+    if (channels != group || group != num_output)
+        return 0;
+
+    weights.push_back(&weight_data_tm);
+
+    return 0;
+}
+
 int ConvolutionDepthWise_x86::create_group_ops(const Option& opt)
 {
     // create Convolution op for each group
@@ -829,13 +857,22 @@ int ConvolutionDepthWise_x86::create_pipeline_int8_x86(const Option& opt)
         }
 #endif // __SSE2__
 
+        if (elempack != 1 && !weight_data_tm.empty())
+        {
+            // restored from opt.weight_cache
+            if (opt.lightmode)
+                weight_data.release();
+
+            return 0;
+        }
+
         if (elempack == 8)
         {
             Mat weight_data_r2 = weight_data.reshape(maxk, group);
             convert_packing(weight_data_r2, weight_data_tm, 8, opt);
         }
 
-        if (elempack == 1)
+        if (elempack == 1 && weight_data_tm.empty())
         {
             weight_data_tm = weight_data;
         }
@@ -0,0 +1,239 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cumulativesum_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+namespace ncnn {
+
+CumulativeSum_x86::CumulativeSum_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+// ptr[i] += prev[i]
+static void cumulativesum_add(const float* prev, float* ptr, int size)
+{
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        _mm512_storeu_ps(ptr + i, _mm512_add_ps(_mm512_loadu_ps(ptr + i), _mm512_loadu_ps(prev + i)));
+    }
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
+    {
+        _mm256_storeu_ps(ptr + i, _mm256_add_ps(_mm256_loadu_ps(ptr + i), _mm256_loadu_ps(prev + i)));
+    }
+#endif // __AVX__
+    for (; i + 3 < size; i += 4)
+    {
+        _mm_storeu_ps(ptr + i, _mm_add_ps(_mm_loadu_ps(ptr + i), _mm_loadu_ps(prev + i)));
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        ptr[i] += prev[i];
+    }
+}
+
+// running sum over size packs of elempack lanes, the lanes stay independent
+static void cumulativesum_packs(float* ptr, int size, int elempack)
+{
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        __m512 _sum = _mm512_loadu_ps(ptr);
+        for (int i = 1; i < size; i++)
+        {
+            _sum = _mm512_add_ps(_sum, _mm512_loadu_ps(ptr + i * 16));
+            _mm512_storeu_ps(ptr + i * 16, _sum);
+        }
+        return;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        __m256 _sum = _mm256_loadu_ps(ptr);
+        for (int i = 1; i < size; i++)
+        {
+            _sum = _mm256_add_ps(_sum, _mm256_loadu_ps(ptr + i * 8));
+            _mm256_storeu_ps(ptr + i * 8, _sum);
+        }
+        return;
+    }
+#endif // __AVX__
+    if (elempack == 4)
+    {
+        __m128 _sum = _mm_loadu_ps(ptr);
+        for (int i = 1; i < size; i++)
+        {
+            _sum = _mm_add_ps(_sum, _mm_loadu_ps(ptr + i * 4));
+            _mm_storeu_ps(ptr + i * 4, _sum);
+        }
+        return;
+    }
+#endif // __SSE2__
+
+    for (int i = 1; i < size; i++)
+    {
+        ptr[i] += ptr[i - 1];
+    }
+}
+
+// running sum along the packed axis, lane k of a pack follows lane k - 1
+// and lane 0 follows the last lane of the previous pack at the same position
+static void cumulativesum_lanes(const float* prev, float* ptr, int size, int elempack)
+{
+    for (int i = 0; i < size; i++)
+    {
+        float sum = prev ? prev[elempack - 1] : 0.f;
+        for (int k = 0; k < elempack; k++)
+        {
+            sum += ptr[k];
+            ptr[k] = sum;
+        }
+
+        if (prev)
+            prev += elempack;
+        ptr += elempack;
+    }
+}
+
+int CumulativeSum_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
+{
+    const int dims = bottom_top_blob.dims;
+    const int elempack = bottom_top_blob.elempack;
+    const int positive_axis = axis < 0 ? dims + axis : axis;
+
+    if (dims == 1)
+    {
+        // the packed layout of 1d is contiguous
+        cumulativesum_packs(bottom_top_blob, bottom_top_blob.w * elempack, 1);
+
+        return 0;
+    }
+
+    if (dims == 2 && positive_axis == 0)
+    {
+        // sum over rows
+        const int w = bottom_top_blob.w;
+        const int h = bottom_top_blob.h;
+
+        for (int i = 0; i < h; i++)
+        {
+            const float* prev_row = i == 0 ? 0 : bottom_top_blob.row(i - 1);
+            float* this_row = bottom_top_blob.row(i);
+
+            if (elempack == 1)
+            {
+                if (prev_row)
+                    cumulativesum_add(prev_row, this_row, w);
+            }
+            else
+            {
+                cumulativesum_lanes(prev_row, this_row, w, elempack);
+            }
+        }
+
+        return 0;
+    }
+
+    if (dims == 2 && positive_axis == 1)
+    {
+        // sum over columns
+        const int w = bottom_top_blob.w;
+        const int h = bottom_top_blob.h;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < h; i++)
+        {
+            cumulativesum_packs(bottom_top_blob.row(i), w, elempack);
+        }
+
+        return 0;
+    }
+
+    if (dims == 3 && positive_axis == 0)
+    {
+        // sum over channels
+        const int size = bottom_top_blob.w * bottom_top_blob.h;
+        const int channels = bottom_top_blob.c;
+
+        for (int q = 0; q < channels; q++)
+        {
+            const float* prev = q == 0 ? 0 : bottom_top_blob.channel(q - 1);
+            float* cur = bottom_top_blob.channel(q);
+
+            if (elempack == 1)
+            {
+                if (prev)
+                    cumulativesum_add(prev, cur, size);
+            }
+            else
+            {
+                cumulativesum_lanes(prev, cur, size, elempack);
+            }
+        }
+
+        return 0;
+    }
+
+    if (dims == 3 && positive_axis == 1)
+    {
+        // sum over rows within each channel
+        const int w = bottom_top_blob.w;
+        const int h = bottom_top_blob.h;
+        const int channels = bottom_top_blob.c;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            Mat this_channel = bottom_top_blob.channel(q);
+
+            for (int i = 1; i < h; i++)
+            {
+                cumulativesum_add(this_channel.row(i - 1), this_channel.row(i), w * elempack);
+            }
+        }
+
+        return 0;
+    }
+
+    if (dims == 3 && positive_axis == 2)
+    {
+        // sum over columns within each channel
+        const int w = bottom_top_blob.w;
+        const int h = bottom_top_blob.h;
+        const int channels = bottom_top_blob.c;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            Mat this_channel = bottom_top_blob.channel(q);
+
+            for (int i = 0; i < h; i++)
+            {
+                cumulativesum_packs(this_channel.row(i), w, elempack);
+            }
+        }
+
+        return 0;
+    }
+
+    return -100;
+}
+
+} // namespace ncnn
@@ -0,0 +1,231 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "embed_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __SSE4_1__
+#include <smmintrin.h>
+#endif // __SSE4_1__
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+#include <string.h>
+
+#include "cpu.h"
+
+namespace ncnn {
+
+Embed_x86::Embed_x86()
+{
+}
+
+int Embed_x86::create_pipeline(const Option& opt)
+{
+#if NCNN_F16C && __AVX__
+    if (cpu_support_x86_f16c() && opt.use_fp16_storage && !int8_scale_term)
+    {
+        cast_float32_to_float16(weight_data, weight_data_tm, opt);
+        if (weight_data_tm.empty())
+            return -100;
+
+        if (opt.lightmode)
+            weight_data.release();
+    }
+#else
+    (void)opt;
+#endif
+
+    return 0;
+}
+
+static NCNN_FORCEINLINE int embed_word_index(const Mat& bottom_blob, int q, int input_dim)
+{
+    int word_index = ((const int*)bottom_blob)[q];
+
+    if (word_index < 0)
+        word_index = 0;
+    if (word_index >= input_dim)
+        word_index = input_dim - 1;
+
+    return word_index;
+}
+
+static void embed_row(const float* em, const float* bias_ptr, float* outptr, int num_output)
+{
+    int p = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; p + 15 < num_output; p += 16)
+    {
+        __m512 _em = _mm512_loadu_ps(em + p);
+        if (bias_ptr)
+            _em = _mm512_add_ps(_em, _mm512_loadu_ps(bias_ptr + p));
+        _mm512_storeu_ps(outptr + p, _em);
+    }
+#endif // __AVX512F__
+    for (; p + 7 < num_output; p += 8)
+    {
+        __m256 _em = _mm256_loadu_ps(em + p);
+        if (bias_ptr)
+            _em = _mm256_add_ps(_em, _mm256_loadu_ps(bias_ptr + p));
+        _mm256_storeu_ps(outptr + p, _em);
+    }
+#endif // __AVX__
+    for (; p + 3 < num_output; p += 4)
+    {
+        __m128 _em = _mm_loadu_ps(em + p);
+        if (bias_ptr)
+            _em = _mm_add_ps(_em, _mm_loadu_ps(bias_ptr + p));
+        _mm_storeu_ps(outptr + p, _em);
+    }
+#endif // __SSE2__
+    for (; p < num_output; p++)
+    {
+        outptr[p] = bias_ptr ? em[p] + bias_ptr[p] : em[p];
+    }
+}
+
+#if NCNN_F16C && __AVX__
+static void embed_row_fp16s(const unsigned short* em, const float* bias_ptr, float* outptr, int num_output)
+{
+    int p = 0;
+#if __AVX512F__
+    for (; p + 15 < num_output; p += 16)
+    {
+        __m512 _em = _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(em + p)));
+        if (bias_ptr)
+            _em = _mm512_add_ps(_em, _mm512_loadu_ps(bias_ptr + p));
+        _mm512_storeu_ps(outptr + p, _em);
+    }
+#endif // __AVX512F__
+#if __F16C__
+    for (; p + 7 < num_output; p += 8)
+    {
+        __m256 _em = _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(em + p)));
+        if (bias_ptr)
+            _em = _mm256_add_ps(_em, _mm256_loadu_ps(bias_ptr + p));
+        _mm256_storeu_ps(outptr + p, _em);
+    }
+#endif // __F16C__
+    for (; p < num_output; p++)
+    {
+        const float v = float16_to_float32(em[p]);
+        outptr[p] = bias_ptr ? v + bias_ptr[p] : v;
+    }
+}
+#endif // NCNN_F16C && __AVX__
+
+#if NCNN_INT8
+static void embed_row_int8(const signed char* em, float descale_em, const float* bias_ptr, float* outptr, int num_output)
+{
+    int p = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        __m512 _descale = _mm512_set1_ps(descale_em);
+        for (; p + 15 < num_output; p += 16)
+        {
+            __m512 _em = _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i*)(em + p)))), _descale);
+            if (bias_ptr)
+                _em = _mm512_add_ps(_em, _mm512_loadu_ps(bias_ptr + p));
+            _mm512_storeu_ps(outptr + p, _em);
+        }
+    }
+#endif // __AVX512F__
+#if __AVX2__
+    {
+        __m256 _descale = _mm256_set1_ps(descale_em);
+        for (; p + 7 < num_output; p += 8)
+        {
+            __m256 _em = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i*)(em + p)))), _descale);
+            if (bias_ptr)
+                _em = _mm256_add_ps(_em, _mm256_loadu_ps(bias_ptr + p));
+            _mm256_storeu_ps(outptr + p, _em);
+        }
+    }
+#endif // __AVX2__
+#endif // __AVX__
+#if __SSE4_1__
+    {
+        __m128 _descale = _mm_set1_ps(descale_em);
+        for (; p + 3 < num_output; p += 4)
+        {
+            int v;
+            memcpy(&v, em + p, 4);
+            __m128 _em = _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtepi8_epi32(_mm_cvtsi32_si128(v))), _descale);
+            if (bias_ptr)
+                _em = _mm_add_ps(_em, _mm_loadu_ps(bias_ptr + p));
+            _mm_storeu_ps(outptr + p, _em);
+        }
+    }
+#endif // __SSE4_1__
+#endif // __SSE2__
+    for (; p < num_output; p++)
+    {
+        outptr[p] = bias_ptr ? em[p] * descale_em + bias_ptr[p] : em[p] * descale_em;
+    }
+}
+#endif // NCNN_INT8
+
+int Embed_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int words = bottom_blob.w;
+
+    top_blob.create(num_output, words, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const float* bias_ptr = bias_term ? (const float*)bias_data : 0;
+
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        const float descale_em = 1.f / weight_data_int8_scale;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < words; q++)
+        {
+            const int word_index = embed_word_index(bottom_blob, q, input_dim);
+
+            embed_row_int8((const signed char*)weight_data + num_output * word_index, descale_em, bias_ptr, top_blob.row(q), num_output);
+        }
+
+        return 0;
+    }
+#endif // NCNN_INT8
+
+#if NCNN_F16C && __AVX__
+    if (!weight_data_tm.empty())
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < words; q++)
+        {
+            const int word_index = embed_word_index(bottom_blob, q, input_dim);
+
+            embed_row_fp16s((const unsigned short*)weight_data_tm + num_output * word_index, bias_ptr, top_blob.row(q), num_output);
+        }
+
+        return 0;
+    }
+#endif // NCNN_F16C && __AVX__
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < words; q++)
+    {
+        const int word_index = embed_word_index(bottom_blob, q, input_dim);
+
+        embed_row((const float*)weight_data + num_output * word_index, bias_ptr, top_blob.row(q), num_output);
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,27 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_EMBED_X86_H
+#define LAYER_EMBED_X86_H
+
+#include "embed.h"
+
+namespace ncnn {
+
+class Embed_x86 : public Embed
+{
+public:
+    Embed_x86();
+
+    virtual int create_pipeline(const Option& opt);
+
+    virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+public:
+    // fp16 table when fp16 storage is enabled, dequantized during the gather
+    Mat weight_data_tm;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_EMBED_X86_H
@@ -0,0 +1,58 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// one pixel of elempack fp16 lanes to and from fp32
+
+static NCNN_FORCEINLINE void load_fp16s_pixel(const unsigned short* ptr, float* v, int elempack)
+{
+#if __F16C__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        _mm512_storeu_ps(v, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)ptr)));
+        return;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        _mm256_storeu_ps(v, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)ptr)));
+        return;
+    }
+    if (elempack == 4)
+    {
+        _mm_storeu_ps(v, _mm_cvtph_ps(_mm_loadl_epi64((const __m128i*)ptr)));
+        return;
+    }
+#endif // __F16C__
+    for (int k = 0; k < elempack; k++)
+    {
+        v[k] = float16_to_float32(ptr[k]);
+    }
+}
+
+static NCNN_FORCEINLINE void store_fp16s_pixel(const float* v, unsigned short* ptr, int elempack)
+{
+#if __F16C__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        _mm256_storeu_si256((__m256i*)ptr, _mm512_cvtps_ph(_mm512_loadu_ps(v), _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC));
+        return;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        _mm_storeu_si128((__m128i*)ptr, _mm256_cvtps_ph(_mm256_loadu_ps(v), _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC));
+        return;
+    }
+    if (elempack == 4)
+    {
+        _mm_storel_epi64((__m128i*)ptr, _mm_cvtps_ph(_mm_loadu_ps(v), _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC));
+        return;
+    }
+#endif // __F16C__
+    for (int k = 0; k < elempack; k++)
+    {
+        ptr[k] = float32_to_float16(v[k]);
+    }
+}
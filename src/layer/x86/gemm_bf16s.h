@@ -0,0 +1,410 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// bf16 storage gemm as dot products along K
+// A holds M rows and B holds N rows of K contiguous bf16 values, accumulation is fp32
+// top(i, j) = activation((dot(A[i], B[j]) + C(i, j)) * alpha) rounded to bf16
+// top(i, j) lives at top[i * top_istep + j * top_jstep], C(i, j) at C[i * C_istep + j * C_jstep]
+
+template<int MR, int NR>
+static void gemm_dot_bf16s_block(const unsigned short* A, size_t A_hstep, const unsigned short* B, size_t B_hstep, int K, float* sums)
+{
+    int kk = 0;
+#if __SSE2__
+#if __AVX512F__
+    __m512 _sum[MR][NR];
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            _sum[i][j] = _mm512_setzero_ps();
+        }
+    }
+#if __AVX512BF16__
+    for (; kk + 31 < K; kk += 32)
+    {
+        __m512i _a[MR];
+        for (int i = 0; i < MR; i++)
+        {
+            _a[i] = _mm512_loadu_si512((const __m512i*)(A + i * A_hstep + kk));
+        }
+        for (int j = 0; j < NR; j++)
+        {
+            __m512i _b = _mm512_loadu_si512((const __m512i*)(B + j * B_hstep + kk));
+            for (int i = 0; i < MR; i++)
+            {
+                _sum[i][j] = _mm512_dpbf16_ps(_sum[i][j], (__m512bh)_a[i], (__m512bh)_b);
+            }
+        }
+    }
+    if (kk < K)
+    {
+        // zero filled tail
+        const __mmask32 _mask = (__mmask32)((1u << (K - kk)) - 1);
+        __m512i _a[MR];
+        for (int i = 0; i < MR; i++)
+        {
+            _a[i] = _mm512_maskz_loadu_epi16(_mask, A + i * A_hstep + kk);
+        }
+        for (int j = 0; j < NR; j++)
+        {
+            __m512i _b = _mm512_maskz_loadu_epi16(_mask, B + j * B_hstep + kk);
+            for (int i = 0; i < MR; i++)
+            {
+                _sum[i][j] = _mm512_dpbf16_ps(_sum[i][j], (__m512bh)_a[i], (__m512bh)_b);
+            }
+        }
+        kk = K;
+    }
+#else  // __AVX512BF16__
+    for (; kk + 15 < K; kk += 16)
+    {
+        __m512 _a[MR];
+        for (int i = 0; i < MR; i++)
+        {
+            _a[i] = bfloat2float_avx512(_mm256_loadu_si256((const __m256i*)(A + i * A_hstep + kk)));
+        }
+        for (int j = 0; j < NR; j++)
+        {
+            __m512 _b = bfloat2float_avx512(_mm256_loadu_si256((const __m256i*)(B + j * B_hstep + kk)));
+            for (int i = 0; i < MR; i++)
+            {
+                _sum[i][j] = _mm512_fmadd_ps(_a[i], _b, _sum[i][j]);
+            }
+        }
+    }
+    if (kk < K)
+    {
+        // zero filled tail
+        const __mmask16 _mask = (__mmask16)((1u << (K - kk)) - 1);
+        __m512 _a[MR];
+        for (int i = 0; i < MR; i++)
+        {
+            _a[i] = bfloat2float_avx512(_mm256_maskz_loadu_epi16(_mask, A + i * A_hstep + kk));
+        }
+        for (int j = 0; j < NR; j++)
+        {
+            __m512 _b = bfloat2float_avx512(_mm256_maskz_loadu_epi16(_mask, B + j * B_hstep + kk));
+            for (int i = 0; i < MR; i++)
+            {
+                _sum[i][j] = _mm512_fmadd_ps(_a[i], _b, _sum[i][j]);
+            }
+        }
+        kk = K;
+    }
+#endif // __AVX512BF16__
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            sums[i * NR + j] = _mm512_comp_reduce_add_ps(_sum[i][j]);
+        }
+    }
+#elif __AVX__
+    __m256 _sum[MR][NR];
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            _sum[i][j] = _mm256_setzero_ps();
+        }
+    }
+    for (; kk + 7 < K; kk += 8)
+    {
+        __m256 _a[MR];
+        for (int i = 0; i < MR; i++)
+        {
+            _a[i] = bfloat2float_avx(_mm_loadu_si128((const __m128i*)(A + i * A_hstep + kk)));
+        }
+        for (int j = 0; j < NR; j++)
+        {
+            __m256 _b = bfloat2float_avx(_mm_loadu_si128((const __m128i*)(B + j * B_hstep + kk)));
+            for (int i = 0; i < MR; i++)
+            {
+                _sum[i][j] = _mm256_comp_fmadd_ps(_a[i], _b, _sum[i][j]);
+            }
+        }
+    }
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            sums[i * NR + j] = _mm256_reduce_add_ps(_sum[i][j]);
+        }
+    }
+#else
+    __m128 _sum[MR][NR];
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            _sum[i][j] = _mm_setzero_ps();
+        }
+    }
+    for (; kk + 3 < K; kk += 4)
+    {
+        __m128 _a[MR];
+        for (int i = 0; i < MR; i++)
+        {
+            _a[i] = bfloat2float_sse(_mm_loadl_epi64((const __m128i*)(A + i * A_hstep + kk)));
+        }
+        for (int j = 0; j < NR; j++)
+        {
+            __m128 _b = bfloat2float_sse(_mm_loadl_epi64((const __m128i*)(B + j * B_hstep + kk)));
+            for (int i = 0; i < MR; i++)
+            {
+                _sum[i][j] = _mm_comp_fmadd_ps(_a[i], _b, _sum[i][j]);
+            }
+        }
+    }
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            sums[i * NR + j] = _mm_reduce_add_ps(_sum[i][j]);
+        }
+    }
+#endif
+#else  // __SSE2__
+    for (int i = 0; i < MR * NR; i++)
+    {
+        sums[i] = 0.f;
+    }
+#endif // __SSE2__
+    for (; kk < K; kk++)
+    {
+        for (int i = 0; i < MR; i++)
+        {
+            const float a = bfloat16_to_float32(A[i * A_hstep + kk]);
+            for (int j = 0; j < NR; j++)
+            {
+                sums[i * NR + j] += a * bfloat16_to_float32(B[j * B_hstep + kk]);
+            }
+        }
+    }
+}
+
+template<int MR, int NR>
+static void gemm_dot_bf16s_store(const float* sums, unsigned short* top, size_t top_istep, size_t top_jstep, const float* C, size_t C_istep, size_t C_jstep, float alpha, int activation_type, const Mat& activation_params)
+{
+    for (int i = 0; i < MR; i++)
+    {
+        for (int j = 0; j < NR; j++)
+        {
+            float v = sums[i * NR + j];
+            if (C)
+                v += C[i * C_istep + j * C_jstep];
+
+            v = activation_ss(v * alpha, activation_type, activation_params);
+
+            top[i * top_istep + j * top_jstep] = float32_to_bfloat16(v);
+        }
+    }
+}
+
+// the tile kernels take B as zero padded panels of 16 rows, panel jj / 16 starts at B_tm + jj * Kp
+// each panel holds Kp / 2 rows of 16 k pairs, the layout tdpbf16ps expects, Kp is K rounded up to 32
+static int gemm_dot_bf16s_amx_supported()
+{
+#if (NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__) || __AMX_BF16__
+    return ncnn::cpu_support_x86_amx_bf16();
+#else
+    return 0;
+#endif
+}
+
+static void gemm_dot_bf16s_pack_B_amx(const unsigned short* B, size_t B_hstep, int N, int K, unsigned short* B_tm, int nT)
+{
+    const int Kp = (K + 31) / 32 * 32;
+    const int nn_N = (N + 15) / 16;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int pj = 0; pj < nn_N; pj++)
+    {
+        const int jj = pj * 16;
+        const int max_j = std::min(N - jj, 16);
+
+        unsigned short* pB = B_tm + (size_t)jj * Kp;
+        for (int k = 0; k < Kp; k += 2)
+        {
+            for (int j = 0; j < 16; j++)
+            {
+                const unsigned short* p = B + (jj + std::min(j, max_j - 1)) * B_hstep;
+                pB[0] = j < max_j && k < K ? p[k] : 0;
+                pB[1] = j < max_j && k + 1 < K ? p[k + 1] : 0;
+                pB += 2;
+            }
+        }
+    }
+}
+
+#if __AMX_BF16__
+// tmm0 accumulates a 16 x 16 fp32 block, tmm1 holds 16 A rows of 32 bf16, tmm2 one 32 k slice of a B panel
+// the tile state is configured by the caller
+static NCNN_FORCEINLINE void gemm_dot_bf16s_block_amx(const unsigned short* A, size_t A_hstep, const unsigned short* B_tm, int Kp, float* sums)
+{
+    _tile_zero(0);
+    for (int kk = 0; kk < Kp; kk += 32)
+    {
+        _tile_loadd(1, A + kk, (long)(A_hstep * 2));
+        _tile_loadd(2, B_tm + kk * 16, 64);
+        _tile_dpbf16ps(0, 1, 2);
+    }
+    _tile_stored(0, sums, 64);
+}
+
+// B_tm from gemm_dot_bf16s_pack_B_amx, A is copied into zero padded rows only when M or K does not fill whole tiles
+static int gemm_dot_bf16s_amx(const unsigned short* A, size_t A_hstep, const unsigned short* B_tm, unsigned short* top, size_t top_istep, size_t top_jstep, const float* C, size_t C_istep, size_t C_jstep, int M, int N, int K, float alpha, int activation_type, const Mat& activation_params, int nT)
+{
+    const int Kp = (K + 31) / 32 * 32;
+    const int nn_M = (M + 15) / 16;
+    const int nn_N = (N + 15) / 16;
+
+    Mat A_tm;
+    if (M % 16 != 0 || K % 32 != 0)
+    {
+        A_tm.create(Kp, nn_M * 16, (size_t)2u);
+        if (A_tm.empty())
+            return -100;
+
+        #pragma omp parallel for num_threads(nT)
+        for (int i = 0; i < nn_M * 16; i++)
+        {
+            unsigned short* outptr = A_tm.row<unsigned short>(i);
+            for (int k = 0; k < Kp; k++)
+            {
+                outptr[k] = i < M && k < K ? A[i * A_hstep + k] : 0;
+            }
+        }
+
+        A = A_tm;
+        A_hstep = Kp;
+    }
+
+    // one contiguous range of blocks per thread so the tile state is configured once per thread
+    // blocks sharing a B panel are adjacent, each panel streams from memory once
+    const int nn = nn_M * nn_N;
+    nT = std::min(nT, nn);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
+    {
+        const int start = (int)((long long)nn * t / nT);
+        const int end = (int)((long long)nn * (t + 1) / nT);
+
+        float sums[16 * 16];
+
+        amx_tile_config_16x64(3);
+
+        for (int ppij = start; ppij < end; ppij++)
+        {
+            const int ii = ppij % nn_M * 16;
+            const int jj = ppij / nn_M * 16;
+
+            const int max_i = std::min(M - ii, 16);
+            const int max_j = std::min(N - jj, 16);
+
+            gemm_dot_bf16s_block_amx(A + ii * A_hstep, A_hstep, B_tm + (size_t)jj * Kp, Kp, sums);
+
+            for (int i = 0; i < max_i; i++)
+            {
+                for (int j = 0; j < max_j; j++)
+                {
+                    float v = sums[i * 16 + j];
+                    if (C)
+                        v += C[(ii + i) * C_istep + (jj + j) * C_jstep];
+
+                    v = activation_ss(v * alpha, activation_type, activation_params);
+
+                    top[(ii + i) * top_istep + (jj + j) * top_jstep] = float32_to_bfloat16(v);
+                }
+            }
+        }
+
+        _tile_release();
+    }
+
+    return 0;
+}
+#endif // __AMX_BF16__
+
+static void gemm_dot_bf16s_tile(const unsigned short* A, size_t A_hstep, const unsigned short* B, size_t B_hstep, unsigned short* top, size_t top_istep, size_t top_jstep, const float* C, size_t C_istep, size_t C_jstep, int max_ii, int max_jj, int K, float alpha, int activation_type, const Mat& activation_params)
+{
+    float sums[16];
+
+    int ii = 0;
+    for (; ii + 3 < max_ii; ii += 4)
+    {
+        const unsigned short* pA = A + ii * A_hstep;
+        const float* pC = C ? C + ii * C_istep : 0;
+
+        int jj = 0;
+        for (; jj + 3 < max_jj; jj += 4)
+        {
+            gemm_dot_bf16s_block<4, 4>(pA, A_hstep, B + jj * B_hstep, B_hstep, K, sums);
+            gemm_dot_bf16s_store<4, 4>(sums, top + ii * top_istep + jj * top_jstep, top_istep, top_jstep, pC ? pC + jj * C_jstep : 0, C_istep, C_jstep, alpha, activation_type, activation_params);
+        }
+        for (; jj < max_jj; jj++)
+        {
+            gemm_dot_bf16s_block<4, 1>(pA, A_hstep, B + jj * B_hstep, B_hstep, K, sums);
+            gemm_dot_bf16s_store<4, 1>(sums, top + ii * top_istep + jj * top_jstep, top_istep, top_jstep, pC ? pC + jj * C_jstep : 0, C_istep, C_jstep, alpha, activation_type, activation_params);
+        }
+    }
+    for (; ii < max_ii; ii++)
+    {
+        const unsigned short* pA = A + ii * A_hstep;
+        const float* pC = C ? C + ii * C_istep : 0;
+
+        int jj = 0;
+        for (; jj + 3 < max_jj; jj += 4)
+        {
+            gemm_dot_bf16s_block<1, 4>(pA, A_hstep, B + jj * B_hstep, B_hstep, K, sums);
+            gemm_dot_bf16s_store<1, 4>(sums, top + ii * top_istep + jj * top_jstep, top_istep, top_jstep, pC ? pC + jj * C_jstep : 0, C_istep, C_jstep, alpha, activation_type, activation_params);
+        }
+        for (; jj < max_jj; jj++)
+        {
+            gemm_dot_bf16s_block<1, 1>(pA, A_hstep, B + jj * B_hstep, B_hstep, K, sums);
+            gemm_dot_bf16s_store<1, 1>(sums, top + ii * top_istep + jj * top_jstep, top_istep, top_jstep, pC ? pC + jj * C_jstep : 0, C_istep, C_jstep, alpha, activation_type, activation_params);
+        }
+    }
+}
+
+// the whole M x N product, tiles run in parallel
+static void gemm_dot_bf16s(const unsigned short* A, size_t A_hstep, const unsigned short* B, size_t B_hstep, unsigned short* top, size_t top_istep, size_t top_jstep, const float* C, size_t C_istep, size_t C_jstep, int M, int N, int K, float alpha, int activation_type, const Mat& activation_params, int nT)
+{
+#if __AMX_BF16__
+    // too few rows or columns waste most of the tile, keep them on the dot product kernels
+    if (M >= 8 && N >= 8 && cpu_support_x86_amx_bf16())
+    {
+        // B is packed once for all tiles
+        Mat B_tm((K + 31) / 32 * 32 * 16, (N + 15) / 16, (size_t)2u);
+        if (!B_tm.empty())
+        {
+            gemm_dot_bf16s_pack_B_amx(B, B_hstep, N, K, B_tm, nT);
+
+            if (gemm_dot_bf16s_amx(A, A_hstep, B_tm, top, top_istep, top_jstep, C, C_istep, C_jstep, M, N, K, alpha, activation_type, activation_params, nT) == 0)
+                return;
+        }
+    }
+#endif // __AMX_BF16__
+
+    const int TILE_M = 32;
+    const int TILE_N = 32;
+
+    const int nn_M = (M + TILE_M - 1) / TILE_M;
+    const int nn_N = (N + TILE_N - 1) / TILE_N;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int ppij = 0; ppij < nn_M * nn_N; ppij++)
+    {
+        const int i = ppij / nn_N * TILE_M;
+        const int j = ppij % nn_N * TILE_N;
+
+        const int max_ii = std::min(M - i, TILE_M);
+        const int max_jj = std::min(N - j, TILE_N);
+
+        const float* pC = C ? C + i * C_istep + j * C_jstep : 0;
+
+        gemm_dot_bf16s_tile(A + i * A_hstep, A_hstep, B + j * B_hstep, B_hstep, top + i * top_istep + j * top_jstep, top_istep, top_jstep, pC, C_istep, C_jstep, max_ii, max_jj, K, alpha, activation_type, activation_params);
+    }
+}
@@ -12469,6 +12469,9 @@ static void unpack_output_tile_int32_to_fp32(const Mat& topT, const Mat& C, Mat&
     }
 }
 
+// shared by Gemm and the Convolution im2col-gemm, amx int8 is not used here
+// the packed panels interleave k quads along both A and B and the accumulators are kept in a rotated layout,
+// while tdpbusd wants one operand as plain rows of 64 k, an amx path needs its own packing and output unpacking
 static void gemm_transB_packed_tile_int8(const Mat& AT_tile, const Mat& BT_tile, Mat& topT_tile, int i, int max_ii, int j, int max_jj, int k, int max_kk)
 {
 #if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
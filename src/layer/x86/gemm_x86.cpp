@@ -14,8 +14,11 @@
 #endif // __AVX512F__
 #endif // __AVX__
 #endif // __SSE2__
+#include "x86_activation.h"
 #include "x86_usability.h"
 
+#include "weight_quant.h"
+
 #include "cpu.h"
 
 namespace ncnn {
@@ -24,11 +27,21 @@ namespace ncnn {
 #include "gemm_int8.h"
 #endif
 
+#include "innerproduct_weight_quant.h"
+
+#if NCNN_BF16
+#include "gemm_bf16s.h"
+#include "gemm_x86_bf16s.h"
+#endif
+
 Gemm_x86::Gemm_x86()
 {
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_BF16
+    support_bf16_storage = true;
+#endif
 
     nT = 0;
 }
@@ -6651,7 +6664,7 @@ static void get_optimal_tile_mnk(int M, int N, int K, int constant_TILE_M, int c
     }
 }
 
-static int gemm_x86(const Mat& A, const Mat& B, const Mat& C, Mat& top_blob, int broadcast_type_C, int transA, int transB, int output_transpose, int constant_TILE_M, int constant_TILE_N, int constant_TILE_K, int nT, const Option& opt)
+static int gemm_x86(const Mat& A, const Mat& B, const Mat& C, Mat& top_blob, int broadcast_type_C, int transA, int transB, int output_transpose, int TILE_M, int TILE_N, int TILE_K, int nT, const Option& opt)
 {
     const int M = transA ? A.w : (A.dims == 3 ? A.c : A.h) * A.elempack;
     const int K = transA ? (A.dims == 3 ? A.c : A.h) * A.elempack : A.w;
@@ -6659,9 +6672,6 @@ static int gemm_x86(const Mat& A, const Mat& B, const Mat& C, Mat& top_blob, int
 
     // NCNN_LOGE("M/N/K = %d %d %d", M, N, K);
 
-    int TILE_M, TILE_N, TILE_K;
-    get_optimal_tile_mnk(M, N, K, constant_TILE_M, constant_TILE_N, constant_TILE_K, TILE_M, TILE_N, TILE_K, nT);
-
     // NCNN_LOGE("TILE M/N/K = %d %d %d", TILE_M, TILE_N, TILE_K);
 
     const int nn_M = (M + TILE_M - 1) / TILE_M;
@@ -6857,15 +6867,12 @@ static int gemm_x86(const Mat& A, const Mat& B, const Mat& C, Mat& top_blob, int
     return 0;
 }
 
-static int gemm_AT_x86(const Mat& AT, const Mat& B, const Mat& C, Mat& top_blob, int broadcast_type_C, int M, int K, int transB, int output_transpose, int constant_TILE_M, int constant_TILE_N, int constant_TILE_K, int nT, const Option& opt)
+static int gemm_AT_x86(const Mat& AT, const Mat& B, const Mat& C, Mat& top_blob, int broadcast_type_C, int M, int K, int transB, int output_transpose, int TILE_M, int TILE_N, int TILE_K, int nT, const Option& opt)
 {
     const int N = transB ? (B.dims == 3 ? B.c : B.h) * B.elempack : B.w;
 
     // NCNN_LOGE("M/N/K = %d %d %d", M, N, K);
 
-    int TILE_M, TILE_N, TILE_K;
-    get_optimal_tile_mnk(M, N, K, constant_TILE_M, constant_TILE_N, constant_TILE_K, TILE_M, TILE_N, TILE_K, nT);
-
     // NCNN_LOGE("TILE M/N/K = %d %d %d", TILE_M, TILE_N, TILE_K);
 
     const int nn_M = (M + TILE_M - 1) / TILE_M;
@@ -6958,15 +6965,12 @@ static int gemm_AT_x86(const Mat& AT, const Mat& B, const Mat& C, Mat& top_blob,
     return 0;
 }
 
-static int gemm_BT_x86(const Mat& A, const Mat& BT, const Mat& C, Mat& top_blob, int broadcast_type_C, int N, int K, int transA, int output_transpose, int constant_TILE_M, int constant_TILE_N, int constant_TILE_K, int nT, const Option& opt)
+static int gemm_BT_x86(const Mat& A, const Mat& BT, const Mat& C, Mat& top_blob, int broadcast_type_C, int N, int K, int transA, int output_transpose, int TILE_M, int TILE_N, int TILE_K, int nT, const Option& opt)
 {
     const int M = transA ? A.w : (A.dims == 3 ? A.c : A.h) * A.elempack;
 
     // NCNN_LOGE("M/N/K = %d %d %d", M, N, K);
 
-    int TILE_M, TILE_N, TILE_K;
-    get_optimal_tile_mnk(M, N, K, constant_TILE_M, constant_TILE_N, constant_TILE_K, TILE_M, TILE_N, TILE_K, nT);
-
     // NCNN_LOGE("TILE M/N/K = %d %d %d", TILE_M, TILE_N, TILE_K);
 
     const int nn_M = (M + TILE_M - 1) / TILE_M;
@@ -7132,13 +7136,10 @@ static int gemm_BT_x86(const Mat& A, const Mat& BT, const Mat& C, Mat& top_blob,
     return 0;
 }
 
-static int gemm_AT_BT_x86(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_blob, int broadcast_type_C, int M, int N, int K, int output_transpose, int constant_TILE_M, int constant_TILE_N, int constant_TILE_K, int nT, const Option& opt)
+static int gemm_AT_BT_x86(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_blob, int broadcast_type_C, int M, int N, int K, int output_transpose, int TILE_M, int TILE_N, int TILE_K, int nT, const Option& opt)
 {
     // NCNN_LOGE("M/N/K = %d %d %d", M, N, K);
 
-    int TILE_M, TILE_N, TILE_K;
-    get_optimal_tile_mnk(M, N, K, constant_TILE_M, constant_TILE_N, constant_TILE_K, TILE_M, TILE_N, TILE_K, nT);
-
     // NCNN_LOGE("TILE M/N/K = %d %d %d", TILE_M, TILE_N, TILE_K);
 
     const int nn_M = (M + TILE_M - 1) / TILE_M;
@@ -7202,13 +7203,55 @@ static int gemm_AT_BT_x86(const Mat& AT, const Mat& BT, const Mat& C, Mat& top_b
 
 int Gemm_x86::create_pipeline(const Option& opt)
 {
+    // the linear layer case, other cases decode the weights once and run the fp32 path
+    if (weight_quant_bits && !constantA && !transA && !output_transpose && constantC && (constant_broadcast_type_C == -1 || constant_broadcast_type_C == 0 || constant_broadcast_type_C == 4))
+    {
+        support_bf16_storage = false;
+        return create_pipeline_weight_quant(opt);
+    }
+
+    if (weight_quant_bits)
+    {
+        Mat B_data_fp32;
+        if (weight_quant_unpack(B_data, B_data_quant_scales, B_data_fp32, constantK * constantN, constantK, weight_quant_group_size, weight_quant_bits) != 0)
+            return -100;
+
+        B_data = B_data_fp32.reshape(constantK, constantN);
+        B_data_quant_scales.release();
+        weight_quant_bits = 0;
+    }
+
 #if NCNN_INT8
     if (int8_scale_term)
     {
+        support_bf16_storage = false;
         return create_pipeline_int8(opt);
     }
 #endif
 
+#if NCNN_BF16
+    if (opt.use_bf16_storage && support_bf16_storage)
+    {
+        return create_pipeline_bf16s(opt);
+    }
+#endif
+
+    if (!AT_data.empty() || !BT_data.empty() || !CT_data.empty())
+    {
+        // restored from opt.weight_cache
+        if (opt.lightmode)
+        {
+            A_data.release();
+            B_data.release();
+            C_data.release();
+        }
+
+        nT = opt.num_threads;
+        shape_cache = new ShapeCache;
+
+        return 0;
+    }
+
     if (constantA)
     {
         const int M = constantM;
@@ -7343,11 +7386,39 @@ int Gemm_x86::create_pipeline(const Option& opt)
         nT = opt.num_threads;
     }
 
+    shape_cache = new ShapeCache;
+
+    return 0;
+}
+
+int Gemm_x86::destroy_pipeline(const Option& /*opt*/)
+{
+    delete shape_cache;
+    shape_cache = 0;
+
+    return 0;
+}
+
+int Gemm_x86::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    if (!constantA && !constantB && !constantC)
+        return 0;
+
+    weights.push_back(&AT_data);
+    weights.push_back(&BT_data);
+    weights.push_back(&CT_data);
+    weights.push_back(&BT_quant_scales);
+
     return 0;
 }
 
 int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+    if (!BT_quant_scales.empty())
+    {
+        return forward_weight_quant(bottom_blobs, top_blobs, opt);
+    }
+
 #if NCNN_INT8
     if (int8_scale_term)
     {
@@ -7356,24 +7427,35 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     }
 #endif
 
+#if NCNN_BF16
+    if (opt.use_bf16_storage && support_bf16_storage)
+    {
+        return forward_bf16s(bottom_blobs, top_blobs, opt);
+    }
+#endif
+
     int M;
     int N;
+    int K;
     if (constantA && constantB)
     {
         M = constantM;
         N = constantN;
+        K = constantK;
     }
     else if (constantA)
     {
         const Mat& B = bottom_blobs[0];
         M = constantM;
         N = transB ? (B.dims == 3 ? B.c : B.h) * B.elempack : B.w;
+        K = constantK;
     }
     else if (constantB)
     {
         const Mat& A = bottom_blobs[0];
         M = transA ? A.w : (A.dims == 3 ? A.c : A.h) * A.elempack;
         N = constantN;
+        K = constantK;
     }
     else
     {
@@ -7381,6 +7463,7 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
         const Mat& B = bottom_blobs[1];
         M = transA ? A.w : (A.dims == 3 ? A.c : A.h) * A.elempack;
         N = transB ? (B.dims == 3 ? B.c : B.h) * B.elempack : B.w;
+        K = transA ? (A.dims == 3 ? A.c : A.h) * A.elempack : A.w;
     }
 
     Mat C;
@@ -7506,26 +7589,49 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
         NCNN_LOGE("opt.num_threads %d changed, gemm will use load-time value %d", opt.num_threads, nT);
     }
 
+    // tile sizes and workspace layout of this shape
+    int TILE_M, TILE_N, TILE_K;
+    {
+        int key[ShapeCache::key_size] = {M, N, K, _nT, 0, 0, 0, 0};
+        int spec[ShapeCache::value_size];
+        if (shape_cache && shape_cache->find(key, spec) == 0)
+        {
+            TILE_M = spec[1];
+            TILE_N = spec[2];
+            TILE_K = spec[3];
+        }
+        else
+        {
+            get_optimal_tile_mnk(M, N, K, constant_TILE_M, constant_TILE_N, constant_TILE_K, TILE_M, TILE_N, TILE_K, _nT);
+
+            if (shape_cache)
+            {
+                int value[ShapeCache::value_size] = {0, TILE_M, TILE_N, TILE_K, 0, 0, 0, 0};
+                shape_cache->insert(key, value);
+            }
+        }
+    }
+
     int ret = 0;
     if (constantA && constantB)
     {
-        ret = gemm_AT_BT_x86(AT_data, BT_data, C, top_blob, broadcast_type_C, constantM, constantN, constantK, output_transpose, constant_TILE_M, constant_TILE_N, constant_TILE_K, _nT, opt);
+        ret = gemm_AT_BT_x86(AT_data, BT_data, C, top_blob, broadcast_type_C, constantM, constantN, constantK, output_transpose, TILE_M, TILE_N, TILE_K, _nT, opt);
     }
     else if (constantA)
     {
         const Mat& B = bottom_blobs[0];
-        ret = gemm_AT_x86(AT_data, B, C, top_blob, broadcast_type_C, constantM, constantK, transB, output_transpose, constant_TILE_M, constant_TILE_N, constant_TILE_K, _nT, opt);
+        ret = gemm_AT_x86(AT_data, B, C, top_blob, broadcast_type_C, constantM, constantK, transB, output_transpose, TILE_M, TILE_N, TILE_K, _nT, opt);
     }
     else if (constantB)
     {
         const Mat& A = bottom_blobs[0];
-        ret = gemm_BT_x86(A, BT_data, C, top_blob, broadcast_type_C, constantN, constantK, transA, output_transpose, constant_TILE_M, constant_TILE_N, constant_TILE_K, _nT, opt);
+        ret = gemm_BT_x86(A, BT_data, C, top_blob, broadcast_type_C, constantN, constantK, transA, output_transpose, TILE_M, TILE_N, TILE_K, _nT, opt);
     }
     else
     {
         const Mat& A = bottom_blobs[0];
         const Mat& B = bottom_blobs[1];
-        ret = gemm_x86(A, B, C, top_blob, broadcast_type_C, transA, transB, output_transpose, constant_TILE_M, constant_TILE_N, constant_TILE_K, _nT, opt);
+        ret = gemm_x86(A, B, C, top_blob, broadcast_type_C, transA, transB, output_transpose, TILE_M, TILE_N, TILE_K, _nT, opt);
     }
     if (ret != 0)
         return ret;
@@ -7545,6 +7651,390 @@ int Gemm_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     return 0;
 }
 
+#if NCNN_BF16
+// cast to bf16 elempack 1 and lay out as rows of K contiguous values
+static int gemm_x86_transform_bf16s(const Mat& X, Mat& XT, int transpose, const Option& opt)
+{
+    Mat X_bf16 = X;
+    if (X.elembits() == 32)
+    {
+        cast_float32_to_bfloat16(X, X_bf16, opt);
+        if (X_bf16.empty())
+            return -100;
+    }
+
+    Mat X_unpacked = X_bf16;
+    if (X_bf16.elempack != 1)
+    {
+        convert_packing(X_bf16, X_unpacked, 1, opt);
+        if (X_unpacked.empty())
+            return -100;
+    }
+
+    if (X_unpacked.dims == 3)
+    {
+        Mat X_2d = X_unpacked.reshape(X_unpacked.w * X_unpacked.h, X_unpacked.c, opt.blob_allocator);
+        if (X_2d.empty())
+            return -100;
+
+        X_unpacked = X_2d;
+    }
+
+    if (!transpose)
+    {
+        XT = X_unpacked;
+        return 0;
+    }
+
+    const int w = X_unpacked.w;
+    const int h = X_unpacked.h;
+
+    XT.create(h, w, 2u, opt.blob_allocator);
+    if (XT.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int i = 0; i < w; i++)
+    {
+        unsigned short* outptr = XT.row<unsigned short>(i);
+
+        for (int k = 0; k < h; k++)
+        {
+            outptr[k] = X_unpacked.row<const unsigned short>(k)[i];
+        }
+    }
+
+    return 0;
+}
+
+int Gemm_x86::create_pipeline_bf16s(const Option& opt)
+{
+    if (!AT_data.empty() || !BT_data.empty() || !CT_data.empty())
+    {
+        // restored from opt.weight_cache
+        if (opt.lightmode)
+        {
+            A_data.release();
+            B_data.release();
+            C_data.release();
+        }
+
+        return 0;
+    }
+
+    Option opt_pipeline = opt;
+    opt_pipeline.blob_allocator = 0;
+
+    if (constantA)
+    {
+        int ret = gemm_x86_transform_bf16s(A_data, AT_data, transA, opt_pipeline);
+        if (ret != 0)
+            return ret;
+
+        if (opt.lightmode)
+            A_data.release();
+    }
+
+    if (constantB)
+    {
+        int ret = gemm_x86_transform_bf16s(B_data, BT_data, !transB, opt_pipeline);
+        if (ret != 0)
+            return ret;
+
+        if (opt.lightmode)
+            B_data.release();
+    }
+
+    if (constantC && constant_broadcast_type_C != -1)
+    {
+        // pre-multiply C with beta
+        CT_data = C_data.clone();
+        if (CT_data.empty())
+            return -100;
+
+        const int size = CT_data.total();
+        for (int i = 0; i < size; i++)
+        {
+            CT_data[i] *= beta;
+        }
+
+        if (opt.lightmode)
+            C_data.release();
+    }
+
+    return 0;
+}
+
+int Gemm_x86::forward_bf16s(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    // fp32 blobs come from layers running this gemm internally, the result goes back to fp32
+    const bool fp32_io = !bottom_blobs.empty() && bottom_blobs[0].elembits() == 32;
+
+    Mat AT;
+    Mat BT;
+    if (constantA)
+    {
+        AT = AT_data;
+    }
+    else
+    {
+        int ret = gemm_x86_transform_bf16s(bottom_blobs[0], AT, transA, opt_ws);
+        if (ret != 0)
+            return ret;
+    }
+    if (constantB)
+    {
+        BT = BT_data;
+    }
+    else
+    {
+        int ret = gemm_x86_transform_bf16s(bottom_blobs[constantA ? 0 : 1], BT, !transB, opt_ws);
+        if (ret != 0)
+            return ret;
+    }
+
+    const int M = AT.h;
+    const int N = BT.h;
+    const int K = AT.w;
+
+    Mat C;
+    int broadcast_type_C = -1;
+    if (constantC)
+    {
+        C = CT_data;
+        broadcast_type_C = constant_broadcast_type_C;
+    }
+    else
+    {
+        const size_t C_index = (constantA ? 0 : 1) + (constantB ? 0 : 1);
+        if (bottom_blobs.size() > C_index)
+        {
+            C = bottom_blobs[C_index];
+
+            if (C.elembits() == 16)
+            {
+                Mat C_fp32;
+                cast_bfloat16_to_float32(C, C_fp32, opt_ws);
+                if (C_fp32.empty())
+                    return -100;
+
+                C = C_fp32;
+            }
+
+            if (C.elempack != 1)
+            {
+                Mat C_unpacked;
+                convert_packing(C, C_unpacked, 1, opt_ws);
+                if (C_unpacked.empty())
+                    return -100;
+
+                C = C_unpacked;
+            }
+
+            if (C.dims == 1 && C.w == 1)
+            {
+                // scalar
+                broadcast_type_C = 0;
+            }
+            if (C.dims == 1 && C.w == M)
+            {
+                // M
+                broadcast_type_C = 1;
+            }
+            if (C.dims == 1 && C.w == N)
+            {
+                // N
+                broadcast_type_C = 4;
+            }
+            if (C.dims == 2 && C.w == 1 && C.h == M)
+            {
+                // Mx1
+                broadcast_type_C = 2;
+            }
+            if (C.dims == 2 && C.w == N && C.h == M)
+            {
+                // MxN
+                broadcast_type_C = 3;
+            }
+            if (C.dims == 2 && C.w == N && C.h == 1)
+            {
+                // 1xN
+                broadcast_type_C = 4;
+            }
+
+            // pre-multiply C with beta
+            if (beta != 1.f)
+            {
+                Mat C2;
+                C2.create_like(C, opt.workspace_allocator);
+                if (C2.empty())
+                    return -100;
+
+                const int size = C.total();
+                for (int i = 0; i < size; i++)
+                {
+                    C2[i] = C[i] * beta;
+                }
+
+                C = C2;
+            }
+        }
+    }
+
+    const float* pC = broadcast_type_C == -1 || C.empty() ? 0 : (const float*)C;
+    size_t C_istep = 0;
+    size_t C_jstep = 0;
+    if (broadcast_type_C == 1 || broadcast_type_C == 2)
+    {
+        C_istep = 1;
+    }
+    if (broadcast_type_C == 3)
+    {
+        C_istep = C.w;
+        C_jstep = 1;
+    }
+    if (broadcast_type_C == 4)
+    {
+        C_jstep = 1;
+    }
+
+    const int outw = output_transpose ? M : N;
+    const int outh = output_transpose ? N : M;
+
+    Mat top_blob_bf16;
+    Allocator* top_allocator = fp32_io || output_elempack > 1 ? opt.workspace_allocator : opt.blob_allocator;
+    if (output_N1M)
+        top_blob_bf16.create(outw, 1, outh, 2u, top_allocator);
+    else
+        top_blob_bf16.create(outw, outh, 2u, top_allocator);
+    if (top_blob_bf16.empty())
+        return -100;
+
+    const size_t hstep = output_N1M ? top_blob_bf16.cstep : (size_t)outw;
+    const size_t top_istep = output_transpose ? 1 : hstep;
+    const size_t top_jstep = output_transpose ? hstep : 1;
+
+    gemm_transB_bf16s(AT, BT, pC, C_istep, C_jstep, top_blob_bf16, top_istep, top_jstep, M, N, K, alpha, opt.num_threads);
+
+    Mat top_blob_unpacked = top_blob_bf16;
+    if (fp32_io)
+    {
+        Option opt_cast = output_elempack > 1 ? opt_ws : opt;
+        cast_bfloat16_to_float32(top_blob_bf16, top_blob_unpacked, opt_cast);
+        if (top_blob_unpacked.empty())
+            return -100;
+    }
+
+    Mat& top_blob = top_blobs[0];
+    if (output_elempack > 1)
+    {
+        convert_packing(top_blob_unpacked, top_blob, output_elempack, opt);
+        if (top_blob.empty())
+            return -100;
+    }
+    else
+    {
+        top_blob = top_blob_unpacked;
+    }
+
+    return 0;
+}
+#endif // NCNN_BF16
+
+int Gemm_x86::create_pipeline_weight_quant(const Option& opt)
+{
+    if (!BT_data.empty())
+    {
+        // restored from opt.weight_cache
+        if (opt.lightmode)
+        {
+            B_data.release();
+            C_data.release();
+        }
+
+        return 0;
+    }
+
+    innerproduct_transform_kernel_weight_quant_sse(B_data, B_data_quant_scales, BT_data, BT_quant_scales, constantK, constantN, weight_quant_bits, weight_quant_group_size, opt);
+
+    if (constant_broadcast_type_C != -1)
+    {
+        // C broadcast along N becomes the bias, pre-multiplied with beta
+        CT_data.create(constantN);
+        if (CT_data.empty())
+            return -100;
+
+        for (int j = 0; j < constantN; j++)
+        {
+            CT_data[j] = (constant_broadcast_type_C == 0 ? C_data[0] : C_data[j]) * beta;
+        }
+    }
+
+    if (opt.lightmode)
+    {
+        B_data.release();
+        C_data.release();
+    }
+
+    return 0;
+}
+
+int Gemm_x86::forward_weight_quant(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& A0 = bottom_blobs[0];
+
+    Mat A = A0;
+    if (A0.elempack != 1)
+    {
+        Option opt_ws = opt;
+        opt_ws.blob_allocator = opt.workspace_allocator;
+
+        convert_packing(A0, A, 1, opt_ws);
+        if (A.empty())
+            return -100;
+    }
+
+    const int M = A.dims == 3 ? A.c : A.h;
+    const int N = constantN;
+
+    Mat& top_blob = top_blobs[0];
+    if (output_N1M)
+        top_blob.create(N, 1, M, 4u, opt.blob_allocator);
+    else
+        top_blob.create(N, M, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    int ret = innerproduct_weight_quant_sse(A, top_blob, BT_data, BT_quant_scales, weight_quant_bits, weight_quant_group_size, CT_data, 0, Mat(), opt);
+    if (ret != 0)
+        return ret;
+
+    // multiply top_blob with alpha
+    if (alpha != 1.f)
+    {
+        const int size = top_blob.total();
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = 0; i < size; i++)
+        {
+            top_blob[i] *= alpha;
+        }
+    }
+
+    if (output_elempack > 1)
+    {
+        Mat top_blob_unpacked = top_blob;
+        convert_packing(top_blob_unpacked, top_blob, output_elempack, opt);
+        if (top_blob.empty())
+            return -100;
+    }
+
+    return 0;
+}
+
 #if NCNN_INT8
 static void compute_A_tile_int8_scales(const Mat& A, Mat& scales, float B_scale, Mat& out_descales, int i, int max_ii)
 {
@@ -8062,6 +8552,21 @@ static int gemm_AT_BT_x86_int8(const Mat& AT, const Mat& A_int8_scales, const Ma
 
 int Gemm_x86::create_pipeline_int8(const Option& opt)
 {
+    if (!AT_data.empty() || !BT_data.empty() || !CT_data.empty())
+    {
+        // restored from opt.weight_cache
+        if (opt.lightmode)
+        {
+            A_data.release();
+            B_data.release();
+            C_data.release();
+        }
+
+        nT = opt.num_threads;
+
+        return 0;
+    }
+
     if (constantA)
     {
         const int M = constantM;
@@ -14,10 +14,19 @@ public:
     Gemm_x86();
 
     virtual int create_pipeline(const Option& opt);
+    virtual int destroy_pipeline(const Option& opt);
+
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
 
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
 protected:
+    int create_pipeline_weight_quant(const Option& opt);
+    int forward_weight_quant(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+#if NCNN_BF16
+    int create_pipeline_bf16s(const Option& opt);
+    int forward_bf16s(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+#endif
 #if NCNN_INT8
     int create_pipeline_int8(const Option& opt);
     int forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
@@ -28,6 +37,9 @@ public:
     Mat AT_data;
     Mat BT_data;
     Mat CT_data;
+
+    // per group scales of the weight-only quantized BT_data
+    Mat BT_quant_scales;
 };
 
 // expose some gemm internal routines for convolution uses
@@ -0,0 +1,21 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "gemm_x86.h"
+
+#include "cpu.h"
+#include "mat.h"
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "gemm_bf16s.h"
+#include "gemm_x86_bf16s.h"
+
+void gemm_transB_bf16s_amxbf16(const Mat& AT, const Mat& BT, const float* C, size_t C_istep, size_t C_jstep, unsigned short* top, size_t top_istep, size_t top_jstep, int M, int N, int K, float alpha, int nT)
+{
+    gemm_transB_bf16s(AT, BT, C, C_istep, C_jstep, top, top_istep, top_jstep, M, N, K, alpha, nT);
+}
+
+} // namespace ncnn
@@ -0,0 +1,30 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__ && !__AMX_BF16__
+void gemm_transB_bf16s_amxbf16(const Mat& AT, const Mat& BT, const float* C, size_t C_istep, size_t C_jstep, unsigned short* top, size_t top_istep, size_t top_jstep, int M, int N, int K, float alpha, int nT);
+#endif
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+void gemm_transB_bf16s_avx512bf16(const Mat& AT, const Mat& BT, const float* C, size_t C_istep, size_t C_jstep, unsigned short* top, size_t top_istep, size_t top_jstep, int M, int N, int K, float alpha, int nT);
+#endif
+
+// AT holds M rows and BT holds N rows of K bf16 values with elempack 1
+static void gemm_transB_bf16s(const Mat& AT, const Mat& BT, const float* C, size_t C_istep, size_t C_jstep, unsigned short* top, size_t top_istep, size_t top_jstep, int M, int N, int K, float alpha, int nT)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__ && !__AMX_BF16__
+    if (ncnn::cpu_support_x86_amx_bf16())
+    {
+        gemm_transB_bf16s_amxbf16(AT, BT, C, C_istep, C_jstep, top, top_istep, top_jstep, M, N, K, alpha, nT);
+        return;
+    }
+#endif
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+    if (ncnn::cpu_support_x86_avx512_bf16())
+    {
+        gemm_transB_bf16s_avx512bf16(AT, BT, C, C_istep, C_jstep, top, top_istep, top_jstep, M, N, K, alpha, nT);
+        return;
+    }
+#endif
+
+    gemm_dot_bf16s(AT, AT.w, BT, BT.w, top, top_istep, top_jstep, C, C_istep, C_jstep, M, N, K, alpha, 0, Mat(), nT);
+}
@@ -0,0 +1,446 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+void gru_transform_weight_int8_avx512vnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+int gru_int8_avx512vnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+void gru_transform_weight_int8_avxvnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+int gru_int8_avxvnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+void gru_transform_weight_int8_avx2(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+int gru_int8_avx2(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt);
+#endif
+
+// hidden units are split into blocks of maxpack lanes, the last one zero padded
+static int gru_int8_maxpack()
+{
+#if __AVX512F__
+    return 16;
+#elif __AVX2__
+    return 8;
+#elif __SSE2__
+    return 4;
+#else
+    return 1;
+#endif
+}
+
+// inputs per dot step, k quads for dpbusd and k pairs for madd
+static int gru_int8_kstep()
+{
+#if (__AVX512F__ && __AVX512VNNI__) || (!__AVX512F__ && __AVX2__ && (__AVXVNNI__ || __AVX512VNNI__))
+    return 4;
+#else
+    return 2;
+#endif
+}
+
+static int gru_int8_weight_tm_size(int K, int P)
+{
+    const int kstep = gru_int8_kstep();
+
+    // the 127 * sum(w) compensation of each gate and hidden unit follows the k quads
+    return (K + kstep - 1) / kstep * kstep * 3 * P + (kstep == 4 ? 3 * P * 4 : 0);
+}
+
+// weight rows of one block with k steps interleaved as [R P x kstep][U P x kstep][N P x kstep], zero padded
+static void gru_int8_pack_block(const Mat& weight, int K, int num_output, int q, int P, signed char* pw)
+{
+    const int kstep = gru_int8_kstep();
+
+    int w_shift[48] = {0};
+    for (int k = 0; k < K; k += kstep)
+    {
+        for (int g = 0; g < 3; g++)
+        {
+            for (int j = 0; j < P; j++)
+            {
+                const signed char* w = q + j < num_output ? weight.row<const signed char>(num_output * g + q + j) : 0;
+                for (int l = 0; l < kstep; l++)
+                {
+                    const signed char v = w && k + l < K ? w[k + l] : 0;
+                    w_shift[P * g + j] += v;
+                    *pw++ = v;
+                }
+            }
+        }
+    }
+
+    if (kstep == 4)
+    {
+        for (int j = 0; j < 3 * P; j++)
+        {
+            const int s = w_shift[j] * 127;
+            memcpy(pw, &s, sizeof(int));
+            pw += sizeof(int);
+        }
+    }
+}
+
+static void gru_transform_weight_int8(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        gru_transform_weight_int8_avx512vnni(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        gru_transform_weight_int8_avxvnni(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        gru_transform_weight_int8_avx2(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+    const int maxpack = gru_int8_maxpack();
+    const int nblocks = (num_output + maxpack - 1) / maxpack;
+    const int num_output_tm = nblocks * maxpack;
+
+    weight_xc_tm.create(gru_int8_weight_tm_size(size, maxpack), nblocks, num_directions, (size_t)1u);
+    weight_hc_tm.create(gru_int8_weight_tm_size(num_output, maxpack), nblocks, num_directions, (size_t)1u);
+    weight_data_tm_int8_descales.create(num_output_tm * 3, 2, num_directions);
+    bias_c_tm.create(num_output_tm, 4, num_directions);
+    if (weight_xc_tm.empty() || weight_hc_tm.empty() || weight_data_tm_int8_descales.empty() || bias_c_tm.empty())
+        return;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const Mat weight_xc_dr = weight_xc.channel(dr);
+        const Mat weight_hc_dr = weight_hc.channel(dr);
+        Mat weight_xc_tm_dr = weight_xc_tm.channel(dr);
+        Mat weight_hc_tm_dr = weight_hc_tm.channel(dr);
+
+        for (int b = 0; b < nblocks; b++)
+        {
+            gru_int8_pack_block(weight_xc_dr, size, num_output, b * maxpack, maxpack, weight_xc_tm_dr.row<signed char>(b));
+            gru_int8_pack_block(weight_hc_dr, num_output, num_output, b * maxpack, maxpack, weight_hc_tm_dr.row<signed char>(b));
+        }
+
+        const float* weight_xc_int8_scales_ptr = weight_xc_int8_scales.row(dr);
+        const float* weight_hc_int8_scales_ptr = weight_hc_int8_scales.row(dr);
+        const Mat bias_c_dr = bias_c.channel(dr);
+
+        float* descales_xc = weight_data_tm_int8_descales.channel(dr).row(0);
+        float* descales_hc = weight_data_tm_int8_descales.channel(dr).row(1);
+        Mat bias_c_tm_dr = bias_c_tm.channel(dr);
+
+        for (int i = 0; i < num_output_tm; i++)
+        {
+            for (int g = 0; g < 3; g++)
+            {
+                descales_xc[num_output_tm * g + i] = i < num_output ? 1.f / weight_xc_int8_scales_ptr[num_output * g + i] : 0.f;
+                descales_hc[num_output_tm * g + i] = i < num_output ? 1.f / weight_hc_int8_scales_ptr[num_output * g + i] : 0.f;
+            }
+
+            for (int g = 0; g < 4; g++)
+            {
+                bias_c_tm_dr.row(g)[i] = i < num_output ? bias_c_dr.row(g)[i] : 0.f;
+            }
+        }
+    }
+}
+
+static NCNN_FORCEINLINE int gru_int8_pair(const signed char* v, int k, int K)
+{
+    const signed char v0 = v[k];
+    const signed char v1 = k + 1 < K ? v[k + 1] : 0;
+    return (int)(((unsigned int)(unsigned short)(short)v1 << 16) | (unsigned short)(short)v0);
+}
+
+// inputs shifted by 127 to unsigned for dpbusd, the zero padded weights cancel the padded inputs
+static NCNN_FORCEINLINE int gru_int8_quad_u8(const signed char* v, int k, int K)
+{
+    unsigned int x = 0;
+    for (int l = 0; l < 4; l++)
+    {
+        const int vl = k + l < K ? v[k + l] : 0;
+        x |= (unsigned int)(unsigned char)(vl + 127) << (l * 8);
+    }
+    return (int)x;
+}
+
+// kptr holds one block of maxpack hidden units, see gru_int8_pack_block, sums get [R P][U P][N P]
+static void gru_int8_dot(const signed char* kptr, const signed char* v, int K, int* sums)
+{
+#if __AVX512F__
+    __m512i _R = _mm512_setzero_si512();
+    __m512i _U = _mm512_setzero_si512();
+    __m512i _N = _mm512_setzero_si512();
+#if __AVX512VNNI__
+    for (int k = 0; k < K; k += 4)
+    {
+        __m512i _v = _mm512_set1_epi32(gru_int8_quad_u8(v, k, K));
+        _R = _mm512_dpbusd_epi32(_R, _v, _mm512_loadu_si512((const __m512i*)kptr));
+        _U = _mm512_dpbusd_epi32(_U, _v, _mm512_loadu_si512((const __m512i*)(kptr + 64)));
+        _N = _mm512_dpbusd_epi32(_N, _v, _mm512_loadu_si512((const __m512i*)(kptr + 128)));
+        kptr += 192;
+    }
+    _R = _mm512_sub_epi32(_R, _mm512_loadu_si512((const __m512i*)kptr));
+    _U = _mm512_sub_epi32(_U, _mm512_loadu_si512((const __m512i*)(kptr + 64)));
+    _N = _mm512_sub_epi32(_N, _mm512_loadu_si512((const __m512i*)(kptr + 128)));
+#else
+    for (int k = 0; k < K; k += 2)
+    {
+        __m512i _v = _mm512_set1_epi32(gru_int8_pair(v, k, K));
+        __m512i _wR = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+        __m512i _wU = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 32)));
+        __m512i _wN = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)(kptr + 64)));
+        _R = _mm512_add_epi32(_R, _mm512_madd_epi16(_wR, _v));
+        _U = _mm512_add_epi32(_U, _mm512_madd_epi16(_wU, _v));
+        _N = _mm512_add_epi32(_N, _mm512_madd_epi16(_wN, _v));
+        kptr += 96;
+    }
+#endif // __AVX512VNNI__
+    _mm512_storeu_si512((__m512i*)sums, _R);
+    _mm512_storeu_si512((__m512i*)(sums + 16), _U);
+    _mm512_storeu_si512((__m512i*)(sums + 32), _N);
+#elif __AVX2__
+    __m256i _R = _mm256_setzero_si256();
+    __m256i _U = _mm256_setzero_si256();
+    __m256i _N = _mm256_setzero_si256();
+#if __AVXVNNI__ || __AVX512VNNI__
+    for (int k = 0; k < K; k += 4)
+    {
+        __m256i _v = _mm256_set1_epi32(gru_int8_quad_u8(v, k, K));
+        _R = _mm256_comp_dpbusd_epi32(_R, _v, _mm256_loadu_si256((const __m256i*)kptr));
+        _U = _mm256_comp_dpbusd_epi32(_U, _v, _mm256_loadu_si256((const __m256i*)(kptr + 32)));
+        _N = _mm256_comp_dpbusd_epi32(_N, _v, _mm256_loadu_si256((const __m256i*)(kptr + 64)));
+        kptr += 96;
+    }
+    _R = _mm256_sub_epi32(_R, _mm256_loadu_si256((const __m256i*)kptr));
+    _U = _mm256_sub_epi32(_U, _mm256_loadu_si256((const __m256i*)(kptr + 32)));
+    _N = _mm256_sub_epi32(_N, _mm256_loadu_si256((const __m256i*)(kptr + 64)));
+#else
+    for (int k = 0; k < K; k += 2)
+    {
+        __m256i _v = _mm256_set1_epi32(gru_int8_pair(v, k, K));
+        __m256i _wR = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+        __m256i _wU = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 16)));
+        __m256i _wN = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(kptr + 32)));
+        _R = _mm256_add_epi32(_R, _mm256_madd_epi16(_wR, _v));
+        _U = _mm256_add_epi32(_U, _mm256_madd_epi16(_wU, _v));
+        _N = _mm256_add_epi32(_N, _mm256_madd_epi16(_wN, _v));
+        kptr += 48;
+    }
+#endif // __AVXVNNI__ || __AVX512VNNI__
+    _mm256_storeu_si256((__m256i*)sums, _R);
+    _mm256_storeu_si256((__m256i*)(sums + 8), _U);
+    _mm256_storeu_si256((__m256i*)(sums + 16), _N);
+#elif __SSE2__
+    __m128i _R = _mm_setzero_si128();
+    __m128i _U = _mm_setzero_si128();
+    __m128i _N = _mm_setzero_si128();
+    for (int k = 0; k < K; k += 2)
+    {
+        __m128i _v = _mm_set1_epi32(gru_int8_pair(v, k, K));
+        __m128i _wR = _mm_loadl_epi64((const __m128i*)kptr);
+        __m128i _wU = _mm_loadl_epi64((const __m128i*)(kptr + 8));
+        __m128i _wN = _mm_loadl_epi64((const __m128i*)(kptr + 16));
+        _wR = _mm_unpacklo_epi8(_wR, _mm_cmpgt_epi8(_mm_setzero_si128(), _wR));
+        _wU = _mm_unpacklo_epi8(_wU, _mm_cmpgt_epi8(_mm_setzero_si128(), _wU));
+        _wN = _mm_unpacklo_epi8(_wN, _mm_cmpgt_epi8(_mm_setzero_si128(), _wN));
+        _R = _mm_add_epi32(_R, _mm_madd_epi16(_wR, _v));
+        _U = _mm_add_epi32(_U, _mm_madd_epi16(_wU, _v));
+        _N = _mm_add_epi32(_N, _mm_madd_epi16(_wN, _v));
+        kptr += 24;
+    }
+    _mm_storeu_si128((__m128i*)sums, _R);
+    _mm_storeu_si128((__m128i*)(sums + 4), _U);
+    _mm_storeu_si128((__m128i*)(sums + 8), _N);
+#else
+    int R = 0;
+    int U = 0;
+    int N = 0;
+    for (int k = 0; k < K; k += 2)
+    {
+        const signed char v1 = k + 1 < K ? v[k + 1] : 0;
+        R += kptr[0] * v[k] + kptr[1] * v1;
+        U += kptr[2] * v[k] + kptr[3] * v1;
+        N += kptr[4] * v[k] + kptr[5] * v1;
+        kptr += 6;
+    }
+    sums[0] = R;
+    sums[1] = U;
+    sums[2] = N;
+#endif
+}
+
+// R = sigmoid(xR + hR), U = sigmoid(xU + hU), N = tanh(xN + R * (hN + bBN)), H := (1 - U) * N + U * H over one block
+static void gru_int8_gates(const float* xR, const float* xU, const float* xN, const float* hR, const float* hU, const float* hN, const float* bBN, float* H)
+{
+#if __AVX512F__
+    __m512 _R = sigmoid_avx512(_mm512_add_ps(_mm512_loadu_ps(xR), _mm512_loadu_ps(hR)));
+    __m512 _U = sigmoid_avx512(_mm512_add_ps(_mm512_loadu_ps(xU), _mm512_loadu_ps(hU)));
+    __m512 _N = _mm512_add_ps(_mm512_loadu_ps(hN), _mm512_loadu_ps(bBN));
+    _N = tanh_avx512(_mm512_fmadd_ps(_R, _N, _mm512_loadu_ps(xN)));
+    _mm512_storeu_ps(H, _mm512_fmadd_ps(_U, _mm512_sub_ps(_mm512_loadu_ps(H), _N), _N));
+#elif __AVX2__
+    __m256 _R = sigmoid_avx(_mm256_add_ps(_mm256_loadu_ps(xR), _mm256_loadu_ps(hR)));
+    __m256 _U = sigmoid_avx(_mm256_add_ps(_mm256_loadu_ps(xU), _mm256_loadu_ps(hU)));
+    __m256 _N = _mm256_add_ps(_mm256_loadu_ps(hN), _mm256_loadu_ps(bBN));
+    _N = tanh_avx(_mm256_comp_fmadd_ps(_R, _N, _mm256_loadu_ps(xN)));
+    _mm256_storeu_ps(H, _mm256_comp_fmadd_ps(_U, _mm256_sub_ps(_mm256_loadu_ps(H), _N), _N));
+#elif __SSE2__
+    __m128 _R = sigmoid_sse(_mm_add_ps(_mm_loadu_ps(xR), _mm_loadu_ps(hR)));
+    __m128 _U = sigmoid_sse(_mm_add_ps(_mm_loadu_ps(xU), _mm_loadu_ps(hU)));
+    __m128 _N = _mm_add_ps(_mm_loadu_ps(hN), _mm_loadu_ps(bBN));
+    _N = tanh_sse(_mm_comp_fmadd_ps(_R, _N, _mm_loadu_ps(xN)));
+    _mm_storeu_ps(H, _mm_comp_fmadd_ps(_U, _mm_sub_ps(_mm_loadu_ps(H), _N), _N));
+#else
+    const float R = 1.f / (1.f + expf(-(xR[0] + hR[0])));
+    const float U = 1.f / (1.f + expf(-(xU[0] + hU[0])));
+    const float N = tanhf(xN[0] + R * (hN[0] + bBN[0]));
+    H[0] = (1.f - U) * N + U * H[0];
+#endif
+}
+
+// quantize with 127 / absmax and return the descale, an all zero vector gets descale 1
+static float gru_dynamic_quantize(const float* ptr, int size, signed char* outptr)
+{
+    float absmax = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        absmax = std::max(absmax, (float)fabs(ptr[i]));
+    }
+
+    if (absmax == 0.f)
+    {
+        memset(outptr, 0, size);
+        return 1.f;
+    }
+
+    const float scale = 127.f / absmax;
+    for (int i = 0; i < size; i++)
+    {
+        outptr[i] = float2int8(ptr[i] * scale);
+    }
+
+    return absmax / 127.f;
+}
+
+static int gru_int8(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        return gru_int8_avx512vnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        return gru_int8_avxvnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return gru_int8_avx2(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+    }
+#endif
+
+    const int size = bottom_blob_int8.w;
+    const int T = bottom_blob_int8.h;
+    const int maxpack = gru_int8_maxpack();
+    const int nblocks = weight_hc_tm.h;
+    const int num_output_tm = nblocks * maxpack;
+
+    const float* descales_xc = weight_int8_descales.row(0);
+    const float* descales_hc = weight_int8_descales.row(1);
+
+    // input projection of every timestep ahead of the recurrence
+    Mat xproj(num_output_tm * 3, T, 4u, opt.workspace_allocator);
+    if (xproj.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int tb = 0; tb < T * nblocks; tb++)
+    {
+        const int t = tb / nblocks;
+        const int q = tb % nblocks * maxpack;
+
+        int sums[48] = {0};
+        gru_int8_dot(weight_xc_tm.row<const signed char>(tb % nblocks), bottom_blob_int8.row<const signed char>(t), size, sums);
+
+        const float descale_x = bottom_blob_int8_descales[t];
+
+        float* xp = xproj.row(t);
+        for (int g = 0; g < 3; g++)
+        {
+            const float* bias = bias_c_tm.row(g);
+            for (int j = 0; j < maxpack; j++)
+            {
+                const int p = num_output_tm * g + q + j;
+                xp[p] = bias[q + j] + sums[maxpack * g + j] * (descale_x * descales_xc[p]);
+            }
+        }
+    }
+
+    Mat hidden_state_int8(num_output, (size_t)1u, 1, opt.workspace_allocator);
+    if (hidden_state_int8.empty())
+        return -100;
+
+    const float* bias_c_BN = bias_c_tm.row(3);
+
+    // unroll
+    for (int t = 0; t < T; t++)
+    {
+        int ti = reverse ? T - 1 - t : t;
+
+        const float descale_h = gru_dynamic_quantize(hidden_state, num_output, hidden_state_int8);
+
+        const float* xR = xproj.row(ti);
+        const float* xU = xR + num_output_tm;
+        const float* xN = xR + num_output_tm * 2;
+        float* outptr = top_blob.row(ti) + top_offset;
+
+        // the blocks only read the quantized hidden state, so each one updates its own lanes
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int b = 0; b < nblocks; b++)
+        {
+            const int q = b * maxpack;
+            const int P = std::min(maxpack, num_output - q);
+
+            int sums[48] = {0};
+            gru_int8_dot(weight_hc_tm.row<const signed char>(b), hidden_state_int8, num_output, sums);
+
+            float hsums[48];
+            for (int g = 0; g < 3; g++)
+            {
+                for (int j = 0; j < maxpack; j++)
+                {
+                    hsums[maxpack * g + j] = sums[maxpack * g + j] * (descale_h * descales_hc[num_output_tm * g + q + j]);
+                }
+            }
+
+            float H[16] = {0.f};
+            memcpy(H, hidden_state + q, P * sizeof(float));
+
+            gru_int8_gates(xR + q, xU + q, xN + q, hsums, hsums + maxpack, hsums + maxpack * 2, bias_c_BN + q, H);
+
+            memcpy(hidden_state + q, H, P * sizeof(float));
+            memcpy(outptr + q, H, P * sizeof(float));
+        }
+    }
+
+    return 0;
+}
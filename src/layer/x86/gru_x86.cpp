@@ -0,0 +1,536 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "gru_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+#include "layer_type.h"
+
+#include "cpu.h"
+
+namespace ncnn {
+
+#include "gru_int8.h"
+
+GRU_x86::GRU_x86()
+{
+    one_blob_only = false;
+    support_inplace = false;
+
+    gemm_xc = 0;
+}
+
+static int gru_maxpack()
+{
+#if __AVX512F__
+    return 16;
+#elif __AVX__
+    return 8;
+#elif __SSE2__
+    return 4;
+#else
+    return 1;
+#endif
+}
+
+// hidden units are split into blocks of 16, 8, 4 and 1 lanes, widest first
+static int gru_block_count(int num_output, int maxpack)
+{
+    int nblocks = 0;
+    int q = 0;
+    for (int P = maxpack; P > 0; P = P == 4 ? 1 : P / 2)
+    {
+        for (; q + P - 1 < num_output; q += P)
+            nblocks++;
+    }
+    return nblocks;
+}
+
+static void gru_block_range(int b, int num_output, int maxpack, int& q, int& P)
+{
+    q = 0;
+    for (P = maxpack; P > 0; P = P == 4 ? 1 : P / 2)
+    {
+        const int nn = (num_output - q) / P;
+        if (b < nn)
+        {
+            q += b * P;
+            return;
+        }
+
+        b -= nn;
+        q += nn * P;
+    }
+}
+
+// R = sigmoid(xR + hR), U = sigmoid(xU + hU), N = tanh(xN + R * (hN + bBN))
+static void gru_gates(const float* xR, const float* xU, const float* xN, const float* hR, const float* hU, const float* hN, const float* bBN, float* outU, float* outN, int P)
+{
+    int j = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; j + 15 < P; j += 16)
+    {
+        __m512 _R = sigmoid_avx512(_mm512_add_ps(_mm512_loadu_ps(xR + j), _mm512_loadu_ps(hR + j)));
+        __m512 _U = sigmoid_avx512(_mm512_add_ps(_mm512_loadu_ps(xU + j), _mm512_loadu_ps(hU + j)));
+        __m512 _N = _mm512_add_ps(_mm512_loadu_ps(hN + j), _mm512_loadu_ps(bBN + j));
+        _N = tanh_avx512(_mm512_fmadd_ps(_R, _N, _mm512_loadu_ps(xN + j)));
+        _mm512_storeu_ps(outU + j, _U);
+        _mm512_storeu_ps(outN + j, _N);
+    }
+#endif // __AVX512F__
+    for (; j + 7 < P; j += 8)
+    {
+        __m256 _R = sigmoid_avx(_mm256_add_ps(_mm256_loadu_ps(xR + j), _mm256_loadu_ps(hR + j)));
+        __m256 _U = sigmoid_avx(_mm256_add_ps(_mm256_loadu_ps(xU + j), _mm256_loadu_ps(hU + j)));
+        __m256 _N = _mm256_add_ps(_mm256_loadu_ps(hN + j), _mm256_loadu_ps(bBN + j));
+        _N = tanh_avx(_mm256_comp_fmadd_ps(_R, _N, _mm256_loadu_ps(xN + j)));
+        _mm256_storeu_ps(outU + j, _U);
+        _mm256_storeu_ps(outN + j, _N);
+    }
+#endif // __AVX__
+    for (; j + 3 < P; j += 4)
+    {
+        __m128 _R = sigmoid_sse(_mm_add_ps(_mm_loadu_ps(xR + j), _mm_loadu_ps(hR + j)));
+        __m128 _U = sigmoid_sse(_mm_add_ps(_mm_loadu_ps(xU + j), _mm_loadu_ps(hU + j)));
+        __m128 _N = _mm_add_ps(_mm_loadu_ps(hN + j), _mm_loadu_ps(bBN + j));
+        _N = tanh_sse(_mm_comp_fmadd_ps(_R, _N, _mm_loadu_ps(xN + j)));
+        _mm_storeu_ps(outU + j, _U);
+        _mm_storeu_ps(outN + j, _N);
+    }
+#endif // __SSE2__
+    for (; j < P; j++)
+    {
+        const float R = 1.f / (1.f + expf(-(xR[j] + hR[j])));
+        const float U = 1.f / (1.f + expf(-(xU[j] + hU[j])));
+        outU[j] = U;
+        outN[j] = tanhf(xN[j] + R * (hN[j] + bBN[j]));
+    }
+}
+
+// h_t := (1 - update) .* new + update .* h_{t-1}
+static void gru_update(const float* U, const float* N, float* hidden_state, float* output_data, int num_output)
+{
+    int q = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; q + 15 < num_output; q += 16)
+    {
+        __m512 _N = _mm512_loadu_ps(N + q);
+        __m512 _H = _mm512_fmadd_ps(_mm512_loadu_ps(U + q), _mm512_sub_ps(_mm512_loadu_ps(hidden_state + q), _N), _N);
+        _mm512_storeu_ps(hidden_state + q, _H);
+        _mm512_storeu_ps(output_data + q, _H);
+    }
+#endif // __AVX512F__
+    for (; q + 7 < num_output; q += 8)
+    {
+        __m256 _N = _mm256_loadu_ps(N + q);
+        __m256 _H = _mm256_comp_fmadd_ps(_mm256_loadu_ps(U + q), _mm256_sub_ps(_mm256_loadu_ps(hidden_state + q), _N), _N);
+        _mm256_storeu_ps(hidden_state + q, _H);
+        _mm256_storeu_ps(output_data + q, _H);
+    }
+#endif // __AVX__
+    for (; q + 3 < num_output; q += 4)
+    {
+        __m128 _N = _mm_loadu_ps(N + q);
+        __m128 _H = _mm_comp_fmadd_ps(_mm_loadu_ps(U + q), _mm_sub_ps(_mm_loadu_ps(hidden_state + q), _N), _N);
+        _mm_storeu_ps(hidden_state + q, _H);
+        _mm_storeu_ps(output_data + q, _H);
+    }
+#endif // __SSE2__
+    for (; q < num_output; q++)
+    {
+        const float H = N[q] + U[q] * (hidden_state[q] - N[q]);
+        hidden_state[q] = H;
+        output_data[q] = H;
+    }
+}
+
+// kptr holds [R P][U P][N P] weights for each hidden input
+static void gru_dot(const float* kptr, const float* hs, int num_output, int P, float* sums)
+{
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (P == 16)
+    {
+        __m512 _R = _mm512_setzero_ps();
+        __m512 _U = _mm512_setzero_ps();
+        __m512 _N = _mm512_setzero_ps();
+        for (int i = 0; i < num_output; i++)
+        {
+            __m512 _h = _mm512_set1_ps(hs[i]);
+            _R = _mm512_fmadd_ps(_mm512_loadu_ps(kptr), _h, _R);
+            _U = _mm512_fmadd_ps(_mm512_loadu_ps(kptr + 16), _h, _U);
+            _N = _mm512_fmadd_ps(_mm512_loadu_ps(kptr + 32), _h, _N);
+            kptr += 48;
+        }
+        _mm512_storeu_ps(sums, _R);
+        _mm512_storeu_ps(sums + 16, _U);
+        _mm512_storeu_ps(sums + 32, _N);
+        return;
+    }
+#endif // __AVX512F__
+    if (P == 8)
+    {
+        __m256 _R = _mm256_setzero_ps();
+        __m256 _U = _mm256_setzero_ps();
+        __m256 _N = _mm256_setzero_ps();
+        for (int i = 0; i < num_output; i++)
+        {
+            __m256 _h = _mm256_set1_ps(hs[i]);
+            _R = _mm256_comp_fmadd_ps(_mm256_loadu_ps(kptr), _h, _R);
+            _U = _mm256_comp_fmadd_ps(_mm256_loadu_ps(kptr + 8), _h, _U);
+            _N = _mm256_comp_fmadd_ps(_mm256_loadu_ps(kptr + 16), _h, _N);
+            kptr += 24;
+        }
+        _mm256_storeu_ps(sums, _R);
+        _mm256_storeu_ps(sums + 8, _U);
+        _mm256_storeu_ps(sums + 16, _N);
+        return;
+    }
+#endif // __AVX__
+    if (P == 4)
+    {
+        __m128 _R = _mm_setzero_ps();
+        __m128 _U = _mm_setzero_ps();
+        __m128 _N = _mm_setzero_ps();
+        for (int i = 0; i < num_output; i++)
+        {
+            __m128 _h = _mm_set1_ps(hs[i]);
+            _R = _mm_comp_fmadd_ps(_mm_loadu_ps(kptr), _h, _R);
+            _U = _mm_comp_fmadd_ps(_mm_loadu_ps(kptr + 4), _h, _U);
+            _N = _mm_comp_fmadd_ps(_mm_loadu_ps(kptr + 8), _h, _N);
+            kptr += 12;
+        }
+        _mm_storeu_ps(sums, _R);
+        _mm_storeu_ps(sums + 4, _U);
+        _mm_storeu_ps(sums + 8, _N);
+        return;
+    }
+#endif // __SSE2__
+
+    float R = 0.f;
+    float U = 0.f;
+    float N = 0.f;
+    for (int i = 0; i < num_output; i++)
+    {
+        const float h = hs[i];
+        R += kptr[0] * h;
+        U += kptr[1] * h;
+        N += kptr[2] * h;
+        kptr += 3;
+    }
+    sums[0] = R;
+    sums[1] = U;
+    sums[2] = N;
+}
+
+// xproj row t holds the R U N input projections with biases, this direction starting at xproj_offset
+static int gru(const Mat& xproj, int xproj_offset, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_hc, const float* bias_c_BN, float* hidden_state, const Option& opt)
+{
+    const int T = xproj.h;
+    const int maxpack = gru_maxpack();
+    const int nblocks = gru_block_count(num_output, maxpack);
+
+    Mat gates(num_output, 2, 4u, opt.workspace_allocator);
+    if (gates.empty())
+        return -100;
+
+    // unroll
+    for (int t = 0; t < T; t++)
+    {
+        int ti = reverse ? T - 1 - t : t;
+
+        const float* xR = xproj.row(ti) + xproj_offset;
+        const float* xU = xR + num_output;
+        const float* xN = xR + num_output * 2;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int b = 0; b < nblocks; b++)
+        {
+            int q;
+            int P;
+            gru_block_range(b, num_output, maxpack, q, P);
+
+            float sums[48];
+            gru_dot(weight_hc.row(b), hidden_state, num_output, P, sums);
+
+            gru_gates(xR + q, xU + q, xN + q, sums, sums + P, sums + P * 2, bias_c_BN + q, gates.row(0) + q, gates.row(1) + q, P);
+        }
+
+        gru_update(gates.row(0), gates.row(1), hidden_state, top_blob.row(ti) + top_offset, num_output);
+    }
+
+    return 0;
+}
+
+int GRU_x86::create_pipeline(const Option& opt)
+{
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        return create_pipeline_int8(opt);
+    }
+#endif
+
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int size = weight_data_size / num_directions / num_output / 3;
+
+    // the R U N input weights of both directions side by side
+    {
+        Mat weight_xc_all(size, num_output * 3 * num_directions);
+        Mat bias_xc_all(num_output * 3 * num_directions);
+        if (weight_xc_all.empty() || bias_xc_all.empty())
+            return -100;
+
+        for (int dr = 0; dr < num_directions; dr++)
+        {
+            const Mat weight_xc = weight_xc_data.channel(dr);
+            const Mat bias_c = bias_c_data.channel(dr);
+
+            memcpy(weight_xc_all.row(num_output * 3 * dr), weight_xc, size * num_output * 3 * sizeof(float));
+            memcpy((float*)bias_xc_all + num_output * 3 * dr, bias_c, num_output * 3 * sizeof(float));
+        }
+
+        gemm_xc = ncnn::create_layer_cpu(ncnn::LayerType::Gemm);
+        ncnn::ParamDict pd;
+        pd.set(2, 0);                                  // transA
+        pd.set(3, 1);                                  // transB
+        pd.set(4, 0);                                  // constantA
+        pd.set(5, 1);                                  // constantB
+        pd.set(6, 1);                                  // constantC
+        pd.set(7, 0);                                  // M
+        pd.set(8, num_output * 3 * num_directions);    // N
+        pd.set(9, size);                               // K
+        pd.set(10, 4);                                 // constant_broadcast_type_C
+        pd.set(11, 0);                                 // output_N1M
+        pd.set(12, 1);                                 // output_elempack
+        pd.set(14, 0);                                 // output_transpose
+        gemm_xc->load_param(pd);
+        Mat weights[2];
+        weights[0] = weight_xc_all;
+        weights[1] = bias_xc_all;
+        gemm_xc->load_model(ModelBinFromMatArray(weights));
+
+        Option opt_gemm = opt;
+        opt_gemm.use_fp16_storage = false;
+        opt_gemm.use_bf16_storage = false;
+        gemm_xc->create_pipeline(opt_gemm);
+    }
+
+    // recurrent weights of one block of P hidden units as [R P][U P][N P] for each hidden input
+    const int maxpack = gru_maxpack();
+    const int nblocks = gru_block_count(num_output, maxpack);
+
+    weight_hc_data_packed.create(num_output * 3 * maxpack, nblocks, num_directions);
+    if (weight_hc_data_packed.empty())
+        return -100;
+
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const Mat weight_hc = weight_hc_data.channel(dr);
+        Mat weight_hc_data_packed_dr = weight_hc_data_packed.channel(dr);
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int b = 0; b < nblocks; b++)
+        {
+            int q;
+            int P;
+            gru_block_range(b, num_output, maxpack, q, P);
+
+            float* pw = weight_hc_data_packed_dr.row(b);
+
+            for (int i = 0; i < num_output; i++)
+            {
+                for (int g = 0; g < 3; g++)
+                {
+                    for (int j = 0; j < P; j++)
+                    {
+                        *pw++ = weight_hc.row(num_output * g + q + j)[i];
+                    }
+                }
+            }
+        }
+    }
+
+    bias_c_data_packed = bias_c_data;
+
+    if (opt.lightmode)
+    {
+        weight_xc_data.release();
+        bias_c_data.release();
+        weight_hc_data.release();
+    }
+
+    return 0;
+}
+
+#if NCNN_INT8
+int GRU_x86::create_pipeline_int8(const Option& opt)
+{
+    const int num_directions = direction == 2 ? 2 : 1;
+    const int size = weight_data_size / num_directions / num_output / 3;
+
+    gru_transform_weight_int8(weight_xc_data, weight_xc_data_int8_scales, weight_hc_data, weight_hc_data_int8_scales, bias_c_data, weight_xc_data_packed, weight_hc_data_packed, weight_data_tm_int8_descales, bias_c_data_packed, size, num_output, num_directions, opt);
+    if (weight_xc_data_packed.empty() || weight_hc_data_packed.empty() || weight_data_tm_int8_descales.empty() || bias_c_data_packed.empty())
+        return -100;
+
+    if (opt.lightmode)
+    {
+        weight_xc_data.release();
+        bias_c_data.release();
+        weight_hc_data.release();
+        weight_xc_data_int8_scales.release();
+        weight_hc_data_int8_scales.release();
+    }
+
+    return 0;
+}
+#endif // NCNN_INT8
+
+int GRU_x86::destroy_pipeline(const Option& opt)
+{
+    if (gemm_xc)
+    {
+        Option opt_gemm = opt;
+        opt_gemm.use_fp16_storage = false;
+        opt_gemm.use_bf16_storage = false;
+        gemm_xc->destroy_pipeline(opt_gemm);
+        delete gemm_xc;
+        gemm_xc = 0;
+    }
+
+    return 0;
+}
+
+int GRU_x86::forward_directions(const Mat& bottom_blob, Mat& top_blob, Mat& hidden, const Option& opt) const
+{
+    const int num_directions = direction == 2 ? 2 : 1;
+
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        const int size = bottom_blob.w;
+        const int T = bottom_blob.h;
+
+        // dynamic quantize bottom_blob
+        Mat bottom_blob_int8(size, T, (size_t)1u, 1, opt.workspace_allocator);
+        Mat bottom_blob_int8_descales(T, (size_t)4u, 1, opt.workspace_allocator);
+        if (bottom_blob_int8.empty() || bottom_blob_int8_descales.empty())
+            return -100;
+
+        for (int t = 0; t < T; t++)
+        {
+            bottom_blob_int8_descales[t] = gru_dynamic_quantize(bottom_blob.row(t), size, bottom_blob_int8.row<signed char>(t));
+        }
+
+        for (int dr = 0; dr < num_directions; dr++)
+        {
+            const int reverse = direction == 2 ? dr : direction;
+
+            int ret = gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob, num_output * dr, reverse, num_output, weight_xc_data_packed.channel(dr), weight_hc_data_packed.channel(dr), weight_data_tm_int8_descales.channel(dr), bias_c_data_packed.channel(dr), hidden.row(dr), opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        return 0;
+    }
+#endif
+
+    // input projection of all timesteps and directions
+    Mat xproj;
+    {
+        Option opt_gemm = opt;
+        opt_gemm.blob_allocator = opt.workspace_allocator;
+        opt_gemm.use_fp16_storage = false;
+        opt_gemm.use_bf16_storage = false;
+        int ret = gemm_xc->forward(bottom_blob, xproj, opt_gemm);
+        if (ret != 0)
+            return ret;
+    }
+
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const int reverse = direction == 2 ? dr : direction;
+
+        int ret = gru(xproj, num_output * 3 * dr, top_blob, num_output * dr, reverse, num_output, weight_hc_data_packed.channel(dr), bias_c_data_packed.channel(dr).row(3), hidden.row(dr), opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+int GRU_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int T = bottom_blob.h;
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    // initial hidden state of each direction
+    Mat hidden(num_output, num_directions, 4u, opt.workspace_allocator);
+    if (hidden.empty())
+        return -100;
+    hidden.fill(0.f);
+
+    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    return forward_directions(bottom_blob, top_blob, hidden, opt);
+}
+
+int GRU_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const int T = bottom_blob.h;
+    const int num_directions = direction == 2 ? 2 : 1;
+
+    Mat hidden;
+    Allocator* hidden_allocator = top_blobs.size() == 2 ? opt.blob_allocator : opt.workspace_allocator;
+    if (bottom_blobs.size() == 2)
+    {
+        hidden = bottom_blobs[1].clone(hidden_allocator);
+    }
+    else
+    {
+        hidden.create(num_output, num_directions, 4u, hidden_allocator);
+        if (hidden.empty())
+            return -100;
+        hidden.fill(0.f);
+    }
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create(num_output * num_directions, T, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    int ret = forward_directions(bottom_blob, top_blob, hidden, opt);
+    if (ret != 0)
+        return ret;
+
+    if (top_blobs.size() == 2)
+    {
+        top_blobs[1] = hidden;
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
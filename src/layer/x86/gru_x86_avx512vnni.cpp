@@ -0,0 +1,24 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "cpu.h"
+#include "mat.h"
+#include "layer.h"
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "gru_int8.h"
+
+void gru_transform_weight_int8_avx512vnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt)
+{
+    gru_transform_weight_int8(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+}
+
+int gru_int8_avx512vnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt)
+{
+    return gru_int8(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+}
+
+} // namespace ncnn
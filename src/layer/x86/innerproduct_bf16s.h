@@ -0,0 +1,77 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__ && !__AMX_BF16__
+int innerproduct_bf16s_amxbf16(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt);
+#endif
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+int innerproduct_bf16s_avx512bf16(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt);
+#endif
+
+// weight_data_tm holds num_output rows of num_input bf16 weights
+// or the zero padded panels of 16 weight rows when the tile kernel is used, see gemm_dot_bf16s_pack_B_amx
+static void innerproduct_transform_kernel_bf16s(const Mat& weight_data, Mat& weight_data_tm, int num_input, int num_output, const Option& opt)
+{
+    Mat weight_data_bf16(num_input, num_output, (size_t)2u);
+    if (weight_data_bf16.empty())
+        return;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        const float* kptr = (const float*)weight_data + num_input * p;
+        unsigned short* outptr = weight_data_bf16.row<unsigned short>(p);
+
+        for (int k = 0; k < num_input; k++)
+        {
+            outptr[k] = float32_to_bfloat16(kptr[k]);
+        }
+    }
+
+    if (gemm_dot_bf16s_amx_supported())
+    {
+        weight_data_tm.create((num_input + 31) / 32 * 32 * 16, (num_output + 15) / 16, (size_t)2u);
+        if (weight_data_tm.empty())
+            return;
+
+        gemm_dot_bf16s_pack_B_amx(weight_data_bf16, num_input, num_output, num_input, weight_data_tm, opt.num_threads);
+        return;
+    }
+
+    weight_data_tm = weight_data_bf16;
+}
+
+// bottom_blob holds h rows of num_input bf16 values with elempack 1, top_blob holds h rows of num_output
+static int innerproduct_bf16s(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AMXBF16 && __AVX512F__ && !__AMX_BF16__
+    if (ncnn::cpu_support_x86_amx_bf16())
+    {
+        return innerproduct_bf16s_amxbf16(bottom_blob, top_blob, weight_data_tm, bias_data, activation_type, activation_params, opt);
+    }
+#endif
+#if NCNN_RUNTIME_CPU && NCNN_AVX512BF16 && __AVX512F__ && !__AVX512BF16__
+    if (ncnn::cpu_support_x86_avx512_bf16())
+    {
+        return innerproduct_bf16s_avx512bf16(bottom_blob, top_blob, weight_data_tm, bias_data, activation_type, activation_params, opt);
+    }
+#endif
+
+    const int num_input = bottom_blob.w;
+    const int num_output = top_blob.w;
+    const int h = bottom_blob.dims == 2 ? bottom_blob.h : 1;
+
+    const float* bias_data_ptr = bias_data.empty() ? 0 : (const float*)bias_data;
+
+#if __AMX_BF16__
+    if (gemm_dot_bf16s_amx_supported())
+    {
+        // the weight panels are packed in create_pipeline
+        return gemm_dot_bf16s_amx(bottom_blob, bottom_blob.w, weight_data_tm, top_blob, top_blob.w, 1, bias_data_ptr, 0, 1, h, num_output, num_input, 1.f, activation_type, activation_params, opt.num_threads);
+    }
+#endif // __AMX_BF16__
+
+    gemm_dot_bf16s(bottom_blob, bottom_blob.w, weight_data_tm, weight_data_tm.w, top_blob, top_blob.w, 1, bias_data_ptr, 0, 1, h, num_output, num_input, 1.f, activation_type, activation_params, opt.num_threads);
+
+    return 0;
+}
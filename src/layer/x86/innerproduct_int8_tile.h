@@ -0,0 +1,158 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AMXINT8 && __AVX512F__ && !__AMX_INT8__
+int innerproduct_int8_tile_amxint8(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& scale_in_data, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt);
+#endif
+
+// the tile kernel wants weight_data_tm as whole blocks of 16 rows and 64 int8 weights
+static int innerproduct_int8_tile_supported()
+{
+#if (NCNN_RUNTIME_CPU && NCNN_AMXINT8 && __AVX512F__) || __AMX_INT8__
+    return ncnn::cpu_support_x86_amx_int8();
+#else
+    return 0;
+#endif
+}
+
+// num_output rows of num_input int8 weights, zero padded to whole tiles so the kernel loads them as is
+static void innerproduct_int8_tile_transform_kernel(const Mat& weight_data, Mat& weight_data_tm, int num_input, int num_output)
+{
+    const int Kp = (num_input + 63) / 64 * 64;
+    const int num_output_p = (num_output + 15) / 16 * 16;
+
+    weight_data_tm.create(Kp, num_output_p, (size_t)1u);
+    if (weight_data_tm.empty())
+        return;
+
+    memset(weight_data_tm.data, 0, weight_data_tm.total());
+
+    for (int p = 0; p < num_output; p++)
+    {
+        memcpy(weight_data_tm.row<signed char>(p), (const signed char*)weight_data + num_input * p, num_input);
+    }
+}
+
+// bottom_blob holds h rows of num_input int8 values with elempack 1, or one contiguous vector when 1d
+// top_blob is fp32 with num_output columns and its rows packed by top_blob.elempack
+static int innerproduct_int8_tile(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& scale_in_data, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AMXINT8 && __AVX512F__ && !__AMX_INT8__
+    if (ncnn::cpu_support_x86_amx_int8())
+    {
+        return innerproduct_int8_tile_amxint8(bottom_blob, top_blob, weight_data_tm, scale_in_data, bias_data, activation_type, activation_params, opt);
+    }
+#endif
+
+#if __AMX_INT8__
+    const int num_input = bottom_blob.w * bottom_blob.elempack;
+    const int h = bottom_blob.dims == 2 ? bottom_blob.h : 1;
+    const int num_output = scale_in_data.w;
+    const int out_elempack = top_blob.elempack;
+
+    const int Kp = weight_data_tm.w;
+    const int nn_M = (h + 15) / 16;
+    const int nn_N = (num_output + 15) / 16;
+
+    int nT = opt.num_threads;
+
+    // 16 input rows per tile with k quads interleaved, the layout tdpbssd expects, zero padded
+    Mat bottom_tm(Kp * 16, nn_M, (size_t)1u, opt.workspace_allocator);
+    if (bottom_tm.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(nT)
+    for (int mb = 0; mb < nn_M; mb++)
+    {
+        const int max_m = std::min(h - mb * 16, 16);
+
+        signed char* pB = bottom_tm.row<signed char>(mb);
+
+        for (int k = 0; k < Kp; k += 4)
+        {
+            for (int m = 0; m < 16; m++)
+            {
+                const signed char* p = bottom_blob.row<const signed char>(mb * 16 + std::min(m, max_m - 1));
+                for (int t = 0; t < 4; t++)
+                {
+                    pB[t] = m < max_m && k + t < num_input ? p[k + t] : 0;
+                }
+                pB += 4;
+            }
+        }
+    }
+
+    const float* bias_data_ptr = bias_data.empty() ? 0 : (const float*)bias_data;
+    float* outptr = top_blob;
+
+    // one contiguous range of tiles per thread so the tile state is configured once per thread
+    // tiles sharing a weight block are adjacent, each weight block streams from memory once
+    const int nn = nn_N * nn_M;
+    nT = std::min(nT, nn);
+
+    #pragma omp parallel for num_threads(nT)
+    for (int t = 0; t < nT; t++)
+    {
+        const int start = (int)((long long)nn * t / nT);
+        const int end = (int)((long long)nn * (t + 1) / nT);
+
+        int sums[16 * 16];
+
+        amx_tile_config_16x64(3);
+
+        // tmm0 accumulates 16 outputs x 16 input rows, tmm1 holds 16 weight rows of 64 int8
+        for (int ppij = start; ppij < end; ppij++)
+        {
+            const int n0 = ppij / nn_M * 16;
+            const int m0 = ppij % nn_M * 16;
+
+            const int max_n = std::min(num_output - n0, 16);
+            const int max_m = std::min(h - m0, 16);
+
+            const signed char* pA = weight_data_tm.row<const signed char>(n0);
+            const signed char* pB = bottom_tm.row<const signed char>(m0 / 16);
+
+            _tile_zero(0);
+            for (int kk = 0; kk < Kp; kk += 64)
+            {
+                _tile_loadd(1, pA + kk, (long)Kp);
+                _tile_loadd(2, pB + kk * 16, 64);
+                _tile_dpbssd(0, 1, 2);
+            }
+            _tile_stored(0, sums, 64);
+
+            // dequantize and activation
+            for (int n = 0; n < max_n; n++)
+            {
+                const int p = n0 + n;
+
+                for (int m = 0; m < max_m; m++)
+                {
+                    const int y = m0 + m;
+
+                    float sumfp32 = sums[n * 16 + m] * scale_in_data[p];
+
+                    if (bias_data_ptr)
+                        sumfp32 += bias_data_ptr[p];
+
+                    outptr[(size_t)(y / out_elempack) * num_output * out_elempack + p * out_elempack + y % out_elempack] = activation_ss(sumfp32, activation_type, activation_params);
+                }
+            }
+        }
+
+        _tile_release();
+    }
+
+    return 0;
+#else
+    (void)bottom_blob;
+    (void)top_blob;
+    (void)weight_data_tm;
+    (void)scale_in_data;
+    (void)bias_data;
+    (void)activation_type;
+    (void)activation_params;
+    (void)opt;
+    return -1;
+#endif // __AMX_INT8__
+}
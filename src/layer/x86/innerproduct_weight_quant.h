@@ -0,0 +1,317 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// weight-only quantized innerproduct, activations stay fp32
+// each group of a weight row is stored in blocks of 32 signed values, int8 as is,
+// int4 with values j in the low nibbles and j + 16 in the high nibbles of 16 bytes,
+// the tail of the group shorter than a block is stored two values per byte low nibble first
+// every group is decoded once into a fp32 panel shared by all the input rows
+
+static void innerproduct_transform_kernel_weight_quant_sse(const Mat& weight_data, const Mat& weight_data_quant_scales, Mat& weight_data_tm, Mat& weight_scales, int num_input, int num_output, int bits, int group_size, const Option& opt)
+{
+    const int num_group = weight_quant_num_group(num_input, group_size);
+
+    weight_scales = weight_data_quant_scales.reshape(num_group, num_output);
+
+    if (bits == 8)
+    {
+        // int8 rows are already in place
+        weight_data_tm = weight_data.reshape(num_input, num_output);
+        return;
+    }
+
+    weight_data_tm.create((num_input + 1) / 2, num_output, (size_t)1u);
+
+    const signed char* qptr = weight_data;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        signed char* outptr = weight_data_tm.row<signed char>(p);
+
+        // the packed rows of an odd num_input start at half bytes
+        const size_t q0 = (size_t)num_input * p;
+
+        for (int g = 0; g < num_group; g++)
+        {
+            const int k0 = g * group_size;
+            const int size = std::min(group_size, num_input - k0);
+
+            // group_size is even for int4, every group starts at a whole byte
+            signed char* pp = outptr + k0 / 2;
+
+            int kk = 0;
+            for (; kk + 31 < size; kk += 32)
+            {
+                for (int j = 0; j < 16; j++)
+                {
+                    const int v0 = weight_quant_value(qptr, q0 + k0 + kk + j, 4);
+                    const int v1 = weight_quant_value(qptr, q0 + k0 + kk + 16 + j, 4);
+                    pp[j] = (signed char)((v0 & 15) | (v1 << 4));
+                }
+                pp += 16;
+            }
+            for (; kk < size; kk += 2)
+            {
+                const int v0 = weight_quant_value(qptr, q0 + k0 + kk, 4);
+                const int v1 = kk + 1 < size ? weight_quant_value(qptr, q0 + k0 + kk + 1, 4) : 0;
+                pp[0] = (signed char)((v0 & 15) | (v1 << 4));
+                pp += 1;
+            }
+        }
+    }
+}
+
+#if __SSE2__
+static NCNN_FORCEINLINE void load_weight_block_int8(const signed char* kptr, int bits, __m128i& _lo, __m128i& _hi)
+{
+    if (bits == 8)
+    {
+        _lo = _mm_loadu_si128((const __m128i*)kptr);
+        _hi = _mm_loadu_si128((const __m128i*)(kptr + 16));
+    }
+    else
+    {
+        const __m128i _15 = _mm_set1_epi8(15);
+        const __m128i _8 = _mm_set1_epi8(8);
+        __m128i _b = _mm_loadu_si128((const __m128i*)kptr);
+        _lo = _mm_sub_epi8(_mm_xor_si128(_mm_and_si128(_b, _15), _8), _8);
+        _hi = _mm_sub_epi8(_mm_xor_si128(_mm_and_si128(_mm_srli_epi16(_b, 4), _15), _8), _8);
+    }
+}
+
+#if !__AVX2__
+static NCNN_FORCEINLINE void int8_to_float_sse(const __m128i& _v, __m128& _w0, __m128& _w1, __m128& _w2, __m128& _w3)
+{
+    // sign extend via the high half of wider lanes
+    __m128i _v01 = _mm_srai_epi16(_mm_unpacklo_epi8(_v, _v), 8);
+    __m128i _v23 = _mm_srai_epi16(_mm_unpackhi_epi8(_v, _v), 8);
+    _w0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(_v01, _v01), 16));
+    _w1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(_v01, _v01), 16));
+    _w2 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(_v23, _v23), 16));
+    _w3 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(_v23, _v23), 16));
+}
+#endif // !__AVX2__
+#endif // __SSE2__
+
+// decode one group of weights scaled to fp32
+static void dequantize_weight_group(const signed char* kptr, int size, int bits, float scale, float* pp)
+{
+    // bytes of a block of 32 values
+    const int block_bytes = bits == 8 ? 32 : 16;
+
+    int kk = 0;
+#if __SSE2__
+    for (; kk + 31 < size; kk += 32)
+    {
+        __m128i _lo;
+        __m128i _hi;
+        load_weight_block_int8(kptr, bits, _lo, _hi);
+#if __AVX512F__
+        __m512 _scale = _mm512_set1_ps(scale);
+        _mm512_storeu_ps(pp + kk, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_lo)), _scale));
+        _mm512_storeu_ps(pp + kk + 16, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_hi)), _scale));
+#elif __AVX2__
+        __m256 _scale = _mm256_set1_ps(scale);
+        _mm256_storeu_ps(pp + kk, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_lo)), _scale));
+        _mm256_storeu_ps(pp + kk + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(_lo, 8))), _scale));
+        _mm256_storeu_ps(pp + kk + 16, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_hi)), _scale));
+        _mm256_storeu_ps(pp + kk + 24, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(_hi, 8))), _scale));
+#else
+        __m128 _scale = _mm_set1_ps(scale);
+        __m128 _w[8];
+        int8_to_float_sse(_lo, _w[0], _w[1], _w[2], _w[3]);
+        int8_to_float_sse(_hi, _w[4], _w[5], _w[6], _w[7]);
+        for (int j = 0; j < 8; j++)
+        {
+            _mm_storeu_ps(pp + kk + j * 4, _mm_mul_ps(_w[j], _scale));
+        }
+#endif
+        kptr += block_bytes;
+    }
+#endif // __SSE2__
+    // the tail packed two per byte
+    const int tail = kk;
+    for (; kk < size; kk++)
+    {
+        pp[kk] = weight_quant_value(kptr, kk - tail, bits) * scale;
+    }
+}
+
+static inline const float* weight_quant_row(const Mat& m, int i)
+{
+    return m.dims == 3 ? (const float*)m.channel(i) : (const float*)m + (size_t)m.w * i;
+}
+
+// top_blob row i = bottom_blob row i * weight^T + bias, the rows of dims 2 or channels of dims 3 blobs, or the single row of dims 1
+static int innerproduct_weight_quant_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& weight_scales, int bits, int group_size, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    const int num_input = bottom_blob.w;
+    const int M = bottom_blob.dims == 3 ? bottom_blob.c : bottom_blob.dims == 2 ? bottom_blob.h : 1;
+    const int num_output = weight_data_tm.h;
+    const int num_group = weight_scales.w;
+
+    const int panel_size = std::min(group_size, num_input);
+
+    // one decoded group panel and the row sums per thread
+    Mat panel(panel_size + M, 1, opt.num_threads, 4u, opt.workspace_allocator);
+    if (panel.empty())
+        return -100;
+
+    const float* bias_data_ptr = bias_data;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        const signed char* kptr0 = weight_data_tm.row<const signed char>(p);
+        const float* sptr = weight_scales.row(p);
+
+        float* pp = panel.channel(get_omp_thread_num());
+        float* sums = pp + panel_size;
+
+        const float bias = bias_data_ptr ? bias_data_ptr[p] : 0.f;
+        for (int i = 0; i < M; i++)
+        {
+            sums[i] = bias;
+        }
+
+        for (int g = 0; g < num_group; g++)
+        {
+            const int k0 = g * group_size;
+            const int size = std::min(group_size, num_input - k0);
+
+            dequantize_weight_group(kptr0 + (bits == 8 ? k0 : k0 / 2), size, bits, sptr[g], pp);
+
+            int i = 0;
+            for (; i + 3 < M; i += 4)
+            {
+                const float* ptr0 = weight_quant_row(bottom_blob, i) + k0;
+                const float* ptr1 = weight_quant_row(bottom_blob, i + 1) + k0;
+                const float* ptr2 = weight_quant_row(bottom_blob, i + 2) + k0;
+                const float* ptr3 = weight_quant_row(bottom_blob, i + 3) + k0;
+
+                float sum0 = 0.f;
+                float sum1 = 0.f;
+                float sum2 = 0.f;
+                float sum3 = 0.f;
+
+                int kk = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+                __m512 _sum0 = _mm512_setzero_ps();
+                __m512 _sum1 = _mm512_setzero_ps();
+                __m512 _sum2 = _mm512_setzero_ps();
+                __m512 _sum3 = _mm512_setzero_ps();
+                for (; kk + 15 < size; kk += 16)
+                {
+                    __m512 _w = _mm512_loadu_ps(pp + kk);
+                    _sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(ptr0 + kk), _w, _sum0);
+                    _sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(ptr1 + kk), _w, _sum1);
+                    _sum2 = _mm512_fmadd_ps(_mm512_loadu_ps(ptr2 + kk), _w, _sum2);
+                    _sum3 = _mm512_fmadd_ps(_mm512_loadu_ps(ptr3 + kk), _w, _sum3);
+                }
+                sum0 += _mm512_comp_reduce_add_ps(_sum0);
+                sum1 += _mm512_comp_reduce_add_ps(_sum1);
+                sum2 += _mm512_comp_reduce_add_ps(_sum2);
+                sum3 += _mm512_comp_reduce_add_ps(_sum3);
+#endif // __AVX512F__
+                __m256 _sum0_avx = _mm256_setzero_ps();
+                __m256 _sum1_avx = _mm256_setzero_ps();
+                __m256 _sum2_avx = _mm256_setzero_ps();
+                __m256 _sum3_avx = _mm256_setzero_ps();
+                for (; kk + 7 < size; kk += 8)
+                {
+                    __m256 _w = _mm256_loadu_ps(pp + kk);
+                    _sum0_avx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(ptr0 + kk), _w, _sum0_avx);
+                    _sum1_avx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(ptr1 + kk), _w, _sum1_avx);
+                    _sum2_avx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(ptr2 + kk), _w, _sum2_avx);
+                    _sum3_avx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(ptr3 + kk), _w, _sum3_avx);
+                }
+                sum0 += _mm256_reduce_add_ps(_sum0_avx);
+                sum1 += _mm256_reduce_add_ps(_sum1_avx);
+                sum2 += _mm256_reduce_add_ps(_sum2_avx);
+                sum3 += _mm256_reduce_add_ps(_sum3_avx);
+#endif // __AVX__
+                __m128 _sum0_sse = _mm_setzero_ps();
+                __m128 _sum1_sse = _mm_setzero_ps();
+                __m128 _sum2_sse = _mm_setzero_ps();
+                __m128 _sum3_sse = _mm_setzero_ps();
+                for (; kk + 3 < size; kk += 4)
+                {
+                    __m128 _w = _mm_loadu_ps(pp + kk);
+                    _sum0_sse = _mm_comp_fmadd_ps(_mm_loadu_ps(ptr0 + kk), _w, _sum0_sse);
+                    _sum1_sse = _mm_comp_fmadd_ps(_mm_loadu_ps(ptr1 + kk), _w, _sum1_sse);
+                    _sum2_sse = _mm_comp_fmadd_ps(_mm_loadu_ps(ptr2 + kk), _w, _sum2_sse);
+                    _sum3_sse = _mm_comp_fmadd_ps(_mm_loadu_ps(ptr3 + kk), _w, _sum3_sse);
+                }
+                sum0 += _mm_reduce_add_ps(_sum0_sse);
+                sum1 += _mm_reduce_add_ps(_sum1_sse);
+                sum2 += _mm_reduce_add_ps(_sum2_sse);
+                sum3 += _mm_reduce_add_ps(_sum3_sse);
+#endif // __SSE2__
+                for (; kk < size; kk++)
+                {
+                    sum0 += ptr0[kk] * pp[kk];
+                    sum1 += ptr1[kk] * pp[kk];
+                    sum2 += ptr2[kk] * pp[kk];
+                    sum3 += ptr3[kk] * pp[kk];
+                }
+
+                sums[i] += sum0;
+                sums[i + 1] += sum1;
+                sums[i + 2] += sum2;
+                sums[i + 3] += sum3;
+            }
+            for (; i < M; i++)
+            {
+                const float* ptr = weight_quant_row(bottom_blob, i) + k0;
+
+                float sum = 0.f;
+
+                int kk = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+                __m512 _sum0 = _mm512_setzero_ps();
+                __m512 _sum1 = _mm512_setzero_ps();
+                for (; kk + 31 < size; kk += 32)
+                {
+                    _sum0 = _mm512_fmadd_ps(_mm512_loadu_ps(ptr + kk), _mm512_loadu_ps(pp + kk), _sum0);
+                    _sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(ptr + kk + 16), _mm512_loadu_ps(pp + kk + 16), _sum1);
+                }
+                sum += _mm512_comp_reduce_add_ps(_mm512_add_ps(_sum0, _sum1));
+#endif // __AVX512F__
+                __m256 _sum0_avx = _mm256_setzero_ps();
+                __m256 _sum1_avx = _mm256_setzero_ps();
+                for (; kk + 15 < size; kk += 16)
+                {
+                    _sum0_avx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(ptr + kk), _mm256_loadu_ps(pp + kk), _sum0_avx);
+                    _sum1_avx = _mm256_comp_fmadd_ps(_mm256_loadu_ps(ptr + kk + 8), _mm256_loadu_ps(pp + kk + 8), _sum1_avx);
+                }
+                sum += _mm256_reduce_add_ps(_mm256_add_ps(_sum0_avx, _sum1_avx));
+#endif // __AVX__
+                __m128 _sum0_sse = _mm_setzero_ps();
+                for (; kk + 3 < size; kk += 4)
+                {
+                    _sum0_sse = _mm_comp_fmadd_ps(_mm_loadu_ps(ptr + kk), _mm_loadu_ps(pp + kk), _sum0_sse);
+                }
+                sum += _mm_reduce_add_ps(_sum0_sse);
+#endif // __SSE2__
+                for (; kk < size; kk++)
+                {
+                    sum += ptr[kk] * pp[kk];
+                }
+
+                sums[i] += sum;
+            }
+        }
+
+        for (int i = 0; i < M; i++)
+        {
+            ((float*)weight_quant_row(top_blob, i))[p] = activation_ss(sums[i], activation_type, activation_params);
+        }
+    }
+
+    return 0;
+}
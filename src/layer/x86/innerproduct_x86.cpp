@@ -13,6 +13,8 @@
 #include "x86_activation.h"
 #include "x86_usability.h"
 
+#include "weight_quant.h"
+
 #include "layer_type.h"
 
 #include "cpu.h"
@@ -21,6 +23,16 @@ namespace ncnn {
 
 #include "innerproduct_fp.h"
 #include "innerproduct_gemm_fp.h"
+#include "innerproduct_weight_quant.h"
+
+#if NCNN_BF16
+#include "gemm_bf16s.h"
+#include "innerproduct_bf16s.h"
+#endif
+
+#if NCNN_INT8
+#include "innerproduct_int8_tile.h"
+#endif
 
 #if NCNN_F16C && __AVX__
 #define NCNN_IMPL_FP16S 1
@@ -34,6 +46,9 @@ InnerProduct_x86::InnerProduct_x86()
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_BF16
+    support_bf16_storage = true;
+#endif
 
     flatten = 0;
 }
@@ -51,13 +66,27 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
         flatten->create_pipeline(opt);
     }
 
+    if (weight_quant_bits)
+    {
+        support_bf16_storage = false;
+        return create_pipeline_weight_quant(opt);
+    }
+
 #if NCNN_INT8
     if (opt.use_int8_inference && weight_data.elemsize == (size_t)1u)
     {
+        support_bf16_storage = false;
         return create_pipeline_int8_x86(opt);
     }
 #endif
 
+#if NCNN_BF16
+    if (opt.use_bf16_storage && support_bf16_storage)
+    {
+        return create_pipeline_bf16s(opt);
+    }
+#endif
+
 #if NCNN_F16C && __AVX__
     if (cpu_support_x86_f16c() && opt.use_fp16_storage)
     {
@@ -67,7 +96,8 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
 
     const int num_input = weight_data_size / num_output;
 
-    innerproduct_transform_kernel_sse(weight_data, weight_data_tm, num_input, num_output, opt);
+    if (weight_data_tm.empty())
+        innerproduct_transform_kernel_sse(weight_data, weight_data_tm, num_input, num_output, opt);
 
     if (opt.lightmode)
         weight_data.release();
@@ -87,8 +117,21 @@ int InnerProduct_x86::destroy_pipeline(const Option& opt)
     return 0;
 }
 
+int InnerProduct_x86::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.push_back(&weight_data_tm);
+    weights.push_back(&weight_quant_scales);
+
+    return 0;
+}
+
 int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
 {
+    if (weight_quant_bits)
+    {
+        return forward_weight_quant(bottom_blob, top_blob, opt);
+    }
+
 #if NCNN_INT8
     if (opt.use_int8_inference && int8_scale_term)
     {
@@ -96,6 +139,13 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     }
 #endif
 
+#if NCNN_BF16
+    if (opt.use_bf16_storage && support_bf16_storage)
+    {
+        return forward_bf16s(bottom_blob, top_blob, opt);
+    }
+#endif
+
 #if NCNN_F16C && __AVX__
     if (cpu_support_x86_f16c() && opt.use_fp16_storage)
     {
@@ -160,12 +210,72 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     return 0;
 }
 
+int InnerProduct_x86::create_pipeline_weight_quant(const Option& opt)
+{
+    const int num_input = weight_data_size / num_output;
+
+    if (weight_data_tm.empty())
+        innerproduct_transform_kernel_weight_quant_sse(weight_data, weight_data_quant_scales, weight_data_tm, weight_quant_scales, num_input, num_output, weight_quant_bits, weight_quant_group_size, opt);
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_weight_quant(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int num_input = weight_data_size / num_output;
+
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    Mat bottom_blob_unpacked = bottom_blob;
+    if (bottom_blob.dims == 2 && bottom_blob.w == num_input)
+    {
+        // gemm
+        if (bottom_blob.elempack != 1)
+        {
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_ws);
+            if (bottom_blob_unpacked.empty())
+                return -100;
+        }
+
+        top_blob.create(num_output, bottom_blob_unpacked.h, 4u, opt.blob_allocator);
+    }
+    else
+    {
+        // flatten
+        if (bottom_blob.dims != 1)
+        {
+            flatten->forward(bottom_blob, bottom_blob_unpacked, opt_ws);
+            if (bottom_blob_unpacked.empty())
+                return -100;
+        }
+
+        if (bottom_blob_unpacked.elempack != 1)
+        {
+            Mat bottom_blob_flattened = bottom_blob_unpacked;
+            convert_packing(bottom_blob_flattened, bottom_blob_unpacked, 1, opt_ws);
+            if (bottom_blob_unpacked.empty())
+                return -100;
+        }
+
+        top_blob.create(num_output, 4u, opt.blob_allocator);
+    }
+    if (top_blob.empty())
+        return -100;
+
+    return innerproduct_weight_quant_sse(bottom_blob_unpacked, top_blob, weight_data_tm, weight_quant_scales, weight_quant_bits, weight_quant_group_size, bias_data, activation_type, activation_params, opt);
+}
+
 #if NCNN_F16C && __AVX__
 int InnerProduct_x86::create_pipeline_fp16s(const Option& opt)
 {
     const int num_input = weight_data_size / num_output;
 
-    innerproduct_transform_kernel_fp16s_sse(weight_data, weight_data_tm, num_input, num_output, opt);
+    if (weight_data_tm.empty())
+        innerproduct_transform_kernel_fp16s_sse(weight_data, weight_data_tm, num_input, num_output, opt);
 
     if (opt.lightmode)
         weight_data.release();
@@ -229,6 +339,146 @@ int InnerProduct_x86::forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const
 }
 #endif // NCNN_F16C && __AVX__
 
+#if NCNN_BF16
+int InnerProduct_x86::create_pipeline_bf16s(const Option& opt)
+{
+    const int num_input = weight_data_size / num_output;
+
+    if (weight_data_tm.empty())
+    {
+        innerproduct_transform_kernel_bf16s(weight_data, weight_data_tm, num_input, num_output, opt);
+        if (weight_data_tm.empty())
+            return -100;
+    }
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int num_input = weight_data_size / num_output;
+
+    Option opt_ws = opt;
+    opt_ws.blob_allocator = opt.workspace_allocator;
+
+    // fp32 blobs come from layers running this innerproduct internally, the result goes back to fp32
+    const bool fp32_io = bottom_blob.elembits() == 32;
+
+    Mat bottom_blob_bf16 = bottom_blob;
+    if (fp32_io)
+    {
+        cast_float32_to_bfloat16(bottom_blob, bottom_blob_bf16, opt_ws);
+        if (bottom_blob_bf16.empty())
+            return -100;
+    }
+
+    Mat bottom_blob_unpacked = bottom_blob_bf16;
+    if (bottom_blob_bf16.elempack != 1)
+    {
+        convert_packing(bottom_blob_bf16, bottom_blob_unpacked, 1, opt_ws);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+    }
+
+    Allocator* top_allocator = fp32_io ? opt.workspace_allocator : opt.blob_allocator;
+
+    Mat top_blob_bf16;
+    if (bottom_blob_unpacked.dims == 2 && bottom_blob_unpacked.w == num_input)
+    {
+        // gemm
+        top_blob_bf16.create(num_output, bottom_blob_unpacked.h, 2u, top_allocator);
+    }
+    else
+    {
+        // flatten
+        if (bottom_blob_unpacked.dims != 1)
+        {
+            Mat bottom_blob_flattened = bottom_blob_unpacked.reshape(num_input, opt.workspace_allocator);
+            if (bottom_blob_flattened.empty())
+                return -100;
+
+            bottom_blob_unpacked = bottom_blob_flattened;
+        }
+
+        top_blob_bf16.create(num_output, 2u, top_allocator);
+    }
+    if (top_blob_bf16.empty())
+        return -100;
+
+    int ret = innerproduct_bf16s(bottom_blob_unpacked, top_blob_bf16, weight_data_tm, bias_data, activation_type, activation_params, opt);
+    if (ret != 0)
+        return ret;
+
+    if (fp32_io)
+    {
+        // back to the packed fp32 layout the fp32 path produces
+        if (top_blob_bf16.dims == 2)
+        {
+            // gemm keeps the input packing along h
+            const int out_elempack = bottom_blob.elempack;
+            const int outh = top_blob_bf16.h / out_elempack;
+
+            top_blob.create(num_output, outh, 4u * out_elempack, out_elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int i = 0; i < outh; i++)
+            {
+                float* outptr = top_blob.row(i);
+
+                for (int k = 0; k < out_elempack; k++)
+                {
+                    const unsigned short* ptr = top_blob_bf16.row<const unsigned short>(i * out_elempack + k);
+
+                    for (int j = 0; j < num_output; j++)
+                    {
+                        outptr[j * out_elempack + k] = bfloat16_to_float32(ptr[j]);
+                    }
+                }
+            }
+        }
+        else
+        {
+            int out_elempack = 1;
+#if __SSE2__
+            if (opt.use_packing_layout)
+            {
+#if __AVX512F__
+                out_elempack = num_output % 16 == 0 ? 16 : num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#elif __AVX__
+                out_elempack = num_output % 8 == 0 ? 8 : num_output % 4 == 0 ? 4 : 1;
+#else
+                out_elempack = num_output % 4 == 0 ? 4 : 1;
+#endif
+            }
+#endif // __SSE2__
+
+            // 1d packing keeps the element order
+            top_blob.create(num_output / out_elempack, 4u * out_elempack, out_elempack, opt.blob_allocator);
+            if (top_blob.empty())
+                return -100;
+
+            const unsigned short* ptr = top_blob_bf16;
+            float* outptr = top_blob;
+            for (int j = 0; j < num_output; j++)
+            {
+                outptr[j] = bfloat16_to_float32(ptr[j]);
+            }
+        }
+    }
+    else
+    {
+        top_blob = top_blob_bf16;
+    }
+
+    return 0;
+}
+#endif // NCNN_BF16
+
 #if NCNN_INT8
 int InnerProduct_x86::create_pipeline_int8_x86(const Option& opt)
 {
@@ -236,7 +486,7 @@ int InnerProduct_x86::create_pipeline_int8_x86(const Option& opt)
 
     int out_elempack = 1;
 #if __SSE2__
-    if (opt.use_packing_layout)
+    if (opt.use_packing_layout && !innerproduct_int8_tile_supported())
     {
         out_elempack = num_output % 8 == 0 ? 8 : 1;
     }
@@ -244,6 +494,14 @@ int InnerProduct_x86::create_pipeline_int8_x86(const Option& opt)
 
     // src = inch-outch
     // dst = pb-inch-outch/pb
+    // the tile kernel takes whole tiles of plain rows
+    if (weight_data_tm.empty() && innerproduct_int8_tile_supported())
+    {
+        innerproduct_int8_tile_transform_kernel(weight_data, weight_data_tm, num_input, num_output);
+        if (weight_data_tm.empty())
+            return -100;
+    }
+    if (weight_data_tm.empty())
     {
         Mat weight_data_r2 = weight_data.reshape(num_input, num_output);
 
@@ -324,13 +582,12 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
         if (top_blob.empty())
             return -100;
 
-        int num_output_elempack = 1;
-#if __SSE2__
-        if (opt.use_packing_layout)
+        if (innerproduct_int8_tile_supported())
         {
-            num_output_elempack = num_output % 8 == 0 ? 8 : 1;
+            return innerproduct_int8_tile(bottom_blob_int8_unpacked, top_blob, weight_data_tm, scale_in_data, bias_data, activation_type, activation_params, opt);
         }
-#endif
+
+        const int num_output_elempack = weight_data_tm.elempack;
 
 #if __SSE2__
         if (num_output_elempack == 8 && out_elempack == 4)
@@ -633,19 +890,18 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
 
     //     int elempack = bottom_blob_int8_flattened.elempack;
 
-    int out_elempack = 1;
-#if __SSE2__
-    if (opt.use_packing_layout)
-    {
-        out_elempack = num_output % 8 == 0 ? 8 : 1;
-    }
-#endif // __SSE2__
+    const int out_elempack = weight_data_tm.elempack;
     //     size_t out_elemsize = elemsize / elempack * out_elempack;
 
     top_blob.create(num_output / out_elempack, (size_t)(4u * out_elempack), out_elempack, opt.blob_allocator);
     if (top_blob.empty())
         return -100;
 
+    if (innerproduct_int8_tile_supported())
+    {
+        return innerproduct_int8_tile(bottom_blob_int8_flattened, top_blob, weight_data_tm, scale_in_data, bias_data, activation_type, activation_params, opt);
+    }
+
 #if __SSE2__
     if (out_elempack == 8)
     {
@@ -16,13 +16,21 @@ public:
     virtual int create_pipeline(const Option& opt);
     virtual int destroy_pipeline(const Option& opt);
 
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
 protected:
+    int create_pipeline_weight_quant(const Option& opt);
+    int forward_weight_quant(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #if NCNN_F16C && __AVX__
     int create_pipeline_fp16s(const Option& opt);
     int forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #endif
+#if NCNN_BF16
+    int create_pipeline_bf16s(const Option& opt);
+    int forward_bf16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif
 #if NCNN_INT8
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
@@ -33,6 +41,9 @@ public:
 
     Mat weight_data_tm;
 
+    // per group scales of the weight-only quantized weight_data_tm
+    Mat weight_quant_scales;
+
 #if NCNN_INT8
     Mat scale_in_data;
 #endif
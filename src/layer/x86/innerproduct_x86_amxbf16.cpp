@@ -0,0 +1,21 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "innerproduct_x86.h"
+
+#include "cpu.h"
+#include "mat.h"
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "gemm_bf16s.h"
+#include "innerproduct_bf16s.h"
+
+int innerproduct_bf16s_amxbf16(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    return innerproduct_bf16s(bottom_blob, top_blob, weight_data_tm, bias_data, activation_type, activation_params, opt);
+}
+
+} // namespace ncnn
@@ -0,0 +1,20 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "innerproduct_x86.h"
+
+#include "cpu.h"
+#include "mat.h"
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "innerproduct_int8_tile.h"
+
+int innerproduct_int8_tile_amxint8(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& scale_in_data, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    return innerproduct_int8_tile(bottom_blob, top_blob, weight_data_tm, scale_in_data, bias_data, activation_type, activation_params, opt);
+}
+
+} // namespace ncnn
@@ -39,6 +39,19 @@ int LSTM_x86::create_pipeline(const Option& opt)
     }
 #endif
 
+    if (!weight_xc_data_packed.empty())
+    {
+        // restored from opt.weight_cache
+        if (opt.lightmode)
+        {
+            weight_xc_data.release();
+            bias_c_data.release();
+            weight_hc_data.release();
+        }
+
+        return 0;
+    }
+
     // pack IFOG
     int num_directions = direction == 2 ? 2 : 1;
     int size = weight_data_size / num_directions / hidden_size / 4;
@@ -195,6 +208,19 @@ int LSTM_x86::create_pipeline(const Option& opt)
     return 0;
 }
 
+int LSTM_x86::get_pipeline_weights(std::vector<Mat*>& weights)
+{
+    weights.push_back(&weight_xc_data_packed);
+    weights.push_back(&bias_c_data_packed);
+    weights.push_back(&weight_hc_data_packed);
+    weights.push_back(&weight_data_tm);
+#if NCNN_INT8
+    weights.push_back(&weight_data_tm_int8_descales);
+#endif
+
+    return 0;
+}
+
 static int lstm(const Mat& bottom_blob, Mat& top_blob, int reverse, const Mat& weight_xc, const Mat& bias_c, const Mat& weight_hc, const Mat& weight_hr, Mat& hidden_state, Mat& cell_state, const Option& opt)
 {
     int size = bottom_blob.w;
@@ -738,7 +764,8 @@ int LSTM_x86::create_pipeline_int8(const Option& opt)
     const int num_directions = direction == 2 ? 2 : 1;
     const int size = weight_data_size / num_directions / hidden_size / 4;
 
-    lstm_transform_weight_int8(weight_xc_data, weight_xc_data_int8_scales, weight_hc_data, weight_hc_data_int8_scales, bias_c_data, weight_data_tm, weight_data_tm_int8_descales, bias_c_data_packed, size, num_output, num_directions, hidden_size, opt);
+    if (weight_data_tm.empty())
+        lstm_transform_weight_int8(weight_xc_data, weight_xc_data_int8_scales, weight_hc_data, weight_hc_data_int8_scales, bias_c_data, weight_data_tm, weight_data_tm_int8_descales, bias_c_data_packed, size, num_output, num_directions, hidden_size, opt);
 
     if (opt.lightmode)
     {
@@ -15,6 +15,8 @@ public:
 
     virtual int create_pipeline(const Option& opt);
 
+    virtual int get_pipeline_weights(std::vector<Mat*>& weights);
+
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
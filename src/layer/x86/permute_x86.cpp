@@ -0,0 +1,200 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "permute_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+namespace ncnn {
+
+Permute_x86::Permute_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+// output w h d c taken from input axis 0 = w, 1 = h, 2 = d, 3 = the outermost packed axis
+static const int permute_order_2d[2][4] = {
+    {0, 1, 2, 3}, // w h
+    {3, 1, 2, 0}, // h w
+};
+
+static const int permute_order_3d[6][4] = {
+    {0, 1, 2, 3}, // w h c
+    {1, 0, 2, 3}, // h w c
+    {0, 3, 2, 1}, // w c h
+    {3, 0, 2, 1}, // c w h
+    {1, 3, 2, 0}, // h c w
+    {3, 1, 2, 0}, // c h w
+};
+
+static const int permute_order_4d[24][4] = {
+    {0, 1, 2, 3}, // w h d c
+    {1, 0, 2, 3}, // h w d c
+    {0, 2, 1, 3}, // w d h c
+    {2, 0, 1, 3}, // d w h c
+    {1, 2, 0, 3}, // h d w c
+    {2, 1, 0, 3}, // d h w c
+    {0, 1, 3, 2}, // w h c d
+    {1, 0, 3, 2}, // h w c d
+    {0, 3, 1, 2}, // w c h d
+    {3, 0, 1, 2}, // c w h d
+    {1, 3, 0, 2}, // h c w d
+    {3, 1, 0, 2}, // c h w d
+    {0, 2, 3, 1}, // w d c h
+    {2, 0, 3, 1}, // d w c h
+    {0, 3, 2, 1}, // w c d h
+    {3, 0, 2, 1}, // c w d h
+    {2, 3, 0, 1}, // d c w h
+    {3, 2, 0, 1}, // c d w h
+    {1, 2, 3, 0}, // h d c w
+    {2, 1, 3, 0}, // d h c w
+    {1, 3, 2, 0}, // h c d w
+    {3, 1, 2, 0}, // c h d w
+    {2, 3, 1, 0}, // d c h w
+    {3, 2, 1, 0}, // c d h w
+};
+
+static void permute_copy_pack(const float* ptr, float* outptr, int elempack)
+{
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        _mm512_storeu_ps(outptr, _mm512_loadu_ps(ptr));
+        return;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        _mm256_storeu_ps(outptr, _mm256_loadu_ps(ptr));
+        return;
+    }
+#endif // __AVX__
+    if (elempack == 4)
+    {
+        _mm_storeu_ps(outptr, _mm_loadu_ps(ptr));
+        return;
+    }
+#endif // __SSE2__
+    for (int k = 0; k < elempack; k++)
+    {
+        outptr[k] = ptr[k];
+    }
+}
+
+int Permute_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int dims = bottom_blob.dims;
+    const int elempack = bottom_blob.elempack;
+
+    if (dims == 1 || order_type == 0)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+
+    const int* order = dims == 2 ? permute_order_2d[order_type] : dims == 3 ? permute_order_3d[order_type] : permute_order_4d[order_type];
+
+    // inner w h d of one outer pack and the unpacked outer size
+    int shape[4];
+    shape[0] = bottom_blob.w;
+    shape[1] = dims >= 3 ? bottom_blob.h : 1;
+    shape[2] = dims == 4 ? bottom_blob.d : 1;
+    shape[3] = (dims == 2 ? bottom_blob.h : bottom_blob.c) * elempack;
+
+    const size_t outer_stride = (dims >= 3 ? bottom_blob.cstep : (size_t)bottom_blob.w) * elempack;
+
+    const int outw = shape[order[0]];
+    const int outh = shape[order[1]];
+    const int outd = shape[order[2]];
+    const int outc = shape[order[3]];
+
+    // the packed axis stays outermost, otherwise pack the new outermost axis afresh
+    int out_elempack = elempack;
+    if (order[3] != 3)
+    {
+        out_elempack = 1;
+#if __SSE2__
+        if (opt.use_packing_layout)
+        {
+#if __AVX512F__
+            out_elempack = outc % 16 == 0 ? 16 : outc % 8 == 0 ? 8 : outc % 4 == 0 ? 4 : 1;
+#elif __AVX__
+            out_elempack = outc % 8 == 0 ? 8 : outc % 4 == 0 ? 4 : 1;
+#else
+            out_elempack = outc % 4 == 0 ? 4 : 1;
+#endif
+        }
+#endif // __SSE2__
+    }
+    const size_t out_elemsize = bottom_blob.elemsize / elempack * out_elempack;
+
+    if (dims == 2)
+        top_blob.create(outw, outc / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (dims == 3)
+        top_blob.create(outw, outh, outc / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (dims == 4)
+        top_blob.create(outw, outh, outd, outc / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const size_t out_outer_stride = (dims >= 3 ? top_blob.cstep : (size_t)top_blob.w) * out_elempack;
+
+    const int istride[3] = {elempack, shape[0] * elempack, shape[0] * shape[1] * elempack};
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < outc / out_elempack; q++)
+    {
+        float* outptr = (float*)top_blob + out_outer_stride * q;
+
+        int coord[4];
+        for (int z = 0; z < outd; z++)
+        {
+            coord[order[2]] = z;
+            for (int y = 0; y < outh; y++)
+            {
+                coord[order[1]] = y;
+
+                if (order[3] == 3)
+                {
+                    // whole packs move together
+                    coord[3] = q;
+                    const float* ptr = (const float*)bottom_blob + outer_stride * q;
+
+                    for (int x = 0; x < outw; x++)
+                    {
+                        coord[order[0]] = x;
+                        permute_copy_pack(ptr + coord[0] * istride[0] + coord[1] * istride[1] + coord[2] * istride[2], outptr, elempack);
+                        outptr += elempack;
+                    }
+                    continue;
+                }
+
+                for (int x = 0; x < outw; x++)
+                {
+                    coord[order[0]] = x;
+                    for (int k = 0; k < out_elempack; k++)
+                    {
+                        coord[order[3]] = q * out_elempack + k;
+
+                        const int c = coord[3];
+                        const float* ptr = (const float*)bottom_blob + outer_stride * (c / elempack) + c % elempack;
+                        *outptr++ = ptr[coord[0] * istride[0] + coord[1] * istride[1] + coord[2] * istride[2]];
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
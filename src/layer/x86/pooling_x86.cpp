@@ -28,11 +28,18 @@ namespace ncnn {
 #endif // __AVX__
 #endif // __SSE2__
 
+#if NCNN_F16C && __F16C__
+#include "fp16s_pixel.h"
+#endif
+
 Pooling_x86::Pooling_x86()
 {
 #if __SSE2__
     support_packing = true;
 #endif // __SSE2__
+#if NCNN_F16C && __F16C__
+    support_fp16_storage = true;
+#endif
 }
 
 int Pooling_x86::create_pipeline(const Option& /*opt*/)
@@ -59,6 +66,11 @@ int Pooling_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
         return Pooling::forward(bottom_blob, top_blob, opt);
     }
 
+#if NCNN_F16C && __F16C__
+    if (opt.use_fp16_storage && bottom_blob.elembits() == 16)
+        return forward_fp16s(bottom_blob, top_blob, opt);
+#endif
+
 #if __SSE2__
     int elempack = bottom_blob.elempack;
     int w = bottom_blob.w;
@@ -815,4 +827,176 @@ int Pooling_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
 #endif
 }
 
+#if NCNN_F16C && __F16C__
+int Pooling_x86::forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int channels = bottom_blob.c;
+    const size_t elemsize = bottom_blob.elemsize;
+    const int elempack = bottom_blob.elempack;
+
+    if (global_pooling)
+    {
+        top_blob.create(channels, elemsize, elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        const int size = w * h;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            const unsigned short* ptr = bottom_blob.channel(q);
+
+            float acc[16];
+            float val[16];
+            load_fp16s_pixel(ptr, acc, elempack);
+            if (pooling_type == PoolMethod_AVE)
+            {
+                for (int i = 1; i < size; i++)
+                {
+                    load_fp16s_pixel(ptr + i * elempack, val, elempack);
+                    for (int k = 0; k < elempack; k++)
+                        acc[k] += val[k];
+                }
+                for (int k = 0; k < elempack; k++)
+                    acc[k] /= size;
+            }
+            else
+            {
+                for (int i = 1; i < size; i++)
+                {
+                    load_fp16s_pixel(ptr + i * elempack, val, elempack);
+                    for (int k = 0; k < elempack; k++)
+                        acc[k] = std::max(acc[k], val[k]);
+                }
+            }
+
+            unsigned short* outptr = top_blob;
+            store_fp16s_pixel(acc, outptr + q * elempack, elempack);
+        }
+
+        return 0;
+    }
+
+    // the padded border is virtual, resolve it the same way as make_padding
+    int pad_l = pad_left;
+    int pad_t = pad_top;
+    int wpadded = w + pad_left + pad_right;
+    int hpadded = h + pad_top + pad_bottom;
+    int wtailpad = 0;
+    int htailpad = 0;
+    if (pad_mode == 0) // full padding
+    {
+        int wtail = (w + pad_left + pad_right - kernel_w) % stride_w;
+        int htail = (h + pad_top + pad_bottom - kernel_h) % stride_h;
+
+        if (wtail != 0)
+            wtailpad = stride_w - wtail;
+        if (htail != 0)
+            htailpad = stride_h - htail;
+
+        wpadded += wtailpad;
+        hpadded += htailpad;
+    }
+    else if (pad_mode == 2 || pad_mode == 3) // same upper / same lower
+    {
+        int wpad = kernel_w + (w - 1) / stride_w * stride_w - w;
+        int hpad = kernel_h + (h - 1) / stride_h * stride_h - h;
+        if (wpad > 0 || hpad > 0)
+        {
+            pad_l = pad_mode == 2 ? wpad / 2 : wpad - wpad / 2;
+            pad_t = pad_mode == 2 ? hpad / 2 : hpad - hpad / 2;
+            wpadded = w + wpad;
+            hpadded = h + hpad;
+        }
+        else
+        {
+            pad_l = 0;
+            pad_t = 0;
+            wpadded = w;
+            hpadded = h;
+        }
+    }
+
+    const int outw = (wpadded - kernel_w) / stride_w + 1;
+    const int outh = (hpadded - kernel_h) / stride_h + 1;
+
+    top_blob.create(outw, outh, channels, elemsize, elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int maxk = kernel_w * kernel_h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const Mat m = bottom_blob.channel(q);
+        unsigned short* outptr = top_blob.channel(q);
+
+        float acc[16];
+        float val[16];
+
+        for (int i = 0; i < outh; i++)
+        {
+            for (int j = 0; j < outw; j++)
+            {
+                const int sy0 = i * stride_h;
+                const int sx0 = j * stride_w;
+
+                int area = 0;
+
+                for (int k = 0; k < elempack; k++)
+                    acc[k] = pooling_type == PoolMethod_MAX ? -FLT_MAX : 0.f;
+
+                for (int ki = 0; ki < kernel_h; ki++)
+                {
+                    const int y = sy0 + ki - pad_t;
+
+                    // counting rule for the average without padding, matching the fp32 path
+                    const bool y_counted = sy0 + ki >= pad_top && sy0 + ki < hpadded - pad_bottom - htailpad;
+
+                    for (int kj = 0; kj < kernel_w; kj++)
+                    {
+                        const int x = sx0 + kj - pad_l;
+
+                        if (y_counted && sx0 + kj >= pad_left && sx0 + kj < wpadded - pad_right - wtailpad)
+                            area += 1;
+
+                        if (y < 0 || y >= h || x < 0 || x >= w)
+                            continue;
+
+                        load_fp16s_pixel(m.row<const unsigned short>(y) + x * elempack, val, elempack);
+
+                        if (pooling_type == PoolMethod_MAX)
+                        {
+                            for (int k = 0; k < elempack; k++)
+                                acc[k] = std::max(acc[k], val[k]);
+                        }
+                        else
+                        {
+                            for (int k = 0; k < elempack; k++)
+                                acc[k] += val[k];
+                        }
+                    }
+                }
+
+                if (pooling_type == PoolMethod_AVE)
+                {
+                    const float inv_area = avgpool_count_include_pad == 0 ? 1.f / area : 1.f / maxk;
+                    for (int k = 0; k < elempack; k++)
+                        acc[k] *= inv_area;
+                }
+
+                store_fp16s_pixel(acc, outptr, elempack);
+                outptr += elempack;
+            }
+        }
+    }
+
+    return 0;
+}
+#endif // NCNN_F16C && __F16C__
+
 } // namespace ncnn
@@ -16,6 +16,11 @@ public:
     virtual int create_pipeline(const Option& opt);
     virtual int forward(const Mat& bottom_blob, Mat& top_blob,
                         const Option& opt) const;
+
+protected:
+#if NCNN_F16C && __F16C__
+    int forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+#endif
 };
 
 } // namespace ncnn
@@ -0,0 +1,656 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "reduction_x86.h"
+
+#include <float.h>
+#include <string.h>
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+namespace ncnn {
+
+Reduction_x86::Reduction_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+namespace Reduction_x86_functor {
+
+struct reduction_op_add
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return x + y;
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_add_ps(x, y);
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_add_ps(x, y);
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_add_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_mul
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return x * y;
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_mul_ps(x, y);
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_mul_ps(x, y);
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_mul_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_asum
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return x + fabsf(y);
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_add_ps(x, _mm_andnot_ps(_mm_set1_ps(-0.f), y));
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_add_ps(x, _mm256_andnot_ps(_mm256_set1_ps(-0.f), y));
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_add_ps(x, _mm512_abs_ps(y));
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_sumsq
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return x + y * y;
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_comp_fmadd_ps(y, y, x);
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_comp_fmadd_ps(y, y, x);
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_fmadd_ps(y, y, x);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_sumexp
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return x + expf(y);
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_add_ps(x, exp_ps(y));
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_add_ps(x, exp256_ps(y));
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_add_ps(x, exp512_ps(y));
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_max
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return std::max(x, y);
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_max_ps(x, y);
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_max_ps(x, y);
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_max_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+struct reduction_op_min
+{
+    NCNN_FORCEINLINE float func(const float& x, const float& y) const
+    {
+        return std::min(x, y);
+    }
+#if __SSE2__
+    NCNN_FORCEINLINE __m128 func_pack4(const __m128& x, const __m128& y) const
+    {
+        return _mm_min_ps(x, y);
+    }
+#if __AVX__
+    NCNN_FORCEINLINE __m256 func_pack8(const __m256& x, const __m256& y) const
+    {
+        return _mm256_min_ps(x, y);
+    }
+#if __AVX512F__
+    NCNN_FORCEINLINE __m512 func_pack16(const __m512& x, const __m512& y) const
+    {
+        return _mm512_min_ps(x, y);
+    }
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+};
+
+} // namespace Reduction_x86_functor
+
+// fold size packs of elempack lanes into the single pack at outptr
+template<typename Op>
+static void reduction_pack(const float* ptr, float* outptr, int size, int elempack)
+{
+    const Op op;
+
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    if (elempack == 16)
+    {
+        __m512 _sum = _mm512_loadu_ps(outptr);
+        for (int i = 0; i < size; i++)
+        {
+            _sum = op.func_pack16(_sum, _mm512_loadu_ps(ptr));
+            ptr += 16;
+        }
+        _mm512_storeu_ps(outptr, _sum);
+        return;
+    }
+#endif // __AVX512F__
+    if (elempack == 8)
+    {
+        __m256 _sum = _mm256_loadu_ps(outptr);
+        for (int i = 0; i < size; i++)
+        {
+            _sum = op.func_pack8(_sum, _mm256_loadu_ps(ptr));
+            ptr += 8;
+        }
+        _mm256_storeu_ps(outptr, _sum);
+        return;
+    }
+#endif // __AVX__
+    if (elempack == 4)
+    {
+        __m128 _sum = _mm_loadu_ps(outptr);
+        for (int i = 0; i < size; i++)
+        {
+            _sum = op.func_pack4(_sum, _mm_loadu_ps(ptr));
+            ptr += 4;
+        }
+        _mm_storeu_ps(outptr, _sum);
+        return;
+    }
+#endif // __SSE2__
+
+    float sum = outptr[0];
+    for (int i = 0; i < size; i++)
+    {
+        sum = op.func(sum, ptr[i]);
+    }
+    outptr[0] = sum;
+}
+
+// outptr[i] = op(outptr[i], ptr[i]) for size contiguous floats
+template<typename Op>
+static void reduction_elementwise(const float* ptr, float* outptr, int size)
+{
+    const Op op;
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; i + 15 < size; i += 16)
+    {
+        _mm512_storeu_ps(outptr + i, op.func_pack16(_mm512_loadu_ps(outptr + i), _mm512_loadu_ps(ptr + i)));
+    }
+#endif // __AVX512F__
+    for (; i + 7 < size; i += 8)
+    {
+        _mm256_storeu_ps(outptr + i, op.func_pack8(_mm256_loadu_ps(outptr + i), _mm256_loadu_ps(ptr + i)));
+    }
+#endif // __AVX__
+    for (; i + 3 < size; i += 4)
+    {
+        _mm_storeu_ps(outptr + i, op.func_pack4(_mm_loadu_ps(outptr + i), _mm_loadu_ps(ptr + i)));
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        outptr[i] = op.func(outptr[i], ptr[i]);
+    }
+}
+
+// reduce the w h d block of one outer pack, the reduced axes collapse to one
+template<typename Op>
+static void reduction_inner(const float* ptr, float* outptr, int w, int h, int d, bool reduce_w, bool reduce_h, bool reduce_d, int elempack)
+{
+    const int outw = reduce_w ? 1 : w;
+    const int outh = reduce_h ? 1 : h;
+
+    for (int z = 0; z < d; z++)
+    {
+        for (int y = 0; y < h; y++)
+        {
+            const float* p = ptr + (z * h + y) * w * elempack;
+            float* outp = outptr + ((reduce_d ? 0 : z) * outh + (reduce_h ? 0 : y)) * outw * elempack;
+
+            if (reduce_w)
+                reduction_pack<Op>(p, outp, w, elempack);
+            else
+                reduction_elementwise<Op>(p, outp, w * elempack);
+        }
+    }
+}
+
+static void reduction_inner(const float* ptr, float* outptr, int w, int h, int d, bool reduce_w, bool reduce_h, bool reduce_d, int elempack, int op_type)
+{
+    using namespace Reduction_x86_functor;
+
+    if (op_type == Reduction::ReductionOp_SUM) return reduction_inner<reduction_op_add>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+    if (op_type == Reduction::ReductionOp_ASUM) return reduction_inner<reduction_op_asum>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+    if (op_type == Reduction::ReductionOp_SUMSQ) return reduction_inner<reduction_op_sumsq>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+    if (op_type == Reduction::ReductionOp_PROD) return reduction_inner<reduction_op_mul>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+    if (op_type == Reduction::ReductionOp_MAX) return reduction_inner<reduction_op_max>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+    if (op_type == Reduction::ReductionOp_MIN) return reduction_inner<reduction_op_min>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+    if (op_type == Reduction::ReductionOp_LogSumExp) return reduction_inner<reduction_op_sumexp>(ptr, outptr, w, h, d, reduce_w, reduce_h, reduce_d, elempack);
+
+    // should never reach here
+}
+
+// fold the lanes of every outer pack, partial results in row q of sums
+template<typename Op>
+static void reduction_outer(const Mat& sums, float* outptr, int size, int elempack, const Option& opt)
+{
+    const Op op;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int i = 0; i < size; i++)
+    {
+        float sum = sums.row(0)[i * elempack];
+        for (int q = 0; q < sums.h; q++)
+        {
+            const float* ptr = sums.row(q) + i * elempack;
+            for (int k = q == 0 ? 1 : 0; k < elempack; k++)
+            {
+                sum = op.func(sum, ptr[k]);
+            }
+        }
+        outptr[i] = sum;
+    }
+}
+
+static void reduction_outer(const Mat& sums, float* outptr, int size, int elempack, int op2_type, const Option& opt)
+{
+    using namespace Reduction_x86_functor;
+
+    if (op2_type == Reduction::ReductionOp_SUM) return reduction_outer<reduction_op_add>(sums, outptr, size, elempack, opt);
+    if (op2_type == Reduction::ReductionOp_PROD) return reduction_outer<reduction_op_mul>(sums, outptr, size, elempack, opt);
+    if (op2_type == Reduction::ReductionOp_MAX) return reduction_outer<reduction_op_max>(sums, outptr, size, elempack, opt);
+    if (op2_type == Reduction::ReductionOp_MIN) return reduction_outer<reduction_op_min>(sums, outptr, size, elempack, opt);
+
+    // should never reach here
+}
+
+static void reduction_fill(float* ptr, float v, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        ptr[i] = v;
+    }
+}
+
+int Reduction_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int dims = bottom_blob.dims;
+    const int elempack = bottom_blob.elempack;
+
+    int axes_flag[4] = {0};
+    bool reduce_w = false;
+    bool reduce_h = false;
+    bool reduce_d = false;
+    bool reduce_c = false;
+
+    if (reduce_all)
+    {
+        reduce_w = true;
+        reduce_h = true;
+        reduce_d = true;
+        reduce_c = true;
+    }
+    else
+    {
+        const int* axes_ptr = axes;
+        int reduced_axes_num = axes.w;
+
+        for (int i = 0; i < reduced_axes_num; i++)
+        {
+            int axis = axes_ptr[i];
+            // handle negative axis
+            if (axis < 0)
+                axis += dims;
+            axes_flag[axis] = 1;
+        }
+
+        if (dims == 1)
+        {
+            reduce_w = true;
+        }
+        else if (dims == 2)
+        {
+            if (axes_flag[0] == 1) reduce_h = true;
+            if (axes_flag[1] == 1) reduce_w = true;
+        }
+        else if (dims == 3)
+        {
+            if (axes_flag[0] == 1) reduce_c = true;
+            if (axes_flag[1] == 1) reduce_h = true;
+            if (axes_flag[2] == 1) reduce_w = true;
+        }
+        else if (dims == 4)
+        {
+            if (axes_flag[0] == 1) reduce_c = true;
+            if (axes_flag[1] == 1) reduce_d = true;
+            if (axes_flag[2] == 1) reduce_h = true;
+            if (axes_flag[3] == 1) reduce_w = true;
+        }
+    }
+
+    int op_type = Reduction::ReductionOp_SUM;
+    int op2_type = Reduction::ReductionOp_SUM;
+    float v0 = 0.f;
+
+    switch (operation)
+    {
+    case Reduction::ReductionOp_ASUM:
+    case Reduction::ReductionOp_L1:
+        op_type = Reduction::ReductionOp_ASUM;
+        break;
+    case Reduction::ReductionOp_SUMSQ:
+    case Reduction::ReductionOp_L2:
+        op_type = Reduction::ReductionOp_SUMSQ;
+        break;
+    case Reduction::ReductionOp_MAX:
+        op_type = Reduction::ReductionOp_MAX;
+        op2_type = Reduction::ReductionOp_MAX;
+        v0 = -FLT_MAX;
+        break;
+    case Reduction::ReductionOp_MIN:
+        op_type = Reduction::ReductionOp_MIN;
+        op2_type = Reduction::ReductionOp_MIN;
+        v0 = FLT_MAX;
+        break;
+    case Reduction::ReductionOp_PROD:
+        op_type = Reduction::ReductionOp_PROD;
+        op2_type = Reduction::ReductionOp_PROD;
+        v0 = 1.f;
+        break;
+    case Reduction::ReductionOp_LogSumExp:
+        op_type = Reduction::ReductionOp_LogSumExp;
+        break;
+    default:
+        break;
+    }
+
+    // the outermost axis carries the packing, w h d are the inner axes of one outer pack
+    int w = 1;
+    int h = 1;
+    int d = 1;
+    int outer = bottom_blob.w;
+    size_t outer_stride = elempack;
+    bool reduce_outer = reduce_w;
+    bool reduce_inner_w = false;
+    bool reduce_inner_h = false;
+    bool reduce_inner_d = false;
+    if (dims == 2)
+    {
+        w = bottom_blob.w;
+        outer = bottom_blob.h;
+        outer_stride = (size_t)w * elempack;
+        reduce_outer = reduce_h;
+        reduce_inner_w = reduce_w;
+    }
+    if (dims == 3 || dims == 4)
+    {
+        w = bottom_blob.w;
+        h = bottom_blob.h;
+        d = bottom_blob.d;
+        outer = bottom_blob.c;
+        outer_stride = bottom_blob.cstep * elempack;
+        reduce_outer = reduce_c;
+        reduce_inner_w = reduce_w;
+        reduce_inner_h = reduce_h;
+        reduce_inner_d = dims == 4 && reduce_d;
+    }
+
+    const int outw = reduce_inner_w ? 1 : w;
+    const int outh = reduce_inner_h ? 1 : h;
+    const int outd = reduce_inner_d ? 1 : d;
+    const int inner_size = outw * outh * outd;
+
+    // output shape from the outermost axis inwards
+    int outshape[4];
+    int outdims = 0;
+    {
+        int shape[4];
+        bool reduce[4];
+        int n = 0;
+        shape[n] = outer;
+        reduce[n++] = reduce_outer;
+        if (dims == 4)
+        {
+            shape[n] = d;
+            reduce[n++] = reduce_inner_d;
+        }
+        if (dims >= 3)
+        {
+            shape[n] = h;
+            reduce[n++] = reduce_inner_h;
+        }
+        if (dims >= 2)
+        {
+            shape[n] = w;
+            reduce[n++] = reduce_inner_w;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            if (!reduce[i])
+                outshape[outdims++] = shape[i];
+            else if (keepdims)
+                outshape[outdims++] = 1;
+        }
+
+        if (outdims == 0)
+            outshape[outdims++] = 1;
+    }
+
+    const int out_elempack = reduce_outer ? 1 : elempack;
+    const size_t out_elemsize = bottom_blob.elemsize / elempack * out_elempack;
+
+    if (outdims == 1)
+        top_blob.create(outshape[0], out_elemsize, out_elempack, opt.blob_allocator);
+    if (outdims == 2)
+        top_blob.create(outshape[1], outshape[0], out_elemsize, out_elempack, opt.blob_allocator);
+    if (outdims == 3)
+        top_blob.create(outshape[2], outshape[1], outshape[0], out_elemsize, out_elempack, opt.blob_allocator);
+    if (outdims == 4)
+        top_blob.create(outshape[3], outshape[2], outshape[1], outshape[0], out_elemsize, out_elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    if (!reduce_outer)
+    {
+        // every outer pack reduces into its own output pack
+        const size_t out_outer_stride = (top_blob.dims >= 3 ? top_blob.cstep : top_blob.dims == 2 ? (size_t)top_blob.w : 1) * out_elempack;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < outer; q++)
+        {
+            const float* ptr = (const float*)bottom_blob + outer_stride * q;
+            float* outptr = (float*)top_blob + out_outer_stride * q;
+
+            reduction_fill(outptr, v0, inner_size * elempack);
+            reduction_inner(ptr, outptr, w, h, d, reduce_inner_w, reduce_inner_h, reduce_inner_d, elempack, op_type);
+        }
+    }
+    else
+    {
+        Mat sums(inner_size * elempack, outer, 4u, opt.workspace_allocator);
+        if (sums.empty())
+            return -100;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < outer; q++)
+        {
+            const float* ptr = (const float*)bottom_blob + outer_stride * q;
+            float* outptr = sums.row(q);
+
+            reduction_fill(outptr, v0, inner_size * elempack);
+            reduction_inner(ptr, outptr, w, h, d, reduce_inner_w, reduce_inner_h, reduce_inner_d, elempack, op_type);
+        }
+
+        // the output channels come from the inner axes, gather them unpadded first
+        Mat top_blob_flat = top_blob;
+        if (top_blob.dims >= 3 && top_blob.cstep != (size_t)top_blob.w * top_blob.h * top_blob.d)
+        {
+            top_blob_flat.create(inner_size, 4u, opt.workspace_allocator);
+            if (top_blob_flat.empty())
+                return -100;
+        }
+
+        reduction_outer(sums, top_blob_flat, inner_size, elempack, op2_type, opt);
+
+        if (top_blob_flat.data != top_blob.data)
+        {
+            const int channel_size = top_blob.w * top_blob.h * top_blob.d;
+            for (int q = 0; q < top_blob.c; q++)
+            {
+                memcpy(top_blob.channel(q), (const float*)top_blob_flat + channel_size * q, channel_size * sizeof(float));
+            }
+        }
+    }
+
+    float coeff = this->coeff;
+    if (operation == Reduction::ReductionOp_MEAN)
+    {
+        int scale = 1;
+        if (reduce_outer) scale *= outer * elempack;
+        if (reduce_inner_w) scale *= w;
+        if (reduce_inner_h) scale *= h;
+        if (reduce_inner_d) scale *= d;
+
+        coeff = coeff / scale;
+    }
+
+    const int size = (int)top_blob.total() * out_elempack;
+    float* outptr = top_blob;
+
+    if (operation == Reduction::ReductionOp_LogSum || operation == Reduction::ReductionOp_LogSumExp)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            outptr[i] = logf(outptr[i]);
+        }
+    }
+
+    if (operation == Reduction::ReductionOp_L2)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            // flush subnormal input to zero as the generic layer does
+            outptr[i] = sqrtf(outptr[i] < FLT_MIN ? 0.f : outptr[i]);
+        }
+    }
+
+    if (coeff != 1.f)
+    {
+        for (int i = 0; i < size; i++)
+        {
+            outptr[i] = outptr[i] * coeff;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
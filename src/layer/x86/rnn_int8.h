@@ -0,0 +1,362 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+void rnn_transform_weight_int8_avx512vnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+int rnn_int8_avx512vnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+void rnn_transform_weight_int8_avxvnni(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+int rnn_int8_avxvnni(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt);
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+void rnn_transform_weight_int8_avx2(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt);
+int rnn_int8_avx2(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt);
+#endif
+
+// hidden units are split into blocks of maxpack lanes, the last one zero padded
+static int rnn_int8_maxpack()
+{
+#if __AVX512F__
+    return 16;
+#elif __AVX2__
+    return 8;
+#elif __SSE2__
+    return 4;
+#else
+    return 1;
+#endif
+}
+
+// inputs per dot step, k quads for dpbusd and k pairs for madd
+static int rnn_int8_kstep()
+{
+#if (__AVX512F__ && __AVX512VNNI__) || (!__AVX512F__ && __AVX2__ && (__AVXVNNI__ || __AVX512VNNI__))
+    return 4;
+#else
+    return 2;
+#endif
+}
+
+static int rnn_int8_weight_tm_size(int K, int P)
+{
+    const int kstep = rnn_int8_kstep();
+
+    // the 127 * sum(w) compensation of each hidden unit follows the k quads
+    return (K + kstep - 1) / kstep * kstep * P + (kstep == 4 ? P * 4 : 0);
+}
+
+// weight rows of one block with k steps interleaved as [P x kstep], zero padded
+static void rnn_int8_pack_block(const Mat& weight, int K, int num_output, int q, int P, signed char* pw)
+{
+    const int kstep = rnn_int8_kstep();
+
+    int w_shift[16] = {0};
+    for (int k = 0; k < K; k += kstep)
+    {
+        for (int j = 0; j < P; j++)
+        {
+            const signed char* w = q + j < num_output ? weight.row<const signed char>(q + j) : 0;
+            for (int l = 0; l < kstep; l++)
+            {
+                const signed char v = w && k + l < K ? w[k + l] : 0;
+                w_shift[j] += v;
+                *pw++ = v;
+            }
+        }
+    }
+
+    if (kstep == 4)
+    {
+        for (int j = 0; j < P; j++)
+        {
+            const int s = w_shift[j] * 127;
+            memcpy(pw, &s, sizeof(int));
+            pw += sizeof(int);
+        }
+    }
+}
+
+static void rnn_transform_weight_int8(const Mat& weight_xc, const Mat& weight_xc_int8_scales, const Mat& weight_hc, const Mat& weight_hc_int8_scales, const Mat& bias_c, Mat& weight_xc_tm, Mat& weight_hc_tm, Mat& weight_data_tm_int8_descales, Mat& bias_c_tm, int size, int num_output, int num_directions, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        rnn_transform_weight_int8_avx512vnni(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        rnn_transform_weight_int8_avxvnni(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        rnn_transform_weight_int8_avx2(weight_xc, weight_xc_int8_scales, weight_hc, weight_hc_int8_scales, bias_c, weight_xc_tm, weight_hc_tm, weight_data_tm_int8_descales, bias_c_tm, size, num_output, num_directions, opt);
+        return;
+    }
+#endif
+
+    const int maxpack = rnn_int8_maxpack();
+    const int nblocks = (num_output + maxpack - 1) / maxpack;
+    const int num_output_tm = nblocks * maxpack;
+
+    weight_xc_tm.create(rnn_int8_weight_tm_size(size, maxpack), nblocks, num_directions, (size_t)1u);
+    weight_hc_tm.create(rnn_int8_weight_tm_size(num_output, maxpack), nblocks, num_directions, (size_t)1u);
+    weight_data_tm_int8_descales.create(num_output_tm, 2, num_directions);
+    bias_c_tm.create(num_output_tm, 1, num_directions);
+    if (weight_xc_tm.empty() || weight_hc_tm.empty() || weight_data_tm_int8_descales.empty() || bias_c_tm.empty())
+        return;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int dr = 0; dr < num_directions; dr++)
+    {
+        const Mat weight_xc_dr = weight_xc.channel(dr);
+        const Mat weight_hc_dr = weight_hc.channel(dr);
+        Mat weight_xc_tm_dr = weight_xc_tm.channel(dr);
+        Mat weight_hc_tm_dr = weight_hc_tm.channel(dr);
+
+        for (int b = 0; b < nblocks; b++)
+        {
+            rnn_int8_pack_block(weight_xc_dr, size, num_output, b * maxpack, maxpack, weight_xc_tm_dr.row<signed char>(b));
+            rnn_int8_pack_block(weight_hc_dr, num_output, num_output, b * maxpack, maxpack, weight_hc_tm_dr.row<signed char>(b));
+        }
+
+        const float* weight_xc_int8_scales_ptr = weight_xc_int8_scales.row(dr);
+        const float* weight_hc_int8_scales_ptr = weight_hc_int8_scales.row(dr);
+        const float* bias_c_ptr = bias_c.channel(dr);
+
+        float* descales_xc = weight_data_tm_int8_descales.channel(dr).row(0);
+        float* descales_hc = weight_data_tm_int8_descales.channel(dr).row(1);
+        float* bias_c_tm_ptr = bias_c_tm.channel(dr);
+
+        for (int i = 0; i < num_output_tm; i++)
+        {
+            descales_xc[i] = i < num_output ? 1.f / weight_xc_int8_scales_ptr[i] : 0.f;
+            descales_hc[i] = i < num_output ? 1.f / weight_hc_int8_scales_ptr[i] : 0.f;
+            bias_c_tm_ptr[i] = i < num_output ? bias_c_ptr[i] : 0.f;
+        }
+    }
+}
+
+static NCNN_FORCEINLINE int rnn_int8_pair(const signed char* v, int k, int K)
+{
+    const signed char v0 = v[k];
+    const signed char v1 = k + 1 < K ? v[k + 1] : 0;
+    return (int)(((unsigned int)(unsigned short)(short)v1 << 16) | (unsigned short)(short)v0);
+}
+
+// inputs shifted by 127 to unsigned for dpbusd, the zero padded weights cancel the padded inputs
+static NCNN_FORCEINLINE int rnn_int8_quad_u8(const signed char* v, int k, int K)
+{
+    unsigned int x = 0;
+    for (int l = 0; l < 4; l++)
+    {
+        const int vl = k + l < K ? v[k + l] : 0;
+        x |= (unsigned int)(unsigned char)(vl + 127) << (l * 8);
+    }
+    return (int)x;
+}
+
+// kptr holds one block of maxpack hidden units, see rnn_int8_pack_block
+static void rnn_int8_dot(const signed char* kptr, const signed char* v, int K, int* sums)
+{
+#if __AVX512F__
+    __m512i _H = _mm512_setzero_si512();
+#if __AVX512VNNI__
+    for (int k = 0; k < K; k += 4)
+    {
+        _H = _mm512_dpbusd_epi32(_H, _mm512_set1_epi32(rnn_int8_quad_u8(v, k, K)), _mm512_loadu_si512((const __m512i*)kptr));
+        kptr += 64;
+    }
+    _H = _mm512_sub_epi32(_H, _mm512_loadu_si512((const __m512i*)kptr));
+#else
+    for (int k = 0; k < K; k += 2)
+    {
+        __m512i _w = _mm512_cvtepi8_epi16(_mm256_loadu_si256((const __m256i*)kptr));
+        _H = _mm512_add_epi32(_H, _mm512_madd_epi16(_w, _mm512_set1_epi32(rnn_int8_pair(v, k, K))));
+        kptr += 32;
+    }
+#endif // __AVX512VNNI__
+    _mm512_storeu_si512((__m512i*)sums, _H);
+#elif __AVX2__
+    __m256i _H = _mm256_setzero_si256();
+#if __AVXVNNI__ || __AVX512VNNI__
+    for (int k = 0; k < K; k += 4)
+    {
+        _H = _mm256_comp_dpbusd_epi32(_H, _mm256_set1_epi32(rnn_int8_quad_u8(v, k, K)), _mm256_loadu_si256((const __m256i*)kptr));
+        kptr += 32;
+    }
+    _H = _mm256_sub_epi32(_H, _mm256_loadu_si256((const __m256i*)kptr));
+#else
+    for (int k = 0; k < K; k += 2)
+    {
+        __m256i _w = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)kptr));
+        _H = _mm256_add_epi32(_H, _mm256_madd_epi16(_w, _mm256_set1_epi32(rnn_int8_pair(v, k, K))));
+        kptr += 16;
+    }
+#endif // __AVXVNNI__ || __AVX512VNNI__
+    _mm256_storeu_si256((__m256i*)sums, _H);
+#elif __SSE2__
+    __m128i _H = _mm_setzero_si128();
+    for (int k = 0; k < K; k += 2)
+    {
+        __m128i _w = _mm_loadl_epi64((const __m128i*)kptr);
+        _w = _mm_unpacklo_epi8(_w, _mm_cmpgt_epi8(_mm_setzero_si128(), _w));
+        _H = _mm_add_epi32(_H, _mm_madd_epi16(_w, _mm_set1_epi32(rnn_int8_pair(v, k, K))));
+        kptr += 8;
+    }
+    _mm_storeu_si128((__m128i*)sums, _H);
+#else
+    int H = 0;
+    for (int k = 0; k < K; k += 2)
+    {
+        const signed char v1 = k + 1 < K ? v[k + 1] : 0;
+        H += kptr[0] * v[k] + kptr[1] * v1;
+        kptr += 2;
+    }
+    sums[0] = H;
+#endif
+}
+
+// H = tanh(xH + hH) over one block
+static void rnn_int8_gate(const float* xH, const float* hH, float* outH)
+{
+#if __AVX512F__
+    _mm512_storeu_ps(outH, tanh_avx512(_mm512_add_ps(_mm512_loadu_ps(xH), _mm512_loadu_ps(hH))));
+#elif __AVX2__
+    _mm256_storeu_ps(outH, tanh_avx(_mm256_add_ps(_mm256_loadu_ps(xH), _mm256_loadu_ps(hH))));
+#elif __SSE2__
+    _mm_storeu_ps(outH, tanh_sse(_mm_add_ps(_mm_loadu_ps(xH), _mm_loadu_ps(hH))));
+#else
+    outH[0] = tanhf(xH[0] + hH[0]);
+#endif
+}
+
+// quantize with 127 / absmax and return the descale, an all zero vector gets descale 1
+static float rnn_dynamic_quantize(const float* ptr, int size, signed char* outptr)
+{
+    float absmax = 0.f;
+    for (int i = 0; i < size; i++)
+    {
+        absmax = std::max(absmax, (float)fabs(ptr[i]));
+    }
+
+    if (absmax == 0.f)
+    {
+        memset(outptr, 0, size);
+        return 1.f;
+    }
+
+    const float scale = 127.f / absmax;
+    for (int i = 0; i < size; i++)
+    {
+        outptr[i] = float2int8(ptr[i] * scale);
+    }
+
+    return absmax / 127.f;
+}
+
+static int rnn_int8(const Mat& bottom_blob_int8, const Mat& bottom_blob_int8_descales, Mat& top_blob, int top_offset, int reverse, int num_output, const Mat& weight_xc_tm, const Mat& weight_hc_tm, const Mat& weight_int8_descales, const Mat& bias_c_tm, float* hidden_state, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX512VNNI && __AVX512F__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx512_vnni())
+    {
+        return rnn_int8_avx512vnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVXVNNI && __AVX__ && !__AVX512F__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx_vnni())
+    {
+        return rnn_int8_avxvnni(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+    }
+#endif
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__ && !__AVXVNNI__ && !__AVX512VNNI__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        return rnn_int8_avx2(bottom_blob_int8, bottom_blob_int8_descales, top_blob, top_offset, reverse, num_output, weight_xc_tm, weight_hc_tm, weight_int8_descales, bias_c_tm, hidden_state, opt);
+    }
+#endif
+
+    const int size = bottom_blob_int8.w;
+    const int T = bottom_blob_int8.h;
+    const int maxpack = rnn_int8_maxpack();
+    const int nblocks = weight_hc_tm.h;
+
+    const float* descales_xc = weight_int8_descales.row(0);
+    const float* descales_hc = weight_int8_descales.row(1);
+    const float* bias_c = bias_c_tm;
+
+    // input projection of every timestep ahead of the recurrence
+    Mat xproj(nblocks * maxpack, T, 4u, opt.workspace_allocator);
+    if (xproj.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int tb = 0; tb < T * nblocks; tb++)
+    {
+        const int t = tb / nblocks;
+        const int q = tb % nblocks * maxpack;
+
+        int sums[16] = {0};
+        rnn_int8_dot(weight_xc_tm.row<const signed char>(tb % nblocks), bottom_blob_int8.row<const signed char>(t), size, sums);
+
+        const float descale_x = bottom_blob_int8_descales[t];
+
+        float* xp = xproj.row(t) + q;
+        for (int j = 0; j < maxpack; j++)
+        {
+            xp[j] = bias_c[q + j] + sums[j] * (descale_x * descales_xc[q + j]);
+        }
+    }
+
+    Mat hidden_state_int8(num_output, (size_t)1u, 1, opt.workspace_allocator);
+    if (hidden_state_int8.empty())
+        return -100;
+
+    // unroll
+    for (int t = 0; t < T; t++)
+    {
+        int ti = reverse ? T - 1 - t : t;
+
+        const float descale_h = rnn_dynamic_quantize(hidden_state, num_output, hidden_state_int8);
+
+        const float* xH = xproj.row(ti);
+        float* outptr = top_blob.row(ti) + top_offset;
+
+        // the blocks only read the quantized hidden state, so each one updates its own lanes
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int b = 0; b < nblocks; b++)
+        {
+            const int q = b * maxpack;
+
+            int sums[16] = {0};
+            rnn_int8_dot(weight_hc_tm.row<const signed char>(b), hidden_state_int8, num_output, sums);
+
+            float hsums[16];
+            for (int j = 0; j < maxpack; j++)
+            {
+                hsums[j] = sums[j] * (descale_h * descales_hc[q + j]);
+            }
+
+            float H[16];
+            rnn_int8_gate(xH + q, hsums, H);
+
+            const int P = std::min(maxpack, num_output - q);
+            memcpy(hidden_state + q, H, P * sizeof(float));
+            memcpy(outptr + q, H, P * sizeof(float));
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_RNN_X86_H
+#define LAYER_RNN_X86_H
+
+#include "rnn.h"
+
+namespace ncnn {
+
+class RNN_x86 : public RNN
+{
+public:
+    RNN_x86();
+
+    virtual int create_pipeline(const Option& opt);
+    virtual int destroy_pipeline(const Option& opt);
+
+    virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+protected:
+    int forward_directions(const Mat& bottom_blob, Mat& top_blob, Mat& hidden, const Option& opt) const;
+#if NCNN_INT8
+    int create_pipeline_int8(const Option& opt);
+#endif
+
+public:
+    // input projection of all timesteps and directions as one gemm
+    Layer* gemm_xc;
+
+    Mat bias_c_data_packed;
+    Mat weight_hc_data_packed;
+
+#if NCNN_INT8
+    Mat weight_xc_data_packed;
+    Mat weight_data_tm_int8_descales;
+#endif
+};
+
+} // namespace ncnn
+
+#endif // LAYER_RNN_X86_H
@@ -0,0 +1,179 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "rotaryembed_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+namespace ncnn {
+
+RotaryEmbed_x86::RotaryEmbed_x86()
+{
+}
+
+// x0 and x1 are the two halves of the head
+static void rotaryembed_row(const float* ptr, const float* cos_ptr, const float* sin_ptr, float* outptr, int half_dim)
+{
+    const float* ptr0 = ptr;
+    const float* ptr1 = ptr + half_dim;
+    float* outptr0 = outptr;
+    float* outptr1 = outptr + half_dim;
+
+    int j = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; j + 15 < half_dim; j += 16)
+    {
+        __m512 _x0 = _mm512_loadu_ps(ptr0 + j);
+        __m512 _x1 = _mm512_loadu_ps(ptr1 + j);
+        __m512 _cos = _mm512_loadu_ps(cos_ptr + j);
+        __m512 _sin = _mm512_loadu_ps(sin_ptr + j);
+        __m512 _out0 = _mm512_fmsub_ps(_x0, _cos, _mm512_mul_ps(_x1, _sin));
+        __m512 _out1 = _mm512_fmadd_ps(_x0, _sin, _mm512_mul_ps(_x1, _cos));
+        _mm512_storeu_ps(outptr0 + j, _out0);
+        _mm512_storeu_ps(outptr1 + j, _out1);
+    }
+#endif // __AVX512F__
+    for (; j + 7 < half_dim; j += 8)
+    {
+        __m256 _x0 = _mm256_loadu_ps(ptr0 + j);
+        __m256 _x1 = _mm256_loadu_ps(ptr1 + j);
+        __m256 _cos = _mm256_loadu_ps(cos_ptr + j);
+        __m256 _sin = _mm256_loadu_ps(sin_ptr + j);
+        __m256 _out0 = _mm256_comp_fnmadd_ps(_x1, _sin, _mm256_mul_ps(_x0, _cos));
+        __m256 _out1 = _mm256_comp_fmadd_ps(_x0, _sin, _mm256_mul_ps(_x1, _cos));
+        _mm256_storeu_ps(outptr0 + j, _out0);
+        _mm256_storeu_ps(outptr1 + j, _out1);
+    }
+#endif // __AVX__
+    for (; j + 3 < half_dim; j += 4)
+    {
+        __m128 _x0 = _mm_loadu_ps(ptr0 + j);
+        __m128 _x1 = _mm_loadu_ps(ptr1 + j);
+        __m128 _cos = _mm_loadu_ps(cos_ptr + j);
+        __m128 _sin = _mm_loadu_ps(sin_ptr + j);
+        __m128 _out0 = _mm_sub_ps(_mm_mul_ps(_x0, _cos), _mm_mul_ps(_x1, _sin));
+        __m128 _out1 = _mm_add_ps(_mm_mul_ps(_x0, _sin), _mm_mul_ps(_x1, _cos));
+        _mm_storeu_ps(outptr0 + j, _out0);
+        _mm_storeu_ps(outptr1 + j, _out1);
+    }
+#endif // __SSE2__
+    for (; j < half_dim; j++)
+    {
+        const float x0 = ptr0[j];
+        const float x1 = ptr1[j];
+        const float cos_val = cos_ptr[j];
+        const float sin_val = sin_ptr[j];
+        outptr0[j] = x0 * cos_val - x1 * sin_val;
+        outptr1[j] = x0 * sin_val + x1 * cos_val;
+    }
+}
+
+// x0 and x1 are adjacent pairs, cos/sin are duplicated per pair and x is swapped within pairs
+// so that out = x * cos -+ swap(x) * sin
+static void rotaryembed_row_interleaved(const float* ptr, const float* cos_ptr, const float* sin_ptr, float* outptr, int half_dim)
+{
+    int j = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        const __m512i _idx = _mm512_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7);
+        for (; j + 7 < half_dim; j += 8)
+        {
+            __m512 _x = _mm512_loadu_ps(ptr + j * 2);
+            __m512 _cos = _mm512_permutexvar_ps(_idx, _mm512_castps256_ps512(_mm256_loadu_ps(cos_ptr + j)));
+            __m512 _sin = _mm512_permutexvar_ps(_idx, _mm512_castps256_ps512(_mm256_loadu_ps(sin_ptr + j)));
+            __m512 _xs = _mm512_permute_ps(_x, _MM_SHUFFLE(2, 3, 0, 1));
+            __m512 _out = _mm512_fmaddsub_ps(_x, _cos, _mm512_mul_ps(_xs, _sin));
+            _mm512_storeu_ps(outptr + j * 2, _out);
+        }
+    }
+#endif // __AVX512F__
+    for (; j + 3 < half_dim; j += 4)
+    {
+        __m256 _x = _mm256_loadu_ps(ptr + j * 2);
+        __m128 _cos4 = _mm_loadu_ps(cos_ptr + j);
+        __m128 _sin4 = _mm_loadu_ps(sin_ptr + j);
+        __m256 _cos = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(_cos4, _cos4)), _mm_unpackhi_ps(_cos4, _cos4), 1);
+        __m256 _sin = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(_sin4, _sin4)), _mm_unpackhi_ps(_sin4, _sin4), 1);
+        __m256 _xs = _mm256_permute_ps(_x, _MM_SHUFFLE(2, 3, 0, 1));
+        __m256 _out = _mm256_addsub_ps(_mm256_mul_ps(_x, _cos), _mm256_mul_ps(_xs, _sin));
+        _mm256_storeu_ps(outptr + j * 2, _out);
+    }
+#endif // __AVX__
+    {
+        const __m128 _sign = _mm_setr_ps(-1.f, 1.f, -1.f, 1.f);
+        for (; j + 1 < half_dim; j += 2)
+        {
+            __m128 _x = _mm_loadu_ps(ptr + j * 2);
+            __m128 _cos2 = _mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(cos_ptr + j)));
+            __m128 _sin2 = _mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)(sin_ptr + j)));
+            __m128 _cos = _mm_unpacklo_ps(_cos2, _cos2);
+            __m128 _sin = _mm_mul_ps(_mm_unpacklo_ps(_sin2, _sin2), _sign);
+            __m128 _xs = _mm_shuffle_ps(_x, _x, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 _out = _mm_add_ps(_mm_mul_ps(_x, _cos), _mm_mul_ps(_xs, _sin));
+            _mm_storeu_ps(outptr + j * 2, _out);
+        }
+    }
+#endif // __SSE2__
+    for (; j < half_dim; j++)
+    {
+        const float x0 = ptr[j * 2];
+        const float x1 = ptr[j * 2 + 1];
+        const float cos_val = cos_ptr[j];
+        const float sin_val = sin_ptr[j];
+        outptr[j * 2] = x0 * cos_val - x1 * sin_val;
+        outptr[j * 2 + 1] = x0 * sin_val + x1 * cos_val;
+    }
+}
+
+int RotaryEmbed_x86::forward_rope(const Mat& bottom_blob, const Mat& cos_cache, const Mat& sin_cache, Mat& top_blob, const Option& opt) const
+{
+    const int embed_dim = bottom_blob.w;
+    const int seqlen = bottom_blob.h;
+    const int num_heads = bottom_blob.c;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < num_heads; q++)
+    {
+        const Mat head = bottom_blob.channel(q);
+        Mat out_head = top_blob.channel(q);
+
+        for (int i = 0; i < seqlen; i++)
+        {
+            if (interleaved)
+            {
+                rotaryembed_row_interleaved(head.row(i), cos_cache.row(i), sin_cache.row(i), out_head.row(i), embed_dim / 2);
+            }
+            else
+            {
+                rotaryembed_row(head.row(i), cos_cache.row(i), sin_cache.row(i), out_head.row(i), embed_dim / 2);
+            }
+        }
+    }
+
+    return 0;
+}
+
+int RotaryEmbed_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create_like(bottom_blob, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    return forward_rope(bottom_blob, bottom_blobs[1], bottom_blobs[2], top_blob, opt);
+}
+
+} // namespace ncnn
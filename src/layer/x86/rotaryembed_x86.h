@@ -0,0 +1,24 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_ROTARYEMBED_X86_H
+#define LAYER_ROTARYEMBED_X86_H
+
+#include "rotaryembed.h"
+
+namespace ncnn {
+
+class RotaryEmbed_x86 : public RotaryEmbed
+{
+public:
+    RotaryEmbed_x86();
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+protected:
+    int forward_rope(const Mat& bottom_blob, const Mat& cos_cache, const Mat& sin_cache, Mat& top_blob, const Option& opt) const;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_ROTARYEMBED_X86_H
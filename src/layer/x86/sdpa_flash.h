@@ -0,0 +1,953 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// flash attention
+// query rows are processed in tiles of 4 against blocks of 64 keys
+// each block updates a running max and sum per row (online softmax)
+// and rescales the partial output, so the full score matrix is never stored
+// the int8 variant keeps the 4 score rows of a tile for all keys instead
+
+static void sdpa_flash_pack_key(const Mat& key_head, Mat& key_packed_head, int embed_dim)
+{
+    // [block][embed_dim][64] with zero padded keys
+    const int dst_seqlen = key_head.h;
+
+    key_packed_head.fill(0.f);
+
+    for (int j = 0; j < dst_seqlen; j++)
+    {
+        const float* kptr = key_head.row(j);
+        float* pp = key_packed_head.row(j / 64) + j % 64;
+
+        for (int k = 0; k < embed_dim; k++)
+        {
+            pp[k * 64] = kptr[k];
+        }
+    }
+}
+
+static void sdpa_flash_qk(const float* q0, const float* q1, const float* q2, const float* q3, const float* kptr, int embed_dim, float* qk)
+{
+    // qk[4][64] = q[4][embed_dim] * k^T
+    int jj = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; jj + 31 < 64; jj += 32)
+    {
+        __m512 _s00 = _mm512_setzero_ps();
+        __m512 _s01 = _mm512_setzero_ps();
+        __m512 _s10 = _mm512_setzero_ps();
+        __m512 _s11 = _mm512_setzero_ps();
+        __m512 _s20 = _mm512_setzero_ps();
+        __m512 _s21 = _mm512_setzero_ps();
+        __m512 _s30 = _mm512_setzero_ps();
+        __m512 _s31 = _mm512_setzero_ps();
+        const float* pk = kptr + jj;
+        for (int k = 0; k < embed_dim; k++)
+        {
+            __m512 _k0 = _mm512_loadu_ps(pk);
+            __m512 _k1 = _mm512_loadu_ps(pk + 16);
+            __m512 _q0 = _mm512_set1_ps(q0[k]);
+            __m512 _q1 = _mm512_set1_ps(q1[k]);
+            __m512 _q2 = _mm512_set1_ps(q2[k]);
+            __m512 _q3 = _mm512_set1_ps(q3[k]);
+            _s00 = _mm512_fmadd_ps(_q0, _k0, _s00);
+            _s01 = _mm512_fmadd_ps(_q0, _k1, _s01);
+            _s10 = _mm512_fmadd_ps(_q1, _k0, _s10);
+            _s11 = _mm512_fmadd_ps(_q1, _k1, _s11);
+            _s20 = _mm512_fmadd_ps(_q2, _k0, _s20);
+            _s21 = _mm512_fmadd_ps(_q2, _k1, _s21);
+            _s30 = _mm512_fmadd_ps(_q3, _k0, _s30);
+            _s31 = _mm512_fmadd_ps(_q3, _k1, _s31);
+            pk += 64;
+        }
+        _mm512_storeu_ps(qk + jj, _s00);
+        _mm512_storeu_ps(qk + jj + 16, _s01);
+        _mm512_storeu_ps(qk + 64 + jj, _s10);
+        _mm512_storeu_ps(qk + 64 + jj + 16, _s11);
+        _mm512_storeu_ps(qk + 128 + jj, _s20);
+        _mm512_storeu_ps(qk + 128 + jj + 16, _s21);
+        _mm512_storeu_ps(qk + 192 + jj, _s30);
+        _mm512_storeu_ps(qk + 192 + jj + 16, _s31);
+    }
+#endif // __AVX512F__
+    for (; jj + 15 < 64; jj += 16)
+    {
+        __m256 _s00 = _mm256_setzero_ps();
+        __m256 _s01 = _mm256_setzero_ps();
+        __m256 _s10 = _mm256_setzero_ps();
+        __m256 _s11 = _mm256_setzero_ps();
+        __m256 _s20 = _mm256_setzero_ps();
+        __m256 _s21 = _mm256_setzero_ps();
+        __m256 _s30 = _mm256_setzero_ps();
+        __m256 _s31 = _mm256_setzero_ps();
+        const float* pk = kptr + jj;
+        for (int k = 0; k < embed_dim; k++)
+        {
+            __m256 _k0 = _mm256_loadu_ps(pk);
+            __m256 _k1 = _mm256_loadu_ps(pk + 8);
+            __m256 _q0 = _mm256_set1_ps(q0[k]);
+            __m256 _q1 = _mm256_set1_ps(q1[k]);
+            __m256 _q2 = _mm256_set1_ps(q2[k]);
+            __m256 _q3 = _mm256_set1_ps(q3[k]);
+            _s00 = _mm256_comp_fmadd_ps(_q0, _k0, _s00);
+            _s01 = _mm256_comp_fmadd_ps(_q0, _k1, _s01);
+            _s10 = _mm256_comp_fmadd_ps(_q1, _k0, _s10);
+            _s11 = _mm256_comp_fmadd_ps(_q1, _k1, _s11);
+            _s20 = _mm256_comp_fmadd_ps(_q2, _k0, _s20);
+            _s21 = _mm256_comp_fmadd_ps(_q2, _k1, _s21);
+            _s30 = _mm256_comp_fmadd_ps(_q3, _k0, _s30);
+            _s31 = _mm256_comp_fmadd_ps(_q3, _k1, _s31);
+            pk += 64;
+        }
+        _mm256_storeu_ps(qk + jj, _s00);
+        _mm256_storeu_ps(qk + jj + 8, _s01);
+        _mm256_storeu_ps(qk + 64 + jj, _s10);
+        _mm256_storeu_ps(qk + 64 + jj + 8, _s11);
+        _mm256_storeu_ps(qk + 128 + jj, _s20);
+        _mm256_storeu_ps(qk + 128 + jj + 8, _s21);
+        _mm256_storeu_ps(qk + 192 + jj, _s30);
+        _mm256_storeu_ps(qk + 192 + jj + 8, _s31);
+    }
+#endif // __AVX__
+    for (; jj + 3 < 64; jj += 4)
+    {
+        __m128 _s0 = _mm_setzero_ps();
+        __m128 _s1 = _mm_setzero_ps();
+        __m128 _s2 = _mm_setzero_ps();
+        __m128 _s3 = _mm_setzero_ps();
+        const float* pk = kptr + jj;
+        for (int k = 0; k < embed_dim; k++)
+        {
+            __m128 _k = _mm_loadu_ps(pk);
+            _s0 = _mm_comp_fmadd_ps(_mm_set1_ps(q0[k]), _k, _s0);
+            _s1 = _mm_comp_fmadd_ps(_mm_set1_ps(q1[k]), _k, _s1);
+            _s2 = _mm_comp_fmadd_ps(_mm_set1_ps(q2[k]), _k, _s2);
+            _s3 = _mm_comp_fmadd_ps(_mm_set1_ps(q3[k]), _k, _s3);
+            pk += 64;
+        }
+        _mm_storeu_ps(qk + jj, _s0);
+        _mm_storeu_ps(qk + 64 + jj, _s1);
+        _mm_storeu_ps(qk + 128 + jj, _s2);
+        _mm_storeu_ps(qk + 192 + jj, _s3);
+    }
+#endif // __SSE2__
+    for (; jj < 64; jj++)
+    {
+        float s0 = 0.f;
+        float s1 = 0.f;
+        float s2 = 0.f;
+        float s3 = 0.f;
+        const float* pk = kptr + jj;
+        for (int k = 0; k < embed_dim; k++)
+        {
+            s0 += q0[k] * pk[0];
+            s1 += q1[k] * pk[0];
+            s2 += q2[k] * pk[0];
+            s3 += q3[k] * pk[0];
+            pk += 64;
+        }
+        qk[jj] = s0;
+        qk[64 + jj] = s1;
+        qk[128 + jj] = s2;
+        qk[192 + jj] = s3;
+    }
+}
+
+static float sdpa_flash_exp_sum(float* ptr, float max, int size)
+{
+    // ptr = exp(ptr - max), return the sum
+    float sum = 0.f;
+
+    int j = 0;
+#if __SSE2__
+    __m128 _sum = _mm_setzero_ps();
+#if __AVX__
+    __m256 _sum_avx = _mm256_setzero_ps();
+#if __AVX512F__
+    __m512 _sum_avx512 = _mm512_setzero_ps();
+    __m512 _max_avx512 = _mm512_set1_ps(max);
+    for (; j + 15 < size; j += 16)
+    {
+        __m512 _p = exp512_ps(_mm512_sub_ps(_mm512_loadu_ps(ptr + j), _max_avx512));
+        _mm512_storeu_ps(ptr + j, _p);
+        _sum_avx512 = _mm512_add_ps(_sum_avx512, _p);
+    }
+    sum += _mm512_comp_reduce_add_ps(_sum_avx512);
+#endif // __AVX512F__
+    __m256 _max_avx = _mm256_set1_ps(max);
+    for (; j + 7 < size; j += 8)
+    {
+        __m256 _p = exp256_ps(_mm256_sub_ps(_mm256_loadu_ps(ptr + j), _max_avx));
+        _mm256_storeu_ps(ptr + j, _p);
+        _sum_avx = _mm256_add_ps(_sum_avx, _p);
+    }
+    sum += _mm256_reduce_add_ps(_sum_avx);
+#endif // __AVX__
+    __m128 _max = _mm_set1_ps(max);
+    for (; j + 3 < size; j += 4)
+    {
+        __m128 _p = exp_ps(_mm_sub_ps(_mm_loadu_ps(ptr + j), _max));
+        _mm_storeu_ps(ptr + j, _p);
+        _sum = _mm_add_ps(_sum, _p);
+    }
+    sum += _mm_reduce_add_ps(_sum);
+#endif // __SSE2__
+    for (; j < size; j++)
+    {
+        ptr[j] = expf(ptr[j] - max);
+        sum += ptr[j];
+    }
+
+    return sum;
+}
+
+static float sdpa_flash_scale_max(float* ptr, const float* mptr, float scale, float max, int size)
+{
+    // ptr = ptr * scale + mask, return the max
+    int j = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _scale_avx512 = _mm512_set1_ps(scale);
+    __m512 _max_avx512 = _mm512_set1_ps(max);
+    for (; j + 15 < size; j += 16)
+    {
+        __m512 _p = _mm512_mul_ps(_mm512_loadu_ps(ptr + j), _scale_avx512);
+        if (mptr)
+            _p = _mm512_add_ps(_p, _mm512_loadu_ps(mptr + j));
+        _mm512_storeu_ps(ptr + j, _p);
+        _max_avx512 = _mm512_max_ps(_max_avx512, _p);
+    }
+    max = std::max(max, _mm512_comp_reduce_max_ps(_max_avx512));
+#endif // __AVX512F__
+    __m256 _scale_avx = _mm256_set1_ps(scale);
+    __m256 _max_avx = _mm256_set1_ps(max);
+    for (; j + 7 < size; j += 8)
+    {
+        __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr + j), _scale_avx);
+        if (mptr)
+            _p = _mm256_add_ps(_p, _mm256_loadu_ps(mptr + j));
+        _mm256_storeu_ps(ptr + j, _p);
+        _max_avx = _mm256_max_ps(_max_avx, _p);
+    }
+    max = std::max(max, _mm256_reduce_max_ps(_max_avx));
+#endif // __AVX__
+    __m128 _scale = _mm_set1_ps(scale);
+    __m128 _max = _mm_set1_ps(max);
+    for (; j + 3 < size; j += 4)
+    {
+        __m128 _p = _mm_mul_ps(_mm_loadu_ps(ptr + j), _scale);
+        if (mptr)
+            _p = _mm_add_ps(_p, _mm_loadu_ps(mptr + j));
+        _mm_storeu_ps(ptr + j, _p);
+        _max = _mm_max_ps(_max, _p);
+    }
+    max = std::max(max, _mm_reduce_max_ps(_max));
+#endif // __SSE2__
+    for (; j < size; j++)
+    {
+        float v = ptr[j] * scale;
+        if (mptr)
+            v += mptr[j];
+        ptr[j] = v;
+        max = std::max(max, v);
+    }
+
+    return max;
+}
+
+static void sdpa_flash_online_softmax(float* qk, const Mat& mask_head, int i, int max_ii, int j, int max_jj, float scale, float* row_max, float* row_sum, float* alpha)
+{
+    for (int ii = 0; ii < max_ii; ii++)
+    {
+        float* ptr = qk + ii * 64;
+
+        const float* mptr = mask_head.empty() ? 0 : mask_head.row(i + ii) + j;
+
+        const float max = sdpa_flash_scale_max(ptr, mptr, scale, row_max[ii], max_jj);
+
+        const float sum = sdpa_flash_exp_sum(ptr, max, max_jj);
+
+        alpha[ii] = expf(row_max[ii] - max);
+        row_sum[ii] = row_sum[ii] * alpha[ii] + sum;
+        row_max[ii] = max;
+    }
+}
+
+static void sdpa_flash_pv(const float* qk, const Mat& value_head, int j, int max_jj, float** outptrs, const float* alpha)
+{
+    // out = out * alpha + p * v
+    const int out_embed_dim = value_head.w;
+
+    float* outptr0 = outptrs[0];
+    float* outptr1 = outptrs[1];
+    float* outptr2 = outptrs[2];
+    float* outptr3 = outptrs[3];
+
+    int kk = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    for (; kk + 31 < out_embed_dim; kk += 32)
+    {
+        __m512 _a0 = _mm512_set1_ps(alpha[0]);
+        __m512 _a1 = _mm512_set1_ps(alpha[1]);
+        __m512 _a2 = _mm512_set1_ps(alpha[2]);
+        __m512 _a3 = _mm512_set1_ps(alpha[3]);
+        __m512 _o00 = _mm512_mul_ps(_mm512_loadu_ps(outptr0 + kk), _a0);
+        __m512 _o01 = _mm512_mul_ps(_mm512_loadu_ps(outptr0 + kk + 16), _a0);
+        __m512 _o10 = _mm512_mul_ps(_mm512_loadu_ps(outptr1 + kk), _a1);
+        __m512 _o11 = _mm512_mul_ps(_mm512_loadu_ps(outptr1 + kk + 16), _a1);
+        __m512 _o20 = _mm512_mul_ps(_mm512_loadu_ps(outptr2 + kk), _a2);
+        __m512 _o21 = _mm512_mul_ps(_mm512_loadu_ps(outptr2 + kk + 16), _a2);
+        __m512 _o30 = _mm512_mul_ps(_mm512_loadu_ps(outptr3 + kk), _a3);
+        __m512 _o31 = _mm512_mul_ps(_mm512_loadu_ps(outptr3 + kk + 16), _a3);
+        const float* pv = value_head.row(j) + kk;
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            __m512 _v0 = _mm512_loadu_ps(pv);
+            __m512 _v1 = _mm512_loadu_ps(pv + 16);
+            __m512 _p0 = _mm512_set1_ps(qk[jj]);
+            __m512 _p1 = _mm512_set1_ps(qk[64 + jj]);
+            __m512 _p2 = _mm512_set1_ps(qk[128 + jj]);
+            __m512 _p3 = _mm512_set1_ps(qk[192 + jj]);
+            _o00 = _mm512_fmadd_ps(_p0, _v0, _o00);
+            _o01 = _mm512_fmadd_ps(_p0, _v1, _o01);
+            _o10 = _mm512_fmadd_ps(_p1, _v0, _o10);
+            _o11 = _mm512_fmadd_ps(_p1, _v1, _o11);
+            _o20 = _mm512_fmadd_ps(_p2, _v0, _o20);
+            _o21 = _mm512_fmadd_ps(_p2, _v1, _o21);
+            _o30 = _mm512_fmadd_ps(_p3, _v0, _o30);
+            _o31 = _mm512_fmadd_ps(_p3, _v1, _o31);
+            pv += out_embed_dim;
+        }
+        _mm512_storeu_ps(outptr0 + kk, _o00);
+        _mm512_storeu_ps(outptr0 + kk + 16, _o01);
+        _mm512_storeu_ps(outptr1 + kk, _o10);
+        _mm512_storeu_ps(outptr1 + kk + 16, _o11);
+        _mm512_storeu_ps(outptr2 + kk, _o20);
+        _mm512_storeu_ps(outptr2 + kk + 16, _o21);
+        _mm512_storeu_ps(outptr3 + kk, _o30);
+        _mm512_storeu_ps(outptr3 + kk + 16, _o31);
+    }
+    for (; kk + 15 < out_embed_dim; kk += 16)
+    {
+        __m512 _o0 = _mm512_mul_ps(_mm512_loadu_ps(outptr0 + kk), _mm512_set1_ps(alpha[0]));
+        __m512 _o1 = _mm512_mul_ps(_mm512_loadu_ps(outptr1 + kk), _mm512_set1_ps(alpha[1]));
+        __m512 _o2 = _mm512_mul_ps(_mm512_loadu_ps(outptr2 + kk), _mm512_set1_ps(alpha[2]));
+        __m512 _o3 = _mm512_mul_ps(_mm512_loadu_ps(outptr3 + kk), _mm512_set1_ps(alpha[3]));
+        const float* pv = value_head.row(j) + kk;
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            __m512 _v = _mm512_loadu_ps(pv);
+            _o0 = _mm512_fmadd_ps(_mm512_set1_ps(qk[jj]), _v, _o0);
+            _o1 = _mm512_fmadd_ps(_mm512_set1_ps(qk[64 + jj]), _v, _o1);
+            _o2 = _mm512_fmadd_ps(_mm512_set1_ps(qk[128 + jj]), _v, _o2);
+            _o3 = _mm512_fmadd_ps(_mm512_set1_ps(qk[192 + jj]), _v, _o3);
+            pv += out_embed_dim;
+        }
+        _mm512_storeu_ps(outptr0 + kk, _o0);
+        _mm512_storeu_ps(outptr1 + kk, _o1);
+        _mm512_storeu_ps(outptr2 + kk, _o2);
+        _mm512_storeu_ps(outptr3 + kk, _o3);
+    }
+#endif // __AVX512F__
+    for (; kk + 15 < out_embed_dim; kk += 16)
+    {
+        __m256 _a0 = _mm256_set1_ps(alpha[0]);
+        __m256 _a1 = _mm256_set1_ps(alpha[1]);
+        __m256 _a2 = _mm256_set1_ps(alpha[2]);
+        __m256 _a3 = _mm256_set1_ps(alpha[3]);
+        __m256 _o00 = _mm256_mul_ps(_mm256_loadu_ps(outptr0 + kk), _a0);
+        __m256 _o01 = _mm256_mul_ps(_mm256_loadu_ps(outptr0 + kk + 8), _a0);
+        __m256 _o10 = _mm256_mul_ps(_mm256_loadu_ps(outptr1 + kk), _a1);
+        __m256 _o11 = _mm256_mul_ps(_mm256_loadu_ps(outptr1 + kk + 8), _a1);
+        __m256 _o20 = _mm256_mul_ps(_mm256_loadu_ps(outptr2 + kk), _a2);
+        __m256 _o21 = _mm256_mul_ps(_mm256_loadu_ps(outptr2 + kk + 8), _a2);
+        __m256 _o30 = _mm256_mul_ps(_mm256_loadu_ps(outptr3 + kk), _a3);
+        __m256 _o31 = _mm256_mul_ps(_mm256_loadu_ps(outptr3 + kk + 8), _a3);
+        const float* pv = value_head.row(j) + kk;
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            __m256 _v0 = _mm256_loadu_ps(pv);
+            __m256 _v1 = _mm256_loadu_ps(pv + 8);
+            __m256 _p0 = _mm256_set1_ps(qk[jj]);
+            __m256 _p1 = _mm256_set1_ps(qk[64 + jj]);
+            __m256 _p2 = _mm256_set1_ps(qk[128 + jj]);
+            __m256 _p3 = _mm256_set1_ps(qk[192 + jj]);
+            _o00 = _mm256_comp_fmadd_ps(_p0, _v0, _o00);
+            _o01 = _mm256_comp_fmadd_ps(_p0, _v1, _o01);
+            _o10 = _mm256_comp_fmadd_ps(_p1, _v0, _o10);
+            _o11 = _mm256_comp_fmadd_ps(_p1, _v1, _o11);
+            _o20 = _mm256_comp_fmadd_ps(_p2, _v0, _o20);
+            _o21 = _mm256_comp_fmadd_ps(_p2, _v1, _o21);
+            _o30 = _mm256_comp_fmadd_ps(_p3, _v0, _o30);
+            _o31 = _mm256_comp_fmadd_ps(_p3, _v1, _o31);
+            pv += out_embed_dim;
+        }
+        _mm256_storeu_ps(outptr0 + kk, _o00);
+        _mm256_storeu_ps(outptr0 + kk + 8, _o01);
+        _mm256_storeu_ps(outptr1 + kk, _o10);
+        _mm256_storeu_ps(outptr1 + kk + 8, _o11);
+        _mm256_storeu_ps(outptr2 + kk, _o20);
+        _mm256_storeu_ps(outptr2 + kk + 8, _o21);
+        _mm256_storeu_ps(outptr3 + kk, _o30);
+        _mm256_storeu_ps(outptr3 + kk + 8, _o31);
+    }
+    for (; kk + 7 < out_embed_dim; kk += 8)
+    {
+        __m256 _o0 = _mm256_mul_ps(_mm256_loadu_ps(outptr0 + kk), _mm256_set1_ps(alpha[0]));
+        __m256 _o1 = _mm256_mul_ps(_mm256_loadu_ps(outptr1 + kk), _mm256_set1_ps(alpha[1]));
+        __m256 _o2 = _mm256_mul_ps(_mm256_loadu_ps(outptr2 + kk), _mm256_set1_ps(alpha[2]));
+        __m256 _o3 = _mm256_mul_ps(_mm256_loadu_ps(outptr3 + kk), _mm256_set1_ps(alpha[3]));
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            __m256 _v = _mm256_loadu_ps(value_head.row(j + jj) + kk);
+            _o0 = _mm256_comp_fmadd_ps(_mm256_set1_ps(qk[jj]), _v, _o0);
+            _o1 = _mm256_comp_fmadd_ps(_mm256_set1_ps(qk[64 + jj]), _v, _o1);
+            _o2 = _mm256_comp_fmadd_ps(_mm256_set1_ps(qk[128 + jj]), _v, _o2);
+            _o3 = _mm256_comp_fmadd_ps(_mm256_set1_ps(qk[192 + jj]), _v, _o3);
+        }
+        _mm256_storeu_ps(outptr0 + kk, _o0);
+        _mm256_storeu_ps(outptr1 + kk, _o1);
+        _mm256_storeu_ps(outptr2 + kk, _o2);
+        _mm256_storeu_ps(outptr3 + kk, _o3);
+    }
+#endif // __AVX__
+    for (; kk + 3 < out_embed_dim; kk += 4)
+    {
+        __m128 _o0 = _mm_mul_ps(_mm_loadu_ps(outptr0 + kk), _mm_set1_ps(alpha[0]));
+        __m128 _o1 = _mm_mul_ps(_mm_loadu_ps(outptr1 + kk), _mm_set1_ps(alpha[1]));
+        __m128 _o2 = _mm_mul_ps(_mm_loadu_ps(outptr2 + kk), _mm_set1_ps(alpha[2]));
+        __m128 _o3 = _mm_mul_ps(_mm_loadu_ps(outptr3 + kk), _mm_set1_ps(alpha[3]));
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            __m128 _v = _mm_loadu_ps(value_head.row(j + jj) + kk);
+            _o0 = _mm_comp_fmadd_ps(_mm_set1_ps(qk[jj]), _v, _o0);
+            _o1 = _mm_comp_fmadd_ps(_mm_set1_ps(qk[64 + jj]), _v, _o1);
+            _o2 = _mm_comp_fmadd_ps(_mm_set1_ps(qk[128 + jj]), _v, _o2);
+            _o3 = _mm_comp_fmadd_ps(_mm_set1_ps(qk[192 + jj]), _v, _o3);
+        }
+        _mm_storeu_ps(outptr0 + kk, _o0);
+        _mm_storeu_ps(outptr1 + kk, _o1);
+        _mm_storeu_ps(outptr2 + kk, _o2);
+        _mm_storeu_ps(outptr3 + kk, _o3);
+    }
+#endif // __SSE2__
+    for (; kk < out_embed_dim; kk++)
+    {
+        float o0 = outptr0[kk] * alpha[0];
+        float o1 = outptr1[kk] * alpha[1];
+        float o2 = outptr2[kk] * alpha[2];
+        float o3 = outptr3[kk] * alpha[3];
+        for (int jj = 0; jj < max_jj; jj++)
+        {
+            const float v = value_head.row(j + jj)[kk];
+            o0 += qk[jj] * v;
+            o1 += qk[64 + jj] * v;
+            o2 += qk[128 + jj] * v;
+            o3 += qk[192 + jj] * v;
+        }
+        outptr0[kk] = o0;
+        outptr1[kk] = o1;
+        outptr2[kk] = o2;
+        outptr3[kk] = o3;
+    }
+}
+
+static void sdpa_flash_normalize(float** outptrs, int max_ii, int out_embed_dim, const float* row_sum)
+{
+    for (int ii = 0; ii < max_ii; ii++)
+    {
+        float* outptr = outptrs[ii];
+        const float inv_sum = 1.f / row_sum[ii];
+
+        for (int kk = 0; kk < out_embed_dim; kk++)
+        {
+            outptr[kk] *= inv_sum;
+        }
+    }
+}
+
+static void sdpa_flash(const Mat& query_head, const Mat& key_packed_head, const Mat& value_head, const Mat& mask_head, Mat& top_blob_head, int i, int max_ii, float scale, Mat& out_pad, float* qk)
+{
+    const int embed_dim = query_head.w;
+    const int dst_seqlen = value_head.h;
+    const int out_embed_dim = value_head.w;
+
+    // tail rows compute on row i and write to a scratch row
+    const float* q0 = query_head.row(i);
+    const float* q1 = max_ii > 1 ? query_head.row(i + 1) : q0;
+    const float* q2 = max_ii > 2 ? query_head.row(i + 2) : q0;
+    const float* q3 = max_ii > 3 ? query_head.row(i + 3) : q0;
+
+    float* outptrs[4];
+    for (int ii = 0; ii < 4; ii++)
+    {
+        outptrs[ii] = ii < max_ii ? top_blob_head.row(i + ii) : out_pad.row(ii);
+        memset(outptrs[ii], 0, out_embed_dim * sizeof(float));
+    }
+
+    float row_max[4] = {-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+    float row_sum[4] = {0.f, 0.f, 0.f, 0.f};
+    float alpha[4] = {1.f, 1.f, 1.f, 1.f};
+
+    for (int j = 0; j < dst_seqlen; j += 64)
+    {
+        const int max_jj = std::min(dst_seqlen - j, 64);
+
+        sdpa_flash_qk(q0, q1, q2, q3, key_packed_head.row(j / 64), embed_dim, qk);
+
+        sdpa_flash_online_softmax(qk, mask_head, i, max_ii, j, max_jj, scale, row_max, row_sum, alpha);
+
+        sdpa_flash_pv(qk, value_head, j, max_jj, outptrs, alpha);
+    }
+
+    sdpa_flash_normalize(outptrs, max_ii, out_embed_dim, row_sum);
+}
+
+#if NCNN_INT8
+static void sdpa_flash_quantize_rows(const Mat& blob, int i, int max_ii, short* outptr, int outstep, float* scales)
+{
+    // dynamic quantize each row, padded to outstep with zero
+    const int w = blob.w;
+
+    for (int ii = 0; ii < max_ii; ii++)
+    {
+        const float* ptr = blob.row(i + ii);
+
+        float absmax = 0.f;
+        for (int k = 0; k < w; k++)
+        {
+            absmax = std::max(absmax, (float)fabs(ptr[k]));
+        }
+
+        const float scale = absmax == 0.f ? 1.f : 127.f / absmax;
+        scales[ii] = scale;
+
+        short* pp = outptr + ii * outstep;
+        for (int k = 0; k < w; k++)
+        {
+            pp[k] = float2int8(ptr[k] * scale);
+        }
+        for (int k = w; k < outstep; k++)
+        {
+            pp[k] = 0;
+        }
+    }
+}
+
+static float sdpa_flash_absmax_scale(const Mat& blob, int w)
+{
+    float absmax = 0.f;
+    for (int i = 0; i < blob.h; i++)
+    {
+        const float* ptr = blob.row(i);
+        for (int k = 0; k < w; k++)
+        {
+            absmax = std::max(absmax, (float)fabs(ptr[k]));
+        }
+    }
+
+    return absmax == 0.f ? 1.f : 127.f / absmax;
+}
+
+static float sdpa_flash_pack_key_int8(const Mat& key_head, Mat& key_packed_head, int embed_dim)
+{
+    // [block][embed_dim / 2][64][2] int16 with zero padded keys, return the scale
+    const int dst_seqlen = key_head.h;
+
+    const float scale = sdpa_flash_absmax_scale(key_head, embed_dim);
+
+    key_packed_head.fill<short>(0);
+
+    for (int j = 0; j < dst_seqlen; j++)
+    {
+        const float* kptr = key_head.row(j);
+        short* pp = key_packed_head.row<short>(j / 64) + (j % 64) * 2;
+
+        for (int k = 0; k < embed_dim; k++)
+        {
+            pp[(k / 2) * 128 + k % 2] = float2int8(kptr[k] * scale);
+        }
+    }
+
+    return scale;
+}
+
+static float sdpa_flash_pack_value_int8(const Mat& value_head, Mat& value_packed_head)
+{
+    // [dst_seqlen / 2][out_embed_dim][2] int16 with zero padded keys, return the scale
+    const int out_embed_dim = value_head.w;
+    const int dst_seqlen = value_head.h;
+
+    const float scale = sdpa_flash_absmax_scale(value_head, out_embed_dim);
+
+    value_packed_head.fill<short>(0);
+
+    for (int j = 0; j < dst_seqlen; j++)
+    {
+        const float* vptr = value_head.row(j);
+        short* pp = value_packed_head.row<short>(j / 2) + j % 2;
+
+        for (int k = 0; k < out_embed_dim; k++)
+        {
+            pp[k * 2] = float2int8(vptr[k] * scale);
+        }
+    }
+
+    return scale;
+}
+
+static void sdpa_flash_qk_int8(const int* qpair, int embed_pairs, const short* kptr, float* qk)
+{
+    // qk[4][64] = q[4][embed_dim] * k^T, q packed as int16 pairs
+    const int* qp0 = qpair;
+    const int* qp1 = qpair + embed_pairs;
+    const int* qp2 = qpair + embed_pairs * 2;
+    const int* qp3 = qpair + embed_pairs * 3;
+
+    int jj = 0;
+#if __SSE2__
+#if __AVX2__
+#if __AVX512F__
+    for (; jj + 31 < 64; jj += 32)
+    {
+        __m512i _s00 = _mm512_setzero_si512();
+        __m512i _s01 = _mm512_setzero_si512();
+        __m512i _s10 = _mm512_setzero_si512();
+        __m512i _s11 = _mm512_setzero_si512();
+        __m512i _s20 = _mm512_setzero_si512();
+        __m512i _s21 = _mm512_setzero_si512();
+        __m512i _s30 = _mm512_setzero_si512();
+        __m512i _s31 = _mm512_setzero_si512();
+        const short* pk = kptr + jj * 2;
+        for (int k = 0; k < embed_pairs; k++)
+        {
+            __m512i _k0 = _mm512_loadu_si512((const __m512i*)pk);
+            __m512i _k1 = _mm512_loadu_si512((const __m512i*)(pk + 32));
+            __m512i _q0 = _mm512_set1_epi32(qp0[k]);
+            __m512i _q1 = _mm512_set1_epi32(qp1[k]);
+            __m512i _q2 = _mm512_set1_epi32(qp2[k]);
+            __m512i _q3 = _mm512_set1_epi32(qp3[k]);
+            _s00 = _mm512_comp_dpwssd_epi32(_s00, _q0, _k0);
+            _s01 = _mm512_comp_dpwssd_epi32(_s01, _q0, _k1);
+            _s10 = _mm512_comp_dpwssd_epi32(_s10, _q1, _k0);
+            _s11 = _mm512_comp_dpwssd_epi32(_s11, _q1, _k1);
+            _s20 = _mm512_comp_dpwssd_epi32(_s20, _q2, _k0);
+            _s21 = _mm512_comp_dpwssd_epi32(_s21, _q2, _k1);
+            _s30 = _mm512_comp_dpwssd_epi32(_s30, _q3, _k0);
+            _s31 = _mm512_comp_dpwssd_epi32(_s31, _q3, _k1);
+            pk += 128;
+        }
+        _mm512_storeu_ps(qk + jj, _mm512_cvtepi32_ps(_s00));
+        _mm512_storeu_ps(qk + jj + 16, _mm512_cvtepi32_ps(_s01));
+        _mm512_storeu_ps(qk + 64 + jj, _mm512_cvtepi32_ps(_s10));
+        _mm512_storeu_ps(qk + 64 + jj + 16, _mm512_cvtepi32_ps(_s11));
+        _mm512_storeu_ps(qk + 128 + jj, _mm512_cvtepi32_ps(_s20));
+        _mm512_storeu_ps(qk + 128 + jj + 16, _mm512_cvtepi32_ps(_s21));
+        _mm512_storeu_ps(qk + 192 + jj, _mm512_cvtepi32_ps(_s30));
+        _mm512_storeu_ps(qk + 192 + jj + 16, _mm512_cvtepi32_ps(_s31));
+    }
+#endif // __AVX512F__
+    for (; jj + 15 < 64; jj += 16)
+    {
+        __m256i _s00 = _mm256_setzero_si256();
+        __m256i _s01 = _mm256_setzero_si256();
+        __m256i _s10 = _mm256_setzero_si256();
+        __m256i _s11 = _mm256_setzero_si256();
+        __m256i _s20 = _mm256_setzero_si256();
+        __m256i _s21 = _mm256_setzero_si256();
+        __m256i _s30 = _mm256_setzero_si256();
+        __m256i _s31 = _mm256_setzero_si256();
+        const short* pk = kptr + jj * 2;
+        for (int k = 0; k < embed_pairs; k++)
+        {
+            __m256i _k0 = _mm256_loadu_si256((const __m256i*)pk);
+            __m256i _k1 = _mm256_loadu_si256((const __m256i*)(pk + 16));
+            __m256i _q0 = _mm256_set1_epi32(qp0[k]);
+            __m256i _q1 = _mm256_set1_epi32(qp1[k]);
+            __m256i _q2 = _mm256_set1_epi32(qp2[k]);
+            __m256i _q3 = _mm256_set1_epi32(qp3[k]);
+            _s00 = _mm256_comp_dpwssd_epi32(_s00, _q0, _k0);
+            _s01 = _mm256_comp_dpwssd_epi32(_s01, _q0, _k1);
+            _s10 = _mm256_comp_dpwssd_epi32(_s10, _q1, _k0);
+            _s11 = _mm256_comp_dpwssd_epi32(_s11, _q1, _k1);
+            _s20 = _mm256_comp_dpwssd_epi32(_s20, _q2, _k0);
+            _s21 = _mm256_comp_dpwssd_epi32(_s21, _q2, _k1);
+            _s30 = _mm256_comp_dpwssd_epi32(_s30, _q3, _k0);
+            _s31 = _mm256_comp_dpwssd_epi32(_s31, _q3, _k1);
+            pk += 128;
+        }
+        _mm256_storeu_ps(qk + jj, _mm256_cvtepi32_ps(_s00));
+        _mm256_storeu_ps(qk + jj + 8, _mm256_cvtepi32_ps(_s01));
+        _mm256_storeu_ps(qk + 64 + jj, _mm256_cvtepi32_ps(_s10));
+        _mm256_storeu_ps(qk + 64 + jj + 8, _mm256_cvtepi32_ps(_s11));
+        _mm256_storeu_ps(qk + 128 + jj, _mm256_cvtepi32_ps(_s20));
+        _mm256_storeu_ps(qk + 128 + jj + 8, _mm256_cvtepi32_ps(_s21));
+        _mm256_storeu_ps(qk + 192 + jj, _mm256_cvtepi32_ps(_s30));
+        _mm256_storeu_ps(qk + 192 + jj + 8, _mm256_cvtepi32_ps(_s31));
+    }
+#endif // __AVX2__
+    for (; jj + 3 < 64; jj += 4)
+    {
+        __m128i _s0 = _mm_setzero_si128();
+        __m128i _s1 = _mm_setzero_si128();
+        __m128i _s2 = _mm_setzero_si128();
+        __m128i _s3 = _mm_setzero_si128();
+        const short* pk = kptr + jj * 2;
+        for (int k = 0; k < embed_pairs; k++)
+        {
+            __m128i _k = _mm_loadu_si128((const __m128i*)pk);
+            _s0 = _mm_comp_dpwssd_epi32(_s0, _mm_set1_epi32(qp0[k]), _k);
+            _s1 = _mm_comp_dpwssd_epi32(_s1, _mm_set1_epi32(qp1[k]), _k);
+            _s2 = _mm_comp_dpwssd_epi32(_s2, _mm_set1_epi32(qp2[k]), _k);
+            _s3 = _mm_comp_dpwssd_epi32(_s3, _mm_set1_epi32(qp3[k]), _k);
+            pk += 128;
+        }
+        _mm_storeu_ps(qk + jj, _mm_cvtepi32_ps(_s0));
+        _mm_storeu_ps(qk + 64 + jj, _mm_cvtepi32_ps(_s1));
+        _mm_storeu_ps(qk + 128 + jj, _mm_cvtepi32_ps(_s2));
+        _mm_storeu_ps(qk + 192 + jj, _mm_cvtepi32_ps(_s3));
+    }
+#endif // __SSE2__
+    for (; jj < 64; jj++)
+    {
+        int s0 = 0;
+        int s1 = 0;
+        int s2 = 0;
+        int s3 = 0;
+        for (int k = 0; k < embed_pairs; k++)
+        {
+            const short* pk = kptr + k * 128 + jj * 2;
+            const short* q0 = (const short*)(qp0 + k);
+            const short* q1 = (const short*)(qp1 + k);
+            const short* q2 = (const short*)(qp2 + k);
+            const short* q3 = (const short*)(qp3 + k);
+            s0 += q0[0] * pk[0] + q0[1] * pk[1];
+            s1 += q1[0] * pk[0] + q1[1] * pk[1];
+            s2 += q2[0] * pk[0] + q2[1] * pk[1];
+            s3 += q3[0] * pk[0] + q3[1] * pk[1];
+        }
+        qk[jj] = (float)s0;
+        qk[64 + jj] = (float)s1;
+        qk[128 + jj] = (float)s2;
+        qk[192 + jj] = (float)s3;
+    }
+}
+
+static void sdpa_flash_pv_int8(const int* ppair, const Mat& value_packed_head, int j, int max_jj, float** outptrs, float descale)
+{
+    // out += p * v, p quantized by 127 and packed as int16 pairs
+    const int out_embed_dim = value_packed_head.w / 2;
+    const int max_jp = (max_jj + 1) / 2;
+
+    const int* pp0 = ppair;
+    const int* pp1 = ppair + 32;
+    const int* pp2 = ppair + 64;
+    const int* pp3 = ppair + 96;
+
+    float* outptr0 = outptrs[0];
+    float* outptr1 = outptrs[1];
+    float* outptr2 = outptrs[2];
+    float* outptr3 = outptrs[3];
+
+    int kk = 0;
+#if __SSE2__
+#if __AVX2__
+#if __AVX512F__
+    for (; kk + 31 < out_embed_dim; kk += 32)
+    {
+        __m512i _s00 = _mm512_setzero_si512();
+        __m512i _s01 = _mm512_setzero_si512();
+        __m512i _s10 = _mm512_setzero_si512();
+        __m512i _s11 = _mm512_setzero_si512();
+        __m512i _s20 = _mm512_setzero_si512();
+        __m512i _s21 = _mm512_setzero_si512();
+        __m512i _s30 = _mm512_setzero_si512();
+        __m512i _s31 = _mm512_setzero_si512();
+        const short* pv = value_packed_head.row<const short>(j / 2) + kk * 2;
+        for (int jp = 0; jp < max_jp; jp++)
+        {
+            __m512i _v0 = _mm512_loadu_si512((const __m512i*)pv);
+            __m512i _v1 = _mm512_loadu_si512((const __m512i*)(pv + 32));
+            __m512i _p0 = _mm512_set1_epi32(pp0[jp]);
+            __m512i _p1 = _mm512_set1_epi32(pp1[jp]);
+            __m512i _p2 = _mm512_set1_epi32(pp2[jp]);
+            __m512i _p3 = _mm512_set1_epi32(pp3[jp]);
+            _s00 = _mm512_comp_dpwssd_epi32(_s00, _p0, _v0);
+            _s01 = _mm512_comp_dpwssd_epi32(_s01, _p0, _v1);
+            _s10 = _mm512_comp_dpwssd_epi32(_s10, _p1, _v0);
+            _s11 = _mm512_comp_dpwssd_epi32(_s11, _p1, _v1);
+            _s20 = _mm512_comp_dpwssd_epi32(_s20, _p2, _v0);
+            _s21 = _mm512_comp_dpwssd_epi32(_s21, _p2, _v1);
+            _s30 = _mm512_comp_dpwssd_epi32(_s30, _p3, _v0);
+            _s31 = _mm512_comp_dpwssd_epi32(_s31, _p3, _v1);
+            pv += out_embed_dim * 2;
+        }
+        __m512 _descale = _mm512_set1_ps(descale);
+        _mm512_storeu_ps(outptr0 + kk, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s00), _descale, _mm512_loadu_ps(outptr0 + kk)));
+        _mm512_storeu_ps(outptr0 + kk + 16, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s01), _descale, _mm512_loadu_ps(outptr0 + kk + 16)));
+        _mm512_storeu_ps(outptr1 + kk, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s10), _descale, _mm512_loadu_ps(outptr1 + kk)));
+        _mm512_storeu_ps(outptr1 + kk + 16, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s11), _descale, _mm512_loadu_ps(outptr1 + kk + 16)));
+        _mm512_storeu_ps(outptr2 + kk, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s20), _descale, _mm512_loadu_ps(outptr2 + kk)));
+        _mm512_storeu_ps(outptr2 + kk + 16, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s21), _descale, _mm512_loadu_ps(outptr2 + kk + 16)));
+        _mm512_storeu_ps(outptr3 + kk, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s30), _descale, _mm512_loadu_ps(outptr3 + kk)));
+        _mm512_storeu_ps(outptr3 + kk + 16, _mm512_fmadd_ps(_mm512_cvtepi32_ps(_s31), _descale, _mm512_loadu_ps(outptr3 + kk + 16)));
+    }
+#endif // __AVX512F__
+    for (; kk + 7 < out_embed_dim; kk += 8)
+    {
+        __m256i _s0 = _mm256_setzero_si256();
+        __m256i _s1 = _mm256_setzero_si256();
+        __m256i _s2 = _mm256_setzero_si256();
+        __m256i _s3 = _mm256_setzero_si256();
+        const short* pv = value_packed_head.row<const short>(j / 2) + kk * 2;
+        for (int jp = 0; jp < max_jp; jp++)
+        {
+            __m256i _v = _mm256_loadu_si256((const __m256i*)pv);
+            _s0 = _mm256_comp_dpwssd_epi32(_s0, _mm256_set1_epi32(pp0[jp]), _v);
+            _s1 = _mm256_comp_dpwssd_epi32(_s1, _mm256_set1_epi32(pp1[jp]), _v);
+            _s2 = _mm256_comp_dpwssd_epi32(_s2, _mm256_set1_epi32(pp2[jp]), _v);
+            _s3 = _mm256_comp_dpwssd_epi32(_s3, _mm256_set1_epi32(pp3[jp]), _v);
+            pv += out_embed_dim * 2;
+        }
+        __m256 _descale = _mm256_set1_ps(descale);
+        _mm256_storeu_ps(outptr0 + kk, _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_s0), _descale, _mm256_loadu_ps(outptr0 + kk)));
+        _mm256_storeu_ps(outptr1 + kk, _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_s1), _descale, _mm256_loadu_ps(outptr1 + kk)));
+        _mm256_storeu_ps(outptr2 + kk, _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_s2), _descale, _mm256_loadu_ps(outptr2 + kk)));
+        _mm256_storeu_ps(outptr3 + kk, _mm256_comp_fmadd_ps(_mm256_cvtepi32_ps(_s3), _descale, _mm256_loadu_ps(outptr3 + kk)));
+    }
+#endif // __AVX2__
+    for (; kk + 3 < out_embed_dim; kk += 4)
+    {
+        __m128i _s0 = _mm_setzero_si128();
+        __m128i _s1 = _mm_setzero_si128();
+        __m128i _s2 = _mm_setzero_si128();
+        __m128i _s3 = _mm_setzero_si128();
+        const short* pv = value_packed_head.row<const short>(j / 2) + kk * 2;
+        for (int jp = 0; jp < max_jp; jp++)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)pv);
+            _s0 = _mm_comp_dpwssd_epi32(_s0, _mm_set1_epi32(pp0[jp]), _v);
+            _s1 = _mm_comp_dpwssd_epi32(_s1, _mm_set1_epi32(pp1[jp]), _v);
+            _s2 = _mm_comp_dpwssd_epi32(_s2, _mm_set1_epi32(pp2[jp]), _v);
+            _s3 = _mm_comp_dpwssd_epi32(_s3, _mm_set1_epi32(pp3[jp]), _v);
+            pv += out_embed_dim * 2;
+        }
+        __m128 _descale = _mm_set1_ps(descale);
+        _mm_storeu_ps(outptr0 + kk, _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_s0), _descale, _mm_loadu_ps(outptr0 + kk)));
+        _mm_storeu_ps(outptr1 + kk, _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_s1), _descale, _mm_loadu_ps(outptr1 + kk)));
+        _mm_storeu_ps(outptr2 + kk, _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_s2), _descale, _mm_loadu_ps(outptr2 + kk)));
+        _mm_storeu_ps(outptr3 + kk, _mm_comp_fmadd_ps(_mm_cvtepi32_ps(_s3), _descale, _mm_loadu_ps(outptr3 + kk)));
+    }
+#endif // __SSE2__
+    for (; kk < out_embed_dim; kk++)
+    {
+        int s0 = 0;
+        int s1 = 0;
+        int s2 = 0;
+        int s3 = 0;
+        const short* pv = value_packed_head.row<const short>(j / 2) + kk * 2;
+        for (int jp = 0; jp < max_jp; jp++)
+        {
+            const short* p0 = (const short*)(pp0 + jp);
+            const short* p1 = (const short*)(pp1 + jp);
+            const short* p2 = (const short*)(pp2 + jp);
+            const short* p3 = (const short*)(pp3 + jp);
+            s0 += p0[0] * pv[0] + p0[1] * pv[1];
+            s1 += p1[0] * pv[0] + p1[1] * pv[1];
+            s2 += p2[0] * pv[0] + p2[1] * pv[1];
+            s3 += p3[0] * pv[0] + p3[1] * pv[1];
+            pv += out_embed_dim * 2;
+        }
+        outptr0[kk] += s0 * descale;
+        outptr1[kk] += s1 * descale;
+        outptr2[kk] += s2 * descale;
+        outptr3[kk] += s3 * descale;
+    }
+}
+
+static void sdpa_flash_int8(const Mat& query_head, const Mat& key_packed_head, float key_scale, const Mat& value_packed_head, float value_scale, const Mat& mask_head, Mat& top_blob_head, int i, int max_ii, int dst_seqlen, float scale, Mat& out_pad, float* qk, int* qpair, int* ppair)
+{
+    // the int8 path keeps the scores of the whole tile in qk [block][4][64]
+    // so that p quantizes against the final row max like the reference
+    const int embed_dim = query_head.w;
+    const int embed_pairs = (embed_dim + 1) / 2;
+    const int out_embed_dim = value_packed_head.w / 2;
+
+    // quantize the query rows, tail rows reuse row 0
+    float query_scales[4];
+    sdpa_flash_quantize_rows(query_head, i, max_ii, (short*)qpair, embed_pairs * 2, query_scales);
+    for (int ii = max_ii; ii < 4; ii++)
+    {
+        memcpy(qpair + ii * embed_pairs, qpair, embed_pairs * sizeof(int));
+        query_scales[ii] = query_scales[0];
+    }
+
+    float* outptrs[4];
+    for (int ii = 0; ii < 4; ii++)
+    {
+        outptrs[ii] = ii < max_ii ? top_blob_head.row(i + ii) : out_pad.row(ii);
+        memset(outptrs[ii], 0, out_embed_dim * sizeof(float));
+    }
+
+    float row_max[4] = {-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+    float row_sum[4] = {0.f, 0.f, 0.f, 0.f};
+
+    for (int j = 0; j < dst_seqlen; j += 64)
+    {
+        const int max_jj = std::min(dst_seqlen - j, 64);
+
+        float* qk_block = qk + j * 4;
+
+        sdpa_flash_qk_int8(qpair, embed_pairs, key_packed_head.row<const short>(j / 64), qk_block);
+
+        for (int ii = 0; ii < max_ii; ii++)
+        {
+            const float* mptr = mask_head.empty() ? 0 : mask_head.row(i + ii) + j;
+            const float row_scale = scale / (query_scales[ii] * key_scale);
+
+            row_max[ii] = sdpa_flash_scale_max(qk_block + ii * 64, mptr, row_scale, row_max[ii], max_jj);
+        }
+    }
+
+    // p of the row max quantizes to 127
+    const float value_descale = 1.f / (127.f * value_scale);
+
+    for (int j = 0; j < dst_seqlen; j += 64)
+    {
+        const int max_jj = std::min(dst_seqlen - j, 64);
+
+        float* qk_block = qk + j * 4;
+
+        for (int ii = 0; ii < 4; ii++)
+        {
+            short* pp = (short*)(ppair + ii * 32);
+            if (ii >= max_ii)
+            {
+                memset(pp, 0, 64 * sizeof(short));
+                continue;
+            }
+
+            float* ptr = qk_block + ii * 64;
+            row_sum[ii] += sdpa_flash_exp_sum(ptr, row_max[ii], max_jj);
+
+            for (int jj = 0; jj < max_jj; jj++)
+            {
+                pp[jj] = (short)(ptr[jj] * 127.f + 0.5f);
+            }
+            for (int jj = max_jj; jj < 64; jj++)
+            {
+                pp[jj] = 0;
+            }
+        }
+
+        sdpa_flash_pv_int8(ppair, value_packed_head, j, max_jj, outptrs, value_descale);
+    }
+
+    sdpa_flash_normalize(outptrs, max_ii, out_embed_dim, row_sum);
+}
+#endif // NCNN_INT8
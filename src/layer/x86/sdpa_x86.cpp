@@ -3,10 +3,30 @@
 
 #include "sdpa_x86.h"
 
+#include <float.h>
+
+#if __SSE2__
+#include <emmintrin.h>
+#include "sse_mathfun.h"
+#if __AVX__
+#include <immintrin.h>
+#include "avx_mathfun.h"
+#if __AVX512F__
+#include "avx512_mathfun.h"
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+#include "x86_usability.h"
+
+#include "cpu.h"
+#include "kvcache.h"
 #include "layer_type.h"
 
 namespace ncnn {
 
+#include "sdpa_flash.h"
+
 SDPA_x86::SDPA_x86()
 {
     qk_gemm = 0;
@@ -145,11 +165,26 @@ int SDPA_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     const int cur_seqlen = cur_key.h;
     const int num_group = cur_key.c;
     const int out_embed_dim = cur_value.w;
-    const int past_seqlen = kv_cache ? past_key.h : 0;
+
+    // append to the history in place, past_key and past_value are ignored
+    Mat cached_key;
+    Mat cached_value;
+    if (kv_cache && opt.kv_cache)
+    {
+        int ret = opt.kv_cache->append(this, cur_key, cur_value, cached_key, cached_value);
+        if (ret != 0)
+            return ret;
+    }
+
+    const int past_seqlen = !cached_key.empty() ? cached_key.h - cur_seqlen : kv_cache ? past_key.h : 0;
     const int dst_seqlen = past_seqlen + cur_seqlen;
 
     Mat key;
-    if (past_seqlen > 0)
+    if (!cached_key.empty())
+    {
+        key = cached_key;
+    }
+    else if (past_seqlen > 0)
     {
         key.create(embed_dim, dst_seqlen, num_group, 4u, opt.blob_allocator);
         if (key.empty())
@@ -172,7 +207,11 @@ int SDPA_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     }
 
     Mat value;
-    if (past_seqlen > 0)
+    if (!cached_value.empty())
+    {
+        value = cached_value;
+    }
+    else if (past_seqlen > 0)
     {
         value.create(out_embed_dim, dst_seqlen, num_group, 4u, opt.blob_allocator);
         if (value.empty())
@@ -199,6 +238,25 @@ int SDPA_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     if (top_blob.empty())
         return -100;
 
+    // stream long sequences through the fused kernel once the score matrix of one head spills out of l2
+    // the int8 gemm path is cheaper per score, so it keeps going longer
+    const size_t qk_cross_head_size = (size_t)src_seqlen * dst_seqlen * sizeof(float);
+    const size_t l2_cache_size = get_cpu_level2_cache_size();
+    if (qk_cross_head_size > (int8_scale_term ? l2_cache_size * 4 : l2_cache_size))
+    {
+        int ret = forward_flash(query, key, value, attn_mask_blob, top_blob, opt);
+        if (ret != 0)
+            return ret;
+
+        if (kv_cache)
+        {
+            top_blobs[1] = key;
+            top_blobs[2] = value;
+        }
+
+        return 0;
+    }
+
     const int num_heads_per_group = num_heads / num_group;
 
     Mat qk_cross(dst_seqlen, src_seqlen, num_heads, 4u, opt.workspace_allocator);
@@ -323,4 +381,99 @@ int SDPA_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     return 0;
 }
 
+int SDPA_x86::forward_flash(const Mat& query, const Mat& key, const Mat& value, const Mat& attn_mask_blob, Mat& top_blob, const Option& opt) const
+{
+    const int embed_dim = query.w;
+    const int src_seqlen = query.h;
+    const int num_heads = query.c;
+    const int dst_seqlen = key.h;
+    const int num_group = key.c;
+    const int out_embed_dim = value.w;
+
+    const float _scale = scale == 0.f ? 1.f / sqrt(embed_dim) : scale;
+    const int num_heads_per_group = num_heads / num_group;
+
+    const int num_blocks = (dst_seqlen + 63) / 64;
+    const int num_tiles = (src_seqlen + 3) / 4;
+
+    // output rows beyond the last query
+    Mat out_pad(out_embed_dim, 4, opt.num_threads, 4u, opt.workspace_allocator);
+    if (out_pad.empty())
+        return -100;
+
+#if NCNN_INT8
+    if (int8_scale_term)
+    {
+        const int embed_pairs = (embed_dim + 1) / 2;
+
+        Mat key_packed(64 * embed_pairs * 2, num_blocks, num_group, 2u, opt.workspace_allocator);
+        Mat value_packed(out_embed_dim * 2, (dst_seqlen + 1) / 2, num_group, 2u, opt.workspace_allocator);
+        Mat qk_tile(64 * 4 * num_blocks, opt.num_threads, 4u, opt.workspace_allocator);
+        Mat qpair(embed_pairs * 4, opt.num_threads, 4u, opt.workspace_allocator);
+        Mat ppair(32 * 4, opt.num_threads, 4u, opt.workspace_allocator);
+        if (key_packed.empty() || value_packed.empty() || qk_tile.empty() || qpair.empty() || ppair.empty())
+            return -100;
+
+        std::vector<float> key_scales(num_group);
+        std::vector<float> value_scales(num_group);
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < num_group; q++)
+        {
+            Mat key_packed_head = key_packed.channel(q);
+            Mat value_packed_head = value_packed.channel(q);
+            key_scales[q] = sdpa_flash_pack_key_int8(key.channel(q), key_packed_head, embed_dim);
+            value_scales[q] = sdpa_flash_pack_value_int8(value.channel(q), value_packed_head);
+        }
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int t = 0; t < num_heads * num_tiles; t++)
+        {
+            const int q = t / num_tiles;
+            const int i = t % num_tiles * 4;
+            const int max_ii = std::min(src_seqlen - i, 4);
+            const int g = q / num_heads_per_group;
+
+            const Mat mask_head = !attn_mask ? Mat() : attn_mask_blob.c > 1 ? attn_mask_blob.channel(q) : attn_mask_blob;
+            Mat top_blob_head = top_blob.channel(q);
+            Mat out_pad_thread = out_pad.channel(get_omp_thread_num());
+
+            sdpa_flash_int8(query.channel(q), key_packed.channel(g), key_scales[g], value_packed.channel(g), value_scales[g], mask_head, top_blob_head, i, max_ii, dst_seqlen, _scale, out_pad_thread, qk_tile.row(get_omp_thread_num()), qpair.row<int>(get_omp_thread_num()), ppair.row<int>(get_omp_thread_num()));
+        }
+
+        return 0;
+    }
+#endif // NCNN_INT8
+
+    // scores of one tile and block
+    Mat qk(64 * 4, opt.num_threads, 4u, opt.workspace_allocator);
+    Mat key_packed(64 * embed_dim, num_blocks, num_group, 4u, opt.workspace_allocator);
+    if (qk.empty() || key_packed.empty())
+        return -100;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < num_group; q++)
+    {
+        Mat key_packed_head = key_packed.channel(q);
+        sdpa_flash_pack_key(key.channel(q), key_packed_head, embed_dim);
+    }
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int t = 0; t < num_heads * num_tiles; t++)
+    {
+        const int q = t / num_tiles;
+        const int i = t % num_tiles * 4;
+        const int max_ii = std::min(src_seqlen - i, 4);
+        const int g = q / num_heads_per_group;
+
+        const Mat mask_head = !attn_mask ? Mat() : attn_mask_blob.c > 1 ? attn_mask_blob.channel(q) : attn_mask_blob;
+        Mat top_blob_head = top_blob.channel(q);
+        Mat out_pad_thread = out_pad.channel(get_omp_thread_num());
+
+        sdpa_flash(query.channel(q), key_packed.channel(g), value.channel(g), mask_head, top_blob_head, i, max_ii, _scale, out_pad_thread, qk.row(get_omp_thread_num()));
+    }
+
+    return 0;
+}
+
 } // namespace ncnn
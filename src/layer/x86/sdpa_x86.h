@@ -18,6 +18,9 @@ public:
 
     virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
 
+protected:
+    int forward_flash(const Mat& query, const Mat& key, const Mat& value, const Mat& attn_mask_blob, Mat& top_blob, const Option& opt) const;
+
 public:
     Layer* qk_gemm;
     Layer* qkv_gemm;
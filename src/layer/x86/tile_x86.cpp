@@ -0,0 +1,57 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tile_x86.h"
+
+namespace ncnn {
+
+Tile_x86::Tile_x86()
+{
+#if __SSE2__
+    support_packing = true;
+#endif // __SSE2__
+}
+
+int Tile_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int elempack = bottom_blob.elempack;
+
+    if (elempack == 1)
+        return Tile::forward(bottom_blob, top_blob, opt);
+
+    if (repeats.w > bottom_blob.dims)
+    {
+        // new outer axes move the packed axis inwards
+        Mat bottom_blob_unpacked;
+        Option opt_unpack = opt;
+        opt_unpack.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_unpack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+
+        return Tile::forward(bottom_blob_unpacked, top_blob, opt);
+    }
+
+    // the packed axis is outermost, so repeating whole packs along any axis
+    // is the same as tiling the blob viewed with w widened by elempack
+    Mat bottom_blob_flat = bottom_blob;
+    bottom_blob_flat.w = bottom_blob.w * elempack;
+    bottom_blob_flat.cstep = bottom_blob.cstep * elempack;
+    bottom_blob_flat.elemsize = bottom_blob.elemsize / elempack;
+    bottom_blob_flat.elempack = 1;
+
+    Mat top_blob_flat;
+    int ret = Tile::forward(bottom_blob_flat, top_blob_flat, opt);
+    if (ret != 0)
+        return ret;
+
+    top_blob = top_blob_flat;
+    top_blob.w = top_blob_flat.w / elempack;
+    top_blob.cstep = top_blob_flat.cstep / elempack;
+    top_blob.elemsize = top_blob_flat.elemsize * elempack;
+    top_blob.elempack = elempack;
+
+    return 0;
+}
+
+} // namespace ncnn
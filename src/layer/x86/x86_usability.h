@@ -1819,6 +1819,37 @@ static NCNN_FORCEINLINE __m512i float2bfloat_avx512(const __m512& v0, const __m5
     return _v;
 }
 
+#if __AMX_TILE__
+// palette 1 with the first tile_count tiles sized 16 rows x 64 bytes
+// tile state is per thread, configure it in the thread that issues the tile instructions
+static NCNN_FORCEINLINE void amx_tile_config_16x64(int tile_count)
+{
+    struct
+    {
+        unsigned char palette_id;
+        unsigned char start_row;
+        unsigned char reserved[14];
+        unsigned short colsb[16];
+        unsigned char rows[16];
+    } cfg;
+
+    unsigned char* p = (unsigned char*)&cfg;
+    for (int i = 0; i < (int)sizeof(cfg); i++)
+    {
+        p[i] = 0;
+    }
+
+    cfg.palette_id = 1;
+    for (int i = 0; i < tile_count; i++)
+    {
+        cfg.colsb[i] = 64;
+        cfg.rows[i] = 16;
+    }
+
+    _tile_loadconfig(&cfg);
+}
+#endif // __AMX_TILE__
+
 #endif // __AVX512F__
 #endif // __AVX2__
 #endif // __AVX__
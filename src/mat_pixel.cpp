@@ -8,11 +8,116 @@
 #if __ARM_NEON
 #include <arm_neon.h>
 #endif // __ARM_NEON
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
 #include "platform.h"
 
 namespace ncnn {
 
 #if NCNN_PIXEL
+#if __SSE2__
+// 4 packed 3-byte pixels in the low 12 bytes to 4 lanes of 0x00bbggrr
+static NCNN_FORCEINLINE __m128i expand_u8c3x4_sse2(__m128i _c)
+{
+    const __m128i _mask = _mm_set_epi32(0, 0xffffff, 0, 0xffffff);
+    __m128i _q = _mm_unpacklo_epi64(_c, _mm_srli_si128(_c, 6));
+    __m128i _lo = _mm_and_si128(_q, _mask);
+    __m128i _hi = _mm_slli_epi64(_mm_and_si128(_mm_srli_epi64(_q, 24), _mask), 32);
+    return _mm_or_si128(_lo, _hi);
+}
+
+// 4 lanes of 0x00bbggrr to 4 packed 3-byte pixels in the low 12 bytes
+static NCNN_FORCEINLINE __m128i compact_u8c3x4_sse2(__m128i _p)
+{
+    const __m128i _mask = _mm_set_epi32(0, 0xffffff, 0, 0xffffff);
+    __m128i _q = _mm_or_si128(_mm_and_si128(_p, _mask), _mm_slli_epi64(_mm_and_si128(_mm_srli_epi64(_p, 32), _mask), 24));
+    __m128i _lo = _mm_move_epi64(_q);
+    __m128i _hi = _mm_xor_si128(_q, _lo);
+    return _mm_or_si128(_lo, _mm_srli_si128(_hi, 2));
+}
+
+static NCNN_FORCEINLINE void load_u8c3_sse2(const unsigned char* p, __m128i* _p)
+{
+    __m128i _v0 = _mm_loadu_si128((const __m128i*)p);
+    __m128i _v1 = _mm_loadu_si128((const __m128i*)(p + 16));
+    __m128i _v2 = _mm_loadu_si128((const __m128i*)(p + 32));
+    _p[0] = expand_u8c3x4_sse2(_v0);
+    _p[1] = expand_u8c3x4_sse2(_mm_or_si128(_mm_srli_si128(_v0, 12), _mm_slli_si128(_v1, 4)));
+    _p[2] = expand_u8c3x4_sse2(_mm_or_si128(_mm_srli_si128(_v1, 8), _mm_slli_si128(_v2, 8)));
+    _p[3] = expand_u8c3x4_sse2(_mm_srli_si128(_v2, 4));
+}
+
+static NCNN_FORCEINLINE void store_u8c3_sse2(unsigned char* p, __m128i _r, __m128i _g, __m128i _b)
+{
+    const __m128i _zero = _mm_setzero_si128();
+    __m128i _rg0 = _mm_unpacklo_epi8(_r, _g);
+    __m128i _rg1 = _mm_unpackhi_epi8(_r, _g);
+    __m128i _b0 = _mm_unpacklo_epi8(_b, _zero);
+    __m128i _b1 = _mm_unpackhi_epi8(_b, _zero);
+    __m128i _c0 = compact_u8c3x4_sse2(_mm_unpacklo_epi16(_rg0, _b0));
+    __m128i _c1 = compact_u8c3x4_sse2(_mm_unpackhi_epi16(_rg0, _b0));
+    __m128i _c2 = compact_u8c3x4_sse2(_mm_unpacklo_epi16(_rg1, _b1));
+    __m128i _c3 = compact_u8c3x4_sse2(_mm_unpackhi_epi16(_rg1, _b1));
+    _mm_storeu_si128((__m128i*)p, _mm_or_si128(_c0, _mm_slli_si128(_c1, 12)));
+    _mm_storeu_si128((__m128i*)(p + 16), _mm_or_si128(_mm_srli_si128(_c1, 4), _mm_slli_si128(_c2, 8)));
+    _mm_storeu_si128((__m128i*)(p + 32), _mm_or_si128(_mm_srli_si128(_c2, 8), _mm_slli_si128(_c3, 4)));
+}
+
+static NCNN_FORCEINLINE void store_u8c4_sse2(unsigned char* p, __m128i _r, __m128i _g, __m128i _b, __m128i _a)
+{
+    __m128i _rg0 = _mm_unpacklo_epi8(_r, _g);
+    __m128i _rg1 = _mm_unpackhi_epi8(_r, _g);
+    __m128i _ba0 = _mm_unpacklo_epi8(_b, _a);
+    __m128i _ba1 = _mm_unpackhi_epi8(_b, _a);
+    _mm_storeu_si128((__m128i*)p, _mm_unpacklo_epi16(_rg0, _ba0));
+    _mm_storeu_si128((__m128i*)(p + 16), _mm_unpackhi_epi16(_rg0, _ba0));
+    _mm_storeu_si128((__m128i*)(p + 32), _mm_unpacklo_epi16(_rg1, _ba1));
+    _mm_storeu_si128((__m128i*)(p + 48), _mm_unpackhi_epi16(_rg1, _ba1));
+}
+
+// byte k of each pixel lane as float
+static NCNN_FORCEINLINE __m128 u8c_lane_ps_sse2(__m128i _p, int k)
+{
+    return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(_p, k * 8), _mm_set1_epi32(0xff)));
+}
+
+// (r * 77 + g * 150 + b * 29) >> 8 of each pixel lane as float
+static NCNN_FORCEINLINE __m128 u8c_gray_ps_sse2(__m128i _p, int rk, int bk)
+{
+    const __m128i _mask = _mm_set1_epi32(0xff);
+    __m128i _r = _mm_and_si128(_mm_srli_epi32(_p, rk * 8), _mask);
+    __m128i _g = _mm_and_si128(_mm_srli_epi32(_p, 8), _mask);
+    __m128i _b = _mm_and_si128(_mm_srli_epi32(_p, bk * 8), _mask);
+    // products fit in the low 16 bits of each lane
+    __m128i _y = _mm_mullo_epi16(_r, _mm_set1_epi32(77));
+    _y = _mm_add_epi32(_y, _mm_mullo_epi16(_g, _mm_set1_epi32(150)));
+    _y = _mm_add_epi32(_y, _mm_mullo_epi16(_b, _mm_set1_epi32(29)));
+    return _mm_cvtepi32_ps(_mm_srli_epi32(_y, 8));
+}
+
+static NCNN_FORCEINLINE void u8_to_float_sse2(__m128i _v, float* ptr)
+{
+    const __m128i _zero = _mm_setzero_si128();
+    __m128i _lo = _mm_unpacklo_epi8(_v, _zero);
+    __m128i _hi = _mm_unpackhi_epi8(_v, _zero);
+    _mm_storeu_ps(ptr, _mm_cvtepi32_ps(_mm_unpacklo_epi16(_lo, _zero)));
+    _mm_storeu_ps(ptr + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(_lo, _zero)));
+    _mm_storeu_ps(ptr + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(_hi, _zero)));
+    _mm_storeu_ps(ptr + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(_hi, _zero)));
+}
+
+// truncate and saturate 16 floats to bytes like SATURATE_CAST_UCHAR
+static NCNN_FORCEINLINE __m128i float_to_u8_sse2(const float* ptr)
+{
+    __m128i _v0 = _mm_cvttps_epi32(_mm_loadu_ps(ptr));
+    __m128i _v1 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + 4));
+    __m128i _v2 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + 8));
+    __m128i _v3 = _mm_cvttps_epi32(_mm_loadu_ps(ptr + 12));
+    return _mm_packus_epi16(_mm_packs_epi32(_v0, _v1), _mm_packs_epi32(_v2, _v3));
+}
+#endif // __SSE2__
+
 static int from_rgb(const unsigned char* rgb, int w, int h, int stride, Mat& m, Allocator* allocator)
 {
     m.create(w, h, 3, 4u, allocator);
@@ -35,6 +140,9 @@ static int from_rgb(const unsigned char* rgb, int w, int h, int stride, Mat& m,
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -108,6 +216,24 @@ static int from_rgb(const unsigned char* rgb, int w, int h, int stride, Mat& m,
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _p[4];
+            load_u8c3_sse2(rgb, _p);
+            for (int k = 0; k < 4; k++)
+            {
+                _mm_storeu_ps(ptr0 + k * 4, u8c_lane_ps_sse2(_p[k], 0));
+                _mm_storeu_ps(ptr1 + k * 4, u8c_lane_ps_sse2(_p[k], 1));
+                _mm_storeu_ps(ptr2 + k * 4, u8c_lane_ps_sse2(_p[k], 2));
+            }
+
+            rgb += 3 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgb[0];
@@ -149,6 +275,9 @@ static void to_rgb(const Mat& m, unsigned char* rgb, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -180,6 +309,20 @@ static void to_rgb(const Mat& m, unsigned char* rgb, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _r = float_to_u8_sse2(ptr0);
+            __m128i _g = float_to_u8_sse2(ptr1);
+            __m128i _b = float_to_u8_sse2(ptr2);
+            store_u8c3_sse2(rgb, _r, _g, _b);
+
+            rgb += 3 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgb[0] = SATURATE_CAST_UCHAR(*ptr0);
@@ -217,6 +360,9 @@ static int from_gray(const unsigned char* gray, int w, int h, int stride, Mat& m
 #if __ARM_NEON
         int nn = w >> 4;
         int remain = w - (nn << 4);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -273,6 +419,15 @@ static int from_gray(const unsigned char* gray, int w, int h, int stride, Mat& m
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            u8_to_float_sse2(_mm_loadu_si128((const __m128i*)gray), ptr);
+
+            gray += 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = *gray;
@@ -308,6 +463,9 @@ static void to_gray(const Mat& m, unsigned char* gray, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -328,6 +486,15 @@ static void to_gray(const Mat& m, unsigned char* gray, int stride)
             ptr += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            _mm_storeu_si128((__m128i*)gray, float_to_u8_sse2(ptr));
+
+            gray += 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *gray = SATURATE_CAST_UCHAR(*ptr);
@@ -364,6 +531,9 @@ static int from_rgba(const unsigned char* rgba, int w, int h, int stride, Mat& m
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -451,6 +621,25 @@ static int from_rgba(const unsigned char* rgba, int w, int h, int stride, Mat& m
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)(rgba + k * 16));
+                _mm_storeu_ps(ptr0 + k * 4, u8c_lane_ps_sse2(_p, 0));
+                _mm_storeu_ps(ptr1 + k * 4, u8c_lane_ps_sse2(_p, 1));
+                _mm_storeu_ps(ptr2 + k * 4, u8c_lane_ps_sse2(_p, 2));
+                _mm_storeu_ps(ptr3 + k * 4, u8c_lane_ps_sse2(_p, 3));
+            }
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+            ptr3 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[0];
@@ -495,6 +684,9 @@ static void to_rgba(const Mat& m, unsigned char* rgba, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -531,6 +723,22 @@ static void to_rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr3 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _r = float_to_u8_sse2(ptr0);
+            __m128i _g = float_to_u8_sse2(ptr1);
+            __m128i _b = float_to_u8_sse2(ptr2);
+            __m128i _a = float_to_u8_sse2(ptr3);
+            store_u8c4_sse2(rgba, _r, _g, _b, _a);
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+            ptr3 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgba[0] = SATURATE_CAST_UCHAR(*ptr0);
@@ -572,6 +780,9 @@ static int from_rgb2bgr(const unsigned char* rgb, int w, int h, int stride, Mat&
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -645,6 +856,24 @@ static int from_rgb2bgr(const unsigned char* rgb, int w, int h, int stride, Mat&
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _p[4];
+            load_u8c3_sse2(rgb, _p);
+            for (int k = 0; k < 4; k++)
+            {
+                _mm_storeu_ps(ptr0 + k * 4, u8c_lane_ps_sse2(_p[k], 2));
+                _mm_storeu_ps(ptr1 + k * 4, u8c_lane_ps_sse2(_p[k], 1));
+                _mm_storeu_ps(ptr2 + k * 4, u8c_lane_ps_sse2(_p[k], 0));
+            }
+
+            rgb += 3 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgb[2];
@@ -686,6 +915,9 @@ static void to_bgr2rgb(const Mat& m, unsigned char* rgb, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -717,6 +949,20 @@ static void to_bgr2rgb(const Mat& m, unsigned char* rgb, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _b = float_to_u8_sse2(ptr0);
+            __m128i _g = float_to_u8_sse2(ptr1);
+            __m128i _r = float_to_u8_sse2(ptr2);
+            store_u8c3_sse2(rgb, _r, _g, _b);
+
+            rgb += 3 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgb[2] = SATURATE_CAST_UCHAR(*ptr0);
@@ -760,6 +1006,9 @@ static int from_rgb2gray(const unsigned char* rgb, int w, int h, int stride, Mat
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -821,6 +1070,20 @@ static int from_rgb2gray(const unsigned char* rgb, int w, int h, int stride, Mat
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _p[4];
+            load_u8c3_sse2(rgb, _p);
+            for (int k = 0; k < 4; k++)
+            {
+                _mm_storeu_ps(ptr + k * 4, u8c_gray_ps_sse2(_p[k], 0, 2));
+            }
+
+            rgb += 3 * 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((rgb[0] * R2Y + rgb[1] * G2Y + rgb[2] * B2Y) >> Y_shift);
@@ -873,6 +1136,9 @@ static void to_rgb2rgba(const Mat& m, unsigned char* rgba, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -906,6 +1172,21 @@ static void to_rgb2rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        __m128i _a = _mm_set1_epi8(-1);
+        for (; nn > 0; nn--)
+        {
+            __m128i _r = float_to_u8_sse2(ptr0);
+            __m128i _g = float_to_u8_sse2(ptr1);
+            __m128i _b = float_to_u8_sse2(ptr2);
+            store_u8c4_sse2(rgba, _r, _g, _b, _a);
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgba[0] = SATURATE_CAST_UCHAR(*ptr0);
@@ -950,6 +1231,9 @@ static int from_bgr2gray(const unsigned char* bgr, int w, int h, int stride, Mat
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1011,6 +1295,20 @@ static int from_bgr2gray(const unsigned char* bgr, int w, int h, int stride, Mat
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _p[4];
+            load_u8c3_sse2(bgr, _p);
+            for (int k = 0; k < 4; k++)
+            {
+                _mm_storeu_ps(ptr + k * 4, u8c_gray_ps_sse2(_p[k], 2, 0));
+            }
+
+            bgr += 3 * 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((bgr[2] * R2Y + bgr[1] * G2Y + bgr[0] * B2Y) >> Y_shift);
@@ -1063,6 +1361,9 @@ static void to_bgr2rgba(const Mat& m, unsigned char* rgba, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1096,6 +1397,21 @@ static void to_bgr2rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr2 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        __m128i _a = _mm_set1_epi8(-1);
+        for (; nn > 0; nn--)
+        {
+            __m128i _b = float_to_u8_sse2(ptr0);
+            __m128i _g = float_to_u8_sse2(ptr1);
+            __m128i _r = float_to_u8_sse2(ptr2);
+            store_u8c4_sse2(rgba, _r, _g, _b, _a);
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             rgba[0] = SATURATE_CAST_UCHAR(*ptr2);
@@ -1136,6 +1452,9 @@ static int from_gray2rgb(const unsigned char* gray, int w, int h, int stride, Ma
 #if __ARM_NEON
         int nn = w >> 4;
         int remain = w - (nn << 4);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1212,6 +1531,20 @@ static int from_gray2rgb(const unsigned char* gray, int w, int h, int stride, Ma
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)gray);
+            u8_to_float_sse2(_v, ptr0);
+            u8_to_float_sse2(_v, ptr1);
+            u8_to_float_sse2(_v, ptr2);
+
+            gray += 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = *gray;
@@ -1266,6 +1599,9 @@ static void to_gray2rgba(const Mat& m, unsigned char* rgba, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1293,6 +1629,17 @@ static void to_gray2rgba(const Mat& m, unsigned char* rgba, int stride)
             ptr += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        __m128i _a = _mm_set1_epi8(-1);
+        for (; nn > 0; nn--)
+        {
+            __m128i _gray = float_to_u8_sse2(ptr);
+            store_u8c4_sse2(rgba, _gray, _gray, _gray, _a);
+
+            rgba += 4 * 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             unsigned char gray = SATURATE_CAST_UCHAR(*ptr);
@@ -1332,6 +1679,9 @@ static int from_rgba2rgb(const unsigned char* rgba, int w, int h, int stride, Ma
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1405,6 +1755,23 @@ static int from_rgba2rgb(const unsigned char* rgba, int w, int h, int stride, Ma
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)(rgba + k * 16));
+                _mm_storeu_ps(ptr0 + k * 4, u8c_lane_ps_sse2(_p, 0));
+                _mm_storeu_ps(ptr1 + k * 4, u8c_lane_ps_sse2(_p, 1));
+                _mm_storeu_ps(ptr2 + k * 4, u8c_lane_ps_sse2(_p, 2));
+            }
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[0];
@@ -1445,6 +1812,9 @@ static int from_rgba2bgr(const unsigned char* rgba, int w, int h, int stride, Ma
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1518,6 +1888,23 @@ static int from_rgba2bgr(const unsigned char* rgba, int w, int h, int stride, Ma
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)(rgba + k * 16));
+                _mm_storeu_ps(ptr0 + k * 4, u8c_lane_ps_sse2(_p, 2));
+                _mm_storeu_ps(ptr1 + k * 4, u8c_lane_ps_sse2(_p, 1));
+                _mm_storeu_ps(ptr2 + k * 4, u8c_lane_ps_sse2(_p, 0));
+            }
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[2];
@@ -1562,6 +1949,9 @@ static int from_rgba2gray(const unsigned char* rgba, int w, int h, int stride, M
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1623,6 +2013,19 @@ static int from_rgba2gray(const unsigned char* rgba, int w, int h, int stride, M
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)(rgba + k * 16));
+                _mm_storeu_ps(ptr + k * 4, u8c_gray_ps_sse2(_p, 0, 2));
+            }
+
+            rgba += 4 * 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((rgba[0] * R2Y + rgba[1] * G2Y + rgba[2] * B2Y) >> Y_shift);
@@ -1660,6 +2063,9 @@ static int from_rgba2bgra(const unsigned char* rgba, int w, int h, int stride, M
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1747,6 +2153,25 @@ static int from_rgba2bgra(const unsigned char* rgba, int w, int h, int stride, M
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)(rgba + k * 16));
+                _mm_storeu_ps(ptr0 + k * 4, u8c_lane_ps_sse2(_p, 2));
+                _mm_storeu_ps(ptr1 + k * 4, u8c_lane_ps_sse2(_p, 1));
+                _mm_storeu_ps(ptr2 + k * 4, u8c_lane_ps_sse2(_p, 0));
+                _mm_storeu_ps(ptr3 + k * 4, u8c_lane_ps_sse2(_p, 3));
+            }
+
+            rgba += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+            ptr3 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr0 = rgba[2];
@@ -1791,6 +2216,9 @@ static void to_rgba2bgra(const Mat& m, unsigned char* bgra, int stride)
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1827,6 +2255,22 @@ static void to_rgba2bgra(const Mat& m, unsigned char* bgra, int stride)
             ptr3 += 8;
         }
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            __m128i _r = float_to_u8_sse2(ptr0);
+            __m128i _g = float_to_u8_sse2(ptr1);
+            __m128i _b = float_to_u8_sse2(ptr2);
+            __m128i _a = float_to_u8_sse2(ptr3);
+            store_u8c4_sse2(bgra, _b, _g, _r, _a);
+
+            bgra += 4 * 16;
+            ptr0 += 16;
+            ptr1 += 16;
+            ptr2 += 16;
+            ptr3 += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             bgra[0] = SATURATE_CAST_UCHAR(*ptr2);
@@ -1872,6 +2316,9 @@ static int from_bgra2gray(const unsigned char* bgra, int w, int h, int stride, M
 #if __ARM_NEON
         int nn = w >> 3;
         int remain = w - (nn << 3);
+#elif __SSE2__
+        int nn = w >> 4;
+        int remain = w - (nn << 4);
 #else
         int remain = w;
 #endif // __ARM_NEON
@@ -1933,6 +2380,19 @@ static int from_bgra2gray(const unsigned char* bgra, int w, int h, int stride, M
         }
 #endif // __aarch64__
 #endif // __ARM_NEON
+#if __SSE2__
+        for (; nn > 0; nn--)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                __m128i _p = _mm_loadu_si128((const __m128i*)(bgra + k * 16));
+                _mm_storeu_ps(ptr + k * 4, u8c_gray_ps_sse2(_p, 2, 0));
+            }
+
+            bgra += 4 * 16;
+            ptr += 16;
+        }
+#endif // __SSE2__
         for (; remain > 0; remain--)
         {
             *ptr = static_cast<float>((bgra[2] * R2Y + bgra[1] * G2Y + bgra[0] * B2Y) >> Y_shift);
@@ -6,6 +6,7 @@
 #include <arm_neon.h>
 #endif // __ARM_NEON
 #include <limits.h>
+#include <string.h>
 
 #include "platform.h"
 
@@ -140,6 +141,81 @@ void invert_affine_transform(const float* tm, float* tm_inv)
     tm_inv[5] = b2;
 }
 
+#if __SSE2__
+// source offsets and the alpha0 alpha1 / beta0 beta1 weight pairs of 8 pixels that are all inside
+static NCNN_FORCEINLINE void warpaffine_coeffs_sse2(int X0, int Y0, const int* adelta, const int* bdelta, int srcstride, int elemsize, int* ofs, int* alpha, int* beta)
+{
+    const __m128i _v1023 = _mm_set1_epi32((1 << 10) - 1);
+    const __m128i _v1024 = _mm_set1_epi32(1 << 10);
+    for (int i = 0; i < 8; i += 4)
+    {
+        __m128i _X = _mm_add_epi32(_mm_set1_epi32(X0), _mm_loadu_si128((const __m128i*)(adelta + i)));
+        __m128i _Y = _mm_add_epi32(_mm_set1_epi32(Y0), _mm_loadu_si128((const __m128i*)(bdelta + i)));
+        __m128i _fx = _mm_and_si128(_X, _v1023);
+        __m128i _fy = _mm_and_si128(_Y, _v1023);
+        _mm_storeu_si128((__m128i*)(alpha + i), _mm_or_si128(_mm_sub_epi32(_v1024, _fx), _mm_slli_epi32(_fx, 16)));
+        _mm_storeu_si128((__m128i*)(beta + i), _mm_or_si128(_mm_sub_epi32(_v1024, _fy), _mm_slli_epi32(_fy, 16)));
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        ofs[i] = srcstride * ((Y0 + bdelta[i]) >> 10) + ((X0 + adelta[i]) >> 10) * elemsize;
+    }
+}
+
+// _a and _b hold u16 pairs of the left and right source pixel for one channel per 32bit lane
+static NCNN_FORCEINLINE __m128i warpaffine_blend_sse2(__m128i _a, __m128i _b, __m128i _alpha, __m128i _beta)
+{
+    __m128i _ta = _mm_srai_epi32(_mm_madd_epi16(_a, _alpha), 5);
+    __m128i _tb = _mm_srai_epi32(_mm_madd_epi16(_b, _alpha), 5);
+    return _mm_srli_epi32(_mm_madd_epi16(_mm_or_si128(_ta, _mm_slli_epi32(_tb, 16)), _beta), 15);
+}
+
+// the two adjacent bytes at each of the 8 offsets
+static NCNN_FORCEINLINE __m128i load_u8x2_sse2(const unsigned char* p, const int* ofs)
+{
+    __m128i _v = _mm_cvtsi32_si128(p[ofs[0]] | (p[ofs[0] + 1] << 8));
+    _v = _mm_insert_epi16(_v, p[ofs[1]] | (p[ofs[1] + 1] << 8), 1);
+    _v = _mm_insert_epi16(_v, p[ofs[2]] | (p[ofs[2] + 1] << 8), 2);
+    _v = _mm_insert_epi16(_v, p[ofs[3]] | (p[ofs[3] + 1] << 8), 3);
+    _v = _mm_insert_epi16(_v, p[ofs[4]] | (p[ofs[4] + 1] << 8), 4);
+    _v = _mm_insert_epi16(_v, p[ofs[5]] | (p[ofs[5] + 1] << 8), 5);
+    _v = _mm_insert_epi16(_v, p[ofs[6]] | (p[ofs[6] + 1] << 8), 6);
+    _v = _mm_insert_epi16(_v, p[ofs[7]] | (p[ofs[7] + 1] << 8), 7);
+    return _v;
+}
+
+// the 4 bytes at each of the 4 offsets as c0 c0' c1 c1' u16 pairs of 2 pixels in each half
+static NCNN_FORCEINLINE void load_u8x4_c2_sse2(const unsigned char* p, const int* ofs, __m128i& _lo, __m128i& _hi)
+{
+    int v0, v1, v2, v3;
+    memcpy(&v0, p + ofs[0], 4);
+    memcpy(&v1, p + ofs[1], 4);
+    memcpy(&v2, p + ofs[2], 4);
+    memcpy(&v3, p + ofs[3], 4);
+    __m128i _v = _mm_setr_epi32(v0, v1, v2, v3);
+    _lo = _mm_unpacklo_epi8(_v, _mm_setzero_si128());
+    _hi = _mm_unpackhi_epi8(_v, _mm_setzero_si128());
+    _lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_lo, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+    _hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_hi, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// the 6 bytes at p as c0 c0' c1 c1' c2 c2' u16 pairs
+static NCNN_FORCEINLINE __m128i load_u8x6_c3_sse2(const unsigned char* p)
+{
+    int v;
+    memcpy(&v, p, 4);
+    __m128i _v = _mm_unpacklo_epi8(_mm_insert_epi16(_mm_cvtsi32_si128(v), p[4] | (p[5] << 8), 2), _mm_setzero_si128());
+    return _mm_unpacklo_epi16(_v, _mm_srli_si128(_v, 6));
+}
+
+// the 8 bytes at p as c0 c0' c1 c1' c2 c2' c3 c3' u16 pairs
+static NCNN_FORCEINLINE __m128i load_u8x8_c4_sse2(const unsigned char* p)
+{
+    __m128i _v = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)p), _mm_setzero_si128());
+    return _mm_unpacklo_epi16(_v, _mm_srli_si128(_v, 8));
+}
+#endif // __SSE2__
+
 void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, unsigned char* dst, int w, int h, const float* tm, int type, unsigned int v)
 {
     return warpaffine_bilinear_c1(src, srcw, srch, srcw, dst, w, h, w, tm, type, v);
@@ -287,6 +363,20 @@ void warpaffine_bilinear_c1(const unsigned char* src, int srcw, int srch, int sr
 
                 vst1_u8(dst0, _dst);
 
+                dst0 += 8;
+#elif __SSE2__
+                int ofs[8];
+                int alpha[8];
+                int beta[8];
+                warpaffine_coeffs_sse2(X0, Y0, adelta.data() + x, bdelta.data() + x, srcstride, 1, ofs, alpha, beta);
+
+                __m128i _zero = _mm_setzero_si128();
+                __m128i _a = load_u8x2_sse2(src0, ofs);
+                __m128i _b = load_u8x2_sse2(src0 + srcstride, ofs);
+                __m128i _dst0 = warpaffine_blend_sse2(_mm_unpacklo_epi8(_a, _zero), _mm_unpacklo_epi8(_b, _zero), _mm_loadu_si128((const __m128i*)alpha), _mm_loadu_si128((const __m128i*)beta));
+                __m128i _dst1 = warpaffine_blend_sse2(_mm_unpackhi_epi8(_a, _zero), _mm_unpackhi_epi8(_b, _zero), _mm_loadu_si128((const __m128i*)(alpha + 4)), _mm_loadu_si128((const __m128i*)(beta + 4)));
+                _mm_storel_epi64((__m128i*)dst0, _mm_packus_epi16(_mm_packs_epi32(_dst0, _dst1), _zero));
+
                 dst0 += 8;
 #else
                 for (int xi = 0; xi < 8; xi++)
@@ -605,6 +695,34 @@ void warpaffine_bilinear_c2(const unsigned char* src, int srcw, int srch, int sr
 
                 vst2_u8(dst0, _dst);
 
+                dst0 += 2 * 8;
+#elif __SSE2__
+                int ofs[8];
+                int alpha[8];
+                int beta[8];
+                warpaffine_coeffs_sse2(X0, Y0, adelta.data() + x, bdelta.data() + x, srcstride, 2, ofs, alpha, beta);
+
+                __m128i _dst[4];
+                for (int i = 0; i < 2; i++)
+                {
+                    __m128i _alpha = _mm_loadu_si128((const __m128i*)(alpha + i * 4));
+                    __m128i _beta = _mm_loadu_si128((const __m128i*)(beta + i * 4));
+                    __m128i _alo = _mm_unpacklo_epi32(_alpha, _alpha);
+                    __m128i _ahi = _mm_unpackhi_epi32(_alpha, _alpha);
+                    __m128i _blo = _mm_unpacklo_epi32(_beta, _beta);
+                    __m128i _bhi = _mm_unpackhi_epi32(_beta, _beta);
+
+                    __m128i _a0;
+                    __m128i _a1;
+                    __m128i _b0;
+                    __m128i _b1;
+                    load_u8x4_c2_sse2(src0, ofs + i * 4, _a0, _a1);
+                    load_u8x4_c2_sse2(src0 + srcstride, ofs + i * 4, _b0, _b1);
+                    _dst[i * 2] = warpaffine_blend_sse2(_a0, _b0, _alo, _blo);
+                    _dst[i * 2 + 1] = warpaffine_blend_sse2(_a1, _b1, _ahi, _bhi);
+                }
+                _mm_storeu_si128((__m128i*)dst0, _mm_packus_epi16(_mm_packs_epi32(_dst[0], _dst[1]), _mm_packs_epi32(_dst[2], _dst[3])));
+
                 dst0 += 2 * 8;
 #else
                 for (int xi = 0; xi < 8; xi++)
@@ -966,6 +1084,26 @@ void warpaffine_bilinear_c3(const unsigned char* src, int srcw, int srch, int sr
                 vst3_u8(dst0, _dst);
 
                 dst0 += 3 * 8;
+#elif __SSE2__
+                int ofs[8];
+                int alpha[8];
+                int beta[8];
+                warpaffine_coeffs_sse2(X0, Y0, adelta.data() + x, bdelta.data() + x, srcstride, 3, ofs, alpha, beta);
+
+                for (int xi = 0; xi < 8; xi++)
+                {
+                    __m128i _alpha = _mm_set1_epi32(alpha[xi]);
+                    __m128i _beta = _mm_set1_epi32(beta[xi]);
+                    __m128i _a = load_u8x6_c3_sse2(src0 + ofs[xi]);
+                    __m128i _b = load_u8x6_c3_sse2(src0 + srcstride + ofs[xi]);
+                    __m128i _dst = warpaffine_blend_sse2(_a, _b, _alpha, _beta);
+                    int v = _mm_cvtsi128_si32(_mm_packus_epi16(_mm_packs_epi32(_dst, _dst), _dst));
+                    dst0[0] = (unsigned char)v;
+                    dst0[1] = (unsigned char)(v >> 8);
+                    dst0[2] = (unsigned char)(v >> 16);
+
+                    dst0 += 3;
+                }
 #else
                 for (int xi = 0; xi < 8; xi++)
                 {
@@ -1368,6 +1506,24 @@ void warpaffine_bilinear_c4(const unsigned char* src, int srcw, int srch, int sr
                 vst4_u8(dst0, _dst);
 
                 dst0 += 4 * 8;
+#elif __SSE2__
+                int ofs[8];
+                int alpha[8];
+                int beta[8];
+                warpaffine_coeffs_sse2(X0, Y0, adelta.data() + x, bdelta.data() + x, srcstride, 4, ofs, alpha, beta);
+
+                for (int xi = 0; xi < 8; xi += 2)
+                {
+                    __m128i _a0 = load_u8x8_c4_sse2(src0 + ofs[xi]);
+                    __m128i _a1 = load_u8x8_c4_sse2(src0 + ofs[xi + 1]);
+                    __m128i _b0 = load_u8x8_c4_sse2(src0 + srcstride + ofs[xi]);
+                    __m128i _b1 = load_u8x8_c4_sse2(src0 + srcstride + ofs[xi + 1]);
+                    __m128i _dst0 = warpaffine_blend_sse2(_a0, _b0, _mm_set1_epi32(alpha[xi]), _mm_set1_epi32(beta[xi]));
+                    __m128i _dst1 = warpaffine_blend_sse2(_a1, _b1, _mm_set1_epi32(alpha[xi + 1]), _mm_set1_epi32(beta[xi + 1]));
+                    _mm_storel_epi64((__m128i*)dst0, _mm_packus_epi16(_mm_packs_epi32(_dst0, _dst1), _mm_setzero_si128()));
+
+                    dst0 += 4 * 2;
+                }
 #else
                 for (int xi = 0; xi < 8; xi++)
                 {
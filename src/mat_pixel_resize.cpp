@@ -4,6 +4,7 @@
 #include "mat.h"
 
 #include <limits.h>
+#include <string.h>
 
 #if __ARM_NEON
 #include <arm_neon.h>
@@ -13,6 +14,115 @@
 namespace ncnn {
 
 #if NCNN_PIXEL
+#if __SSE2__
+// horizontal pass of 8 output pixels per iteration, s0 * a0 + s1 * a1 pairs line up with ialpha for madd
+static int hresize_bilinear_c1_sse2(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    const __m128i _zero = _mm_setzero_si128();
+
+    int dx = 0;
+    for (; dx + 7 < w; dx += 8)
+    {
+        const int* sxp = xofs + dx;
+        __m128i _S = _mm_cvtsi32_si128(S[sxp[0]] | (S[sxp[0] + 1] << 8));
+        _S = _mm_insert_epi16(_S, S[sxp[1]] | (S[sxp[1] + 1] << 8), 1);
+        _S = _mm_insert_epi16(_S, S[sxp[2]] | (S[sxp[2] + 1] << 8), 2);
+        _S = _mm_insert_epi16(_S, S[sxp[3]] | (S[sxp[3] + 1] << 8), 3);
+        _S = _mm_insert_epi16(_S, S[sxp[4]] | (S[sxp[4] + 1] << 8), 4);
+        _S = _mm_insert_epi16(_S, S[sxp[5]] | (S[sxp[5] + 1] << 8), 5);
+        _S = _mm_insert_epi16(_S, S[sxp[6]] | (S[sxp[6] + 1] << 8), 6);
+        _S = _mm_insert_epi16(_S, S[sxp[7]] | (S[sxp[7] + 1] << 8), 7);
+
+        __m128i _rows0 = _mm_madd_epi16(_mm_unpacklo_epi8(_S, _zero), _mm_loadu_si128((const __m128i*)(ialpha + dx * 2)));
+        __m128i _rows1 = _mm_madd_epi16(_mm_unpackhi_epi8(_S, _zero), _mm_loadu_si128((const __m128i*)(ialpha + dx * 2 + 8)));
+        _mm_storeu_si128((__m128i*)(rows + dx), _mm_packs_epi32(_mm_srai_epi32(_rows0, 4), _mm_srai_epi32(_rows1, 4)));
+    }
+
+    return dx;
+}
+
+static int hresize_bilinear_c2_sse2(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    const __m128i _zero = _mm_setzero_si128();
+
+    int dx = 0;
+    for (; dx + 3 < w; dx += 4)
+    {
+        int v0, v1, v2, v3;
+        memcpy(&v0, S + xofs[dx], 4);
+        memcpy(&v1, S + xofs[dx + 1], 4);
+        memcpy(&v2, S + xofs[dx + 2], 4);
+        memcpy(&v3, S + xofs[dx + 3], 4);
+        __m128i _S = _mm_setr_epi32(v0, v1, v2, v3);
+
+        // c0 c1 c0' c1' to c0 c0' c1 c1'
+        __m128i _S0 = _mm_unpacklo_epi8(_S, _zero);
+        __m128i _S1 = _mm_unpackhi_epi8(_S, _zero);
+        _S0 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_S0, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+        _S1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_S1, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+
+        __m128i _a = _mm_loadu_si128((const __m128i*)(ialpha + dx * 2));
+        __m128i _rows0 = _mm_madd_epi16(_S0, _mm_unpacklo_epi32(_a, _a));
+        __m128i _rows1 = _mm_madd_epi16(_S1, _mm_unpackhi_epi32(_a, _a));
+        _mm_storeu_si128((__m128i*)(rows + dx * 2), _mm_packs_epi32(_mm_srai_epi32(_rows0, 4), _mm_srai_epi32(_rows1, 4)));
+    }
+
+    return dx;
+}
+
+// the last output pixel is left to the caller as each store spills one short into the next pixel
+static int hresize_bilinear_c3_sse2(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    const __m128i _zero = _mm_setzero_si128();
+
+    int dx = 0;
+    for (; dx + 1 < w; dx++)
+    {
+        const unsigned char* Sp = S + xofs[dx];
+        int v;
+        memcpy(&v, Sp, 4);
+        __m128i _S = _mm_unpacklo_epi8(_mm_insert_epi16(_mm_cvtsi32_si128(v), Sp[4] | (Sp[5] << 8), 2), _zero);
+
+        // c0 c0' c1 c1' c2 c2'
+        _S = _mm_unpacklo_epi16(_S, _mm_srli_si128(_S, 6));
+
+        int a;
+        memcpy(&a, ialpha + dx * 2, 4);
+        __m128i _rows = _mm_madd_epi16(_S, _mm_set1_epi32(a));
+        _rows = _mm_srai_epi32(_rows, 4);
+        _mm_storel_epi64((__m128i*)(rows + dx * 3), _mm_packs_epi32(_rows, _rows));
+    }
+
+    return dx;
+}
+
+static int hresize_bilinear_c4_sse2(const unsigned char* S, const int* xofs, const short* ialpha, short* rows, int w)
+{
+    const __m128i _zero = _mm_setzero_si128();
+
+    int dx = 0;
+    for (; dx + 1 < w; dx += 2)
+    {
+        __m128i _S0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(S + xofs[dx])), _zero);
+        __m128i _S1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(S + xofs[dx + 1])), _zero);
+
+        // c0 c0' c1 c1' c2 c2' c3 c3'
+        _S0 = _mm_unpacklo_epi16(_S0, _mm_srli_si128(_S0, 8));
+        _S1 = _mm_unpacklo_epi16(_S1, _mm_srli_si128(_S1, 8));
+
+        int a0;
+        int a1;
+        memcpy(&a0, ialpha + dx * 2, 4);
+        memcpy(&a1, ialpha + dx * 2 + 2, 4);
+        __m128i _rows0 = _mm_madd_epi16(_S0, _mm_set1_epi32(a0));
+        __m128i _rows1 = _mm_madd_epi16(_S1, _mm_set1_epi32(a1));
+        _mm_storeu_si128((__m128i*)(rows + dx * 4), _mm_packs_epi32(_mm_srai_epi32(_rows0, 4), _mm_srai_epi32(_rows1, 4)));
+    }
+
+    return dx;
+}
+#endif // __SSE2__
+
 static void vresize_two(const short* rows0p, const short* rows1p, int wsize, unsigned char* Dp0, unsigned char* Dp1, short b0, short b1, short b2, short b3)
 {
     int dx = 0;
@@ -56,6 +166,39 @@ static void vresize_two(const short* rows0p, const short* rows1p, int wsize, uns
         rows1p += 8;
     }
 #endif // __ARM_NEON
+#if __AVX2__
+    {
+        __m256i _b0 = _mm256_set1_epi16(b0);
+        __m256i _b1 = _mm256_set1_epi16(b1);
+        __m256i _b2 = _mm256_set1_epi16(b2);
+        __m256i _b3 = _mm256_set1_epi16(b3);
+        __m256i _v2 = _mm256_set1_epi16(2);
+        for (; dx + 31 < wsize; dx += 32)
+        {
+            __m256i _r00 = _mm256_loadu_si256((const __m256i*)rows0p);
+            __m256i _r01 = _mm256_loadu_si256((const __m256i*)(rows0p + 16));
+            __m256i _r10 = _mm256_loadu_si256((const __m256i*)rows1p);
+            __m256i _r11 = _mm256_loadu_si256((const __m256i*)(rows1p + 16));
+            __m256i _acc00 = _mm256_add_epi16(_mm256_mulhi_epi16(_r00, _b0), _mm256_mulhi_epi16(_r10, _b1));
+            __m256i _acc01 = _mm256_add_epi16(_mm256_mulhi_epi16(_r01, _b0), _mm256_mulhi_epi16(_r11, _b1));
+            __m256i _acc10 = _mm256_add_epi16(_mm256_mulhi_epi16(_r00, _b2), _mm256_mulhi_epi16(_r10, _b3));
+            __m256i _acc11 = _mm256_add_epi16(_mm256_mulhi_epi16(_r01, _b2), _mm256_mulhi_epi16(_r11, _b3));
+            _acc00 = _mm256_srai_epi16(_mm256_add_epi16(_acc00, _v2), 2);
+            _acc01 = _mm256_srai_epi16(_mm256_add_epi16(_acc01, _v2), 2);
+            _acc10 = _mm256_srai_epi16(_mm256_add_epi16(_acc10, _v2), 2);
+            _acc11 = _mm256_srai_epi16(_mm256_add_epi16(_acc11, _v2), 2);
+            // packus works within 128bit lanes
+            __m256i _Dp0 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_acc00, _acc01), _MM_SHUFFLE(3, 1, 2, 0));
+            __m256i _Dp1 = _mm256_permute4x64_epi64(_mm256_packus_epi16(_acc10, _acc11), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256((__m256i*)Dp0, _Dp0);
+            _mm256_storeu_si256((__m256i*)Dp1, _Dp1);
+            Dp0 += 32;
+            Dp1 += 32;
+            rows0p += 32;
+            rows1p += 32;
+        }
+    }
+#endif // __AVX2__
 #if __SSE2__
     __m128i _b0 = _mm_set1_epi16(b0);
     __m128i _b1 = _mm_set1_epi16(b1);
@@ -145,6 +288,29 @@ static void vresize_one(const short* rows0p, const short* rows1p, int wsize, uns
         rows1p += 8;
     }
 #endif // __ARM_NEON
+#if __AVX2__
+    {
+        __m256i _b0 = _mm256_set1_epi16(b0);
+        __m256i _b1 = _mm256_set1_epi16(b1);
+        __m256i _v2 = _mm256_set1_epi16(2);
+        for (; dx + 31 < wsize; dx += 32)
+        {
+            __m256i _r00 = _mm256_loadu_si256((const __m256i*)rows0p);
+            __m256i _r01 = _mm256_loadu_si256((const __m256i*)(rows0p + 16));
+            __m256i _r10 = _mm256_loadu_si256((const __m256i*)rows1p);
+            __m256i _r11 = _mm256_loadu_si256((const __m256i*)(rows1p + 16));
+            __m256i _acc0 = _mm256_add_epi16(_mm256_mulhi_epi16(_r00, _b0), _mm256_mulhi_epi16(_r10, _b1));
+            __m256i _acc1 = _mm256_add_epi16(_mm256_mulhi_epi16(_r01, _b0), _mm256_mulhi_epi16(_r11, _b1));
+            _acc0 = _mm256_srai_epi16(_mm256_add_epi16(_acc0, _v2), 2);
+            _acc1 = _mm256_srai_epi16(_mm256_add_epi16(_acc1, _v2), 2);
+            __m256i _Dp = _mm256_permute4x64_epi64(_mm256_packus_epi16(_acc0, _acc1), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256((__m256i*)Dp, _Dp);
+            Dp += 32;
+            rows0p += 32;
+            rows1p += 32;
+        }
+    }
+#endif // __AVX2__
 #if __SSE2__
     __m128i _b0 = _mm_set1_epi16(b0);
     __m128i _b1 = _mm_set1_epi16(b1);
@@ -308,9 +474,14 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstr
             rows1 = rows0_old;
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c1_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
             short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -328,10 +499,16 @@ void resize_bilinear_c1(const unsigned char* src, int srcw, int srch, int srcstr
             const unsigned char* S0 = src + srcstride * (sy);
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c1_sse2(S0, xofs, ialpha, rows0, w);
+            dx = hresize_bilinear_c1_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
             short* rows0p = rows0;
             short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -474,9 +651,14 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstr
             rows1 = rows0_old;
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c2_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
+            short* rows1p = rows1 + dx * 2;
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
 
@@ -516,10 +698,16 @@ void resize_bilinear_c2(const unsigned char* src, int srcw, int srch, int srcstr
             const unsigned char* S0 = src + srcstride * (sy);
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c2_sse2(S0, xofs, ialpha, rows0, w);
+            dx = hresize_bilinear_c2_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
+            short* rows0p = rows0 + dx * 2;
+            short* rows1p = rows1 + dx * 2;
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -695,9 +883,14 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstr
             rows1 = rows0_old;
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c3_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
+            short* rows1p = rows1 + dx * 3;
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -739,10 +932,16 @@ void resize_bilinear_c3(const unsigned char* src, int srcw, int srch, int srcstr
             const unsigned char* S0 = src + srcstride * (sy);
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c3_sse2(S0, xofs, ialpha, rows0, w);
+            dx = hresize_bilinear_c3_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
+            short* rows0p = rows0 + dx * 3;
+            short* rows1p = rows1 + dx * 3;
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -927,9 +1126,14 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstr
             rows1 = rows0_old;
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c4_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
+            short* rows1p = rows1 + dx * 4;
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -964,10 +1168,16 @@ void resize_bilinear_c4(const unsigned char* src, int srcw, int srch, int srcstr
             const unsigned char* S0 = src + srcstride * (sy);
             const unsigned char* S1 = src + srcstride * (sy + 1);
 
-            const short* ialphap = ialpha;
-            short* rows0p = rows0;
-            short* rows1p = rows1;
-            for (int dx = 0; dx < w; dx++)
+            int dx = 0;
+#if __SSE2__
+            dx = hresize_bilinear_c4_sse2(S0, xofs, ialpha, rows0, w);
+            dx = hresize_bilinear_c4_sse2(S1, xofs, ialpha, rows1, w);
+#endif // __SSE2__
+
+            const short* ialphap = ialpha + dx * 2;
+            short* rows0p = rows0 + dx * 4;
+            short* rows1p = rows1 + dx * 4;
+            for (; dx < w; dx++)
             {
                 sx = xofs[dx];
                 short a0 = ialphap[0];
@@ -7,9 +7,183 @@
 #endif // __ARM_NEON
 #include "platform.h"
 
+#include <string.h>
+
 namespace ncnn {
 
 #if NCNN_PIXEL_ROTATE
+#if __SSE2__
+static NCNN_FORCEINLINE __m128i reverse_u8_sse2(__m128i _v)
+{
+    _v = _mm_shuffle_epi32(_v, _MM_SHUFFLE(0, 1, 2, 3));
+    _v = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(_v, 8), _mm_srli_epi16(_v, 8));
+}
+
+static NCNN_FORCEINLINE __m128i reverse_u16_sse2(__m128i _v)
+{
+    _v = _mm_shuffle_epi32(_v, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(_v, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+}
+
+// mirror the leading elements of a row, dst0 points to the dst element of the first src element
+// returns the number of elements done
+static int kanna_flip_row_sse2(const unsigned char* src0, unsigned char* dst0, int srcw, int elemsize)
+{
+    int x = 0;
+    if (elemsize == 1)
+    {
+        for (; x + 15 < srcw; x += 16)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)(src0 + x));
+            _mm_storeu_si128((__m128i*)(dst0 - x - 15), reverse_u8_sse2(_v));
+        }
+    }
+    if (elemsize == 2)
+    {
+        for (; x + 7 < srcw; x += 8)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)(src0 + x * 2));
+            _mm_storeu_si128((__m128i*)(dst0 - (x + 7) * 2), reverse_u16_sse2(_v));
+        }
+    }
+    if (elemsize == 4)
+    {
+        for (; x + 3 < srcw; x += 4)
+        {
+            __m128i _v = _mm_loadu_si128((const __m128i*)(src0 + x * 4));
+            _mm_storeu_si128((__m128i*)(dst0 - (x + 3) * 4), _mm_shuffle_epi32(_v, _MM_SHUFFLE(0, 1, 2, 3)));
+        }
+    }
+
+    return x;
+}
+
+static void transpose_8x8_c1_sse2(const unsigned char* const* r, int offset, unsigned char* d, int dst_xstep)
+{
+    __m128i _a0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(r[0] + offset)), _mm_loadl_epi64((const __m128i*)(r[1] + offset)));
+    __m128i _a1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(r[2] + offset)), _mm_loadl_epi64((const __m128i*)(r[3] + offset)));
+    __m128i _a2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(r[4] + offset)), _mm_loadl_epi64((const __m128i*)(r[5] + offset)));
+    __m128i _a3 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(r[6] + offset)), _mm_loadl_epi64((const __m128i*)(r[7] + offset)));
+    __m128i _b0 = _mm_unpacklo_epi16(_a0, _a1);
+    __m128i _b1 = _mm_unpackhi_epi16(_a0, _a1);
+    __m128i _b2 = _mm_unpacklo_epi16(_a2, _a3);
+    __m128i _b3 = _mm_unpackhi_epi16(_a2, _a3);
+    __m128i _c0 = _mm_unpacklo_epi32(_b0, _b2);
+    __m128i _c1 = _mm_unpackhi_epi32(_b0, _b2);
+    __m128i _c2 = _mm_unpacklo_epi32(_b1, _b3);
+    __m128i _c3 = _mm_unpackhi_epi32(_b1, _b3);
+    _mm_storel_epi64((__m128i*)d, _c0);
+    _mm_storel_epi64((__m128i*)(d + dst_xstep), _mm_unpackhi_epi64(_c0, _c0));
+    _mm_storel_epi64((__m128i*)(d + dst_xstep * 2), _c1);
+    _mm_storel_epi64((__m128i*)(d + dst_xstep * 3), _mm_unpackhi_epi64(_c1, _c1));
+    _mm_storel_epi64((__m128i*)(d + dst_xstep * 4), _c2);
+    _mm_storel_epi64((__m128i*)(d + dst_xstep * 5), _mm_unpackhi_epi64(_c2, _c2));
+    _mm_storel_epi64((__m128i*)(d + dst_xstep * 6), _c3);
+    _mm_storel_epi64((__m128i*)(d + dst_xstep * 7), _mm_unpackhi_epi64(_c3, _c3));
+}
+
+static void transpose_8x8_c2_sse2(const unsigned char* const* r, int offset, unsigned char* d, int dst_xstep)
+{
+    __m128i _r0 = _mm_loadu_si128((const __m128i*)(r[0] + offset));
+    __m128i _r1 = _mm_loadu_si128((const __m128i*)(r[1] + offset));
+    __m128i _r2 = _mm_loadu_si128((const __m128i*)(r[2] + offset));
+    __m128i _r3 = _mm_loadu_si128((const __m128i*)(r[3] + offset));
+    __m128i _r4 = _mm_loadu_si128((const __m128i*)(r[4] + offset));
+    __m128i _r5 = _mm_loadu_si128((const __m128i*)(r[5] + offset));
+    __m128i _r6 = _mm_loadu_si128((const __m128i*)(r[6] + offset));
+    __m128i _r7 = _mm_loadu_si128((const __m128i*)(r[7] + offset));
+    __m128i _a0 = _mm_unpacklo_epi16(_r0, _r1);
+    __m128i _a1 = _mm_unpackhi_epi16(_r0, _r1);
+    __m128i _a2 = _mm_unpacklo_epi16(_r2, _r3);
+    __m128i _a3 = _mm_unpackhi_epi16(_r2, _r3);
+    __m128i _a4 = _mm_unpacklo_epi16(_r4, _r5);
+    __m128i _a5 = _mm_unpackhi_epi16(_r4, _r5);
+    __m128i _a6 = _mm_unpacklo_epi16(_r6, _r7);
+    __m128i _a7 = _mm_unpackhi_epi16(_r6, _r7);
+    __m128i _b0 = _mm_unpacklo_epi32(_a0, _a2);
+    __m128i _b1 = _mm_unpackhi_epi32(_a0, _a2);
+    __m128i _b2 = _mm_unpacklo_epi32(_a1, _a3);
+    __m128i _b3 = _mm_unpackhi_epi32(_a1, _a3);
+    __m128i _b4 = _mm_unpacklo_epi32(_a4, _a6);
+    __m128i _b5 = _mm_unpackhi_epi32(_a4, _a6);
+    __m128i _b6 = _mm_unpacklo_epi32(_a5, _a7);
+    __m128i _b7 = _mm_unpackhi_epi32(_a5, _a7);
+    _mm_storeu_si128((__m128i*)d, _mm_unpacklo_epi64(_b0, _b4));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep), _mm_unpackhi_epi64(_b0, _b4));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep * 2), _mm_unpacklo_epi64(_b1, _b5));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep * 3), _mm_unpackhi_epi64(_b1, _b5));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep * 4), _mm_unpacklo_epi64(_b2, _b6));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep * 5), _mm_unpackhi_epi64(_b2, _b6));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep * 6), _mm_unpacklo_epi64(_b3, _b7));
+    _mm_storeu_si128((__m128i*)(d + dst_xstep * 7), _mm_unpackhi_epi64(_b3, _b7));
+}
+
+static void transpose_8x8_c4_sse2(const unsigned char* const* r, int offset, unsigned char* d, int dst_xstep)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            // 4x4 block of rows 4i..4i+3 and columns 4j..4j+3
+            __m128i _r0 = _mm_loadu_si128((const __m128i*)(r[i * 4] + offset + j * 16));
+            __m128i _r1 = _mm_loadu_si128((const __m128i*)(r[i * 4 + 1] + offset + j * 16));
+            __m128i _r2 = _mm_loadu_si128((const __m128i*)(r[i * 4 + 2] + offset + j * 16));
+            __m128i _r3 = _mm_loadu_si128((const __m128i*)(r[i * 4 + 3] + offset + j * 16));
+            __m128i _t0 = _mm_unpacklo_epi32(_r0, _r1);
+            __m128i _t1 = _mm_unpacklo_epi32(_r2, _r3);
+            __m128i _t2 = _mm_unpackhi_epi32(_r0, _r1);
+            __m128i _t3 = _mm_unpackhi_epi32(_r2, _r3);
+            unsigned char* dp = d + dst_xstep * (j * 4) + i * 16;
+            _mm_storeu_si128((__m128i*)dp, _mm_unpacklo_epi64(_t0, _t1));
+            _mm_storeu_si128((__m128i*)(dp + dst_xstep), _mm_unpackhi_epi64(_t0, _t1));
+            _mm_storeu_si128((__m128i*)(dp + dst_xstep * 2), _mm_unpacklo_epi64(_t2, _t3));
+            _mm_storeu_si128((__m128i*)(dp + dst_xstep * 3), _mm_unpackhi_epi64(_t2, _t3));
+        }
+    }
+}
+
+// rotate types 5 to 8 send src element (x, y) to dst + x * dst_xstep + y * dst_ystep
+// dst_ystep is +-elemsize, handles whole strips of 8 src rows and returns the number of rows done
+static int kanna_rotate_transpose_sse2(const unsigned char* src, int srcw, int srch, int srcstride, unsigned char* dst, int dst_xstep, int dst_ystep, int elemsize)
+{
+    const bool reverse = dst_ystep < 0;
+
+    int y = 0;
+    for (; y + 7 < srch; y += 8)
+    {
+        // keep the rows in dst address order so a block row is stored ascending
+        const unsigned char* r[8];
+        for (int k = 0; k < 8; k++)
+        {
+            r[k] = src + (reverse ? y + 7 - k : y + k) * srcstride;
+        }
+
+        unsigned char* d = dst + (reverse ? y + 7 : y) * dst_ystep;
+
+        int x = 0;
+        for (; x + 7 < srcw; x += 8)
+        {
+            if (elemsize == 1)
+                transpose_8x8_c1_sse2(r, x, d + x * dst_xstep, dst_xstep);
+            if (elemsize == 2)
+                transpose_8x8_c2_sse2(r, x * 2, d + x * dst_xstep, dst_xstep);
+            if (elemsize == 4)
+                transpose_8x8_c4_sse2(r, x * 4, d + x * dst_xstep, dst_xstep);
+        }
+        for (; x < srcw; x++)
+        {
+            for (int k = 0; k < 8; k++)
+            {
+                memcpy(d + x * dst_xstep + k * elemsize, r[k] + x * elemsize, elemsize);
+            }
+        }
+    }
+
+    return y;
+}
+#endif // __SSE2__
+
 // should be a kanna ascii art here in my local branch
 // but we shall ask the original art author for permission first ...
 // https://www.reddit.com/r/anime/comments/5uxjn4/i_recreated_the_kanna_ascii_art_from_kobayashisan/
@@ -576,6 +750,12 @@ static void kanna_rotate_2_c1(const unsigned char* src, int srcw, int srch, int
 #endif // __aarch64__
 
         dst0 += 15;
+#elif __SSE2__
+        int nn = kanna_flip_row_sse2(src0, dst0, srcw, 1);
+        int remain = srcw - nn;
+
+        src0 += nn;
+        dst0 -= nn;
 #else
         int remain = srcw;
 #endif // __ARM_NEON
@@ -657,6 +837,12 @@ static void kanna_rotate_2_c2(const unsigned char* src, int srcw, int srch, int
 #endif // __aarch64__
 
         dst0 += 7 * 2;
+#elif __SSE2__
+        int nn = kanna_flip_row_sse2(src0, dst0, srcw, 2);
+        int remain = srcw - nn;
+
+        src0 += nn * 2;
+        dst0 -= nn * 2;
 #else
         int remain = srcw;
 #endif // __ARM_NEON
@@ -834,6 +1020,12 @@ static void kanna_rotate_2_c4(const unsigned char* src, int srcw, int srch, int
 #endif // __aarch64__
 
         dst0 += 7 * 4;
+#elif __SSE2__
+        int nn = kanna_flip_row_sse2(src0, dst0, srcw, 4);
+        int remain = srcw - nn;
+
+        src0 += nn * 4;
+        dst0 -= nn * 4;
 #else
         int remain = srcw;
 #endif // __ARM_NEON
@@ -913,6 +1105,12 @@ static void kanna_rotate_3_c1(const unsigned char* src, int srcw, int srch, int
 #endif // __aarch64__
 
         dst0 += 15;
+#elif __SSE2__
+        int nn = kanna_flip_row_sse2(src0, dst0, srcw, 1);
+        int remain = srcw - nn;
+
+        src0 += nn;
+        dst0 -= nn;
 #else
         int remain = srcw;
 #endif // __ARM_NEON
@@ -997,6 +1195,12 @@ static void kanna_rotate_3_c2(const unsigned char* src, int srcw, int srch, int
 #endif // __aarch64__
 
         dst0 += 7 * 2;
+#elif __SSE2__
+        int nn = kanna_flip_row_sse2(src0, dst0, srcw, 2);
+        int remain = srcw - nn;
+
+        src0 += nn * 2;
+        dst0 -= nn * 2;
 #else
         int remain = srcw;
 #endif // __ARM_NEON
@@ -1180,6 +1384,12 @@ static void kanna_rotate_3_c4(const unsigned char* src, int srcw, int srch, int
 #endif // __aarch64__
 
         dst0 += 7 * 4;
+#elif __SSE2__
+        int nn = kanna_flip_row_sse2(src0, dst0, srcw, 4);
+        int remain = srcw - nn;
+
+        src0 += nn * 4;
+        dst0 -= nn * 4;
 #else
         int remain = srcw;
 #endif // __ARM_NEON
@@ -1893,6 +2103,10 @@ static void kanna_rotate_5_c1(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dst, stride, 1, 1);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dst + y;
@@ -2134,6 +2348,10 @@ static void kanna_rotate_5_c2(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dst, stride, 2, 2);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dst + y * 2;
@@ -2739,6 +2957,10 @@ static void kanna_rotate_5_c4(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dst, stride, 4, 4);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dst + y * 4;
@@ -2937,6 +3159,10 @@ static void kanna_rotate_6_c1(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend - 1, stride, -1, 1);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend - y - 1;
@@ -3181,6 +3407,10 @@ static void kanna_rotate_6_c2(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend - 2, stride, -2, 2);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend - y * 2 - 2;
@@ -3792,6 +4022,10 @@ static void kanna_rotate_6_c4(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend - 4, stride, -4, 4);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend - y * 4 - 4;
@@ -3990,6 +4224,10 @@ static void kanna_rotate_7_c1(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend - 1, -stride, -1, 1);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend - y - 1;
@@ -4234,6 +4472,10 @@ static void kanna_rotate_7_c2(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend - 2, -stride, -2, 2);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend - y * 2 - 2;
@@ -4845,6 +5087,10 @@ static void kanna_rotate_7_c4(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend - 4, -stride, -4, 4);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend - y * 4 - 4;
@@ -5043,6 +5289,10 @@ static void kanna_rotate_8_c1(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend, -stride, 1, 1);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend + y;
@@ -5287,6 +5537,10 @@ static void kanna_rotate_8_c2(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend, -stride, 2, 2);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend + y * 2;
@@ -5898,6 +6152,10 @@ static void kanna_rotate_8_c4(const unsigned char* src, int srcw, int srch, int
         src0 += srcwgap + 7 * srcstride;
     }
 #endif // __ARM_NEON
+#if __SSE2__
+    y = kanna_rotate_transpose_sse2(src, srcw, srch, srcstride, dstend, -stride, 4, 4);
+    src0 = src + y * srcstride;
+#endif // __SSE2__
     for (; y < srch; y++)
     {
         unsigned char* dst0 = dstend + y * 4;
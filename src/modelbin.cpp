@@ -218,6 +218,62 @@ Mat ModelBinFromDataReader::load(int w, int type) const
 
             return m;
         }
+        else if (flag_struct.tag == 0x0047A4B1)
+        {
+            // group quantized int4 / int8 data, kept packed for the layer
+            // int bits
+            // signed int8 values, or signed int4 values packed two per byte low nibble first
+            // the group scales follow in a separate buffer loaded by the layer
+            int bits = 0;
+            nread = d->dr.read(&bits, sizeof(int));
+            if (nread != sizeof(int))
+            {
+                NCNN_LOGE("ModelBin read group quant bits failed %zd", nread);
+                return Mat();
+            }
+
+#if __BIG_ENDIAN__
+            swap_endianness_32(&bits);
+#endif
+
+            if (bits != 4 && bits != 8)
+            {
+                NCNN_LOGE("ModelBin group quant bits=%d not supported", bits);
+                return Mat();
+            }
+
+            const int data_size = bits == 8 ? w : (w + 1) / 2;
+            size_t align_data_size = alignSize(data_size, 4);
+
+#if !__BIG_ENDIAN__
+            // try reference data
+            const void* refbuf = 0;
+            nread = d->dr.reference(align_data_size, &refbuf);
+            if (nread == align_data_size)
+            {
+                m = Mat(data_size, (void*)refbuf, (size_t)1u);
+            }
+            else
+#endif
+            {
+                std::vector<signed char> qdata;
+                qdata.resize(align_data_size);
+                nread = d->dr.read(&qdata[0], align_data_size);
+                if (nread != align_data_size)
+                {
+                    NCNN_LOGE("ModelBin read group quant data failed %zd", nread);
+                    return Mat();
+                }
+
+                m.create(data_size, (size_t)1u);
+                if (m.empty())
+                    return m;
+
+                memcpy(m.data, &qdata[0], data_size);
+            }
+
+            return m;
+        }
 
         if (flag != 0)
         {
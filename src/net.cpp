@@ -8,6 +8,9 @@
 #include "layer_type.h"
 #include "modelbin.h"
 #include "paramdict.h"
+#include "profiler.h"
+#include "threadpool.h"
+#include "weightcache.h"
 
 #include <stdarg.h>
 #include <stdint.h>
@@ -24,15 +27,373 @@
 
 namespace ncnn {
 
+// the static blob memory plan resolved by Net::plan_memory
+// every blob allocation of a forward run gets a fixed offset in one arena
+struct BlobMemoryPlan
+{
+    std::vector<size_t> sizes;
+    std::vector<size_t> offsets;
+
+    // the count of free events before each allocation
+    std::vector<int> frees_before;
+
+    // the allocation id of each free event
+    std::vector<int> free_order;
+
+    size_t arena_size;
+
+    // bumped whenever the plan changes
+    int generation;
+};
+
+// records the blob allocation sequence of one forward run
+class BlobMemoryRecorder : public Allocator
+{
+public:
+    BlobMemoryRecorder()
+        : event_count(0)
+    {
+    }
+
+    virtual void* fastMalloc(size_t size)
+    {
+        MutexLockGuard guard(lock);
+
+        void* ptr = ncnn::fastMalloc(size);
+
+        live.push_back(std::make_pair(ptr, (int)sizes.size()));
+        sizes.push_back(size);
+        frees_before.push_back((int)free_order.size());
+        malloc_events.push_back(event_count++);
+        free_events.push_back(-1);
+
+        return ptr;
+    }
+
+    virtual void fastFree(void* ptr)
+    {
+        MutexLockGuard guard(lock);
+
+        for (size_t i = 0; i < live.size(); i++)
+        {
+            if (live[i].first == ptr)
+            {
+                int id = live[i].second;
+                live.erase(live.begin() + i);
+
+                free_order.push_back(id);
+                free_events[id] = event_count++;
+                break;
+            }
+        }
+
+        ncnn::fastFree(ptr);
+    }
+
+    // assign arena offsets with greedy-by-size interval colouring
+    void resolve(BlobMemoryPlan& plan) const
+    {
+        const int count = (int)sizes.size();
+
+        std::vector<size_t> aligned_sizes(count);
+        std::vector<int> end_events(count);
+        std::vector<std::pair<size_t, int> > order(count);
+        for (int i = 0; i < count; i++)
+        {
+            aligned_sizes[i] = alignSize(sizes[i], NCNN_MALLOC_ALIGN);
+
+            // never freed blob lives until the end
+            end_events[i] = free_events[i] == -1 ? event_count : free_events[i];
+
+            order[i] = std::make_pair(aligned_sizes[i], i);
+        }
+
+        // largest first, earlier allocation first among equal sizes
+        std::partial_sort(order.begin(), order.end(), order.end(), compare_size_desc());
+
+        plan.sizes = sizes;
+        plan.offsets.clear();
+        plan.offsets.resize(count, 0);
+        plan.frees_before = frees_before;
+        plan.free_order = free_order;
+        plan.arena_size = 0;
+
+        std::vector<int> placed;
+        std::vector<std::pair<size_t, int> > conflicts;
+        for (int i = 0; i < count; i++)
+        {
+            const int id = order[i].second;
+            const size_t size = aligned_sizes[id];
+
+            // placed blobs alive at the same time, sorted by offset
+            conflicts.clear();
+            for (size_t j = 0; j < placed.size(); j++)
+            {
+                int pid = placed[j];
+                if (malloc_events[pid] < end_events[id] && malloc_events[id] < end_events[pid])
+                    conflicts.push_back(std::make_pair(plan.offsets[pid], pid));
+            }
+
+            std::partial_sort(conflicts.begin(), conflicts.end(), conflicts.end(), compare_offset_asc());
+
+            // lowest gap that fits
+            size_t offset = 0;
+            for (size_t j = 0; j < conflicts.size(); j++)
+            {
+                size_t conflict_offset = conflicts[j].first;
+                if (offset + size <= conflict_offset)
+                    break;
+
+                offset = std::max(offset, conflict_offset + aligned_sizes[conflicts[j].second]);
+            }
+
+            plan.offsets[id] = offset;
+            plan.arena_size = std::max(plan.arena_size, offset + size);
+
+            placed.push_back(id);
+        }
+    }
+
+private:
+    struct compare_size_desc
+    {
+        bool operator()(const std::pair<size_t, int>& a, const std::pair<size_t, int>& b) const
+        {
+            return a.first > b.first || (a.first == b.first && a.second < b.second);
+        }
+    };
+
+    struct compare_offset_asc
+    {
+        bool operator()(const std::pair<size_t, int>& a, const std::pair<size_t, int>& b) const
+        {
+            return a.first < b.first;
+        }
+    };
+
+    Mutex lock;
+    std::vector<std::pair<void*, int> > live;
+    std::vector<size_t> sizes;
+    std::vector<int> frees_before;
+    std::vector<int> free_order;
+    std::vector<int> malloc_events;
+    std::vector<int> free_events;
+    int event_count;
+};
+
+// replays a blob memory plan inside one preallocated arena
+// the allocation and free sequence is verified on the fly,
+// the arena is never handed out again once the sequence diverges from the plan
+class BlobMemoryArena : public Allocator
+{
+public:
+    BlobMemoryArena(const BlobMemoryPlan& _plan)
+        : plan(_plan)
+    {
+        generation = plan.generation;
+        arena = (unsigned char*)ncnn::fastMalloc(plan.arena_size);
+        malloc_count = 0;
+        free_count = 0;
+        diverged = arena == 0;
+        orphaned = false;
+    }
+
+    virtual ~BlobMemoryArena()
+    {
+        if (!live.empty())
+        {
+            NCNN_LOGE("FATAL ERROR! blob memory arena destroyed too early");
+        }
+
+        ncnn::fastFree(arena);
+    }
+
+    virtual void* fastMalloc(size_t size)
+    {
+        lock.lock();
+
+        if (!diverged && generation != plan.generation)
+        {
+            // planned again since this arena was created
+            diverged = true;
+        }
+
+        if (!diverged)
+        {
+            if (malloc_count < (int)plan.sizes.size() && plan.sizes[malloc_count] == size && plan.frees_before[malloc_count] == free_count)
+            {
+                void* ptr = arena + plan.offsets[malloc_count];
+                live.push_back(std::make_pair(ptr, malloc_count));
+                malloc_count++;
+
+                lock.unlock();
+                return ptr;
+            }
+
+            diverged = true;
+        }
+
+        lock.unlock();
+
+        return ncnn::fastMalloc(size);
+    }
+
+    virtual void fastFree(void* ptr)
+    {
+        lock.lock();
+
+        for (size_t i = 0; i < live.size(); i++)
+        {
+            if (live[i].first == ptr)
+            {
+                int id = live[i].second;
+                live.erase(live.begin() + i);
+
+                if (!diverged && (free_count >= (int)plan.free_order.size() || plan.free_order[free_count] != id))
+                    diverged = true;
+
+                free_count++;
+
+                bool release = orphaned && live.empty();
+
+                lock.unlock();
+
+                if (release)
+                {
+                    // the last blob of an orphaned arena goes away
+                    delete this;
+                }
+                return;
+            }
+        }
+
+        lock.unlock();
+
+        ncnn::fastFree(ptr);
+    }
+
+    // rewind for the next forward run
+    // return false if some blobs are still alive in the arena
+    bool reset()
+    {
+        MutexLockGuard guard(lock);
+
+        if (!live.empty())
+        {
+            // release arena once the last blob goes away
+            diverged = true;
+            orphaned = true;
+            return false;
+        }
+
+        malloc_count = 0;
+        free_count = 0;
+        diverged = arena == 0;
+        return true;
+    }
+
+public:
+    int generation;
+
+private:
+    const BlobMemoryPlan& plan;
+    unsigned char* arena;
+
+    Mutex lock;
+    std::vector<std::pair<void*, int> > live;
+    int malloc_count;
+    int free_count;
+    bool diverged;
+    bool orphaned;
+};
+
+class ParallelForwardContext;
+
+// threads kept alive across extracts to forward the independent layers, see Extractor::set_parallel_branches
+// one extract uses them at a time
+class ParallelForwardWorkers
+{
+public:
+    ParallelForwardWorkers();
+    ~ParallelForwardWorkers();
+
+    // let count workers run the ready layers of ctx next to the calling thread
+    // return false when another extract is using the workers
+    bool start(ParallelForwardContext* ctx, int count);
+    // wait until the workers of the current extract are done
+    void wait();
+
+public:
+    Mutex lock;
+    ConditionVariable condition;
+    std::vector<Thread*> threads;
+
+    ParallelForwardContext* ctx;
+    // the workers wanted, joined and done for the current extract
+    int wanted_count;
+    int joined_count;
+    int done_count;
+    // bumped for each extract
+    unsigned int generation;
+    bool busy;
+    bool quit;
+};
+
+// a layer preparing its weights on first forward, see Net::set_lazy_loading
+class LazyLayer
+{
+public:
+    LazyLayer()
+        : mem(0), resident(false), loading(false), model_loaded(false), use_count(0), lru_prev(-1), lru_next(-1), memory_usage(0)
+    {
+    }
+
+    // the model data of the layer, null for the layers loaded in load_model
+    const unsigned char* mem;
+    // the pipeline is created
+    bool resident;
+    // one forward is loading the layer outside lazy_lock, the others wait for it
+    bool loading;
+    // the model weights are loaded, load_model runs again after eviction
+    bool model_loaded;
+    // forwards running
+    int use_count;
+    // neighbours in the lru list of the resident layers not running, -1 for none
+    int lru_prev;
+    int lru_next;
+    // bytes of the prepared weights owned by the layer
+    size_t memory_usage;
+};
+
+// the layers to run for one extracted layer, see NetPrivate::collect_required_layers
+class RequiredLayers
+{
+public:
+    // in reverse topological order
+    std::vector<int> layers;
+    // the blobs not ready yet and consumed by the layers
+    std::vector<unsigned char> blob_required;
+};
+
 class NetPrivate
 {
 public:
     NetPrivate(Option& _opt);
+    ~NetPrivate();
 
     Option& opt;
 
     friend class Extractor;
-    int forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
+    void collect_required_layers(int layer_index, const std::vector<Mat>& blob_mats, std::vector<int>& required_layers, std::vector<unsigned char>& blob_required) const;
+    // the cached required layers of layer_index while still valid, otherwise resolved into local
+    const RequiredLayers* get_required_layers(int layer_index, const std::vector<Mat>& blob_mats, RequiredLayers& local) const;
+    void clear_required_layers_cache();
+    int forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt, int parallel_branches = 0) const;
+    int forward_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt) const;
+    int run_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
+    int run_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt) const;
+    int run_layers_parallel(const std::vector<int>& required_layers, const std::vector<unsigned char>& blob_required, std::vector<Mat>& blob_mats, const Option& opt, int parallel_branches) const;
+    void run_ready_layers(ParallelForwardContext& ctx) const;
 
 #if NCNN_VULKAN
     int forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
@@ -48,14 +409,39 @@ public:
     int do_forward_layer(const Layer* layer, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
 #endif // NCNN_VULKAN
 
+    // create the pipeline of a lazily loaded layer if needed and keep it until release
+    int acquire_lazy_layer(int layer_index) const;
+    void release_lazy_layer(int layer_index) const;
+    int load_lazy_layer(int layer_index) const;
+    void evict_lazy_layers() const;
+    void lazy_lru_push_back(int layer_index) const;
+    void lazy_lru_remove(int layer_index) const;
+
     void update_input_output_indexes();
 #if NCNN_STRING
     void update_input_output_names();
 #endif // NCNN_STRING
 
+    void update_forward_plan();
+    void resolve_forward_plan(std::vector<int>& plan, std::vector<int>& plan_indexes) const;
+
     std::vector<Blob> blobs;
     std::vector<Layer*> layers;
 
+    // hash of the params each layer is loaded with, part of its weight cache key
+    std::vector<uint64_t> layer_param_digests;
+
+    // topologically sorted layer indexes, resolved once in load_model
+    // forward_plan_indexes[i] is the position of layer i in forward_plan
+    std::vector<int> forward_plan;
+    std::vector<int> forward_plan_indexes;
+
+    // the required layers first resolved for each extracted layer, indexed by layer
+    mutable Mutex required_layers_cache_lock;
+    mutable std::vector<RequiredLayers*> required_layers_cache;
+    mutable int forward_plan_resolve_count;
+    mutable int forward_plan_reuse_count;
+
     std::vector<int> input_blob_indexes;
     std::vector<int> output_blob_indexes;
 #if NCNN_STRING
@@ -69,10 +455,32 @@ public:
     PoolAllocator* local_blob_allocator;
     PoolAllocator* local_workspace_allocator;
 
+    BlobMemoryArena* acquire_blob_memory_arena();
+    void reclaim_blob_memory_arena(BlobMemoryArena* arena);
+    void clear_blob_memory_plan();
+
+    BlobMemoryPlan blob_memory_plan;
+    Mutex blob_memory_arenas_lock;
+    std::vector<BlobMemoryArena*> blob_memory_arenas;
+
 #if defined _WIN32 || __ANDROID__ || defined __OHOS__ || defined __linux__ || __APPLE__
     MappedFile mapped_model_file;
 #endif
 
+    bool lazy_loading;
+    size_t lazy_memory_budget;
+    mutable Mutex lazy_lock;
+    mutable ConditionVariable lazy_condition;
+    mutable std::vector<LazyLayer> lazy_layers;
+    // the least and the most recently used layers that can be evicted
+    mutable int lazy_lru_head;
+    mutable int lazy_lru_tail;
+    mutable size_t lazy_memory_usage;
+    mutable int lazy_load_count;
+    mutable int lazy_evict_count;
+
+    mutable ParallelForwardWorkers parallel_forward_workers;
+
 #if NCNN_VULKAN
     const VulkanDevice* vkdev;
 
@@ -89,6 +497,20 @@ NetPrivate::NetPrivate(Option& _opt)
     local_blob_allocator = 0;
     local_workspace_allocator = 0;
 
+    blob_memory_plan.arena_size = 0;
+    blob_memory_plan.generation = 0;
+
+    lazy_loading = false;
+    lazy_memory_budget = 0;
+    lazy_lru_head = -1;
+    lazy_lru_tail = -1;
+    lazy_memory_usage = 0;
+    lazy_load_count = 0;
+    lazy_evict_count = 0;
+
+    forward_plan_resolve_count = 0;
+    forward_plan_reuse_count = 0;
+
 #if NCNN_VULKAN
     vkdev = 0;
     weight_vkallocator = 0;
@@ -97,6 +519,11 @@ NetPrivate::NetPrivate(Option& _opt)
 #endif // NCNN_VULKAN
 }
 
+NetPrivate::~NetPrivate()
+{
+    clear_required_layers_cache();
+}
+
 static Option get_masked_option(const Option& opt, int featmask)
 {
     // mask option usage as layer specific featmask
@@ -114,78 +541,1086 @@ static Option get_masked_option(const Option& opt, int featmask)
     opt1.use_sgemm_convolution = opt1.use_sgemm_convolution && !(featmask & (1 << 5));
     opt1.use_winograd_convolution = opt1.use_winograd_convolution && !(featmask & (1 << 6));
 
-    if (featmask & (1 << 7))
-        opt1.num_threads = 1;
+    if (featmask & (1 << 7))
+        opt1.num_threads = 1;
+
+    return opt1;
+}
+
+// 64-bit hash of the weight and param bytes, 8-byte words are mixed as in murmurhash3
+static void hash64_update(uint64_t& hash, const void* data, size_t size)
+{
+    const unsigned char* p = (const unsigned char*)data;
+
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t k;
+        memcpy(&k, p + i, 8);
+
+        k *= 0x87c37b91114253d5ULL;
+        k = (k << 31) | (k >> 33);
+        k *= 0x4cf5ad432745937fULL;
+
+        hash ^= k;
+        hash = ((hash << 27) | (hash >> 37)) * 5 + 0x52dce729;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ p[i]) * 0x100000001b3ULL;
+    }
+}
+
+// hash every param the layer was loaded with, the prepared weights depend on them as well
+static uint64_t get_param_digest(const ParamDict& pd)
+{
+    uint64_t digest = 0xcbf29ce484222325ULL;
+    for (int id = 0; id < NCNN_MAX_PARAM_COUNT; id++)
+    {
+        const int type = pd.type(id);
+        if (type == 0)
+            continue;
+
+        const int meta[2] = {id, type};
+        hash64_update(digest, meta, sizeof(meta));
+
+        if (type == 1 || type == 2 || type == 3)
+        {
+            const int i = pd.get(id, 0);
+            const float f = pd.get(id, 0.f);
+            hash64_update(digest, &i, sizeof(i));
+            hash64_update(digest, &f, sizeof(f));
+        }
+        if (type == 4 || type == 5 || type == 6)
+        {
+            const Mat v = pd.get(id, Mat());
+            const int w = v.w;
+            hash64_update(digest, &w, sizeof(w));
+            hash64_update(digest, v.data, v.total() * v.elemsize);
+        }
+        if (type == 7)
+        {
+            const std::string str = pd.get(id, std::string());
+            hash64_update(digest, str.c_str(), str.size() + 1);
+        }
+    }
+
+    return digest;
+}
+
+// hash the shapes and all bytes of the weights a layer loads,
+// telling apart the weight cache entries of different models
+// the weights are shared through weight_cache if set
+class ModelBinDigest : public ModelBin
+{
+public:
+    ModelBinDigest(const ModelBin& _mb, WeightCache* _weight_cache)
+        : mb(_mb), weight_cache(_weight_cache)
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        digest = 0xcbf29ce484222325ULL;
+        size = 0;
+    }
+
+    virtual Mat load(int w, int type) const
+    {
+        Mat m = mb.load(w, type);
+        if (m.empty())
+            return m;
+
+        const size_t nbytes = m.total() * m.elemsize;
+
+        const int meta[3] = {w, type, (int)m.elemsize};
+        hash64_update(digest, meta, sizeof(meta));
+        hash64_update(digest, &nbytes, sizeof(nbytes));
+        hash64_update(digest, m.data, nbytes);
+
+        size += nbytes;
+
+        if (weight_cache)
+            return weight_cache->share(m);
+
+        return m;
+    }
+
+public:
+    const ModelBin& mb;
+    WeightCache* weight_cache;
+    mutable uint64_t digest;
+    mutable size_t size;
+};
+
+// the weight cache key of a layer, everything its prepared weights depend on
+static void get_weight_cache_key(const Layer* layer, int layer_index, uint64_t param_digest, const ModelBinDigest& mb, const Option& opt, int* key)
+{
+    memset(key, 0, WeightCache::key_size * sizeof(int));
+
+    key[0] = layer_index;
+    key[1] = layer->typeindex;
+    key[2] = (int)(uint32_t)mb.digest;
+    key[3] = (int)(uint32_t)(mb.digest >> 32);
+    key[4] = opt.num_threads;
+    key[5] = opt.use_packing_layout
+             | opt.use_winograd_convolution << 1
+             | opt.use_winograd23_convolution << 2
+             | opt.use_winograd43_convolution << 3
+             | opt.use_winograd63_convolution << 4
+             | opt.use_sgemm_convolution << 5
+             | opt.use_int8_inference << 6
+             | opt.use_bf16_storage << 7
+             | opt.use_fp16_packed << 8
+             | opt.use_fp16_storage << 9
+             | opt.use_fp16_arithmetic << 10
+             | opt.use_a53_a55_optimized_kernel << 11;
+    key[6] = cpu_support_x86_avx()
+             | cpu_support_x86_fma() << 1
+             | cpu_support_x86_xop() << 2
+             | cpu_support_x86_f16c() << 3
+             | cpu_support_x86_avx2() << 4
+             | cpu_support_x86_avx_vnni() << 5
+             | cpu_support_x86_avx_vnni_int8() << 6
+             | cpu_support_x86_avx_vnni_int16() << 7
+             | cpu_support_x86_avx_ne_convert() << 8
+             | cpu_support_x86_avx512() << 9
+             | cpu_support_x86_avx512_vnni() << 10
+             | cpu_support_x86_avx512_bf16() << 11
+             | cpu_support_x86_avx512_fp16() << 12
+             | cpu_support_x86_amx_int8() << 13
+             | cpu_support_x86_amx_bf16() << 14;
+    key[7] = cpu_support_arm_neon()
+             | cpu_support_arm_vfpv4() << 1
+             | cpu_support_arm_asimdhp() << 2
+             | cpu_support_arm_asimddp() << 3
+             | cpu_support_arm_asimdfhm() << 4
+             | cpu_support_arm_bf16() << 5
+             | cpu_support_arm_i8mm() << 6
+             | cpu_support_arm_sve() << 7
+             | cpu_support_arm_sve2() << 8
+             | cpu_support_arm_svebf16() << 9
+             | cpu_support_arm_svei8mm() << 10
+             | cpu_support_arm_svef32mm() << 11
+             | cpu_support_loongarch_lsx() << 16
+             | cpu_support_loongarch_lasx() << 17
+             | cpu_support_mips_msa() << 18
+             | cpu_support_riscv_v() << 19
+             | cpu_support_riscv_zfh() << 20
+             | cpu_support_riscv_zvfh() << 21;
+    key[8] = get_cpu_level2_cache_size();
+    key[9] = get_cpu_level3_cache_size();
+
+    // the shape hints steer the kernel choice too
+    uint64_t shape_hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < layer->bottom_shapes.size(); i++)
+    {
+        const Mat& shape = layer->bottom_shapes[i];
+        const int dims[5] = {shape.dims, shape.w, shape.h, shape.d, shape.c};
+        hash64_update(shape_hash, dims, sizeof(dims));
+    }
+    for (size_t i = 0; i < layer->top_shapes.size(); i++)
+    {
+        const Mat& shape = layer->top_shapes[i];
+        const int dims[5] = {shape.dims, shape.w, shape.h, shape.d, shape.c};
+        hash64_update(shape_hash, dims, sizeof(dims));
+    }
+    key[10] = (int)(uint32_t)shape_hash;
+
+#ifdef NCNN_VERSION_NUMBER
+    // the weight layouts may change between builds
+    key[11] = NCNN_VERSION_NUMBER;
+#endif
+
+    key[12] = (int)(uint32_t)param_digest;
+    key[13] = (int)(uint32_t)(param_digest >> 32);
+}
+
+// record the weights prepared by create_pipeline, skipping layers that prepared none
+static void insert_pipeline_weights(WeightCache* weight_cache, const int* key, const std::vector<Mat*>& pipeline_weights)
+{
+    std::vector<Mat> weights(pipeline_weights.size());
+    bool prepared = false;
+    for (size_t j = 0; j < pipeline_weights.size(); j++)
+    {
+        weights[j] = *pipeline_weights[j];
+        prepared = prepared || !weights[j].empty();
+    }
+
+    if (prepared)
+        weight_cache->insert(key, weights);
+}
+
+struct compare_load_size_desc
+{
+    bool operator()(const std::pair<size_t, int>& a, const std::pair<size_t, int>& b) const
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+// create_pipeline of the layers in layer_indexes on load_threads threads, the result of layer i goes to rets[i]
+static void create_pipelines_parallel(const std::vector<Layer*>& layers, const std::vector<int>& layer_indexes, const Option& opt, const std::vector<size_t>& load_sizes, int load_threads, std::vector<int>& rets)
+{
+    size_t total_size = 0;
+    for (size_t j = 0; j < layer_indexes.size(); j++)
+    {
+        total_size += load_sizes[layer_indexes[j]];
+    }
+
+    // a layer holding more than its share of the weights is prepared alone with all openmp threads
+    std::vector<std::pair<size_t, int> > order;
+    for (size_t j = 0; j < layer_indexes.size(); j++)
+    {
+        const int i = layer_indexes[j];
+        if (load_sizes[i] * load_threads > total_size)
+        {
+            rets[i] = layers[i]->create_pipeline(get_masked_option(opt, layers[i]->featmask));
+        }
+        else
+        {
+            order.push_back(std::make_pair(load_sizes[i], i));
+        }
+    }
+
+    // the rest run concurrently, largest first, their openmp regions nest in the loader threads
+    std::partial_sort(order.begin(), order.end(), order.end(), compare_load_size_desc());
+
+    const int order_count = (int)order.size();
+    #pragma omp parallel for schedule(dynamic) num_threads(load_threads)
+    for (int j = 0; j < order_count; j++)
+    {
+        Layer* layer = layers[order[j].second];
+
+        // the allocators of opt may not be thread-safe
+        Option opt1 = get_masked_option(opt, layer->featmask);
+        opt1.blob_allocator = 0;
+        opt1.workspace_allocator = 0;
+
+        rets[order[j].second] = layer->create_pipeline(opt1);
+    }
+}
+
+void NetPrivate::collect_required_layers(int layer_index, const std::vector<Mat>& blob_mats, std::vector<int>& required_layers, std::vector<unsigned char>& blob_required) const
+{
+    const std::vector<int>* plan = &forward_plan;
+    const std::vector<int>* plan_indexes = &forward_plan_indexes;
+
+    std::vector<int> local_plan;
+    std::vector<int> local_plan_indexes;
+    if (forward_plan_indexes.size() != layers.size())
+    {
+        // plan not resolved by load_model yet, resolve a temporary one
+        resolve_forward_plan(local_plan, local_plan_indexes);
+        plan = &local_plan;
+        plan_indexes = &local_plan_indexes;
+    }
+
+    // walk the plan backward and collect the layers whose top blobs are required
+    // a blob is required when it is not ready yet and consumed by a required layer
+    blob_required.resize(blobs.size(), 0);
+    for (int i = (*plan_indexes)[layer_index]; i >= 0; i--)
+    {
+        const int required_layer_index = (*plan)[i];
+        const Layer* layer = layers[required_layer_index];
+
+        if (required_layer_index != layer_index)
+        {
+            bool required = false;
+            for (size_t j = 0; j < layer->tops.size(); j++)
+            {
+                if (blob_required[layer->tops[j]])
+                {
+                    required = true;
+                    break;
+                }
+            }
+
+            if (!required)
+                continue;
+        }
+
+        required_layers.push_back(required_layer_index);
+
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            int bottom_blob_index = layer->bottoms[j];
+
+            if (blob_mats[bottom_blob_index].dims == 0)
+                blob_required[bottom_blob_index] = 1;
+        }
+    }
+}
+
+// the walk only tests whether the bottom blobs of the required layers are ready,
+// so its result holds while each of them is ready exactly when it was
+static bool required_layers_match(const RequiredLayers& rl, const std::vector<Layer*>& layers, const std::vector<Mat>& blob_mats)
+{
+    for (size_t i = 0; i < rl.layers.size(); i++)
+    {
+        const Layer* layer = layers[rl.layers[i]];
+
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
+        {
+            int bottom_blob_index = layer->bottoms[j];
+
+            if ((blob_mats[bottom_blob_index].dims == 0) != (rl.blob_required[bottom_blob_index] != 0))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+const RequiredLayers* NetPrivate::get_required_layers(int layer_index, const std::vector<Mat>& blob_mats, RequiredLayers& local) const
+{
+    required_layers_cache_lock.lock();
+
+    const RequiredLayers* cached = layer_index < (int)required_layers_cache.size() ? required_layers_cache[layer_index] : 0;
+    if (cached && required_layers_match(*cached, layers, blob_mats))
+    {
+        forward_plan_reuse_count++;
+        required_layers_cache_lock.unlock();
+        return cached;
+    }
+
+    forward_plan_resolve_count++;
+
+    required_layers_cache_lock.unlock();
+
+    collect_required_layers(layer_index, blob_mats, local.layers, local.blob_required);
+
+    // keep the first resolution, the cached entries are never modified so they are read without lock
+    if (!cached && forward_plan_indexes.size() == layers.size())
+    {
+        required_layers_cache_lock.lock();
+
+        if (required_layers_cache.size() != layers.size())
+            required_layers_cache.resize(layers.size(), 0);
+
+        if (!required_layers_cache[layer_index])
+            required_layers_cache[layer_index] = new RequiredLayers(local);
+
+        required_layers_cache_lock.unlock();
+    }
+
+    return &local;
+}
+
+void NetPrivate::clear_required_layers_cache()
+{
+    for (size_t i = 0; i < required_layers_cache.size(); i++)
+    {
+        delete required_layers_cache[i];
+    }
+    required_layers_cache.clear();
+
+    forward_plan_resolve_count = 0;
+    forward_plan_reuse_count = 0;
+}
+
+int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt, int parallel_branches) const
+{
+    RequiredLayers local;
+    const RequiredLayers* rl = get_required_layers(layer_index, blob_mats, local);
+    const std::vector<int>& required_layers = rl->layers;
+
+    if (parallel_branches > 1 && required_layers.size() > 1)
+        return run_layers_parallel(required_layers, rl->blob_required, blob_mats, opt, parallel_branches);
+
+    // replay the required layers in topological order
+    for (size_t i = required_layers.size(); i > 0; i--)
+    {
+        int ret = run_layer(required_layers[i - 1], blob_mats, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+int NetPrivate::forward_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& opt) const
+{
+    // all samples are fed the same input blobs, the first one decides which layers to run
+    RequiredLayers local;
+    const std::vector<int>& required_layers = get_required_layers(layer_index, batch_blob_mats[0], local)->layers;
+
+    // run each layer for all samples before moving to the next one
+    // so that the weights of a layer stay in cache
+    for (size_t i = required_layers.size(); i > 0; i--)
+    {
+        int ret = run_layer_batch(required_layers[i - 1], batch_blob_mats, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+// shape and elempack of m without its data
+static Mat profile_shape(const Mat& m)
+{
+    Mat shape;
+    shape.elemsize = m.elemsize;
+    shape.elempack = m.elempack;
+    shape.dims = m.dims;
+    shape.w = m.w;
+    shape.h = m.h;
+    shape.d = m.d;
+    shape.c = m.c;
+    shape.cstep = m.cstep;
+    return shape;
+}
+
+// the specialization most recently picked by the layer
+static void profile_kernel(const Layer* layer, ProfileEvent& event)
+{
+    int value[ShapeCache::value_size];
+    if (layer->shape_cache && layer->shape_cache->last_value(value) == 0)
+    {
+        event.kernel = value[0];
+        event.tile_m = value[1];
+        event.tile_n = value[2];
+        event.tile_k = value[3];
+    }
+}
+
+static void profile_begin(const Layer* layer, int layer_index, const std::vector<Mat>& blob_mats, const Profiler* profiler, ProfileEvent& event, std::vector<const void*>& bottom_datas)
+{
+    event.layer_index = layer_index;
+    event.typeindex = layer->typeindex;
+#if NCNN_STRING
+    event.type = layer->type;
+    event.name = layer->name;
+#endif
+    event.thread = profiler->thread_index();
+
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        const Mat& bottom_blob = blob_mats[layer->bottoms[i]];
+        event.bottom_shapes.push_back(profile_shape(bottom_blob));
+        bottom_datas.push_back(bottom_blob.data);
+    }
+
+    event.start = profiler->now();
+}
+
+static void profile_end(const Layer* layer, const std::vector<Mat>& blob_mats, Profiler* profiler, ProfileEvent& event, const std::vector<const void*>& bottom_datas)
+{
+    event.end = profiler->now();
+
+    for (size_t i = 0; i < layer->tops.size(); i++)
+    {
+        const Mat& top_blob = blob_mats[layer->tops[i]];
+        event.top_shapes.push_back(profile_shape(top_blob));
+
+        // inplace layers write into their bottom blob
+        bool inplace = false;
+        for (size_t j = 0; j < bottom_datas.size(); j++)
+        {
+            if (top_blob.data == bottom_datas[j])
+                inplace = true;
+        }
+
+        if (!inplace && top_blob.data)
+            event.allocated_bytes += top_blob.total() * top_blob.elemsize;
+    }
+
+    profile_kernel(layer, event);
+
+    profiler->record(event);
+}
+
+int NetPrivate::run_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+
+    if (layer->typeindex == LayerType::Input)
+        return 0;
+
+    // the weights of a lazily loaded layer stay until the forward is done
+    const bool lazy = !lazy_layers.empty() && lazy_layers[layer_index].mem;
+    if (lazy)
+    {
+        int ret = acquire_lazy_layer(layer_index);
+        if (ret != 0)
+            return ret;
+    }
+
+    //     NCNN_LOGE("run_layer %d %s", layer_index, layer->name.c_str());
+
+#if NCNN_BENCHMARK
+    double start = get_current_time();
+    Mat bottom_blob;
+    if (layer->one_blob_only)
+    {
+        int bottom_blob_index = layer->bottoms[0];
+        bottom_blob.dims = blob_mats[bottom_blob_index].dims;
+        bottom_blob.w = blob_mats[bottom_blob_index].w;
+        bottom_blob.h = blob_mats[bottom_blob_index].h;
+        bottom_blob.d = blob_mats[bottom_blob_index].d;
+        bottom_blob.c = blob_mats[bottom_blob_index].c;
+        bottom_blob.elempack = blob_mats[bottom_blob_index].elempack;
+        bottom_blob.elemsize = blob_mats[bottom_blob_index].elemsize;
+    }
+#endif
+    Profiler* profiler = opt.profiler && opt.profiler->enabled() ? opt.profiler : 0;
+    ProfileEvent event;
+    std::vector<const void*> bottom_datas;
+    if (profiler)
+    {
+        profile_begin(layer, layer_index, blob_mats, profiler, event, bottom_datas);
+    }
+
+    int ret = 0;
+    if (opt.thread_pool)
+    {
+        // run with the threads granted by the shared pool
+        Option opt_pool = layer->featmask ? get_masked_option(opt, layer->featmask) : opt;
+        opt_pool.num_threads = opt.thread_pool->acquire(opt_pool.num_threads);
+
+        ret = do_forward_layer(layer, blob_mats, opt_pool);
+
+        opt.thread_pool->release();
+    }
+    else if (layer->featmask)
+    {
+        ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
+    }
+    else
+    {
+        ret = do_forward_layer(layer, blob_mats, opt);
+    }
+
+    if (lazy)
+    {
+        release_lazy_layer(layer_index);
+    }
+#if NCNN_BENCHMARK
+    double end = get_current_time();
+    if (layer->one_blob_only)
+    {
+        int top_blob_index = layer->tops[0];
+        benchmark(layer, bottom_blob, blob_mats[top_blob_index], start, end);
+    }
+    else
+    {
+        benchmark(layer, start, end);
+    }
+#endif
+    if (ret != 0)
+        return ret;
+
+    if (profiler)
+    {
+        profile_end(layer, blob_mats, profiler, event, bottom_datas);
+    }
+
+    //     NCNN_LOGE("run_layer %d %s done", layer_index, layer->name.c_str());
+    //     const Mat& blob = blob_mats[layer->tops[0]];
+    //     NCNN_LOGE("[%-2d %-16s %-16s]  %d    blobs count = %-3d   size = %-3d x %-3d", layer_index, layer->type.c_str(), layer->name.c_str(), layer->tops[0], blob.c, blob.h, blob.w);
+
+    return 0;
+}
+
+int NetPrivate::run_layer_batch(int layer_index, std::vector<std::vector<Mat> >& batch_blob_mats, const Option& _opt) const
+{
+    const Layer* layer = layers[layer_index];
+    const int batch = (int)batch_blob_mats.size();
+
+    // stack the thin samples as rows of one 2d blob, so that their gemv-shaped forwards become one gemm
+    // only innerproduct and gemm with constant weight support it, convolution and matmul run per sample
+    // a sample with batch_stack_max_rows or more rows is a gemm already and runs alone, stacking would only add copies
+    // innerproduct flattens samples of any other shape into one row
+    const int batch_stack_max_rows = 16;
+    const bool flatten = layer->typeindex == LayerType::InnerProduct;
+
+    std::vector<int> stacked;
+    std::vector<int> rows;
+    int width = 0;
+    int dims = 0;
+    size_t elemsize = 0;
+    int total_rows = 0;
+    for (int i = 0; layer->one_blob_only && layer->support_batch && i < batch; i++)
+    {
+        const Mat& m = batch_blob_mats[i][layer->bottoms[0]];
+
+        int w = 0;
+        int h = 0;
+        if (m.dims == 2)
+        {
+            w = m.w;
+            h = m.h * m.elempack;
+        }
+        else if (m.dims != 0 && flatten)
+        {
+            w = m.w * m.h * m.d * m.c * m.elempack;
+            h = 1;
+        }
+
+        if (w == 0 || h >= batch_stack_max_rows)
+            continue;
+
+        if (!stacked.empty() && (w != width || m.dims != dims || m.elemsize / m.elempack != elemsize))
+            continue;
+
+        width = w;
+        dims = m.dims;
+        elemsize = m.elemsize / m.elempack;
+        stacked.push_back(i);
+        rows.push_back(h);
+        total_rows += h;
+    }
+
+    if (stacked.size() < 2)
+        stacked.clear();
+
+    // the samples left out
+    for (int i = 0, j = 0; i < batch; i++)
+    {
+        if (j < (int)stacked.size() && stacked[j] == i)
+        {
+            j++;
+            continue;
+        }
+
+        int ret = run_layer(layer_index, batch_blob_mats[i], _opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    if (stacked.empty())
+        return 0;
+
+    const int stacked_count = (int)stacked.size();
+
+    Option opt = layer->featmask ? get_masked_option(_opt, layer->featmask) : _opt;
+
+#if NCNN_BENCHMARK
+    double start = get_current_time();
+#endif
+
+    Mat bottom_blob(width, total_rows, elemsize, 1, opt.workspace_allocator);
+    if (bottom_blob.empty())
+        return -100;
+
+    for (int i = 0, row = 0; i < stacked_count; i++)
+    {
+        Mat m = batch_blob_mats[stacked[i]][layer->bottoms[0]];
+        if (m.elempack != 1)
+        {
+            Mat m_unpacked;
+            convert_packing(m, m_unpacked, 1, opt);
+            if (m_unpacked.empty())
+                return -100;
+            m = m_unpacked;
+        }
+        if (m.dims != 2)
+        {
+            m = m.reshape(width, opt.workspace_allocator);
+            if (m.empty())
+                return -100;
+        }
+
+        memcpy(bottom_blob.row<unsigned char>(row), m.data, (size_t)width * rows[i] * elemsize);
+        row += rows[i];
+    }
+
+    const bool lazy = !lazy_layers.empty() && lazy_layers[layer_index].mem;
+    if (lazy)
+    {
+        int ret = acquire_lazy_layer(layer_index);
+        if (ret != 0)
+            return ret;
+    }
+
+    int ret = convert_layout(bottom_blob, layer, opt);
+    if (ret != 0)
+    {
+        if (lazy)
+            release_lazy_layer(layer_index);
+        return ret;
+    }
+
+    // one event for the stacked forward of all samples
+    Profiler* profiler = opt.profiler && opt.profiler->enabled() ? opt.profiler : 0;
+    ProfileEvent event;
+    if (profiler)
+    {
+        event.layer_index = layer_index;
+        event.typeindex = layer->typeindex;
+#if NCNN_STRING
+        event.type = layer->type;
+        event.name = layer->name;
+#endif
+        event.thread = profiler->thread_index();
+        event.batch = stacked_count;
+        event.bottom_shapes.push_back(profile_shape(bottom_blob));
+        event.start = profiler->now();
+    }
+
+    Mat top_blob;
+    if (opt.thread_pool)
+    {
+        Option opt_pool = opt;
+        opt_pool.num_threads = opt.thread_pool->acquire(opt.num_threads);
+
+        ret = layer->forward(bottom_blob, top_blob, opt_pool);
+
+        opt.thread_pool->release();
+    }
+    else
+    {
+        ret = layer->forward(bottom_blob, top_blob, opt);
+    }
+
+    if (lazy)
+    {
+        release_lazy_layer(layer_index);
+    }
+    if (ret != 0)
+        return ret;
+
+    if (profiler)
+    {
+        event.end = profiler->now();
+        event.top_shapes.push_back(profile_shape(top_blob));
+        event.allocated_bytes = top_blob.total() * top_blob.elemsize;
+
+        profile_kernel(layer, event);
+
+        profiler->record(event);
+    }
+
+    if (top_blob.elempack != 1)
+    {
+        Mat top_blob_unpacked;
+        convert_packing(top_blob, top_blob_unpacked, 1, opt);
+        if (top_blob_unpacked.empty())
+            return -100;
+        top_blob = top_blob_unpacked;
+    }
+
+    if (top_blob.dims != 2 || top_blob.h != total_rows)
+    {
+        // the layer did not treat the rows independently, run one sample at a time
+        for (int i = 0; i < stacked_count; i++)
+        {
+            ret = run_layer(layer_index, batch_blob_mats[stacked[i]], _opt);
+            if (ret != 0)
+                return ret;
+        }
+
+        return 0;
+    }
+
+    // split the rows back into samples
+    for (int i = 0, row = 0; i < stacked_count; i++)
+    {
+        Mat top;
+        if (dims == 2)
+            top.create(top_blob.w, rows[i], top_blob.elemsize, 1, opt.blob_allocator);
+        else
+            top.create(top_blob.w, top_blob.elemsize, 1, opt.blob_allocator);
+        if (top.empty())
+            return -100;
+
+        memcpy(top.data, top_blob.row<const unsigned char>(row), (size_t)top_blob.w * rows[i] * top_blob.elemsize);
+        row += rows[i];
+
+        batch_blob_mats[stacked[i]][layer->tops[0]] = top;
+
+        if (opt.lightmode)
+        {
+            // delete after taken in light mode
+            batch_blob_mats[stacked[i]][layer->bottoms[0]].release();
+        }
+    }
+
+#if NCNN_BENCHMARK
+    double end = get_current_time();
+    benchmark(layer, start, end);
+#endif
+
+    return 0;
+}
+
+// shared state of the layers forwarded concurrently
+class ParallelForwardContext
+{
+public:
+    const NetPrivate* net;
+    std::vector<Mat>* blob_mats;
+    const Option* opt;
+    int parallel_branches;
+
+    Mutex lock;
+    ConditionVariable condition;
+
+    // layers whose bottom blobs are all ready
+    std::vector<int> ready_layers;
+
+    // number of bottom blobs not produced yet, indexed by layer
+    std::vector<int> pending_counts;
+
+    // layers waiting for blob i are waiters[waiter_offsets[i] .. waiter_offsets[i + 1]]
+    std::vector<int> waiter_offsets;
+    std::vector<int> waiters;
+
+    int running_count;
+    int ret;
+};
+
+static void* parallel_forward_worker(void* args)
+{
+    ParallelForwardWorkers* workers = (ParallelForwardWorkers*)args;
+
+    // generation 0 is never used, so a new worker joins the extract in progress
+    unsigned int generation = 0;
+
+    workers->lock.lock();
+
+    for (;;)
+    {
+        while (!workers->quit && (workers->generation == generation || workers->joined_count == workers->wanted_count))
+        {
+            workers->condition.wait(workers->lock);
+        }
+
+        if (workers->quit)
+            break;
+
+        generation = workers->generation;
+        workers->joined_count++;
+
+        ParallelForwardContext* ctx = workers->ctx;
+
+        workers->lock.unlock();
+
+        set_flush_denormals(ctx->opt->flush_denormals);
+
+        ctx->net->run_ready_layers(*ctx);
+
+        workers->lock.lock();
+
+        workers->done_count++;
+        workers->condition.broadcast();
+    }
+
+    workers->lock.unlock();
+
+    return 0;
+}
+
+ParallelForwardWorkers::ParallelForwardWorkers()
+{
+    ctx = 0;
+    wanted_count = 0;
+    joined_count = 0;
+    done_count = 0;
+    generation = 0;
+    busy = false;
+    quit = false;
+}
+
+ParallelForwardWorkers::~ParallelForwardWorkers()
+{
+    lock.lock();
+    quit = true;
+    condition.broadcast();
+    lock.unlock();
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+}
+
+bool ParallelForwardWorkers::start(ParallelForwardContext* _ctx, int count)
+{
+    lock.lock();
+
+    if (busy)
+    {
+        lock.unlock();
+        return false;
+    }
+
+    busy = true;
+
+    while ((int)threads.size() < count)
+    {
+        threads.push_back(new Thread(parallel_forward_worker, this));
+    }
+
+    ctx = _ctx;
+    wanted_count = count;
+    joined_count = 0;
+    done_count = 0;
+    generation++;
+    if (generation == 0)
+        generation = 1;
+
+    condition.broadcast();
 
-    return opt1;
+    lock.unlock();
+
+    return true;
 }
 
-int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const
+void ParallelForwardWorkers::wait()
 {
-    const Layer* layer = layers[layer_index];
+    lock.lock();
 
-    if (layer->typeindex == LayerType::Input)
-        return 0;
+    while (done_count < wanted_count)
+    {
+        condition.wait(lock);
+    }
 
-    //     NCNN_LOGE("forward_layer %d %s", layer_index, layer->name.c_str());
+    ctx = 0;
+    busy = false;
 
-    // load bottom blobs
-    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    lock.unlock();
+}
+
+int NetPrivate::run_layers_parallel(const std::vector<int>& required_layers, const std::vector<unsigned char>& blob_required, std::vector<Mat>& blob_mats, const Option& opt, int parallel_branches) const
+{
+    ParallelForwardContext ctx;
+    ctx.net = this;
+    ctx.blob_mats = &blob_mats;
+    ctx.opt = &opt;
+    ctx.parallel_branches = parallel_branches;
+    ctx.running_count = 0;
+    ctx.ret = 0;
+
+    // count the bottom blobs each required layer waits for
+    ctx.pending_counts.resize(layers.size(), 0);
+    ctx.waiter_offsets.resize(blobs.size() + 1, 0);
+    for (size_t i = 0; i < required_layers.size(); i++)
     {
-        int bottom_blob_index = layer->bottoms[i];
+        const int required_layer_index = required_layers[i];
+        const Layer* layer = layers[required_layer_index];
 
-        if (blob_mats[bottom_blob_index].dims == 0)
+        for (size_t j = 0; j < layer->bottoms.size(); j++)
         {
-            int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, opt);
-            if (ret != 0)
-                return ret;
+            int bottom_blob_index = layer->bottoms[j];
+            if (!blob_required[bottom_blob_index])
+                continue;
+
+            ctx.pending_counts[required_layer_index]++;
+            ctx.waiter_offsets[bottom_blob_index + 1]++;
         }
     }
 
-#if NCNN_BENCHMARK
-    double start = get_current_time();
-    Mat bottom_blob;
-    if (layer->one_blob_only)
-    {
-        int bottom_blob_index = layer->bottoms[0];
-        bottom_blob.dims = blob_mats[bottom_blob_index].dims;
-        bottom_blob.w = blob_mats[bottom_blob_index].w;
-        bottom_blob.h = blob_mats[bottom_blob_index].h;
-        bottom_blob.d = blob_mats[bottom_blob_index].d;
-        bottom_blob.c = blob_mats[bottom_blob_index].c;
-        bottom_blob.elempack = blob_mats[bottom_blob_index].elempack;
-        bottom_blob.elemsize = blob_mats[bottom_blob_index].elemsize;
-    }
-#endif
-    int ret = 0;
-    if (layer->featmask)
+    for (size_t i = 0; i < blobs.size(); i++)
     {
-        ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
+        ctx.waiter_offsets[i + 1] += ctx.waiter_offsets[i];
     }
-    else
+
+    ctx.waiters.resize(ctx.waiter_offsets[blobs.size()]);
     {
-        ret = do_forward_layer(layer, blob_mats, opt);
+        std::vector<int> waiter_cursors(blobs.size());
+        for (size_t i = 0; i < blobs.size(); i++)
+        {
+            waiter_cursors[i] = ctx.waiter_offsets[i];
+        }
+
+        for (size_t i = required_layers.size(); i > 0; i--)
+        {
+            const int required_layer_index = required_layers[i - 1];
+            const Layer* layer = layers[required_layer_index];
+
+            for (size_t j = 0; j < layer->bottoms.size(); j++)
+            {
+                int bottom_blob_index = layer->bottoms[j];
+                if (!blob_required[bottom_blob_index])
+                    continue;
+
+                ctx.waiters[waiter_cursors[bottom_blob_index]++] = required_layer_index;
+            }
+        }
     }
-#if NCNN_BENCHMARK
-    double end = get_current_time();
-    if (layer->one_blob_only)
+
+    // ready layers are taken from the back, push them in reverse topological order
+    for (size_t i = 0; i < required_layers.size(); i++)
     {
-        int top_blob_index = layer->tops[0];
-        benchmark(layer, bottom_blob, blob_mats[top_blob_index], start, end);
+        if (ctx.pending_counts[required_layers[i]] == 0)
+            ctx.ready_layers.push_back(required_layers[i]);
     }
-    else
+
+    // the calling thread works as one of the branches
+    // it runs every layer alone while another extract holds the workers
+    const bool started = parallel_forward_workers.start(&ctx, parallel_branches - 1);
+    if (!started)
+        ctx.parallel_branches = 1;
+
+    run_ready_layers(ctx);
+
+    if (started)
+        parallel_forward_workers.wait();
+
+    return ctx.ret;
+}
+
+void NetPrivate::run_ready_layers(ParallelForwardContext& ctx) const
+{
+    ctx.lock.lock();
+
+    for (;;)
     {
-        benchmark(layer, start, end);
+        while (ctx.ready_layers.empty() && ctx.running_count > 0 && ctx.ret == 0)
+        {
+            ctx.condition.wait(ctx.lock);
+        }
+
+        if (ctx.ready_layers.empty() || ctx.ret != 0)
+            break;
+
+        const int layer_index = ctx.ready_layers.back();
+        ctx.ready_layers.pop_back();
+        ctx.running_count++;
+
+        // split the thread budget among the layers that may run at the same time
+        const int branch_count = std::min(ctx.parallel_branches, ctx.running_count + (int)ctx.ready_layers.size());
+
+        Option opt = *ctx.opt;
+        opt.num_threads = std::max(ctx.opt->num_threads / branch_count, 1);
+
+        ctx.lock.unlock();
+
+        int ret = run_layer(layer_index, *ctx.blob_mats, opt);
+
+        ctx.lock.lock();
+
+        ctx.running_count--;
+
+        if (ret != 0)
+        {
+            ctx.ret = ret;
+        }
+        else
+        {
+            const Layer* layer = layers[layer_index];
+            for (size_t i = 0; i < layer->tops.size(); i++)
+            {
+                int top_blob_index = layer->tops[i];
+                for (int j = ctx.waiter_offsets[top_blob_index]; j < ctx.waiter_offsets[top_blob_index + 1]; j++)
+                {
+                    const int waiter_layer_index = ctx.waiters[j];
+                    if (--ctx.pending_counts[waiter_layer_index] == 0)
+                        ctx.ready_layers.push_back(waiter_layer_index);
+                }
+            }
+        }
+
+        ctx.condition.broadcast();
     }
-#endif
-    if (ret != 0)
-        return ret;
 
-    //     NCNN_LOGE("forward_layer %d %s done", layer_index, layer->name.c_str());
-    //     const Mat& blob = blob_mats[layer->tops[0]];
-    //     NCNN_LOGE("[%-2d %-16s %-16s]  %d    blobs count = %-3d   size = %-3d x %-3d", layer_index, layer->type.c_str(), layer->name.c_str(), layer->tops[0], blob.c, blob.h, blob.w);
+    ctx.condition.broadcast();
 
-    return 0;
+    ctx.lock.unlock();
 }
 
 #if NCNN_VULKAN
@@ -392,6 +1827,15 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
         }
         else
 #endif // NCNN_ZFH
+#if NCNN_F16C
+        if (opt.use_fp16_storage && opt.use_x86_fp16_storage && !opt.use_bf16_storage && cpu_support_x86_f16c() && layer->support_fp16_storage)
+        {
+            Mat bottom_blob_fp16;
+            cast_float32_to_float16(bottom_blob, bottom_blob_fp16, opt);
+            bottom_blob = bottom_blob_fp16;
+        }
+        else
+#endif // NCNN_F16C
 #if NCNN_BF16
         if (opt.use_bf16_storage && layer->support_bf16_storage)
         {
@@ -455,6 +1899,18 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
                     dst_elempack = 8;
                 else if (elemcount % 4 == 0)
                     dst_elempack = 4;
+#elif NCNN_AVX512
+                if (elemcount % 16 == 0 && ncnn::cpu_support_x86_avx512())
+                    dst_elempack = 16;
+                else if (elemcount % 8 == 0 && ncnn::cpu_support_x86_avx())
+                    dst_elempack = 8;
+                else if (elemcount % 4 == 0)
+                    dst_elempack = 4;
+#elif NCNN_AVX
+                if (elemcount % 8 == 0 && ncnn::cpu_support_x86_avx())
+                    dst_elempack = 8;
+                else if (elemcount % 4 == 0)
+                    dst_elempack = 4;
 #elif NCNN_RVV || NCNN_XTHEADVECTOR
                 const int packn = ncnn::cpu_riscv_vlenb() / 2;
                 if (elemcount % packn == 0)
@@ -526,6 +1982,15 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
         }
         else
 #endif // NCNN_ZFH
+#if NCNN_F16C
+        if (opt.use_fp16_storage && opt.use_x86_fp16_storage && !opt.use_bf16_storage && cpu_support_x86_f16c() && !layer->support_fp16_storage)
+        {
+            Mat bottom_blob_fp32;
+            cast_float16_to_float32(bottom_blob, bottom_blob_fp32, opt);
+            bottom_blob = bottom_blob_fp32;
+        }
+        else
+#endif // NCNN_F16C
 #if NCNN_BF16
         if (opt.use_bf16_storage && !layer->support_bf16_storage)
         {
@@ -858,6 +2323,191 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<VkMat>& blob_ma
 }
 #endif // NCNN_VULKAN
 
+int NetPrivate::acquire_lazy_layer(int layer_index) const
+{
+    LazyLayer& lazy = lazy_layers[layer_index];
+
+    lazy_lock.lock();
+
+    // another forward is loading it
+    while (lazy.loading)
+    {
+        lazy_condition.wait(lazy_lock);
+    }
+
+    if (lazy.resident)
+    {
+        if (lazy.use_count == 0)
+            lazy_lru_remove(layer_index);
+
+        lazy.use_count++;
+
+        lazy_lock.unlock();
+        return 0;
+    }
+
+    // load without holding lazy_lock, forwards of the other layers go on meanwhile
+    lazy.loading = true;
+
+    lazy_lock.unlock();
+
+    int ret = load_lazy_layer(layer_index);
+
+    lazy_lock.lock();
+
+    lazy.loading = false;
+    lazy_condition.broadcast();
+
+    if (ret == 0)
+    {
+        lazy.resident = true;
+        lazy.use_count++;
+        lazy_memory_usage += lazy.memory_usage;
+        lazy_load_count++;
+
+        evict_lazy_layers();
+    }
+
+    lazy_lock.unlock();
+
+    return ret;
+}
+
+void NetPrivate::release_lazy_layer(int layer_index) const
+{
+    lazy_lock.lock();
+
+    LazyLayer& lazy = lazy_layers[layer_index];
+
+    lazy.use_count--;
+    if (lazy.use_count == 0)
+        lazy_lru_push_back(layer_index);
+
+    // the layers running at acquire time may be evicted now
+    evict_lazy_layers();
+
+    lazy_lock.unlock();
+}
+
+int NetPrivate::load_lazy_layer(int layer_index) const
+{
+    Layer* layer = layers[layer_index];
+    LazyLayer& lazy = lazy_layers[layer_index];
+
+    if (!lazy.model_loaded)
+    {
+        const unsigned char* mem = lazy.mem;
+        DataReaderFromMemory dr(mem);
+        ModelBinFromDataReader mb(dr);
+
+        int lret = layer->load_model(mb);
+        if (lret != 0)
+        {
+#if NCNN_STRING
+            NCNN_LOGE("layer load_model %d %s failed", layer_index, layer->name.c_str());
+#else
+            NCNN_LOGE("layer load_model %d failed", layer_index);
+#endif
+            return -1;
+        }
+
+        lazy.model_loaded = true;
+    }
+
+    // the allocators of opt may be in use by other extractors
+    Option opt1 = get_masked_option(opt, layer->featmask);
+    opt1.blob_allocator = 0;
+    opt1.workspace_allocator = 0;
+
+    int cret = layer->create_pipeline(opt1);
+    if (cret != 0)
+    {
+#if NCNN_STRING
+        NCNN_LOGE("layer create_pipeline %d %s failed", layer_index, layer->name.c_str());
+#else
+        NCNN_LOGE("layer create_pipeline %d failed", layer_index);
+#endif
+        return -1;
+    }
+
+    std::vector<Mat*> pipeline_weights;
+    layer->get_pipeline_weights(pipeline_weights);
+
+    lazy.memory_usage = 0;
+    for (size_t i = 0; i < pipeline_weights.size(); i++)
+    {
+        const Mat& m = *pipeline_weights[i];
+
+        // weights referencing the model data cost nothing
+        if (m.refcount)
+            lazy.memory_usage += m.total() * m.elemsize;
+    }
+
+    return 0;
+}
+
+void NetPrivate::evict_lazy_layers() const
+{
+    // the least recently used layer not running goes first
+    while (lazy_memory_budget != 0 && lazy_memory_usage > lazy_memory_budget && lazy_lru_head != -1)
+    {
+        const int evict_index = lazy_lru_head;
+        lazy_lru_remove(evict_index);
+
+        Layer* layer = layers[evict_index];
+        LazyLayer& lazy = lazy_layers[evict_index];
+
+        layer->destroy_pipeline(get_masked_option(opt, layer->featmask));
+
+        std::vector<Mat*> pipeline_weights;
+        layer->get_pipeline_weights(pipeline_weights);
+        for (size_t i = 0; i < pipeline_weights.size(); i++)
+        {
+            pipeline_weights[i]->release();
+        }
+
+        // lightmode create_pipeline dropped the model weights, load them again next time
+        lazy.resident = false;
+        lazy.model_loaded = false;
+        lazy_memory_usage -= lazy.memory_usage;
+        lazy.memory_usage = 0;
+        lazy_evict_count++;
+    }
+}
+
+void NetPrivate::lazy_lru_push_back(int layer_index) const
+{
+    LazyLayer& lazy = lazy_layers[layer_index];
+
+    lazy.lru_prev = lazy_lru_tail;
+    lazy.lru_next = -1;
+
+    if (lazy_lru_tail != -1)
+        lazy_layers[lazy_lru_tail].lru_next = layer_index;
+    else
+        lazy_lru_head = layer_index;
+
+    lazy_lru_tail = layer_index;
+}
+
+void NetPrivate::lazy_lru_remove(int layer_index) const
+{
+    LazyLayer& lazy = lazy_layers[layer_index];
+
+    if (lazy.lru_prev != -1)
+        lazy_layers[lazy.lru_prev].lru_next = lazy.lru_next;
+    else
+        lazy_lru_head = lazy.lru_next;
+
+    if (lazy.lru_next != -1)
+        lazy_layers[lazy.lru_next].lru_prev = lazy.lru_prev;
+    else
+        lazy_lru_tail = lazy.lru_prev;
+
+    lazy.lru_prev = -1;
+    lazy.lru_next = -1;
+}
+
 void NetPrivate::update_input_output_indexes()
 {
     input_blob_indexes.clear();
@@ -896,13 +2546,116 @@ void NetPrivate::update_input_output_names()
         input_blob_names.push_back(blobs[blob_index].name.c_str());
     }
 
-    for (size_t i = 0; i < output_blob_indexes.size(); i++)
+    for (size_t i = 0; i < output_blob_indexes.size(); i++)
+    {
+        int blob_index = output_blob_indexes[i];
+        output_blob_names.push_back(blobs[blob_index].name.c_str());
+    }
+}
+#endif // NCNN_STRING
+
+void NetPrivate::update_forward_plan()
+{
+    clear_required_layers_cache();
+
+    resolve_forward_plan(forward_plan, forward_plan_indexes);
+}
+
+void NetPrivate::resolve_forward_plan(std::vector<int>& plan, std::vector<int>& plan_indexes) const
+{
+    const int layer_count = (int)layers.size();
+
+    plan.clear();
+
+    // -1 = unvisited, -2 = visiting
+    plan_indexes.clear();
+    plan_indexes.resize(layer_count, -1);
+
+    // depth-first post-order on producers, without recursion
+    std::vector<std::pair<int, int> > stack;
+    for (int i = 0; i < layer_count; i++)
+    {
+        if (plan_indexes[i] != -1)
+            continue;
+
+        plan_indexes[i] = -2;
+        stack.push_back(std::make_pair(i, 0));
+
+        while (!stack.empty())
+        {
+            const int layer_index = stack.back().first;
+            const int bottom_index = stack.back().second;
+            const Layer* layer = layers[layer_index];
+
+            if (layer && bottom_index < (int)layer->bottoms.size())
+            {
+                stack.back().second++;
+
+                int producer = blobs[layer->bottoms[bottom_index]].producer;
+                if (producer >= 0 && plan_indexes[producer] == -1)
+                {
+                    plan_indexes[producer] = -2;
+                    stack.push_back(std::make_pair(producer, 0));
+                }
+                continue;
+            }
+
+            plan_indexes[layer_index] = (int)plan.size();
+            plan.push_back(layer_index);
+            stack.pop_back();
+        }
+    }
+}
+
+BlobMemoryArena* NetPrivate::acquire_blob_memory_arena()
+{
+    MutexLockGuard lock(blob_memory_arenas_lock);
+
+    if (!blob_memory_arenas.empty())
+    {
+        BlobMemoryArena* arena = blob_memory_arenas.back();
+        blob_memory_arenas.pop_back();
+        return arena;
+    }
+
+    return new BlobMemoryArena(blob_memory_plan);
+}
+
+void NetPrivate::reclaim_blob_memory_arena(BlobMemoryArena* arena)
+{
+    if (!arena->reset())
+    {
+        // still referenced, the arena releases itself later
+        return;
+    }
+
+    if (arena->generation != blob_memory_plan.generation)
+    {
+        // created for an outdated plan
+        delete arena;
+        return;
+    }
+
+    MutexLockGuard lock(blob_memory_arenas_lock);
+
+    blob_memory_arenas.push_back(arena);
+}
+
+void NetPrivate::clear_blob_memory_plan()
+{
+    for (size_t i = 0; i < blob_memory_arenas.size(); i++)
     {
-        int blob_index = output_blob_indexes[i];
-        output_blob_names.push_back(blobs[blob_index].name.c_str());
+        delete blob_memory_arenas[i];
     }
+    blob_memory_arenas.clear();
+
+    blob_memory_plan.sizes.clear();
+    blob_memory_plan.offsets.clear();
+    blob_memory_plan.frees_before.clear();
+    blob_memory_plan.free_order.clear();
+    blob_memory_plan.arena_size = 0;
+    blob_memory_plan.generation++;
 }
-#endif // NCNN_STRING
 
 Net::Net()
     : d(new NetPrivate(opt))
@@ -1047,6 +2800,7 @@ int Net::load_param(const DataReader& dr)
     }
 
     d->layers.resize((size_t)layer_count);
+    d->layer_param_digests.resize((size_t)layer_count);
     d->blobs.resize((size_t)blob_count);
 
 #if NCNN_VULKAN
@@ -1250,6 +3004,8 @@ int Net::load_param(const DataReader& dr)
             return -1;
         }
 
+        d->layer_param_digests[i] = get_param_digest(pd);
+
         if (layer->support_int8_storage)
         {
             // no int8 gpu support yet
@@ -1352,6 +3108,7 @@ int Net::load_param_bin(const DataReader& dr)
     }
 
     d->layers.resize(layer_count);
+    d->layer_param_digests.resize(layer_count);
     d->blobs.resize(blob_count);
 
 #if NCNN_VULKAN
@@ -1538,6 +3295,8 @@ int Net::load_param_bin(const DataReader& dr)
             return -1;
         }
 
+        d->layer_param_digests[i] = get_param_digest(pd);
+
         if (layer->support_int8_storage)
         {
             // no int8 gpu support yet
@@ -1642,7 +3401,39 @@ int Net::load_model(const DataReader& dr)
     }
 #endif // NCNN_VULKAN
 
-    ModelBinFromDataReader mb(dr);
+    int load_threads = opt.num_load_threads > 0 ? opt.num_load_threads : opt.num_threads;
+#if NCNN_VULKAN
+    if (opt.use_vulkan_compute)
+    {
+        // pipelines and uploads go through the device one layer after another
+        load_threads = 1;
+    }
+#endif // NCNN_VULKAN
+    load_threads = std::min(load_threads, layer_count);
+
+    // loading with more than one thread prepares the layers after all of them are loaded
+    std::vector<size_t> load_sizes(layer_count, 0);
+    std::vector<int> weight_cache_keys(layer_count * WeightCache::key_size, 0);
+    std::vector<unsigned char> weight_cache_records(layer_count, 0);
+    std::vector<int> pipeline_layers;
+
+    // lazily loaded layers reference their model data to load it again after eviction
+    bool lazy_loading = d->lazy_loading;
+#if NCNN_VULKAN
+    lazy_loading = lazy_loading && !opt.use_vulkan_compute;
+#endif // NCNN_VULKAN
+
+    d->lazy_layers.clear();
+    if (lazy_loading)
+        d->lazy_layers.resize(layer_count);
+    d->lazy_lru_head = -1;
+    d->lazy_lru_tail = -1;
+    d->lazy_memory_usage = 0;
+    d->lazy_load_count = 0;
+    d->lazy_evict_count = 0;
+
+    ModelBinFromDataReader mb0(dr);
+    ModelBinDigest mb(mb0, opt.weight_cache);
     for (int i = 0; i < layer_count; i++)
     {
         Layer* layer = d->layers[i];
@@ -1655,6 +3446,13 @@ int Net::load_model(const DataReader& dr)
             break;
         }
 
+        // null if the data reader can not reference its data
+        const void* layer_mem = 0;
+        if (lazy_loading)
+            dr.reference(0, &layer_mem);
+
+        mb.reset();
+
         int lret = layer->load_model(mb);
         if (lret != 0)
         {
@@ -1669,6 +3467,52 @@ int Net::load_model(const DataReader& dr)
 
         Option opt1 = get_masked_option(opt, layer->featmask);
 
+        if (layer_mem)
+        {
+            std::vector<Mat*> lazy_weights;
+            layer->get_pipeline_weights(lazy_weights);
+            if (!lazy_weights.empty())
+            {
+                // prepared on first forward
+                d->lazy_layers[i].mem = (const unsigned char*)layer_mem;
+                d->lazy_layers[i].model_loaded = true;
+                continue;
+            }
+        }
+
+        // hand the weights prepared in an earlier load to create_pipeline
+        std::vector<Mat*> pipeline_weights;
+        int* weight_cache_key = &weight_cache_keys[i * WeightCache::key_size];
+        bool weight_cache_hit = false;
+        if (opt.weight_cache)
+        {
+            layer->get_pipeline_weights(pipeline_weights);
+        }
+        if (!pipeline_weights.empty())
+        {
+            const uint64_t param_digest = i < (int)d->layer_param_digests.size() ? d->layer_param_digests[i] : 0;
+            get_weight_cache_key(layer, i, param_digest, mb, opt1, weight_cache_key);
+
+            std::vector<Mat> weights;
+            if (opt.weight_cache->find(weight_cache_key, weights) == 0 && weights.size() == pipeline_weights.size())
+            {
+                for (size_t j = 0; j < pipeline_weights.size(); j++)
+                {
+                    *pipeline_weights[j] = weights[j];
+                }
+                weight_cache_hit = true;
+            }
+        }
+
+        load_sizes[i] = mb.size;
+        weight_cache_records[i] = !pipeline_weights.empty() && !weight_cache_hit;
+
+        if (load_threads > 1)
+        {
+            pipeline_layers.push_back(i);
+            continue;
+        }
+
         int cret = layer->create_pipeline(opt1);
         if (cret != 0)
         {
@@ -1681,6 +3525,9 @@ int Net::load_model(const DataReader& dr)
             break;
         }
 
+        if (weight_cache_records[i])
+            insert_pipeline_weights(opt.weight_cache, weight_cache_key, pipeline_weights);
+
 #if NCNN_VULKAN
         if (layer->support_vulkan && opt.use_vulkan_compute && cmd_upload)
         {
@@ -1712,6 +3559,42 @@ int Net::load_model(const DataReader& dr)
 #endif // NCNN_VULKAN
     }
 
+    if (ret == 0 && load_threads > 1)
+    {
+        std::vector<int> rets(layer_count, 0);
+        create_pipelines_parallel(d->layers, pipeline_layers, opt, load_sizes, load_threads, rets);
+
+        // report the first failure and record the weights in layer order, as loading with one thread does
+        for (int i = 0; i < layer_count; i++)
+        {
+            Layer* layer = d->layers[i];
+
+            if (rets[i] != 0)
+            {
+#if NCNN_STRING
+                NCNN_LOGE("layer create_pipeline %d %s failed", i, layer->name.c_str());
+#else
+                NCNN_LOGE("layer create_pipeline %d failed", i);
+#endif
+                ret = -1;
+                break;
+            }
+
+            if (weight_cache_records[i])
+            {
+                std::vector<Mat*> pipeline_weights;
+                layer->get_pipeline_weights(pipeline_weights);
+                insert_pipeline_weights(opt.weight_cache, &weight_cache_keys[i * WeightCache::key_size], pipeline_weights);
+            }
+        }
+    }
+
+    if (opt.weight_cache)
+    {
+        // forget the model weights create_pipeline released in lightmode
+        opt.weight_cache->release_unused();
+    }
+
     if (opt.use_local_pool_allocator)
     {
         if (opt.blob_allocator == 0)
@@ -1732,6 +3615,11 @@ int Net::load_model(const DataReader& dr)
         }
     }
 
+    if (ret == 0)
+    {
+        d->update_forward_plan();
+    }
+
 #if NCNN_VULKAN
     if (ret == 0 && opt.use_vulkan_compute && cmd_upload)
     {
@@ -2050,6 +3938,18 @@ void Net::clear()
         }
     }
     d->layers.clear();
+    d->layer_param_digests.clear();
+
+    d->forward_plan.clear();
+    d->forward_plan_indexes.clear();
+    d->clear_required_layers_cache();
+
+    d->lazy_layers.clear();
+    d->lazy_lru_head = -1;
+    d->lazy_lru_tail = -1;
+    d->lazy_memory_usage = 0;
+
+    d->clear_blob_memory_plan();
 
     if (d->local_blob_allocator)
     {
@@ -2082,6 +3982,100 @@ void Net::clear()
 #endif // NCNN_VULKAN
 }
 
+void Net::set_lazy_loading(bool enabled, size_t memory_budget)
+{
+    d->lazy_loading = enabled;
+
+    d->lazy_lock.lock();
+    d->lazy_memory_budget = memory_budget;
+    d->lazy_lock.unlock();
+}
+
+int Net::lazy_load_count() const
+{
+    d->lazy_lock.lock();
+    int count = d->lazy_load_count;
+    d->lazy_lock.unlock();
+    return count;
+}
+
+int Net::lazy_evict_count() const
+{
+    d->lazy_lock.lock();
+    int count = d->lazy_evict_count;
+    d->lazy_lock.unlock();
+    return count;
+}
+
+size_t Net::lazy_memory_usage() const
+{
+    d->lazy_lock.lock();
+    size_t usage = d->lazy_memory_usage;
+    d->lazy_lock.unlock();
+    return usage;
+}
+
+int Net::forward_plan_resolve_count() const
+{
+    d->required_layers_cache_lock.lock();
+    int count = d->forward_plan_resolve_count;
+    d->required_layers_cache_lock.unlock();
+    return count;
+}
+
+int Net::forward_plan_reuse_count() const
+{
+    d->required_layers_cache_lock.lock();
+    int count = d->forward_plan_reuse_count;
+    d->required_layers_cache_lock.unlock();
+    return count;
+}
+
+size_t Net::plan_memory(const std::vector<Mat>& input_shapes)
+{
+    d->clear_blob_memory_plan();
+
+    if (d->layers.empty() || input_shapes.size() != d->input_blob_indexes.size())
+    {
+        NCNN_LOGE("plan_memory expects %d input shapes", (int)d->input_blob_indexes.size());
+        return 0;
+    }
+
+    // run once on zero inputs and record the blob allocation sequence
+    BlobMemoryRecorder recorder;
+    {
+        Extractor ex = create_extractor();
+        ex.set_blob_allocator(&recorder);
+
+        for (size_t i = 0; i < input_shapes.size(); i++)
+        {
+            Mat in;
+            in.create_like(input_shapes[i]);
+            if (in.empty())
+                return 0;
+
+            memset(in.data, 0, in.total() * in.elemsize);
+
+            ex.input(d->input_blob_indexes[i], in);
+        }
+
+        for (size_t i = 0; i < d->output_blob_indexes.size(); i++)
+        {
+            Mat out;
+            int ret = ex.extract(d->output_blob_indexes[i], out);
+            if (ret != 0)
+            {
+                NCNN_LOGE("plan_memory forward failed %d", ret);
+                return 0;
+            }
+        }
+    }
+
+    recorder.resolve(d->blob_memory_plan);
+
+    return d->blob_memory_plan.arena_size;
+}
+
 Extractor Net::create_extractor() const
 {
     return Extractor(this, d->blobs.size());
@@ -2256,11 +4250,20 @@ public:
     ExtractorPrivate(const Net* _net)
         : net(_net)
     {
+        parallel_branches = 0;
+        local_blob_arena = 0;
     }
     const Net* net;
     std::vector<Mat> blob_mats;
     Option opt;
 
+    // blob mats of each sample in batched inference
+    std::vector<std::vector<Mat> > batch_blob_mats;
+
+    int parallel_branches;
+
+    BlobMemoryArena* local_blob_arena;
+
 #if NCNN_VULKAN
     VkAllocator* local_blob_vkallocator;
     VkAllocator* local_staging_vkallocator;
@@ -2299,6 +4302,11 @@ Extractor::Extractor(const Extractor& rhs)
     d->net = rhs.d->net;
     d->blob_mats = rhs.d->blob_mats;
     d->opt = rhs.d->opt;
+    d->batch_blob_mats = rhs.d->batch_blob_mats;
+    d->parallel_branches = rhs.d->parallel_branches;
+
+    if (d->opt.blob_allocator == rhs.d->local_blob_arena)
+        d->opt.blob_allocator = 0;
 
 #if NCNN_VULKAN
     d->local_blob_vkallocator = 0;
@@ -2313,9 +4321,16 @@ Extractor& Extractor::operator=(const Extractor& rhs)
     if (this == &rhs)
         return *this;
 
+    clear();
+
     d->net = rhs.d->net;
     d->blob_mats = rhs.d->blob_mats;
     d->opt = rhs.d->opt;
+    d->batch_blob_mats = rhs.d->batch_blob_mats;
+    d->parallel_branches = rhs.d->parallel_branches;
+
+    if (d->opt.blob_allocator == rhs.d->local_blob_arena)
+        d->opt.blob_allocator = 0;
 
 #if NCNN_VULKAN
     d->local_blob_vkallocator = 0;
@@ -2330,6 +4345,16 @@ Extractor& Extractor::operator=(const Extractor& rhs)
 void Extractor::clear()
 {
     d->blob_mats.clear();
+    d->batch_blob_mats.clear();
+
+    if (d->local_blob_arena)
+    {
+        if (d->opt.blob_allocator == d->local_blob_arena)
+            d->opt.blob_allocator = 0;
+
+        d->net->d->reclaim_blob_memory_arena(d->local_blob_arena);
+        d->local_blob_arena = 0;
+    }
 
 #if NCNN_VULKAN
     if (d->opt.use_vulkan_compute)
@@ -2365,6 +4390,26 @@ void Extractor::set_workspace_allocator(Allocator* allocator)
     d->opt.workspace_allocator = allocator;
 }
 
+void Extractor::set_thread_pool(ThreadPool* pool)
+{
+    d->opt.thread_pool = pool;
+}
+
+void Extractor::set_profiler(Profiler* profiler)
+{
+    d->opt.profiler = profiler;
+}
+
+void Extractor::set_kv_cache(KVCache* cache)
+{
+    d->opt.kv_cache = cache;
+}
+
+void Extractor::set_parallel_branches(int count)
+{
+    d->parallel_branches = count;
+}
+
 #if NCNN_VULKAN
 void Extractor::set_blob_vkallocator(VkAllocator* allocator)
 {
@@ -2418,6 +4463,42 @@ int Extractor::extract(const char* blob_name, Mat& feat, int type)
 
     return extract(blob_index, feat, type);
 }
+
+int Extractor::input_batch(const char* blob_name, const std::vector<Mat>& in)
+{
+    int blob_index = d->net->find_blob_index_by_name(blob_name);
+    if (blob_index == -1)
+    {
+        NCNN_LOGE("Try");
+        const std::vector<const char*>& input_names = d->net->input_names();
+        for (size_t i = 0; i < input_names.size(); i++)
+        {
+            NCNN_LOGE("    ex.input_batch(\"%s\", in%d);", input_names[i], (int)i);
+        }
+
+        return -1;
+    }
+
+    return input_batch(blob_index, in);
+}
+
+int Extractor::extract_batch(const char* blob_name, std::vector<Mat>& feats, int type)
+{
+    int blob_index = d->net->find_blob_index_by_name(blob_name);
+    if (blob_index == -1)
+    {
+        NCNN_LOGE("Try");
+        const std::vector<const char*>& output_names = d->net->output_names();
+        for (size_t i = 0; i < output_names.size(); i++)
+        {
+            NCNN_LOGE("    ex.extract_batch(\"%s\", out%d);", output_names[i], (int)i);
+        }
+
+        return -1;
+    }
+
+    return extract_batch(blob_index, feats, type);
+}
 #endif // NCNN_STRING
 
 int Extractor::input(int blob_index, const Mat& in)
@@ -2447,6 +4528,14 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
     {
         int layer_index = d->net->blobs()[blob_index].producer;
 
+        // use planned blob memory arena
+        // the plan follows the sequential layer order
+        if (!d->opt.blob_allocator && !d->opt.use_vulkan_compute && d->parallel_branches <= 1 && d->net->d->blob_memory_plan.arena_size != 0)
+        {
+            d->local_blob_arena = d->net->d->acquire_blob_memory_arena();
+            d->opt.blob_allocator = d->local_blob_arena;
+        }
+
         // use local allocator
         if (d->opt.use_local_pool_allocator)
         {
@@ -2511,10 +4600,22 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
         }
         else
         {
-            ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
+            if (d->opt.thread_pool)
+                d->opt.thread_pool->enter();
+
+            ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt, d->parallel_branches);
+
+            if (d->opt.thread_pool)
+                d->opt.thread_pool->leave();
         }
 #else
-        ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
+        if (d->opt.thread_pool)
+            d->opt.thread_pool->enter();
+
+        ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt, d->parallel_branches);
+
+        if (d->opt.thread_pool)
+            d->opt.thread_pool->leave();
 #endif // NCNN_VULKAN
     }
 
@@ -2570,6 +4671,18 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
         }
         else
 #endif // NCNN_ZVFH
+#if NCNN_F16C
+        if (d->opt.use_fp16_storage && d->opt.use_x86_fp16_storage && !d->opt.use_bf16_storage && cpu_support_x86_f16c() && (type == 0))
+        {
+            if (feat.elembits() == 16)
+            {
+                Mat feat_fp32;
+                cast_float16_to_float32(feat, feat_fp32, d->opt);
+                feat = feat_fp32;
+            }
+        }
+        else
+#endif // NCNN_F16C
 #if NCNN_BF16
         if (d->opt.use_bf16_storage && (type == 0))
         {
@@ -2601,6 +4714,15 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
             if (feat.empty())
                 return -100;
         }
+
+        if (d->local_blob_arena && feat.allocator == d->local_blob_arena)
+        {
+            // detach the returned mat from blob memory arena
+            // the arena is recycled when extractor goes away
+            feat = feat.clone();
+            if (feat.empty())
+                return -100;
+        }
     }
 
     set_kmp_blocktime(old_blocktime);
@@ -2609,6 +4731,111 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
     return ret;
 }
 
+int Extractor::input_batch(int blob_index, const std::vector<Mat>& in)
+{
+    if (blob_index < 0 || blob_index >= (int)d->blob_mats.size() || in.empty())
+        return -1;
+
+    if (d->batch_blob_mats.size() != in.size())
+    {
+        // start a new batch
+        d->batch_blob_mats.clear();
+        d->batch_blob_mats.resize(in.size(), std::vector<Mat>(d->blob_mats.size()));
+    }
+
+    for (size_t i = 0; i < in.size(); i++)
+    {
+        d->batch_blob_mats[i][blob_index] = in[i];
+    }
+
+    return 0;
+}
+
+int Extractor::extract_batch(int blob_index, std::vector<Mat>& feats, int type)
+{
+    if (blob_index < 0 || blob_index >= (int)d->blob_mats.size() || d->batch_blob_mats.empty())
+        return -1;
+
+#if NCNN_VULKAN
+    if (d->opt.use_vulkan_compute)
+    {
+        NCNN_LOGE("extract_batch does not support vulkan compute");
+        return -1;
+    }
+#endif // NCNN_VULKAN
+
+    const size_t batch = d->batch_blob_mats.size();
+
+    bool ready = true;
+    for (size_t i = 0; i < batch; i++)
+    {
+        if (d->batch_blob_mats[i][blob_index].dims == 0)
+            ready = false;
+    }
+
+    if (!ready)
+    {
+        int old_blocktime = get_kmp_blocktime();
+        set_kmp_blocktime(d->opt.openmp_blocktime);
+
+        int old_flush_denormals = get_flush_denormals();
+        set_flush_denormals(d->opt.flush_denormals);
+
+        // use local allocator
+        if (d->opt.use_local_pool_allocator)
+        {
+            if (!d->opt.blob_allocator)
+            {
+                d->opt.blob_allocator = d->net->d->local_blob_allocator;
+            }
+            if (!d->opt.workspace_allocator)
+            {
+                d->opt.workspace_allocator = d->net->d->local_workspace_allocator;
+            }
+        }
+
+        if (d->opt.thread_pool)
+            d->opt.thread_pool->enter();
+
+        int layer_index = d->net->blobs()[blob_index].producer;
+        int ret = d->net->d->forward_layer_batch(layer_index, d->batch_blob_mats, d->opt);
+
+        if (d->opt.thread_pool)
+            d->opt.thread_pool->leave();
+
+        set_kmp_blocktime(old_blocktime);
+        set_flush_denormals(old_flush_denormals);
+
+        if (ret != 0)
+            return ret;
+    }
+
+    // convert each result the same way as extract
+    Mat blob = d->blob_mats[blob_index];
+
+    int ret = 0;
+    feats.resize(batch);
+    for (size_t i = 0; i < batch; i++)
+    {
+        if (d->batch_blob_mats[i][blob_index].dims == 0)
+        {
+            // empty is valid for outputs
+            feats[i] = Mat();
+            continue;
+        }
+
+        d->blob_mats[blob_index] = d->batch_blob_mats[i][blob_index];
+
+        ret = extract(blob_index, feats[i], type);
+        if (ret != 0)
+            break;
+    }
+
+    d->blob_mats[blob_index] = blob;
+
+    return ret;
+}
+
 #if NCNN_VULKAN
 #if NCNN_STRING
 int Extractor::input(const char* blob_name, const VkMat& in)
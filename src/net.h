@@ -127,6 +127,36 @@ public:
     // unload network structure and weight data
     void clear();
 
+    // plan all intermediate blob memory ahead of time for the given input shapes
+    // input_shapes follow the order of input_indexes(), only the shape of each mat is used
+    // extractors without custom blob allocator then place intermediate blobs in one preallocated arena
+    // the plan follows extracting output_indexes() in order, any other usage falls back to heap memory
+    // call after load_model and before creating extractors
+    // return the peak arena size in bytes, 0 if failed
+    size_t plan_memory(const std::vector<Mat>& input_shapes);
+
+    // load and prepare the weights of a layer on its first forward instead of in load_model,
+    // for the layers preparing weights in create_pipeline
+    // the model data is referenced, so load it from memory or with opt.use_mapped_model_loading,
+    // from other data readers all layers are loaded in load_model
+    // when the prepared weights exceed memory_budget bytes, the least recently used layers not running drop them
+    // and load again on their next forward, 0 never evicts
+    // the lazily prepared weights bypass opt.weight_cache, they are neither looked up nor inserted
+    // call before load_model, the cpu path only
+    void set_lazy_loading(bool enabled, size_t memory_budget = 0);
+
+    // lazy loading statistics since load_model
+    // layer loads, including the ones after eviction, and evictions
+    int lazy_load_count() const;
+    int lazy_evict_count() const;
+    // bytes of the prepared weights held by the lazily loaded layers
+    size_t lazy_memory_usage() const;
+
+    // forward plan statistics since load_model
+    // extracts that walked the plan for their required layers and extracts that reused the layers cached for the same output
+    int forward_plan_resolve_count() const;
+    int forward_plan_reuse_count() const;
+
     // construct an Extractor from network
     Extractor create_extractor() const;
 
@@ -189,6 +219,27 @@ public:
     // set workspace memory allocator
     void set_workspace_allocator(Allocator* allocator);
 
+    // share the thread budget of pool with other extractors
+    // layers that fixed their thread count in create_pipeline keep using the load-time value
+    // load the net with num_threads no larger than the expected fair share to avoid that
+    void set_thread_pool(ThreadPool* pool);
+
+    // record one event per layer forward into profiler
+    // null stops profiling, which is the default
+    void set_profiler(Profiler* profiler);
+
+    // keep the keys and values of SDPA layers with kv_cache=1 in cache across extractors
+    // past_key and past_value inputs are then ignored, only feed the new tokens each step
+    // null concatenates the past_key and past_value inputs, which is the default
+    void set_kv_cache(KVCache* cache);
+
+    // run up to count independent layers concurrently
+    // the num_threads budget is split among the layers running at the same time
+    // blob and workspace allocators must be thread-safe
+    // layers that fixed their thread count in create_pipeline keep using the load-time value
+    // 0 or 1 forwards layers one after another, which is the default
+    void set_parallel_branches(int count);
+
 #if NCNN_VULKAN
     void set_blob_vkallocator(VkAllocator* allocator);
 
@@ -207,6 +258,14 @@ public:
     // type = 0, default
     // type = 1, do not convert fp16/bf16 or / and packing
     int extract(const char* blob_name, Mat& feat, int type = 0);
+
+    // set input of all samples by blob name
+    // return 0 if success
+    int input_batch(const char* blob_name, const std::vector<Mat>& in);
+
+    // get result of all samples by blob name
+    // return 0 if success
+    int extract_batch(const char* blob_name, std::vector<Mat>& feats, int type = 0);
 #endif // NCNN_STRING
 
     // set input by blob index
@@ -219,6 +278,18 @@ public:
     // type = 1, do not convert fp16/bf16 or / and packing
     int extract(int blob_index, Mat& feat, int type = 0);
 
+    // batched inference on cpu
+    // every sample must be given the same input blobs, a different sample count starts a new batch
+    // layers run for all samples before the next layer starts
+    // innerproduct and gemm with constant weight forward the samples with fewer than 16 rows in one call
+    // set input of all samples by blob index
+    // return 0 if success
+    int input_batch(int blob_index, const std::vector<Mat>& in);
+
+    // get result of all samples by blob index
+    // return 0 if success
+    int extract_batch(int blob_index, std::vector<Mat>& feats, int type = 0);
+
 #if NCNN_VULKAN
 #if NCNN_STRING
     // set input by blob name
@@ -17,6 +17,12 @@ Option::Option()
     num_threads = get_physical_big_cpu_count();
     blob_allocator = 0;
     workspace_allocator = 0;
+    thread_pool = 0;
+    tuning_cache = 0;
+    profiler = 0;
+    kv_cache = 0;
+    weight_cache = 0;
+    num_load_threads = 1;
 
 #if NCNN_VULKAN
     blob_vkallocator = 0;
@@ -70,7 +76,7 @@ Option::Option()
     use_fp16_uniform = true;
     use_int8_uniform = true;
 
-    use_reserved_9 = false;
+    use_x86_fp16_storage = false;
     use_reserved_10 = false;
     use_reserved_11 = false;
 }
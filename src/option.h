@@ -14,6 +14,11 @@ class PipelineCache;
 #endif // NCNN_VULKAN
 
 class Allocator;
+class ThreadPool;
+class TuningCache;
+class Profiler;
+class KVCache;
+class WeightCache;
 class NCNN_EXPORT Option
 {
 public:
@@ -43,6 +48,37 @@ public:
     // workspace memory allocator
     Allocator* workspace_allocator;
 
+    // thread budget shared with other extractors
+    // each layer runs with min(num_threads, its fair share of the pool)
+    // default value is null, every extractor uses num_threads freely
+    ThreadPool* thread_pool;
+
+    // measured kernel choices, see TuningCache
+    // must be set before create_pipeline
+    // default value is null, kernels are picked by the built-in heuristics
+    TuningCache* tuning_cache;
+
+    // per-layer time, shapes and kernel choices, see Profiler
+    // default value is null, nothing is recorded
+    Profiler* profiler;
+
+    // keys and values of past tokens for SDPA layers with kv_cache=1, see KVCache
+    // default value is null, the history comes from the past_key and past_value bottom blobs
+    KVCache* kv_cache;
+
+    // weights prepared by create_pipeline in an earlier load, see WeightCache
+    // must be set before load_model
+    // default value is null, every load prepares the weights from the model
+    WeightCache* weight_cache;
+
+    // thread count preparing the layers concurrently in load_model
+    // the prepared weights follow num_threads, so the result does not depend on it
+    // more than one keeps the model weights of all layers until they are prepared
+    // custom layers must support concurrent create_pipeline
+    // 0 takes num_threads
+    // default value is 1, which prepares the layers one after another
+    int num_load_threads;
+
 #if NCNN_VULKAN
     // blob memory allocator
     VkAllocator* blob_vkallocator;
@@ -145,7 +181,11 @@ public:
     bool use_fp16_uniform;
     bool use_int8_uniform;
 
-    bool use_reserved_9;
+    // keep fp16 blobs between layers on x86 cpus with f16c
+    // requires use_fp16_storage, which alone only selects fp16 weights on x86
+    // disabled by default
+    bool use_x86_fp16_storage;
+
     bool use_reserved_10;
     bool use_reserved_11;
 };
@@ -0,0 +1,296 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "profiler.h"
+
+#include "benchmark.h"
+
+namespace ncnn {
+
+ProfileEvent::ProfileEvent()
+{
+    layer_index = -1;
+    typeindex = -1;
+    start = 0;
+    end = 0;
+    thread = 0;
+    batch = 1;
+    allocated_bytes = 0;
+    kernel = -1;
+    tile_m = 0;
+    tile_n = 0;
+    tile_k = 0;
+}
+
+class ProfilerPrivate
+{
+public:
+    bool enabled;
+    double origin;
+
+    mutable Mutex lock;
+    std::vector<ProfileEvent> events;
+
+    // thread index + 1 of each thread seen so far
+    mutable ThreadLocalStorage thread_index;
+    mutable int thread_count;
+};
+
+Profiler::Profiler()
+    : d(new ProfilerPrivate)
+{
+    d->enabled = true;
+    d->origin = get_current_time();
+    d->thread_count = 0;
+}
+
+Profiler::~Profiler()
+{
+    delete d;
+}
+
+Profiler::Profiler(const Profiler&)
+    : d(0)
+{
+}
+
+Profiler& Profiler::operator=(const Profiler&)
+{
+    return *this;
+}
+
+void Profiler::set_enabled(bool enabled)
+{
+    d->enabled = enabled;
+}
+
+bool Profiler::enabled() const
+{
+    return d->enabled;
+}
+
+void Profiler::clear()
+{
+    d->lock.lock();
+    d->events.clear();
+    d->origin = get_current_time();
+    d->lock.unlock();
+}
+
+int Profiler::event_count() const
+{
+    d->lock.lock();
+    int count = (int)d->events.size();
+    d->lock.unlock();
+    return count;
+}
+
+ProfileEvent Profiler::event(int index) const
+{
+    d->lock.lock();
+    ProfileEvent e = d->events[index];
+    d->lock.unlock();
+    return e;
+}
+
+double Profiler::total_time() const
+{
+    d->lock.lock();
+    double sum = 0;
+    for (size_t i = 0; i < d->events.size(); i++)
+    {
+        sum += d->events[i].end - d->events[i].start;
+    }
+    d->lock.unlock();
+    return sum;
+}
+
+double Profiler::now() const
+{
+    return get_current_time() - d->origin;
+}
+
+int Profiler::thread_index() const
+{
+    size_t index = (size_t)d->thread_index.get();
+    if (index == 0)
+    {
+        d->lock.lock();
+        index = ++d->thread_count;
+        d->lock.unlock();
+
+        d->thread_index.set((void*)index);
+    }
+
+    return (int)index - 1;
+}
+
+void Profiler::record(const ProfileEvent& event)
+{
+    if (!d->enabled)
+        return;
+
+    d->lock.lock();
+    d->events.push_back(event);
+    d->lock.unlock();
+}
+
+#if NCNN_STDIO
+static void print_shape(char* str, size_t size, const Mat& m)
+{
+    if (m.dims == 1)
+        snprintf(str, size, "[%3d *%d]", m.w, m.elempack);
+    else if (m.dims == 2)
+        snprintf(str, size, "[%3d, %3d *%d]", m.w, m.h, m.elempack);
+    else if (m.dims == 3)
+        snprintf(str, size, "[%3d, %3d, %3d *%d]", m.w, m.h, m.c, m.elempack);
+    else if (m.dims == 4)
+        snprintf(str, size, "[%3d, %3d, %3d, %3d *%d]", m.w, m.h, m.d, m.c, m.elempack);
+    else
+        str[0] = '\0';
+}
+
+void Profiler::print() const
+{
+    d->lock.lock();
+    for (size_t i = 0; i < d->events.size(); i++)
+    {
+        const ProfileEvent& e = d->events[i];
+
+#if NCNN_STRING
+        fprintf(stderr, "%-24s %-30s %8.2lfms", e.type.c_str(), e.name.c_str(), e.end - e.start);
+#else
+        fprintf(stderr, "%-24d %-30d %8.2lfms", e.typeindex, e.layer_index, e.end - e.start);
+#endif
+
+        if (e.bottom_shapes.size() == 1 && e.top_shapes.size() == 1)
+        {
+            char in_shape_str[64];
+            char out_shape_str[64];
+            print_shape(in_shape_str, 64, e.bottom_shapes[0]);
+            print_shape(out_shape_str, 64, e.top_shapes[0]);
+            fprintf(stderr, "    | %22s -> %-22s", in_shape_str, out_shape_str);
+        }
+        else
+        {
+            fprintf(stderr, "    |");
+        }
+
+        if (e.kernel != -1)
+        {
+            fprintf(stderr, "     kernel: %d  tile: %d %d %d", e.kernel, e.tile_m, e.tile_n, e.tile_k);
+        }
+
+        fprintf(stderr, "\n");
+    }
+    d->lock.unlock();
+}
+
+static void write_json_string(FILE* fp, const char* s)
+{
+    fputc('"', fp);
+    for (; *s; s++)
+    {
+        const unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\')
+            fprintf(fp, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(fp, "\\u%04x", c);
+        else
+            fputc(c, fp);
+    }
+    fputc('"', fp);
+}
+
+static void write_json_shapes(FILE* fp, const std::vector<Mat>& shapes)
+{
+    fprintf(fp, "[");
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        const Mat& m = shapes[i];
+        if (i != 0)
+            fprintf(fp, ",");
+
+        if (m.dims == 1)
+            fprintf(fp, "[%d]", m.w);
+        else if (m.dims == 2)
+            fprintf(fp, "[%d,%d]", m.w, m.h);
+        else if (m.dims == 3)
+            fprintf(fp, "[%d,%d,%d]", m.w, m.h, m.c);
+        else if (m.dims == 4)
+            fprintf(fp, "[%d,%d,%d,%d]", m.w, m.h, m.d, m.c);
+        else
+            fprintf(fp, "[]");
+    }
+    fprintf(fp, "]");
+}
+
+static void write_json_elempacks(FILE* fp, const std::vector<Mat>& shapes)
+{
+    fprintf(fp, "[");
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        fprintf(fp, i == 0 ? "%d" : ",%d", shapes[i].elempack);
+    }
+    fprintf(fp, "]");
+}
+
+int Profiler::save_chrome_trace(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    int ret = save_chrome_trace(fp);
+
+    fclose(fp);
+
+    return ret;
+}
+
+int Profiler::save_chrome_trace(FILE* fp) const
+{
+    d->lock.lock();
+
+    fprintf(fp, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < d->events.size(); i++)
+    {
+        const ProfileEvent& e = d->events[i];
+
+        // complete events, timestamps in us
+        fprintf(fp, "{\"ph\":\"X\",\"pid\":0,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":", e.thread, e.start * 1000, (e.end - e.start) * 1000);
+#if NCNN_STRING
+        write_json_string(fp, e.name.c_str());
+        fprintf(fp, ",\"cat\":");
+        write_json_string(fp, e.type.c_str());
+#else
+        fprintf(fp, "\"%d\",\"cat\":\"%d\"", e.layer_index, e.typeindex);
+#endif
+
+        fprintf(fp, ",\"args\":{\"layer\":%d,\"batch\":%d,\"bottom_shapes\":", e.layer_index, e.batch);
+        write_json_shapes(fp, e.bottom_shapes);
+        fprintf(fp, ",\"bottom_elempacks\":");
+        write_json_elempacks(fp, e.bottom_shapes);
+        fprintf(fp, ",\"top_shapes\":");
+        write_json_shapes(fp, e.top_shapes);
+        fprintf(fp, ",\"top_elempacks\":");
+        write_json_elempacks(fp, e.top_shapes);
+        fprintf(fp, ",\"allocated_bytes\":%zu", e.allocated_bytes);
+        if (e.kernel != -1)
+        {
+            fprintf(fp, ",\"kernel\":%d,\"tile\":[%d,%d,%d]", e.kernel, e.tile_m, e.tile_n, e.tile_k);
+        }
+        fprintf(fp, "}}%s\n", i + 1 == d->events.size() ? "" : ",");
+    }
+    fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+
+    d->lock.unlock();
+
+    return ferror(fp) ? -1 : 0;
+}
+#endif // NCNN_STDIO
+
+} // namespace ncnn
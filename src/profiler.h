@@ -0,0 +1,109 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_PROFILER_H
+#define NCNN_PROFILER_H
+
+#include "mat.h"
+#include "platform.h"
+
+#include <stdio.h>
+#if NCNN_STRING
+#include <string>
+#endif // NCNN_STRING
+
+namespace ncnn {
+
+// what one layer did in one forward
+class NCNN_EXPORT ProfileEvent
+{
+public:
+    ProfileEvent();
+
+    int layer_index;
+    int typeindex;
+#if NCNN_STRING
+    std::string type;
+    std::string name;
+#endif // NCNN_STRING
+
+    // wall time in ms since the profiler was created or cleared
+    double start;
+    double end;
+
+    // 0 for the first thread that ran a layer, 1 for the next one and so on
+    int thread;
+
+    // number of samples for a stacked batch forward, 1 otherwise
+    int batch;
+
+    // shape and elempack of the blobs, without data
+    std::vector<Mat> bottom_shapes;
+    std::vector<Mat> top_shapes;
+
+    // memory of the top blobs the layer allocated, zero for inplace layers
+    size_t allocated_bytes;
+
+    // specialization the layer picked from its shape cache
+    // kernel is -1 for layers without one
+    int kernel;
+    int tile_m;
+    int tile_n;
+    int tile_k;
+};
+
+class ProfilerPrivate;
+// runtime per-layer profiling, attach to Extractor::set_profiler or Option::profiler
+// records one event per layer forward
+// thread-safe, may be shared by extractors running at the same time
+class NCNN_EXPORT Profiler
+{
+public:
+    Profiler();
+    ~Profiler();
+
+    // start recording or pause, enabled by default
+    void set_enabled(bool enabled);
+    bool enabled() const;
+
+    // drop all events and restart the clock
+    void clear();
+
+    // recorded events in completion order
+    int event_count() const;
+    ProfileEvent event(int index) const;
+
+    // sum of the layer wall time
+    double total_time() const;
+
+    // one line per event, in the format of the NCNN_BENCHMARK build
+    void print() const;
+
+#if NCNN_STDIO
+    // chrome trace event format, open in chrome://tracing or https://ui.perfetto.dev
+    // return 0 on success
+    int save_chrome_trace(const char* path) const;
+    int save_chrome_trace(FILE* fp) const;
+#endif // NCNN_STDIO
+
+public:
+    // current time on the profiler clock in ms
+    double now() const;
+
+    // small index of the calling thread
+    int thread_index() const;
+
+    // append an event, called by the net
+    void record(const ProfileEvent& event);
+
+private:
+    Profiler(const Profiler&);
+    Profiler& operator=(const Profiler&);
+
+private:
+    ProfilerPrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_PROFILER_H
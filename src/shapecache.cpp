@@ -0,0 +1,228 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "shapecache.h"
+
+#include <string.h>
+
+namespace ncnn {
+
+class ShapeCacheEntry
+{
+public:
+    int key[ShapeCache::key_size];
+    int value[ShapeCache::value_size];
+
+    // larger is more recently used
+    size_t last_used;
+};
+
+class ShapeCachePrivate
+{
+public:
+    int capacity;
+
+    // few shapes per layer, a linear scan beats any list or map here
+    std::vector<ShapeCacheEntry> entries;
+
+    size_t clock;
+
+    size_t hit_count;
+    size_t miss_count;
+    size_t eviction_count;
+
+    mutable Mutex lock;
+
+    int find_entry(const int* key) const;
+    void evict_lru();
+};
+
+int ShapeCachePrivate::find_entry(const int* key) const
+{
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (memcmp(entries[i].key, key, sizeof(entries[i].key)) == 0)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+void ShapeCachePrivate::evict_lru()
+{
+    size_t lru = 0;
+    for (size_t i = 1; i < entries.size(); i++)
+    {
+        if (entries[i].last_used < entries[lru].last_used)
+            lru = i;
+    }
+
+    entries[lru] = entries.back();
+    entries.pop_back();
+
+    eviction_count++;
+}
+
+ShapeCache::ShapeCache(int capacity)
+    : d(new ShapeCachePrivate)
+{
+    d->capacity = capacity > 0 ? capacity : 0;
+    d->clock = 0;
+    d->hit_count = 0;
+    d->miss_count = 0;
+    d->eviction_count = 0;
+}
+
+ShapeCache::~ShapeCache()
+{
+    delete d;
+}
+
+ShapeCache::ShapeCache(const ShapeCache&)
+    : d(0)
+{
+}
+
+ShapeCache& ShapeCache::operator=(const ShapeCache&)
+{
+    return *this;
+}
+
+int ShapeCache::find(const int* key, int* value) const
+{
+    d->lock.lock();
+
+    const int i = d->find_entry(key);
+    if (i == -1)
+    {
+        d->miss_count++;
+        d->lock.unlock();
+        return -1;
+    }
+
+    ShapeCacheEntry& entry = d->entries[i];
+    entry.last_used = ++d->clock;
+    memcpy(value, entry.value, sizeof(entry.value));
+
+    d->hit_count++;
+
+    d->lock.unlock();
+
+    return 0;
+}
+
+int ShapeCache::last_value(int* value) const
+{
+    d->lock.lock();
+
+    if (d->entries.empty())
+    {
+        d->lock.unlock();
+        return -1;
+    }
+
+    size_t mru = 0;
+    for (size_t i = 1; i < d->entries.size(); i++)
+    {
+        if (d->entries[i].last_used > d->entries[mru].last_used)
+            mru = i;
+    }
+
+    memcpy(value, d->entries[mru].value, sizeof(d->entries[mru].value));
+
+    d->lock.unlock();
+
+    return 0;
+}
+
+void ShapeCache::insert(const int* key, const int* value)
+{
+    d->lock.lock();
+
+    if (d->capacity == 0)
+    {
+        d->lock.unlock();
+        return;
+    }
+
+    // another thread may have resolved the same shape meanwhile
+    int i = d->find_entry(key);
+    if (i == -1)
+    {
+        if ((int)d->entries.size() >= d->capacity)
+            d->evict_lru();
+
+        d->entries.push_back(ShapeCacheEntry());
+        i = (int)d->entries.size() - 1;
+    }
+
+    ShapeCacheEntry& entry = d->entries[i];
+    memcpy(entry.key, key, sizeof(entry.key));
+    memcpy(entry.value, value, sizeof(entry.value));
+    entry.last_used = ++d->clock;
+
+    d->lock.unlock();
+}
+
+void ShapeCache::set_capacity(int capacity)
+{
+    d->lock.lock();
+
+    d->capacity = capacity > 0 ? capacity : 0;
+
+    while ((int)d->entries.size() > d->capacity)
+    {
+        d->evict_lru();
+    }
+
+    d->lock.unlock();
+}
+
+void ShapeCache::clear()
+{
+    d->lock.lock();
+    d->entries.clear();
+    d->lock.unlock();
+}
+
+int ShapeCache::capacity() const
+{
+    d->lock.lock();
+    int capacity = d->capacity;
+    d->lock.unlock();
+    return capacity;
+}
+
+int ShapeCache::size() const
+{
+    d->lock.lock();
+    int size = (int)d->entries.size();
+    d->lock.unlock();
+    return size;
+}
+
+size_t ShapeCache::hit_count() const
+{
+    d->lock.lock();
+    size_t count = d->hit_count;
+    d->lock.unlock();
+    return count;
+}
+
+size_t ShapeCache::miss_count() const
+{
+    d->lock.lock();
+    size_t count = d->miss_count;
+    d->lock.unlock();
+    return count;
+}
+
+size_t ShapeCache::eviction_count() const
+{
+    d->lock.lock();
+    size_t count = d->eviction_count;
+    d->lock.unlock();
+    return count;
+}
+
+} // namespace ncnn
@@ -0,0 +1,65 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_SHAPECACHE_H
+#define NCNN_SHAPECACHE_H
+
+#include "platform.h"
+
+#include <stddef.h>
+
+namespace ncnn {
+
+class ShapeCachePrivate;
+// per-layer cache of specializations keyed by input shape
+// a layer describes the runtime shape with a key of up to 8 ints
+// and remembers the kernel, tile sizes and workspace layout chosen for it
+// in a value of up to 8 ints, unused trailing ints must be zero
+// by convention value[0] is the kernel id and value[1..3] are TILE_M, TILE_N, TILE_K
+// the least recently used entry is evicted when the cache is full
+// thread-safe, shared by all extractors running the layer
+class NCNN_EXPORT ShapeCache
+{
+public:
+    enum { key_size = 8, value_size = 8 };
+
+    // capacity 0 disables caching
+    ShapeCache(int capacity = 16);
+    ~ShapeCache();
+
+    // copy the value cached for key and return 0
+    // return -1 when the shape is seen for the first time
+    int find(const int* key, int* value) const;
+
+    // copy the value of the most recently used entry and return 0
+    // return -1 when the cache is empty, statistics are not touched
+    int last_value(int* value) const;
+
+    // remember value for key, replacing the existing one
+    void insert(const int* key, const int* value);
+
+    // evict entries beyond the new capacity
+    void set_capacity(int capacity);
+
+    // drop all entries, statistics are kept
+    void clear();
+
+public:
+    // statistics
+    int capacity() const;
+    int size() const;
+    size_t hit_count() const;
+    size_t miss_count() const;
+    size_t eviction_count() const;
+
+private:
+    ShapeCache(const ShapeCache&);
+    ShapeCache& operator=(const ShapeCache&);
+
+private:
+    ShapeCachePrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_SHAPECACHE_H
@@ -63,6 +63,82 @@ static void* kmp_threadfunc(void* args);
 
 namespace ncnn {
 
+// state of one worksharing loop with dynamic, guided or work stealing schedule
+// iterations are normalized to [0, count)
+class KMPWorkshare
+{
+public:
+    // loop sequence number in the team, -1 if unused
+    int seq;
+    // threads that have not left this loop yet
+    int remaining;
+
+    int schedule;
+    uint64_t count;
+    uint64_t chunk;
+
+    // shared cursor of dynamic and guided schedule
+    uint64_t next_index;
+
+    // packed [begin, end) of each thread for work stealing
+    uint64_t* ranges;
+
+    // map normalized iteration back to the loop variable
+    uint64_t lower;
+    int64_t incr;
+};
+
+// shared state of the threads in one parallel region
+class KMPTeam
+{
+public:
+    KMPTeam(int _num_threads, bool _serial);
+    ~KMPTeam();
+
+    // join the next worksharing loop of thread_num, the first thread to arrive initializes it
+    KMPWorkshare* enter_loop(int thread_num, int schedule, uint64_t count, uint64_t chunk, uint64_t lower, int64_t incr);
+
+    // the loop thread_num is working on
+    KMPWorkshare* current_loop(int thread_num) const;
+
+    void leave_loop(KMPWorkshare* ws);
+
+    // take the next chunk [begin, end) for thread_num, return false if no iteration left
+    bool next_chunk(KMPWorkshare* ws, int thread_num, uint64_t& begin, uint64_t& end);
+
+    void barrier();
+
+public:
+    int num_threads;
+
+    // team members run one after another on the calling thread
+    bool serial;
+
+    // serial team of a loop outside any parallel region, freed when the loop ends
+    bool orphan;
+
+private:
+    bool steal_chunk(KMPWorkshare* ws, int thread_num, uint64_t& begin, uint64_t& end);
+
+    // loops in flight, threads may run ahead by nowait loops
+    enum
+    {
+        max_workshares = 4
+    };
+
+    Mutex lock;
+    ConditionVariable condition;
+
+    int barrier_count;
+    int barrier_generation;
+
+    // per-thread loop sequence numbers, allocated on first loop
+    int* loop_seqs;
+    uint64_t* ranges_data;
+
+    KMPWorkshare workshares[max_workshares];
+};
+
 class KMPTask
 {
 public:
@@ -78,6 +154,7 @@ public:
     void* data;
 #endif
     int num_threads;
+    KMPTeam* team;
 
     // per-task
     int thread_num;
@@ -242,6 +319,7 @@ public:
                 tasks[i].data = 0;
 #endif
                 tasks[i].num_threads = kmp_max_threads;
+                tasks[i].team = 0;
                 tasks[i].thread_num = i + 1;
                 tasks[i].num_threads_to_wait = 0;
                 tasks[i].finish_lock = 0;
@@ -283,12 +361,380 @@ static ncnn::KMPGlobal g_kmp_global;
 
 static ncnn::ThreadLocalStorage tls_num_threads;
 static ncnn::ThreadLocalStorage tls_thread_num;
+static ncnn::ThreadLocalStorage tls_team;
 
 static void init_g_kmp_global()
 {
     g_kmp_global.init();
 }
 
+namespace ncnn {
+
+static inline uint64_t pack_range(uint64_t begin, uint64_t end)
+{
+    return (begin << 32) | end;
+}
+
+KMPTeam::KMPTeam(int _num_threads, bool _serial)
+    : num_threads(_num_threads), serial(_serial), orphan(false)
+{
+    barrier_count = 0;
+    barrier_generation = 0;
+    loop_seqs = 0;
+    ranges_data = 0;
+
+    for (int i = 0; i < max_workshares; i++)
+    {
+        workshares[i].seq = -1;
+        workshares[i].remaining = 0;
+        workshares[i].ranges = 0;
+    }
+}
+
+KMPTeam::~KMPTeam()
+{
+    delete[] loop_seqs;
+    delete[] ranges_data;
+}
+
+KMPWorkshare* KMPTeam::enter_loop(int thread_num, int schedule, uint64_t count, uint64_t chunk, uint64_t lower, int64_t incr)
+{
+    if (serial)
+    {
+        // thread 0 runs before the others, let it take all iterations
+        KMPWorkshare* ws = &workshares[0];
+        ws->schedule = omp_sched_dynamic;
+        ws->count = thread_num == 0 ? count : 0;
+        ws->chunk = std::max(count, (uint64_t)1);
+        ws->next_index = 0;
+        ws->lower = lower;
+        ws->incr = incr;
+        return ws;
+    }
+
+    lock.lock();
+
+    if (!loop_seqs)
+    {
+        loop_seqs = new int[num_threads];
+        ranges_data = new uint64_t[max_workshares * num_threads];
+        for (int i = 0; i < num_threads; i++)
+        {
+            loop_seqs[i] = 0;
+        }
+        for (int i = 0; i < max_workshares; i++)
+        {
+            workshares[i].ranges = ranges_data + i * num_threads;
+        }
+    }
+
+    const int seq = loop_seqs[thread_num]++;
+
+    KMPWorkshare* ws = &workshares[seq % max_workshares];
+
+    // wait for all threads leaving the loop that used this slot before
+    while (ws->seq != seq && ws->remaining > 0)
+    {
+        condition.wait(lock);
+    }
+
+    if (ws->seq != seq)
+    {
+        if (schedule == omp_sched_static)
+        {
+            // one block per thread, served as dynamic chunks
+            schedule = omp_sched_dynamic;
+            if (chunk == 0)
+                chunk = (count + num_threads - 1) / num_threads;
+        }
+
+        if (schedule == omp_sched_auto && count > 0xffffffffu)
+        {
+            // packed ranges hold 32bit indexes only
+            schedule = omp_sched_dynamic;
+        }
+
+        if (schedule == omp_sched_auto && chunk == 0)
+        {
+            chunk = std::max(count / (num_threads * 8), (uint64_t)1);
+        }
+
+        ws->seq = seq;
+        ws->remaining = num_threads;
+        ws->schedule = schedule;
+        ws->count = count;
+        ws->chunk = std::max(chunk, (uint64_t)1);
+        ws->next_index = 0;
+        ws->lower = lower;
+        ws->incr = incr;
+
+        if (schedule == omp_sched_auto)
+        {
+            // start from static partition, idle threads steal from the busy ones
+            const uint64_t count_per_thread = count / num_threads;
+            const uint64_t remain = count % num_threads;
+            for (int i = 0; i < num_threads; i++)
+            {
+                const uint64_t begin = i * count_per_thread + std::min(remain, (uint64_t)i);
+                const uint64_t end = begin + count_per_thread + ((uint64_t)i < remain ? 1 : 0);
+                ws->ranges[i] = pack_range(begin, end);
+            }
+        }
+    }
+
+    lock.unlock();
+
+    return ws;
+}
+
+KMPWorkshare* KMPTeam::current_loop(int thread_num) const
+{
+    if (serial)
+        return (KMPWorkshare*)&workshares[0];
+
+    return (KMPWorkshare*)&workshares[(loop_seqs[thread_num] - 1) % max_workshares];
+}
+
+void KMPTeam::leave_loop(KMPWorkshare* ws)
+{
+    if (serial)
+        return;
+
+    lock.lock();
+
+    ws->remaining--;
+    if (ws->remaining == 0)
+    {
+        condition.broadcast();
+    }
+
+    lock.unlock();
+}
+
+bool KMPTeam::next_chunk(KMPWorkshare* ws, int thread_num, uint64_t& begin, uint64_t& end)
+{
+    const uint64_t count = ws->count;
+    const uint64_t chunk = ws->chunk;
+
+    if (ws->schedule == omp_sched_dynamic)
+    {
+        begin = __atomic_fetch_add(&ws->next_index, chunk, __ATOMIC_RELAXED);
+        if (begin >= count)
+            return false;
+
+        end = begin + std::min(chunk, count - begin);
+        return true;
+    }
+
+    if (ws->schedule == omp_sched_guided)
+    {
+        // chunk shrinks with the remaining iterations
+        uint64_t b = __atomic_load_n(&ws->next_index, __ATOMIC_RELAXED);
+        for (;;)
+        {
+            if (b >= count)
+                return false;
+
+            const uint64_t remain = count - b;
+            const uint64_t n = std::min(std::max((remain + num_threads - 1) / num_threads, chunk), remain);
+            if (__atomic_compare_exchange_n(&ws->next_index, &b, b + n, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                begin = b;
+                end = b + n;
+                return true;
+            }
+        }
+    }
+
+    // auto
+    return steal_chunk(ws, thread_num, begin, end);
+}
+
+bool KMPTeam::steal_chunk(KMPWorkshare* ws, int thread_num, uint64_t& begin, uint64_t& end)
+{
+    const uint64_t chunk = ws->chunk;
+
+    // take from the front of own range
+    uint64_t* range = &ws->ranges[thread_num];
+    uint64_t v = __atomic_load_n(range, __ATOMIC_RELAXED);
+    for (;;)
+    {
+        const uint64_t b = v >> 32;
+        const uint64_t e = v & 0xffffffffu;
+        if (b >= e)
+            break;
+
+        const uint64_t nb = b + std::min(chunk, e - b);
+        if (__atomic_compare_exchange_n(range, &v, pack_range(nb, e), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        {
+            begin = b;
+            end = nb;
+            return true;
+        }
+    }
+
+    // steal the back half of another thread
+    for (int i = 1; i < num_threads; i++)
+    {
+        uint64_t* victim_range = &ws->ranges[(thread_num + i) % num_threads];
+        uint64_t vv = __atomic_load_n(victim_range, __ATOMIC_RELAXED);
+        for (;;)
+        {
+            const uint64_t b = vv >> 32;
+            const uint64_t e = vv & 0xffffffffu;
+            if (b >= e)
+                break;
+
+            const uint64_t half = (e - b + 1) / 2;
+            if (__atomic_compare_exchange_n(victim_range, &vv, pack_range(b, e - half), true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            {
+                begin = e - half;
+                end = begin + std::min(chunk, half);
+
+                // keep the rest as own range, thieves skip it while it is empty
+                __atomic_store_n(range, pack_range(end, e), __ATOMIC_RELAXED);
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void KMPTeam::barrier()
+{
+    if (serial || num_threads == 1)
+        return;
+
+    lock.lock();
+
+    const int generation = barrier_generation;
+
+    barrier_count++;
+    if (barrier_count == num_threads)
+    {
+        barrier_count = 0;
+        barrier_generation++;
+        condition.broadcast();
+    }
+    else
+    {
+        while (generation == barrier_generation)
+        {
+            condition.wait(lock);
+        }
+    }
+
+    lock.unlock();
+}
+
+} // namespace ncnn
+
+// schedule(runtime) loops follow omp_set_schedule() or OMP_SCHEDULE
+static pthread_once_t g_runtime_schedule_initialized = PTHREAD_ONCE_INIT;
+static int g_runtime_schedule = omp_sched_dynamic;
+static int g_runtime_schedule_chunk = 0;
+
+static void init_runtime_schedule()
+{
+    const char* env = getenv("OMP_SCHEDULE");
+    if (!env)
+        return;
+
+    // [monotonic:|nonmonotonic:]kind[,chunk]
+    const char* colon = strchr(env, ':');
+    if (colon)
+        env = colon + 1;
+
+    while (*env == ' ')
+        env++;
+
+    if (strncasecmp(env, "static", 6) == 0)
+        g_runtime_schedule = omp_sched_static;
+    else if (strncasecmp(env, "dynamic", 7) == 0)
+        g_runtime_schedule = omp_sched_dynamic;
+    else if (strncasecmp(env, "guided", 6) == 0)
+        g_runtime_schedule = omp_sched_guided;
+    else if (strncasecmp(env, "auto", 4) == 0)
+        g_runtime_schedule = omp_sched_auto;
+    else
+        return;
+
+    const char* comma = strchr(env, ',');
+    if (comma)
+        g_runtime_schedule_chunk = std::max(atoi(comma + 1), 0);
+}
+
+static int resolve_runtime_schedule(uint64_t& chunk)
+{
+    pthread_once(&g_runtime_schedule_initialized, init_runtime_schedule);
+
+    if (g_runtime_schedule_chunk > 0)
+        chunk = g_runtime_schedule_chunk;
+    else
+        chunk = g_runtime_schedule == omp_sched_auto ? 0 : 1;
+
+    return g_runtime_schedule;
+}
+
+static ncnn::KMPTeam* get_current_team()
+{
+    ncnn::KMPTeam* team = (ncnn::KMPTeam*)tls_team.get();
+    if (!team)
+    {
+        // orphaned loop outside any parallel region runs on a serial team of this thread
+        team = new ncnn::KMPTeam(1, true);
+        team->orphan = true;
+        tls_team.set(team);
+    }
+
+    return team;
+}
+
+static int get_current_thread_num(const ncnn::KMPTeam* team)
+{
+    // the thread number is stale outside any parallel region
+    return team->orphan ? 0 : (int)reinterpret_cast<size_t>(tls_thread_num.get());
+}
+
+static ncnn::KMPWorkshare* kmp_loop_enter(int schedule, uint64_t count, uint64_t chunk, uint64_t lower, int64_t incr)
+{
+    ncnn::KMPTeam* team = get_current_team();
+
+    return team->enter_loop(get_current_thread_num(team), schedule, count, chunk, lower, incr);
+}
+
+static bool kmp_loop_next(ncnn::KMPWorkshare*& ws, uint64_t& begin, uint64_t& end)
+{
+    ncnn::KMPTeam* team = get_current_team();
+
+    const int thread_num = get_current_thread_num(team);
+
+    ws = team->current_loop(thread_num);
+
+    if (team->next_chunk(ws, thread_num, begin, end))
+        return true;
+
+    team->leave_loop(ws);
+
+    if (team->orphan)
+    {
+        // ws is not touched by the callers once the loop ends
+        tls_team.set(0);
+        delete team;
+    }
+
+    return false;
+}
+
+static void kmp_barrier()
+{
+    // no team outside any parallel region, nothing to wait for
+    ncnn::KMPTeam* team = (ncnn::KMPTeam*)tls_team.get();
+    if (team)
+        team->barrier();
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -323,6 +769,27 @@ int omp_get_thread_num()
     return (int)reinterpret_cast<size_t>(tls_thread_num.get());
 }
 
+void omp_set_schedule(omp_sched_t kind, int chunk_size)
+{
+    pthread_once(&g_runtime_schedule_initialized, init_runtime_schedule);
+
+    // drop the monotonic modifier
+    kind = (omp_sched_t)(kind & 0xff);
+    if (kind < omp_sched_static || kind > omp_sched_auto)
+        return;
+
+    g_runtime_schedule = kind;
+    g_runtime_schedule_chunk = std::max(chunk_size, 0);
+}
+
+void omp_get_schedule(omp_sched_t* kind, int* chunk_size)
+{
+    pthread_once(&g_runtime_schedule_initialized, init_runtime_schedule);
+
+    *kind = (omp_sched_t)g_runtime_schedule;
+    *chunk_size = g_runtime_schedule_chunk;
+}
+
 #if __clang__
 int kmp_get_blocktime()
 {
@@ -465,6 +932,7 @@ static void* kmp_threadfunc(void* args)
 
         tls_num_threads.set(reinterpret_cast<void*>((size_t)task->num_threads));
         tls_thread_num.set(reinterpret_cast<void*>((size_t)task->thread_num));
+        tls_team.set(task->team);
 
 #if __clang__
         kmp_invoke_microtask(task->fn, task->thread_num, tid, task->argc, task->argv);
@@ -472,6 +940,8 @@ static void* kmp_threadfunc(void* args)
         task->fn(task->data);
 #endif
 
+        tls_team.set(0);
+
         // update finished
         {
             task->finish_lock->lock();
@@ -506,7 +976,8 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
     g_kmp_global.try_init();
 
     // NCNN_LOGE("__kmpc_fork_call %d", argc);
-    int num_threads = omp_get_num_threads();
+    // team members beyond the thread pool would be queued behind each other and never meet at barriers
+    int num_threads = std::min(omp_get_num_threads(), g_kmp_global.kmp_max_threads);
 
     // build argv
     void* argv[32];
@@ -518,8 +989,13 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
         va_end(ap);
     }
 
+    void* outer_team = tls_team.get();
+
     if (g_kmp_global.kmp_max_threads == 1 || num_threads == 1)
     {
+        ncnn::KMPTeam team(num_threads, true);
+        tls_team.set(&team);
+
         for (int i = 0; i < num_threads; i++)
         {
             tls_thread_num.set(reinterpret_cast<void*>((size_t)i));
@@ -527,6 +1003,7 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
             kmp_invoke_microtask(fn, 0, 0, argc, argv);
         }
 
+        tls_team.set(outer_team);
         return;
     }
 
@@ -534,6 +1011,8 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
     ncnn::Mutex finish_lock;
     ncnn::ConditionVariable finish_condition;
 
+    ncnn::KMPTeam team(num_threads, false);
+
     // TODO portable stack allocation
     ncnn::KMPTask* tasks = (ncnn::KMPTask*)alloca((num_threads - 1) * sizeof(ncnn::KMPTask));
     for (int i = 0; i < num_threads - 1; i++)
@@ -542,6 +1021,7 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
         tasks[i].argc = argc;
         tasks[i].argv = (void**)argv;
         tasks[i].num_threads = num_threads;
+        tasks[i].team = &team;
         tasks[i].thread_num = i + 1;
         tasks[i].num_threads_to_wait = &num_threads_to_wait;
         tasks[i].finish_lock = &finish_lock;
@@ -555,6 +1035,7 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
     {
         tls_num_threads.set(reinterpret_cast<void*>((size_t)num_threads));
         tls_thread_num.set(reinterpret_cast<void*>((size_t)0));
+        tls_team.set(&team);
 
         kmp_invoke_microtask(fn, 0, 0, argc, argv);
     }
@@ -568,6 +1049,8 @@ void __kmpc_fork_call(void* /*loc*/, int32_t argc, kmpc_micro fn, ...)
         }
         finish_lock.unlock();
     }
+
+    tls_team.set(outer_team);
 }
 
 void __kmpc_for_static_init_4(void* /*loc*/, int32_t gtid, int32_t /*sched*/, int32_t* last, int32_t* lower, int32_t* upper, int32_t* /*stride*/, int32_t /*incr*/, int32_t /*chunk*/)
@@ -639,6 +1122,131 @@ void __kmpc_for_static_fini(void* /*loc*/, int32_t gtid)
     // NCNN_LOGE("__kmpc_for_static_fini");
     (void)gtid;
 }
+
+static int kmp_resolve_schedule(int32_t sched, uint64_t& chunk)
+{
+    // drop monotonic and nonmonotonic modifiers
+    sched &= ~((1 << 29) | (1 << 30));
+
+    // ordered variants, ordering is not supported
+    if (sched >= 65 && sched <= 76)
+        sched -= 32;
+
+    switch (sched)
+    {
+    case 35: // kmp_sch_dynamic_chunked
+        return omp_sched_dynamic;
+    case 36: // kmp_sch_guided_chunked
+        return omp_sched_guided;
+    case 37: // kmp_sch_runtime
+        return resolve_runtime_schedule(chunk);
+    case 38: // kmp_sch_auto
+        return omp_sched_auto;
+    default:
+        return omp_sched_static;
+    }
+}
+
+template<typename T, typename UT, typename ST>
+static void kmp_dispatch_init(int32_t sched, T lb, T ub, ST st, ST chunk)
+{
+    uint64_t _chunk = chunk > 0 ? (uint64_t)chunk : 0;
+    int schedule = kmp_resolve_schedule(sched, _chunk);
+
+    // ub is inclusive
+    uint64_t count = 0;
+    if (st > 0 && ub >= lb)
+        count = (uint64_t)(((UT)ub - (UT)lb) / (UT)st) + 1;
+    if (st < 0 && lb >= ub)
+        count = (uint64_t)(((UT)lb - (UT)ub) / (UT)(-st)) + 1;
+
+    kmp_loop_enter(schedule, count, _chunk, (uint64_t)(UT)lb, (int64_t)st);
+}
+
+template<typename T, typename UT, typename ST>
+static int32_t kmp_dispatch_next(int32_t* p_last, T* p_lb, T* p_ub, ST* p_st)
+{
+    ncnn::KMPWorkshare* ws;
+    uint64_t begin;
+    uint64_t end;
+    if (!kmp_loop_next(ws, begin, end))
+        return 0;
+
+    if (p_last)
+        *p_last = end == ws->count;
+    *p_lb = (T)(UT)(ws->lower + begin * (uint64_t)ws->incr);
+    *p_ub = (T)(UT)(ws->lower + (end - 1) * (uint64_t)ws->incr);
+    if (p_st)
+        *p_st = (ST)ws->incr;
+    return 1;
+}
+
+void __kmpc_dispatch_init_4(void* /*loc*/, int32_t /*gtid*/, int32_t sched, int32_t lb, int32_t ub, int32_t st, int32_t chunk)
+{
+    // NCNN_LOGE("__kmpc_dispatch_init_4 %d %d %d %d %d", sched, lb, ub, st, chunk);
+    kmp_dispatch_init<int32_t, uint32_t, int32_t>(sched, lb, ub, st, chunk);
+}
+
+void __kmpc_dispatch_init_4u(void* /*loc*/, int32_t /*gtid*/, int32_t sched, uint32_t lb, uint32_t ub, int32_t st, int32_t chunk)
+{
+    kmp_dispatch_init<uint32_t, uint32_t, int32_t>(sched, lb, ub, st, chunk);
+}
+
+void __kmpc_dispatch_init_8(void* /*loc*/, int32_t /*gtid*/, int32_t sched, int64_t lb, int64_t ub, int64_t st, int64_t chunk)
+{
+    kmp_dispatch_init<int64_t, uint64_t, int64_t>(sched, lb, ub, st, chunk);
+}
+
+void __kmpc_dispatch_init_8u(void* /*loc*/, int32_t /*gtid*/, int32_t sched, uint64_t lb, uint64_t ub, int64_t st, int64_t chunk)
+{
+    kmp_dispatch_init<uint64_t, uint64_t, int64_t>(sched, lb, ub, st, chunk);
+}
+
+int32_t __kmpc_dispatch_next_4(void* /*loc*/, int32_t /*gtid*/, int32_t* p_last, int32_t* p_lb, int32_t* p_ub, int32_t* p_st)
+{
+    return kmp_dispatch_next<int32_t, uint32_t, int32_t>(p_last, p_lb, p_ub, p_st);
+}
+
+int32_t __kmpc_dispatch_next_4u(void* /*loc*/, int32_t /*gtid*/, int32_t* p_last, uint32_t* p_lb, uint32_t* p_ub, int32_t* p_st)
+{
+    return kmp_dispatch_next<uint32_t, uint32_t, int32_t>(p_last, p_lb, p_ub, p_st);
+}
+
+int32_t __kmpc_dispatch_next_8(void* /*loc*/, int32_t /*gtid*/, int32_t* p_last, int64_t* p_lb, int64_t* p_ub, int64_t* p_st)
+{
+    return kmp_dispatch_next<int64_t, uint64_t, int64_t>(p_last, p_lb, p_ub, p_st);
+}
+
+int32_t __kmpc_dispatch_next_8u(void* /*loc*/, int32_t /*gtid*/, int32_t* p_last, uint64_t* p_lb, uint64_t* p_ub, int64_t* p_st)
+{
+    return kmp_dispatch_next<uint64_t, uint64_t, int64_t>(p_last, p_lb, p_ub, p_st);
+}
+
+void __kmpc_dispatch_fini_4(void* /*loc*/, int32_t /*gtid*/)
+{
+}
+
+void __kmpc_dispatch_fini_4u(void* /*loc*/, int32_t /*gtid*/)
+{
+}
+
+void __kmpc_dispatch_fini_8(void* /*loc*/, int32_t /*gtid*/)
+{
+}
+
+void __kmpc_dispatch_fini_8u(void* /*loc*/, int32_t /*gtid*/)
+{
+}
+
+void __kmpc_dispatch_deinit(void* /*loc*/, int32_t /*gtid*/)
+{
+}
+
+void __kmpc_barrier(void* /*loc*/, int32_t /*gtid*/)
+{
+    // NCNN_LOGE("__kmpc_barrier");
+    kmp_barrier();
+}
 #else  // __clang__
 
 static ncnn::ThreadLocalStorage tls_parallel_context;
@@ -649,6 +1257,8 @@ struct parallel_context
     ncnn::Mutex finish_lock;
     ncnn::ConditionVariable finish_condition;
     ncnn::KMPTask* tasks;
+    ncnn::KMPTeam* team;
+    void* outer_team;
 };
 
 void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
@@ -661,8 +1271,16 @@ void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
         num_threads = omp_get_max_threads();
     }
 
+    // team members beyond the thread pool would be queued behind each other and never meet at barriers
+    num_threads = std::min(num_threads, (unsigned)g_kmp_global.kmp_max_threads);
+
     if (g_kmp_global.kmp_max_threads == 1 || num_threads == 1)
     {
+        void* outer_team = tls_team.get();
+
+        ncnn::KMPTeam team(num_threads, true);
+        tls_team.set(&team);
+
         for (unsigned i = 0; i < num_threads; i++)
         {
             tls_num_threads.set(reinterpret_cast<void*>((size_t)num_threads));
@@ -671,6 +1289,7 @@ void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
             fn(data);
         }
 
+        tls_team.set(outer_team);
         return;
     }
 
@@ -680,12 +1299,16 @@ void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
 
     pc->num_threads_to_wait = num_threads - 1;
 
+    pc->team = new ncnn::KMPTeam(num_threads, false);
+    pc->outer_team = tls_team.get();
+
     pc->tasks = new ncnn::KMPTask[num_threads - 1];
     for (unsigned i = 0; i < num_threads - 1; i++)
     {
         pc->tasks[i].fn = fn;
         pc->tasks[i].data = data;
         pc->tasks[i].num_threads = num_threads;
+        pc->tasks[i].team = pc->team;
         pc->tasks[i].thread_num = i + 1;
         pc->tasks[i].num_threads_to_wait = &pc->num_threads_to_wait;
         pc->tasks[i].finish_lock = &pc->finish_lock;
@@ -699,6 +1322,7 @@ void GOMP_parallel_start(void (*fn)(void*), void* data, unsigned num_threads)
     {
         tls_num_threads.set(reinterpret_cast<void*>((size_t)num_threads));
         tls_thread_num.set(reinterpret_cast<void*>((size_t)0));
+        tls_team.set(pc->team);
     }
 }
 
@@ -718,7 +1342,10 @@ void GOMP_parallel_end()
         pc->finish_lock.unlock();
     }
 
+    tls_team.set(pc->outer_team);
+
     delete[] pc->tasks;
+    delete pc->team;
     delete pc;
 }
 
@@ -732,8 +1359,16 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
         num_threads = omp_get_max_threads();
     }
 
+    // team members beyond the thread pool would be queued behind each other and never meet at barriers
+    num_threads = std::min(num_threads, (unsigned)g_kmp_global.kmp_max_threads);
+
+    void* outer_team = tls_team.get();
+
     if (g_kmp_global.kmp_max_threads == 1 || num_threads == 1)
     {
+        ncnn::KMPTeam team(num_threads, true);
+        tls_team.set(&team);
+
         for (unsigned i = 0; i < num_threads; i++)
         {
             tls_num_threads.set(reinterpret_cast<void*>((size_t)num_threads));
@@ -742,6 +1377,7 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
             fn(data);
         }
 
+        tls_team.set(outer_team);
         return;
     }
 
@@ -749,6 +1385,8 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
     ncnn::Mutex finish_lock;
     ncnn::ConditionVariable finish_condition;
 
+    ncnn::KMPTeam team(num_threads, false);
+
     // TODO portable stack allocation
     ncnn::KMPTask* tasks = (ncnn::KMPTask*)alloca((num_threads - 1) * sizeof(ncnn::KMPTask));
     for (unsigned i = 0; i < num_threads - 1; i++)
@@ -756,6 +1394,7 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
         tasks[i].fn = fn;
         tasks[i].data = data;
         tasks[i].num_threads = num_threads;
+        tasks[i].team = &team;
         tasks[i].thread_num = i + 1;
         tasks[i].num_threads_to_wait = &num_threads_to_wait;
         tasks[i].finish_lock = &finish_lock;
@@ -769,6 +1408,7 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
     {
         tls_num_threads.set(reinterpret_cast<void*>((size_t)num_threads));
         tls_thread_num.set(reinterpret_cast<void*>((size_t)0));
+        tls_team.set(&team);
 
         fn(data);
     }
@@ -782,6 +1422,291 @@ void GOMP_parallel(void (*fn)(void*), void* data, unsigned num_threads, unsigned
         }
         finish_lock.unlock();
     }
+
+    tls_team.set(outer_team);
+}
+
+bool GOMP_loop_dynamic_next(long* istart, long* iend)
+{
+    ncnn::KMPWorkshare* ws;
+    uint64_t begin;
+    uint64_t end;
+    if (!kmp_loop_next(ws, begin, end))
+        return false;
+
+    *istart = (long)(ws->lower + begin * (uint64_t)ws->incr);
+    *iend = (long)(ws->lower + end * (uint64_t)ws->incr);
+    return true;
+}
+
+bool GOMP_loop_ull_dynamic_next(unsigned long long* istart, unsigned long long* iend)
+{
+    ncnn::KMPWorkshare* ws;
+    uint64_t begin;
+    uint64_t end;
+    if (!kmp_loop_next(ws, begin, end))
+        return false;
+
+    *istart = ws->lower + begin * (uint64_t)ws->incr;
+    *iend = ws->lower + end * (uint64_t)ws->incr;
+    return true;
+}
+
+static uint64_t gomp_loop_count(long start, long end, long incr)
+{
+    // end is exclusive
+    uint64_t count = 0;
+    if (incr > 0 && end > start)
+        count = ((unsigned long)end - (unsigned long)start + (unsigned long)incr - 1) / (unsigned long)incr;
+    if (incr < 0 && start > end)
+        count = ((unsigned long)start - (unsigned long)end - (unsigned long)incr - 1) / (unsigned long)(-incr);
+
+    return count;
+}
+
+static bool gomp_loop_start(int schedule, long start, long end, long incr, uint64_t chunk, long* istart, long* iend)
+{
+    kmp_loop_enter(schedule, gomp_loop_count(start, end, incr), chunk, (uint64_t)(unsigned long)start, (int64_t)incr);
+
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+struct gomp_parallel_loop_context
+{
+    void (*fn)(void*);
+    void* data;
+
+    int schedule;
+    uint64_t count;
+    uint64_t chunk;
+    long start;
+    long incr;
+};
+
+static void gomp_parallel_loop_fn(void* data)
+{
+    // the outlined body of a combined parallel loop only calls GOMP_loop_*_next
+    const gomp_parallel_loop_context* ctx = (const gomp_parallel_loop_context*)data;
+
+    kmp_loop_enter(ctx->schedule, ctx->count, ctx->chunk, (uint64_t)(unsigned long)ctx->start, (int64_t)ctx->incr);
+
+    ctx->fn(ctx->data);
+}
+
+static void gomp_parallel_loop(void (*fn)(void*), void* data, unsigned num_threads, int schedule, long start, long end, long incr, uint64_t chunk, unsigned flags)
+{
+    gomp_parallel_loop_context ctx;
+    ctx.fn = fn;
+    ctx.data = data;
+    ctx.schedule = schedule;
+    ctx.count = gomp_loop_count(start, end, incr);
+    ctx.chunk = chunk;
+    ctx.start = start;
+    ctx.incr = incr;
+
+    GOMP_parallel(gomp_parallel_loop_fn, &ctx, num_threads, flags);
+}
+
+void GOMP_parallel_loop_dynamic(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, long chunk_size, unsigned flags)
+{
+    gomp_parallel_loop(fn, data, num_threads, omp_sched_dynamic, start, end, incr, chunk_size, flags);
+}
+
+void GOMP_parallel_loop_nonmonotonic_dynamic(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, long chunk_size, unsigned flags)
+{
+    gomp_parallel_loop(fn, data, num_threads, omp_sched_dynamic, start, end, incr, chunk_size, flags);
+}
+
+void GOMP_parallel_loop_guided(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, long chunk_size, unsigned flags)
+{
+    gomp_parallel_loop(fn, data, num_threads, omp_sched_guided, start, end, incr, chunk_size, flags);
+}
+
+void GOMP_parallel_loop_nonmonotonic_guided(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, long chunk_size, unsigned flags)
+{
+    gomp_parallel_loop(fn, data, num_threads, omp_sched_guided, start, end, incr, chunk_size, flags);
+}
+
+void GOMP_parallel_loop_runtime(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, unsigned flags)
+{
+    uint64_t chunk;
+    int schedule = resolve_runtime_schedule(chunk);
+    gomp_parallel_loop(fn, data, num_threads, schedule, start, end, incr, chunk, flags);
+}
+
+void GOMP_parallel_loop_nonmonotonic_runtime(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, unsigned flags)
+{
+    GOMP_parallel_loop_runtime(fn, data, num_threads, start, end, incr, flags);
+}
+
+void GOMP_parallel_loop_maybe_nonmonotonic_runtime(void (*fn)(void*), void* data, unsigned num_threads, long start, long end, long incr, unsigned flags)
+{
+    GOMP_parallel_loop_runtime(fn, data, num_threads, start, end, incr, flags);
+}
+
+static bool gomp_loop_ull_start(int schedule, bool up, unsigned long long start, unsigned long long end, unsigned long long incr, uint64_t chunk, unsigned long long* istart, unsigned long long* iend)
+{
+    // end is exclusive, incr is negative in two's complement if counting down
+    uint64_t count = 0;
+    if (up && end > start)
+        count = (end - start + incr - 1) / incr;
+    if (!up && start > end)
+        count = (start - end - incr - 1) / (0 - incr);
+
+    kmp_loop_enter(schedule, count, chunk, (uint64_t)start, (int64_t)incr);
+
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_dynamic_start(long start, long end, long incr, long chunk_size, long* istart, long* iend)
+{
+    // NCNN_LOGE("GOMP_loop_dynamic_start %ld %ld %ld %ld", start, end, incr, chunk_size);
+    return gomp_loop_start(omp_sched_dynamic, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_nonmonotonic_dynamic_start(long start, long end, long incr, long chunk_size, long* istart, long* iend)
+{
+    return gomp_loop_start(omp_sched_dynamic, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_guided_start(long start, long end, long incr, long chunk_size, long* istart, long* iend)
+{
+    return gomp_loop_start(omp_sched_guided, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_nonmonotonic_guided_start(long start, long end, long incr, long chunk_size, long* istart, long* iend)
+{
+    return gomp_loop_start(omp_sched_guided, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_runtime_start(long start, long end, long incr, long* istart, long* iend)
+{
+    uint64_t chunk;
+    int schedule = resolve_runtime_schedule(chunk);
+    return gomp_loop_start(schedule, start, end, incr, chunk, istart, iend);
+}
+
+bool GOMP_loop_nonmonotonic_runtime_start(long start, long end, long incr, long* istart, long* iend)
+{
+    return GOMP_loop_runtime_start(start, end, incr, istart, iend);
+}
+
+bool GOMP_loop_maybe_nonmonotonic_runtime_start(long start, long end, long incr, long* istart, long* iend)
+{
+    return GOMP_loop_runtime_start(start, end, incr, istart, iend);
+}
+
+bool GOMP_loop_nonmonotonic_dynamic_next(long* istart, long* iend)
+{
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_guided_next(long* istart, long* iend)
+{
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_nonmonotonic_guided_next(long* istart, long* iend)
+{
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_runtime_next(long* istart, long* iend)
+{
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_nonmonotonic_runtime_next(long* istart, long* iend)
+{
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_maybe_nonmonotonic_runtime_next(long* istart, long* iend)
+{
+    return GOMP_loop_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_ull_dynamic_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long chunk_size, unsigned long long* istart, unsigned long long* iend)
+{
+    return gomp_loop_ull_start(omp_sched_dynamic, up, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_ull_nonmonotonic_dynamic_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long chunk_size, unsigned long long* istart, unsigned long long* iend)
+{
+    return gomp_loop_ull_start(omp_sched_dynamic, up, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_ull_guided_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long chunk_size, unsigned long long* istart, unsigned long long* iend)
+{
+    return gomp_loop_ull_start(omp_sched_guided, up, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_ull_nonmonotonic_guided_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long chunk_size, unsigned long long* istart, unsigned long long* iend)
+{
+    return gomp_loop_ull_start(omp_sched_guided, up, start, end, incr, chunk_size, istart, iend);
+}
+
+bool GOMP_loop_ull_runtime_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long* istart, unsigned long long* iend)
+{
+    uint64_t chunk;
+    int schedule = resolve_runtime_schedule(chunk);
+    return gomp_loop_ull_start(schedule, up, start, end, incr, chunk, istart, iend);
+}
+
+bool GOMP_loop_ull_nonmonotonic_runtime_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_runtime_start(up, start, end, incr, istart, iend);
+}
+
+bool GOMP_loop_ull_maybe_nonmonotonic_runtime_start(bool up, unsigned long long start, unsigned long long end, unsigned long long incr, unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_runtime_start(up, start, end, incr, istart, iend);
+}
+
+bool GOMP_loop_ull_nonmonotonic_dynamic_next(unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_ull_guided_next(unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_ull_nonmonotonic_guided_next(unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_ull_runtime_next(unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_ull_nonmonotonic_runtime_next(unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+bool GOMP_loop_ull_maybe_nonmonotonic_runtime_next(unsigned long long* istart, unsigned long long* iend)
+{
+    return GOMP_loop_ull_dynamic_next(istart, iend);
+}
+
+void GOMP_loop_end()
+{
+    // NCNN_LOGE("GOMP_loop_end");
+    kmp_barrier();
+}
+
+void GOMP_loop_end_nowait()
+{
+}
+
+void GOMP_barrier()
+{
+    // NCNN_LOGE("GOMP_barrier");
+    kmp_barrier();
 }
 #endif // __clang__
 
@@ -12,11 +12,21 @@
 
 // This minimal openmp runtime implementation only supports the llvm openmp abi
 // and only supports #pragma omp parallel for num_threads(X)
+// loops may use schedule(static), schedule(dynamic), schedule(guided) and schedule(runtime)
+// schedule(runtime) with omp_sched_auto or OMP_SCHEDULE=auto selects work stealing
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+typedef enum omp_sched_t
+{
+    omp_sched_static = 1,
+    omp_sched_dynamic = 2,
+    omp_sched_guided = 3,
+    omp_sched_auto = 4
+} omp_sched_t;
+
 NCNN_EXPORT int omp_get_max_threads();
 
 NCNN_EXPORT void omp_set_num_threads(int num_threads);
@@ -29,6 +39,10 @@ NCNN_EXPORT int omp_get_num_threads();
 
 NCNN_EXPORT int omp_get_thread_num();
 
+NCNN_EXPORT void omp_set_schedule(omp_sched_t kind, int chunk_size);
+
+NCNN_EXPORT void omp_get_schedule(omp_sched_t* kind, int* chunk_size);
+
 NCNN_EXPORT int kmp_get_blocktime();
 
 NCNN_EXPORT void kmp_set_blocktime(int blocktime);
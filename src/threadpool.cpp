@@ -0,0 +1,336 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "threadpool.h"
+
+#include "cpu.h"
+
+#ifdef _OPENMP
+#if NCNN_SIMPLEOMP
+#include "simpleomp.h"
+#else
+#include <omp.h>
+#endif
+#endif
+
+namespace ncnn {
+
+// the threads granted to one calling thread
+class ThreadPoolGrant
+{
+public:
+    int num_threads;
+
+    // granted cpu slots
+    std::vector<int> slots;
+
+    // cpu slots the openmp threads of this thread are pinned to
+    std::vector<int> pinned_slots;
+
+    // affinity and openmp thread count of this thread before the first pin
+    CpuSet saved_affinity;
+    int saved_omp_num_threads;
+};
+
+class ThreadPoolPrivate
+{
+public:
+    int num_threads;
+
+    // cpu of each slot, empty when affinity is not set
+    std::vector<int> slot_cpus;
+    // whether the slot is granted
+    std::vector<unsigned char> slot_busy;
+
+    mutable Mutex lock;
+    ConditionVariable condition;
+
+    int tenant_count;
+    int active_threads;
+    int peak_active_threads;
+    int wait_count;
+
+    // requests are served in ticket order
+    unsigned int next_ticket;
+    unsigned int serving_ticket;
+
+    ThreadLocalStorage tls_grant;
+    std::vector<ThreadPoolGrant*> grants;
+
+    void init(int _num_threads);
+    ThreadPoolGrant* get_grant();
+};
+
+void ThreadPoolPrivate::init(int _num_threads)
+{
+    num_threads = _num_threads;
+    slot_busy.resize(num_threads, 0);
+
+    tenant_count = 0;
+    active_threads = 0;
+    peak_active_threads = 0;
+    wait_count = 0;
+
+    next_ticket = 0;
+    serving_ticket = 0;
+}
+
+ThreadPoolGrant* ThreadPoolPrivate::get_grant()
+{
+    ThreadPoolGrant* grant = (ThreadPoolGrant*)tls_grant.get();
+    if (!grant)
+    {
+        grant = new ThreadPoolGrant;
+        grant->num_threads = 0;
+        grant->saved_omp_num_threads = 0;
+        tls_grant.set(grant);
+
+        lock.lock();
+        grants.push_back(grant);
+        lock.unlock();
+    }
+
+    return grant;
+}
+
+// the thread count of the next parallel region of the calling thread
+static int get_omp_max_threads()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+static bool same_slots(const std::vector<int>& a, const std::vector<int>& b)
+{
+    if (a.size() != b.size())
+        return false;
+
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        if (a[i] != b[i])
+            return false;
+    }
+
+    return true;
+}
+
+ThreadPool::ThreadPool(int num_threads)
+    : d(new ThreadPoolPrivate)
+{
+    d->init(num_threads > 0 ? num_threads : get_physical_big_cpu_count());
+}
+
+ThreadPool::ThreadPool(const CpuSet& thread_affinity_mask)
+    : d(new ThreadPoolPrivate)
+{
+    const int cpu_count = get_cpu_count();
+    for (int i = 0; i < cpu_count; i++)
+    {
+        if (thread_affinity_mask.is_enabled(i))
+            d->slot_cpus.push_back(i);
+    }
+
+    if (d->slot_cpus.empty())
+    {
+        NCNN_LOGE("thread pool affinity mask is empty, use all cpus without affinity");
+        d->init(get_physical_big_cpu_count());
+        return;
+    }
+
+    d->init((int)d->slot_cpus.size());
+}
+
+ThreadPool::~ThreadPool()
+{
+    if (d->active_threads != 0)
+    {
+        NCNN_LOGE("FATAL ERROR! thread pool destroyed too early");
+    }
+
+    for (size_t i = 0; i < d->grants.size(); i++)
+    {
+        delete d->grants[i];
+    }
+
+    delete d;
+}
+
+ThreadPool::ThreadPool(const ThreadPool&)
+    : d(0)
+{
+}
+
+ThreadPool& ThreadPool::operator=(const ThreadPool&)
+{
+    return *this;
+}
+
+int ThreadPool::num_threads() const
+{
+    return d->num_threads;
+}
+
+void ThreadPool::enter()
+{
+    d->lock.lock();
+    d->tenant_count++;
+    d->lock.unlock();
+}
+
+void ThreadPool::leave()
+{
+    // hand the calling thread back with its own affinity
+    ThreadPoolGrant* grant = (ThreadPoolGrant*)d->tls_grant.get();
+    if (grant && !grant->pinned_slots.empty())
+    {
+        set_cpu_thread_affinity(grant->saved_affinity);
+        set_omp_num_threads(grant->saved_omp_num_threads);
+
+        grant->pinned_slots.clear();
+    }
+
+    d->lock.lock();
+    d->tenant_count--;
+    // the fair share grows, let the waiting requests recompute it
+    d->condition.broadcast();
+    d->lock.unlock();
+}
+
+int ThreadPool::acquire(int num_threads)
+{
+    ThreadPoolGrant* grant = d->get_grant();
+
+    if (grant->num_threads != 0)
+    {
+        NCNN_LOGE("thread pool acquire without release");
+        return grant->num_threads;
+    }
+
+    d->lock.lock();
+
+    const unsigned int ticket = d->next_ticket++;
+
+    int want = 1;
+    bool waited = false;
+    for (;;)
+    {
+        const int share = std::max(d->num_threads / std::max(d->tenant_count, 1), 1);
+        want = std::max(std::min(num_threads, share), 1);
+
+        if (ticket == d->serving_ticket && d->num_threads - d->active_threads >= want)
+            break;
+
+        waited = true;
+        d->condition.wait(d->lock);
+    }
+
+    if (waited)
+        d->wait_count++;
+
+    d->serving_ticket++;
+    d->active_threads += want;
+    d->peak_active_threads = std::max(d->peak_active_threads, d->active_threads);
+
+    grant->num_threads = want;
+
+    if (!d->slot_cpus.empty())
+    {
+        grant->slots.clear();
+        for (int i = 0; i < d->num_threads && (int)grant->slots.size() < want; i++)
+        {
+            if (d->slot_busy[i])
+                continue;
+
+            d->slot_busy[i] = 1;
+            grant->slots.push_back(i);
+        }
+    }
+
+    // the next ticket may fit into the remaining threads
+    d->condition.broadcast();
+
+    d->lock.unlock();
+
+    if (!d->slot_cpus.empty() && !same_slots(grant->slots, grant->pinned_slots))
+    {
+        CpuSet mask;
+        mask.disable_all();
+        for (size_t i = 0; i < grant->slots.size(); i++)
+        {
+            mask.enable(d->slot_cpus[grant->slots[i]]);
+        }
+
+        if (grant->pinned_slots.empty())
+        {
+            grant->saved_omp_num_threads = get_omp_max_threads();
+            if (get_cpu_thread_affinity(grant->saved_affinity) != 0)
+                grant->saved_affinity = get_cpu_thread_affinity_mask(0);
+        }
+
+        set_cpu_thread_affinity(mask);
+
+        grant->pinned_slots = grant->slots;
+    }
+
+    return want;
+}
+
+void ThreadPool::release()
+{
+    ThreadPoolGrant* grant = d->get_grant();
+
+    if (grant->num_threads == 0)
+        return;
+
+    d->lock.lock();
+
+    d->active_threads -= grant->num_threads;
+
+    for (size_t i = 0; i < grant->slots.size(); i++)
+    {
+        d->slot_busy[grant->slots[i]] = 0;
+    }
+
+    d->condition.broadcast();
+
+    d->lock.unlock();
+
+    grant->num_threads = 0;
+}
+
+int ThreadPool::tenant_count() const
+{
+    d->lock.lock();
+    int count = d->tenant_count;
+    d->lock.unlock();
+    return count;
+}
+
+int ThreadPool::active_threads() const
+{
+    d->lock.lock();
+    int count = d->active_threads;
+    d->lock.unlock();
+    return count;
+}
+
+int ThreadPool::peak_active_threads() const
+{
+    d->lock.lock();
+    int count = d->peak_active_threads;
+    d->lock.unlock();
+    return count;
+}
+
+int ThreadPool::wait_count() const
+{
+    d->lock.lock();
+    int count = d->wait_count;
+    d->lock.unlock();
+    return count;
+}
+
+} // namespace ncnn
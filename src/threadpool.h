@@ -0,0 +1,62 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_THREADPOOL_H
+#define NCNN_THREADPOOL_H
+
+#include "platform.h"
+
+namespace ncnn {
+
+class CpuSet;
+
+class ThreadPoolPrivate;
+// a fixed thread budget shared by concurrent extractors
+// attach the same pool to the option of every net or extractor that should share it
+// each extractor entering forward becomes a tenant
+// each layer waits for its fair share of threads and returns them when done
+// the share is min(opt.num_threads, num_threads / tenant count)
+// requests are granted in arrival order so no tenant starves
+class NCNN_EXPORT ThreadPool
+{
+public:
+    // num_threads 0 means get_physical_big_cpu_count()
+    ThreadPool(int num_threads = 0);
+    // pin the granted threads to the enabled cpus, one thread per cpu
+    ThreadPool(const CpuSet& thread_affinity_mask);
+    ~ThreadPool();
+
+    // total thread budget
+    int num_threads() const;
+
+    // register the calling extractor as a tenant
+    void enter();
+    // unregister the calling extractor
+    void leave();
+
+    // block until threads are available and return the granted thread count
+    // the granted threads belong to the calling thread until release()
+    // the openmp threads of the calling thread are pinned to the granted cpus when affinity is set
+    // the pin lasts until leave(), which restores the previous affinity and openmp thread count
+    int acquire(int num_threads);
+    // return the threads granted to the calling thread
+    void release();
+
+    // runtime statistics
+    int tenant_count() const;
+    int active_threads() const;
+    int peak_active_threads() const;
+    // how many acquire() had to wait
+    int wait_count() const;
+
+private:
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+private:
+    ThreadPoolPrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_THREADPOOL_H
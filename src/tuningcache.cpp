@@ -0,0 +1,264 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "tuningcache.h"
+
+#include <string.h>
+
+namespace ncnn {
+
+// bump when the meaning of recorded keys or kernels changes
+static const int tuning_file_version = 1;
+
+class TuningCacheEntry
+{
+public:
+    int key[TuningCache::key_size];
+    int kernel;
+    float time_ms;
+};
+
+class TuningCachePrivate
+{
+public:
+    bool autotune;
+
+    std::vector<TuningCacheEntry> entries;
+
+    mutable Mutex lock;
+
+    int find_entry(const int* key) const;
+    void insert_entry(const int* key, int kernel, float time_ms);
+};
+
+int TuningCachePrivate::find_entry(const int* key) const
+{
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (memcmp(entries[i].key, key, sizeof(entries[i].key)) == 0)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+void TuningCachePrivate::insert_entry(const int* key, int kernel, float time_ms)
+{
+    int i = find_entry(key);
+    if (i == -1)
+    {
+        entries.push_back(TuningCacheEntry());
+        i = (int)entries.size() - 1;
+    }
+
+    TuningCacheEntry& entry = entries[i];
+    memcpy(entry.key, key, sizeof(entry.key));
+    entry.kernel = kernel;
+    entry.time_ms = time_ms;
+}
+
+TuningCache::TuningCache()
+    : d(new TuningCachePrivate)
+{
+    d->autotune = false;
+}
+
+TuningCache::~TuningCache()
+{
+    delete d;
+}
+
+TuningCache::TuningCache(const TuningCache&)
+    : d(0)
+{
+}
+
+TuningCache& TuningCache::operator=(const TuningCache&)
+{
+    return *this;
+}
+
+void TuningCache::set_autotune(bool enabled)
+{
+    d->lock.lock();
+    d->autotune = enabled;
+    d->lock.unlock();
+}
+
+bool TuningCache::autotune() const
+{
+    d->lock.lock();
+    bool enabled = d->autotune;
+    d->lock.unlock();
+    return enabled;
+}
+
+int TuningCache::find(const int* key, int& kernel) const
+{
+    d->lock.lock();
+
+    const int i = d->find_entry(key);
+    if (i != -1)
+        kernel = d->entries[i].kernel;
+
+    d->lock.unlock();
+
+    return i == -1 ? -1 : 0;
+}
+
+void TuningCache::insert(const int* key, int kernel, float time_ms)
+{
+    d->lock.lock();
+    d->insert_entry(key, kernel, time_ms);
+    d->lock.unlock();
+}
+
+int TuningCache::find_kernels(const int* config) const
+{
+    int mask = 0;
+
+    d->lock.lock();
+
+    for (size_t i = 0; i < d->entries.size(); i++)
+    {
+        const TuningCacheEntry& entry = d->entries[i];
+        if (memcmp(entry.key, config, config_size * sizeof(int)) == 0 && entry.kernel >= 0 && entry.kernel < 32)
+            mask |= 1 << entry.kernel;
+    }
+
+    d->lock.unlock();
+
+    return mask;
+}
+
+int TuningCache::size() const
+{
+    d->lock.lock();
+    int size = (int)d->entries.size();
+    d->lock.unlock();
+    return size;
+}
+
+void TuningCache::clear()
+{
+    d->lock.lock();
+    d->entries.clear();
+    d->lock.unlock();
+}
+
+#if NCNN_STDIO
+int TuningCache::load(const char* path)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    int ret = load(fp);
+    fclose(fp);
+    return ret;
+}
+
+int TuningCache::load(FILE* fp)
+{
+    int version = 0;
+    int count = 0;
+    int nscan = fscanf(fp, "ncnn tuning %d %d", &version, &count);
+    if (nscan != 2)
+    {
+        NCNN_LOGE("tuning file header read failed");
+        return -1;
+    }
+
+    if (version != tuning_file_version)
+    {
+        NCNN_LOGE("tuning file version %d unsupported, expect %d", version, tuning_file_version);
+        return -1;
+    }
+
+    if (count < 0)
+    {
+        NCNN_LOGE("tuning file entry count %d invalid", count);
+        return -1;
+    }
+
+    // parse everything before touching the cache
+    std::vector<TuningCacheEntry> entries(count);
+    for (int i = 0; i < count; i++)
+    {
+        TuningCacheEntry& entry = entries[i];
+        for (int j = 0; j < key_size; j++)
+        {
+            if (fscanf(fp, "%d", &entry.key[j]) != 1)
+            {
+                NCNN_LOGE("tuning file entry %d read failed", i);
+                return -1;
+            }
+        }
+
+        if (fscanf(fp, "%d %f", &entry.kernel, &entry.time_ms) != 2)
+        {
+            NCNN_LOGE("tuning file entry %d read failed", i);
+            return -1;
+        }
+    }
+
+    d->lock.lock();
+    for (int i = 0; i < count; i++)
+    {
+        d->insert_entry(entries[i].key, entries[i].kernel, entries[i].time_ms);
+    }
+    d->lock.unlock();
+
+    return 0;
+}
+
+int TuningCache::save(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    int ret = save(fp);
+    fclose(fp);
+    return ret;
+}
+
+int TuningCache::save(FILE* fp) const
+{
+    d->lock.lock();
+
+    // one entry per line, layer config first, then input shape, kernel and time
+    int ret = 0;
+    if (fprintf(fp, "ncnn tuning %d %d\n", tuning_file_version, (int)d->entries.size()) < 0)
+        ret = -1;
+
+    for (size_t i = 0; i < d->entries.size() && ret == 0; i++)
+    {
+        const TuningCacheEntry& entry = d->entries[i];
+        for (int j = 0; j < key_size; j++)
+        {
+            fprintf(fp, "%d ", entry.key[j]);
+        }
+
+        if (fprintf(fp, "%d %f\n", entry.kernel, entry.time_ms) < 0)
+            ret = -1;
+    }
+
+    d->lock.unlock();
+
+    if (ret != 0)
+    {
+        NCNN_LOGE("tuning file write failed");
+    }
+
+    return ret;
+}
+#endif // NCNN_STDIO
+
+} // namespace ncnn
@@ -0,0 +1,73 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_TUNINGCACHE_H
+#define NCNN_TUNINGCACHE_H
+
+#include "platform.h"
+
+#if NCNN_STDIO
+#include <stdio.h>
+#endif
+
+namespace ncnn {
+
+class TuningCachePrivate;
+// kernel choices measured on the running cpu, keyed by layer config and input shape
+// attach it to opt.tuning_cache before loading the model
+// with autotune enabled, layers time their candidate kernels on the first sight of a shape
+// and record the fastest one, otherwise only the recorded choices are used
+// save the choices after a tuning run and load them at startup to skip the timing
+// thread-safe, may be shared by several nets
+class NCNN_EXPORT TuningCache
+{
+public:
+    // the first config_size ints of a key describe the layer, the rest the input shape
+    // unused trailing ints must be zero
+    enum { key_size = 16, config_size = 10 };
+
+    TuningCache();
+    ~TuningCache();
+
+    // time the candidate kernels of unseen shapes
+    // default is false
+    void set_autotune(bool enabled);
+    bool autotune() const;
+
+    // return 0 and the recorded kernel for key, -1 if none
+    int find(const int* key, int& kernel) const;
+
+    // record the kernel for key with its measured time in milliseconds
+    void insert(const int* key, int kernel, float time_ms);
+
+    // bitmask of the kernels recorded for the layer config in the first config_size ints of key
+    // layers prepare the weights of these kernels in create_pipeline
+    int find_kernels(const int* config) const;
+
+    // recorded entry count
+    int size() const;
+
+    void clear();
+
+#if NCNN_STDIO
+    // load the choices saved by save(), entries already present are replaced
+    // return 0 if success
+    int load(const char* path);
+    int load(FILE* fp);
+
+    // return 0 if success
+    int save(const char* path) const;
+    int save(FILE* fp) const;
+#endif // NCNN_STDIO
+
+private:
+    TuningCache(const TuningCache&);
+    TuningCache& operator=(const TuningCache&);
+
+private:
+    TuningCachePrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_TUNINGCACHE_H
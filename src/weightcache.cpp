@@ -0,0 +1,556 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "weightcache.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace ncnn {
+
+static const int weight_cache_magic = 0x6e637763; // ncwc
+
+// bump when the file layout or the key layout of Net changes
+static const int weight_cache_version = 2;
+
+// weights are placed at this alignment from the start of the file
+static const size_t weight_cache_align = 64;
+
+class WeightCacheEntry
+{
+public:
+    int key[WeightCache::key_size];
+    std::vector<Mat> weights;
+};
+
+class WeightCachePrivate
+{
+public:
+    std::vector<WeightCacheEntry> entries;
+
+    // model weights shared between nets, bucketed by shared_weight_hash
+    std::vector<Mat> shared_weights;
+    std::vector<unsigned int> shared_hashes;
+
+    mutable int hit_count;
+    mutable int miss_count;
+
+#if NCNN_STDIO
+    // the storage of loaded weights, mapped files or file contents read into memory
+    std::vector<MappedFile*> mapped_files;
+    std::vector<Mat> file_datas;
+#endif // NCNN_STDIO
+
+    mutable Mutex lock;
+
+    int find_entry(const int* key) const;
+    void insert_entry(const int* key, const std::vector<Mat>& weights);
+};
+
+int WeightCachePrivate::find_entry(const int* key) const
+{
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (memcmp(entries[i].key, key, sizeof(entries[i].key)) == 0)
+            return (int)i;
+    }
+
+    return -1;
+}
+
+void WeightCachePrivate::insert_entry(const int* key, const std::vector<Mat>& weights)
+{
+    int i = find_entry(key);
+    if (i == -1)
+    {
+        entries.push_back(WeightCacheEntry());
+        i = (int)entries.size() - 1;
+    }
+
+    WeightCacheEntry& entry = entries[i];
+    memcpy(entry.key, key, sizeof(entry.key));
+    entry.weights = weights;
+}
+
+// shape and a few bytes of the head and tail, candidates are compared in full
+static unsigned int shared_weight_hash(const Mat& m, size_t size)
+{
+    const int meta[7] = {m.dims, m.w, m.h, m.d, m.c, m.elempack, (int)m.elemsize};
+
+    unsigned int hash = 2166136261u;
+    for (size_t i = 0; i < sizeof(meta); i++)
+    {
+        hash = (hash ^ ((const unsigned char*)meta)[i]) * 16777619u;
+    }
+
+    const unsigned char* p = (const unsigned char*)m.data;
+    const size_t n = size < 64 ? size : 64;
+    for (size_t i = 0; i < n; i++)
+    {
+        hash = (hash ^ p[i]) * 16777619u;
+        hash = (hash ^ p[size - 1 - i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+WeightCache::WeightCache()
+    : d(new WeightCachePrivate)
+{
+    d->hit_count = 0;
+    d->miss_count = 0;
+}
+
+WeightCache::~WeightCache()
+{
+    clear();
+
+    delete d;
+}
+
+WeightCache::WeightCache(const WeightCache&)
+    : d(0)
+{
+}
+
+WeightCache& WeightCache::operator=(const WeightCache&)
+{
+    return *this;
+}
+
+int WeightCache::find(const int* key, std::vector<Mat>& weights) const
+{
+    d->lock.lock();
+
+    const int i = d->find_entry(key);
+    if (i != -1)
+    {
+        weights = d->entries[i].weights;
+        d->hit_count++;
+    }
+    else
+    {
+        d->miss_count++;
+    }
+
+    d->lock.unlock();
+
+    return i == -1 ? -1 : 0;
+}
+
+void WeightCache::insert(const int* key, const std::vector<Mat>& weights)
+{
+    d->lock.lock();
+    d->insert_entry(key, weights);
+    d->lock.unlock();
+}
+
+int WeightCache::size() const
+{
+    d->lock.lock();
+    int size = (int)d->entries.size();
+    d->lock.unlock();
+    return size;
+}
+
+int WeightCache::hit_count() const
+{
+    d->lock.lock();
+    int count = d->hit_count;
+    d->lock.unlock();
+    return count;
+}
+
+int WeightCache::miss_count() const
+{
+    d->lock.lock();
+    int count = d->miss_count;
+    d->lock.unlock();
+    return count;
+}
+
+Mat WeightCache::share(const Mat& weight)
+{
+    if (weight.empty() || !weight.refcount)
+        return weight;
+
+    if (weight.dims >= 3 && weight.cstep != (size_t)weight.w * weight.h * weight.d)
+        return weight;
+
+    const size_t size = weight.total() * weight.elemsize;
+    const unsigned int hash = shared_weight_hash(weight, size);
+
+    d->lock.lock();
+
+    for (size_t i = 0; i < d->shared_weights.size(); i++)
+    {
+        const Mat& m = d->shared_weights[i];
+        if (d->shared_hashes[i] != hash || m.dims != weight.dims || m.w != weight.w || m.h != weight.h || m.d != weight.d || m.c != weight.c || m.elempack != weight.elempack || m.elemsize != weight.elemsize)
+            continue;
+
+        if (m.data == weight.data || memcmp(m.data, weight.data, size) == 0)
+        {
+            Mat shared = m;
+            d->lock.unlock();
+            return shared;
+        }
+    }
+
+    d->shared_weights.push_back(weight);
+    d->shared_hashes.push_back(hash);
+
+    d->lock.unlock();
+
+    return weight;
+}
+
+void WeightCache::release_unused()
+{
+    d->lock.lock();
+
+    // a weight referenced only here can not be picked up again but through share()
+    size_t j = 0;
+    for (size_t i = 0; i < d->shared_weights.size(); i++)
+    {
+        if (NCNN_XADD(d->shared_weights[i].refcount, 0) == 1)
+            continue;
+
+        d->shared_weights[j] = d->shared_weights[i];
+        d->shared_hashes[j] = d->shared_hashes[i];
+        j++;
+    }
+    d->shared_weights.resize(j);
+    d->shared_hashes.resize(j);
+
+    d->lock.unlock();
+}
+
+size_t WeightCache::memory_usage() const
+{
+    d->lock.lock();
+
+    size_t usage = 0;
+    for (size_t i = 0; i < d->entries.size(); i++)
+    {
+        const std::vector<Mat>& weights = d->entries[i].weights;
+        for (size_t j = 0; j < weights.size(); j++)
+        {
+            usage += weights[j].total() * weights[j].elemsize;
+        }
+    }
+    for (size_t i = 0; i < d->shared_weights.size(); i++)
+    {
+        usage += d->shared_weights[i].total() * d->shared_weights[i].elemsize;
+    }
+
+    d->lock.unlock();
+
+    return usage;
+}
+
+void WeightCache::clear()
+{
+    d->lock.lock();
+
+    d->entries.clear();
+    d->shared_weights.clear();
+    d->shared_hashes.clear();
+    d->hit_count = 0;
+    d->miss_count = 0;
+
+#if NCNN_STDIO
+    for (size_t i = 0; i < d->mapped_files.size(); i++)
+    {
+        delete d->mapped_files[i];
+    }
+    d->mapped_files.clear();
+    d->file_datas.clear();
+#endif // NCNN_STDIO
+
+    d->lock.unlock();
+}
+
+#if NCNN_STDIO
+// header  magic version entry_count
+// entry   key[key_size] weight_count, followed by its weight records
+// weight  dims w h d c elempack elemsize 0, 64-bit offset from the file start and 64-bit byte size
+// the weight data follows the records, each one aligned to weight_cache_align
+static const size_t weight_record_size = 8 * sizeof(int) + 2 * sizeof(uint64_t);
+
+static Mat make_weight_mat(const int* meta, void* data)
+{
+    const int dims = meta[0];
+    const int w = meta[1];
+    const int h = meta[2];
+    const int d = meta[3];
+    const int c = meta[4];
+    const int elempack = meta[5];
+    const size_t elemsize = (size_t)meta[6];
+
+    if (dims == 1)
+        return Mat(w, data, elemsize, elempack);
+    if (dims == 2)
+        return Mat(w, h, data, elemsize, elempack);
+    if (dims == 3)
+        return Mat(w, h, c, data, elemsize, elempack);
+    if (dims == 4)
+        return Mat(w, h, d, c, data, elemsize, elempack);
+
+    return Mat();
+}
+
+static int parse_weight_cache(const unsigned char* mem, size_t size, std::vector<WeightCacheEntry>& entries)
+{
+    size_t offset = 0;
+
+    int header[3];
+    if (size < sizeof(header))
+        return -1;
+
+    memcpy(header, mem, sizeof(header));
+    offset += sizeof(header);
+
+    if (header[0] != weight_cache_magic)
+    {
+        NCNN_LOGE("weight cache file magic mismatch");
+        return -1;
+    }
+
+    if (header[1] != weight_cache_version)
+    {
+        NCNN_LOGE("weight cache file version %d unsupported, expect %d", header[1], weight_cache_version);
+        return -1;
+    }
+
+    const int entry_count = header[2];
+    if (entry_count < 0)
+        return -1;
+
+    entries.resize(entry_count);
+    for (int i = 0; i < entry_count; i++)
+    {
+        WeightCacheEntry& entry = entries[i];
+
+        int weight_count = 0;
+        if (offset + sizeof(entry.key) + sizeof(int) > size)
+            return -1;
+
+        memcpy(entry.key, mem + offset, sizeof(entry.key));
+        memcpy(&weight_count, mem + offset + sizeof(entry.key), sizeof(int));
+        offset += sizeof(entry.key) + sizeof(int);
+
+        if (weight_count < 0 || offset + weight_count * weight_record_size > size)
+            return -1;
+
+        entry.weights.resize(weight_count);
+        for (int j = 0; j < weight_count; j++)
+        {
+            int meta[8];
+            uint64_t data_offset;
+            uint64_t data_size;
+            memcpy(meta, mem + offset, sizeof(meta));
+            memcpy(&data_offset, mem + offset + sizeof(meta), sizeof(uint64_t));
+            memcpy(&data_size, mem + offset + sizeof(meta) + sizeof(uint64_t), sizeof(uint64_t));
+            offset += weight_record_size;
+
+            if (meta[0] == 0)
+                continue;
+
+            if (meta[0] < 1 || meta[0] > 4 || meta[6] <= 0 || data_offset > size || data_size > size - data_offset)
+                return -1;
+
+            Mat m = make_weight_mat(meta, (void*)(mem + data_offset));
+            if (m.total() * m.elemsize != data_size)
+                return -1;
+
+            entry.weights[j] = m;
+        }
+    }
+
+    return 0;
+}
+
+int WeightCache::load(const char* path)
+{
+    MappedFile* mapped_file = new MappedFile;
+    Mat file_data;
+
+    const unsigned char* mem = 0;
+    size_t size = 0;
+    if (mapped_file->open(path) == 0)
+    {
+        mem = (const unsigned char*)mapped_file->mapped_ptr();
+        size = mapped_file->size();
+    }
+    else
+    {
+        delete mapped_file;
+        mapped_file = 0;
+
+        // read the whole file when it can not be mapped
+        FILE* fp = fopen(path, "rb");
+        if (!fp)
+        {
+            NCNN_LOGE("fopen %s failed", path);
+            return -1;
+        }
+
+        fseek(fp, 0, SEEK_END);
+        long file_size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+
+        if (file_size > 0)
+            file_data.create((int)((file_size + weight_cache_align - 1) / weight_cache_align), weight_cache_align);
+
+        size_t nread = file_data.empty() ? 0 : fread(file_data.data, 1, file_size, fp);
+        fclose(fp);
+
+        if (file_size <= 0 || nread != (size_t)file_size)
+        {
+            NCNN_LOGE("weight cache file %s read failed", path);
+            return -1;
+        }
+
+        mem = (const unsigned char*)file_data.data;
+        size = (size_t)file_size;
+    }
+
+    std::vector<WeightCacheEntry> entries;
+    if (parse_weight_cache(mem, size, entries) != 0)
+    {
+        NCNN_LOGE("weight cache file %s corrupted", path);
+        delete mapped_file;
+        return -1;
+    }
+
+    d->lock.lock();
+
+    if (mapped_file)
+        d->mapped_files.push_back(mapped_file);
+    else
+        d->file_datas.push_back(file_data);
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        d->insert_entry(entries[i].key, entries[i].weights);
+    }
+
+    d->lock.unlock();
+
+    return 0;
+}
+
+int WeightCache::save(const char* path) const
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        NCNN_LOGE("fopen %s failed", path);
+        return -1;
+    }
+
+    int ret = save(fp);
+    fclose(fp);
+    return ret;
+}
+
+int WeightCache::save(FILE* fp) const
+{
+    d->lock.lock();
+
+    std::vector<WeightCacheEntry> entries = d->entries;
+
+    d->lock.unlock();
+
+    // the records first, then the data
+    size_t data_offset = 3 * sizeof(int);
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        std::vector<Mat>& weights = entries[i].weights;
+        data_offset += sizeof(entries[i].key) + sizeof(int) + weights.size() * weight_record_size;
+
+        for (size_t j = 0; j < weights.size(); j++)
+        {
+            Mat& m = weights[j];
+            if (m.empty())
+                continue;
+
+            // views into a larger blob are written with the layout they get when loaded
+            int meta[8] = {m.dims, m.w, m.h, m.d, m.c, m.elempack, (int)m.elemsize, 0};
+            if (make_weight_mat(meta, 0).cstep != m.cstep)
+                m = m.clone();
+        }
+    }
+
+    int ret = 0;
+
+    int header[3] = {weight_cache_magic, weight_cache_version, (int)entries.size()};
+    if (fwrite(header, sizeof(header), 1, fp) != 1)
+        ret = -1;
+
+    size_t offset = data_offset;
+    for (size_t i = 0; i < entries.size() && ret == 0; i++)
+    {
+        const std::vector<Mat>& weights = entries[i].weights;
+
+        int weight_count = (int)weights.size();
+        fwrite(entries[i].key, sizeof(entries[i].key), 1, fp);
+        fwrite(&weight_count, sizeof(int), 1, fp);
+
+        for (size_t j = 0; j < weights.size(); j++)
+        {
+            const Mat& m = weights[j];
+
+            int meta[8] = {m.dims, m.w, m.h, m.d, m.c, m.elempack, (int)m.elemsize, 0};
+            uint64_t weight_offset = 0;
+            uint64_t weight_size = 0;
+            if (!m.empty())
+            {
+                offset = alignSize(offset, weight_cache_align);
+                weight_offset = offset;
+                weight_size = m.total() * m.elemsize;
+                offset += weight_size;
+            }
+            else
+            {
+                meta[0] = 0;
+            }
+
+            fwrite(meta, sizeof(meta), 1, fp);
+            fwrite(&weight_offset, sizeof(uint64_t), 1, fp);
+            if (fwrite(&weight_size, sizeof(uint64_t), 1, fp) != 1)
+                ret = -1;
+        }
+    }
+
+    static const unsigned char zeros[weight_cache_align] = {0};
+
+    offset = data_offset;
+    for (size_t i = 0; i < entries.size() && ret == 0; i++)
+    {
+        const std::vector<Mat>& weights = entries[i].weights;
+        for (size_t j = 0; j < weights.size() && ret == 0; j++)
+        {
+            const Mat& m = weights[j];
+            if (m.empty())
+                continue;
+
+            const size_t padding = alignSize(offset, weight_cache_align) - offset;
+            const size_t weight_size = m.total() * m.elemsize;
+            if (fwrite(zeros, 1, padding, fp) != padding || fwrite(m.data, 1, weight_size, fp) != weight_size)
+                ret = -1;
+
+            offset += padding + weight_size;
+        }
+    }
+
+    if (ret != 0)
+    {
+        NCNN_LOGE("weight cache file write failed");
+    }
+
+    return ret;
+}
+#endif // NCNN_STDIO
+
+} // namespace ncnn
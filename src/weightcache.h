@@ -0,0 +1,90 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_WEIGHTCACHE_H
+#define NCNN_WEIGHTCACHE_H
+
+#include "mat.h"
+#include "platform.h"
+
+#if NCNN_STDIO
+#include <stdio.h>
+#endif
+
+namespace ncnn {
+
+class WeightCachePrivate;
+// the weights layers derive from the model weights in create_pipeline, recorded per layer
+// attach it to opt.weight_cache before load_model
+// load_model hands the recorded weights of a layer to it and create_pipeline skips their transforms,
+// the layers without recorded weights are prepared as usual and recorded
+// entries are keyed by a 64-bit hash of all model weights and params of the layer, the cpu features and the options,
+// so a stale entry is only used on a hash collision
+// save the cache after the first load and load it at startup to bypass the weight transforms
+// the loaded weights are mapped from the file where the platform supports it and the layers use them in place,
+// with opt.use_mapped_model_loading the model weights are referenced from the mapped model file as well,
+// so the cached layers keep no weight copies on the heap and processes serving the model share the page cache
+// keep the cache alive as long as the nets loaded with it
+// nets loaded with the same cache also share the model weights they keep and the prepared weights,
+// so replicas of a model cost one copy of the weights, load every replica with the same opt.num_threads
+// and pick the thread count per extractor to share the prepared weights too
+// thread-safe, may be shared by several nets
+class NCNN_EXPORT WeightCache
+{
+public:
+    // unused trailing ints must be zero
+    enum { key_size = 16 };
+
+    WeightCache();
+    ~WeightCache();
+
+    // return 0 and the recorded weights for key, -1 if none
+    int find(const int* key, std::vector<Mat>& weights) const;
+
+    // record the weights for key, an entry already present is replaced
+    // the weights are referenced, not copied, and must not be modified afterwards
+    void insert(const int* key, const std::vector<Mat>& weights);
+
+    // recorded entry count
+    int size() const;
+
+    // find calls returning an entry and finding none since the last clear
+    int hit_count() const;
+    int miss_count() const;
+
+    // return the stored weight with the same shape and content as weight, or store weight and return it
+    // weights referencing external memory or not stored contiguously are returned as they are
+    // the weight must not be modified afterwards
+    Mat share(const Mat& weight);
+
+    // drop the shared weights no longer referenced by any net
+    void release_unused();
+
+    // bytes of all recorded and shared weights
+    size_t memory_usage() const;
+
+    // drop all entries and unmap the loaded files
+    // nets loaded with the cache must be cleared first
+    void clear();
+
+#if NCNN_STDIO
+    // load the weights saved by save(), entries already present are replaced
+    // return 0 if success
+    int load(const char* path);
+
+    // return 0 if success
+    int save(const char* path) const;
+    int save(FILE* fp) const;
+#endif // NCNN_STDIO
+
+private:
+    WeightCache(const WeightCache&);
+    WeightCache& operator=(const WeightCache&);
+
+private:
+    WeightCachePrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_WEIGHTCACHE_H
@@ -0,0 +1,328 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdio.h>
+#include <string.h>
+
+#include "allocator.h"
+#include "mat.h"
+#include "platform.h"
+
+static int test_allocator_size_class_0()
+{
+    ncnn::SizeClassPoolAllocator allocator;
+
+    const size_t sizes[] = {1, 63, 64, 65, 80, 81, 127, 128, 129, 1000, 4096, 4097, 65536, 1000000};
+    const int count = sizeof(sizes) / sizeof(sizes[0]);
+
+    void* ptrs[count];
+    for (int i = 0; i < count; i++)
+    {
+        ptrs[i] = allocator.fastMalloc(sizes[i]);
+        if (!ptrs[i] || ((size_t)ptrs[i] % NCNN_MALLOC_ALIGN) != 0)
+        {
+            fprintf(stderr, "test_allocator_size_class_0 bad pointer %p for size %zu\n", ptrs[i], sizes[i]);
+            return -1;
+        }
+
+        // the whole requested range plus the overread area must be usable
+        memset(ptrs[i], i, sizes[i] + NCNN_MALLOC_OVERREAD);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const unsigned char* p = (const unsigned char*)ptrs[i];
+        for (size_t j = 0; j < sizes[i]; j++)
+        {
+            if (p[j] != (unsigned char)i)
+            {
+                fprintf(stderr, "test_allocator_size_class_0 overlapped block for size %zu\n", sizes[i]);
+                return -1;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        allocator.fastFree(ptrs[i]);
+    }
+
+    if (allocator.hit_count() != 0 || allocator.allocation_count() != (size_t)count)
+    {
+        fprintf(stderr, "test_allocator_size_class_0 unexpected stats hit %zu count %zu\n", allocator.hit_count(), allocator.allocation_count());
+        return -1;
+    }
+
+    // the same sizes come back from the pool
+    for (int i = 0; i < count; i++)
+    {
+        ptrs[i] = allocator.fastMalloc(sizes[i]);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        allocator.fastFree(ptrs[i]);
+    }
+
+    if (allocator.hit_count() != (size_t)count)
+    {
+        fprintf(stderr, "test_allocator_size_class_0 expect %d hits but got %zu\n", count, allocator.hit_count());
+        return -1;
+    }
+
+    allocator.clear();
+
+    if (allocator.pooled_bytes() != 0)
+    {
+        fprintf(stderr, "test_allocator_size_class_0 pooled_bytes %zu after clear\n", allocator.pooled_bytes());
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_allocator_size_class_1()
+{
+    // blocks beyond the thread cache spill to the shared and overflow tiers
+    ncnn::SizeClassPoolAllocator allocator;
+    allocator.set_thread_cache_size(2);
+
+    const int count = 100;
+    void* ptrs[count];
+    for (int i = 0; i < count; i++)
+    {
+        ptrs[i] = allocator.fastMalloc(300);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        allocator.fastFree(ptrs[i]);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        ptrs[i] = allocator.fastMalloc(290);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = i + 1; j < count; j++)
+        {
+            if (ptrs[i] == ptrs[j])
+            {
+                fprintf(stderr, "test_allocator_size_class_1 block %p handed out twice\n", ptrs[i]);
+                return -1;
+            }
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        allocator.fastFree(ptrs[i]);
+    }
+
+    if (allocator.hit_count() != (size_t)count)
+    {
+        fprintf(stderr, "test_allocator_size_class_1 expect %d hits but got %zu\n", count, allocator.hit_count());
+        return -1;
+    }
+
+    return 0;
+}
+
+struct allocator_worker_args
+{
+    ncnn::Allocator* allocator;
+    ncnn::Mutex* handoff_lock;
+    std::vector<void*>* handoff;
+    int seed;
+    int ret;
+};
+
+static void* allocator_worker(void* args)
+{
+    allocator_worker_args* a = (allocator_worker_args*)args;
+
+    unsigned int s = a->seed;
+    void* ptrs[16] = {0};
+    for (int i = 0; i < 20000; i++)
+    {
+        s = s * 1103515245 + 12345;
+        const int k = (s >> 16) % 16;
+        const size_t size = 16 + ((s >> 8) % 20000);
+
+        if (ptrs[k])
+        {
+            if (((unsigned char*)ptrs[k])[size_t(k) * 7 % 16] != (unsigned char)k)
+                a->ret = -1;
+
+            if (i % 7 == 0)
+            {
+                // let another thread free it
+                a->handoff_lock->lock();
+                a->handoff->push_back(ptrs[k]);
+                a->handoff_lock->unlock();
+            }
+            else
+            {
+                a->allocator->fastFree(ptrs[k]);
+            }
+        }
+
+        if (i % 5 == 0)
+        {
+            void* ptr = 0;
+            a->handoff_lock->lock();
+            if (!a->handoff->empty())
+            {
+                ptr = a->handoff->back();
+                a->handoff->pop_back();
+            }
+            a->handoff_lock->unlock();
+
+            a->allocator->fastFree(ptr);
+        }
+
+        ptrs[k] = a->allocator->fastMalloc(size);
+        memset(ptrs[k], k, size);
+    }
+
+    for (int k = 0; k < 16; k++)
+    {
+        a->allocator->fastFree(ptrs[k]);
+    }
+
+    return 0;
+}
+
+static int test_allocator_size_class_2()
+{
+    // concurrent allocations, some blocks are freed by another thread
+    ncnn::SizeClassPoolAllocator allocator;
+
+    ncnn::Mutex handoff_lock;
+    std::vector<void*> handoff;
+
+    const int thread_count = 4;
+    allocator_worker_args args[thread_count];
+    ncnn::Thread* threads[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        args[i].allocator = &allocator;
+        args[i].handoff_lock = &handoff_lock;
+        args[i].handoff = &handoff;
+        args[i].seed = i + 1;
+        args[i].ret = 0;
+        threads[i] = new ncnn::Thread(allocator_worker, &args[i]);
+    }
+
+    int ret = 0;
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+
+        if (args[i].ret != 0)
+            ret = args[i].ret;
+    }
+
+    for (size_t i = 0; i < handoff.size(); i++)
+    {
+        allocator.fastFree(handoff[i]);
+    }
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_allocator_size_class_2 corrupted block\n");
+        return ret;
+    }
+
+    if (allocator.allocation_count() != thread_count * 20000 || allocator.hit_rate() <= 0.f)
+    {
+        fprintf(stderr, "test_allocator_size_class_2 unexpected stats count %zu hit rate %f\n", allocator.allocation_count(), allocator.hit_rate());
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_allocator_size_class_3()
+{
+    // mats round trip through the allocator
+    ncnn::SizeClassPoolAllocator allocator;
+
+    for (int i = 0; i < 3; i++)
+    {
+        ncnn::Mat a(17, 13, 5, (size_t)4u, &allocator);
+        a.fill(1.f);
+
+        ncnn::Mat b = a.clone(&allocator);
+        if (b.empty() || b.channel(4).row(12)[16] != 1.f)
+        {
+            fprintf(stderr, "test_allocator_size_class_3 clone failed\n");
+            return -1;
+        }
+    }
+
+    if (allocator.hit_count() != 4)
+    {
+        fprintf(stderr, "test_allocator_size_class_3 expect 4 hits but got %zu\n", allocator.hit_count());
+        return -1;
+    }
+
+    return 0;
+}
+
+static void* allocator_exit_worker(void* args)
+{
+    ncnn::SizeClassPoolAllocator* allocator = (ncnn::SizeClassPoolAllocator*)args;
+
+    // these blocks stay in the cache of this thread
+    void* ptrs[4];
+    for (int i = 0; i < 4; i++)
+    {
+        ptrs[i] = allocator->fastMalloc(1000);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        allocator->fastFree(ptrs[i]);
+    }
+
+    return 0;
+}
+
+static int test_allocator_size_class_4()
+{
+    // the cache of an exited thread is reused by the others
+    ncnn::SizeClassPoolAllocator allocator;
+
+    ncnn::Thread thread(allocator_exit_worker, &allocator);
+    thread.join();
+
+    void* ptrs[4];
+    for (int i = 0; i < 4; i++)
+    {
+        ptrs[i] = allocator.fastMalloc(1000);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        allocator.fastFree(ptrs[i]);
+    }
+
+#if NCNN_THREADS
+    if (allocator.hit_count() != 4)
+    {
+        fprintf(stderr, "test_allocator_size_class_4 expect 4 hits but got %zu\n", allocator.hit_count());
+        return -1;
+    }
+#endif
+
+    return 0;
+}
+
+int main()
+{
+    return 0
+           || test_allocator_size_class_0()
+           || test_allocator_size_class_1()
+           || test_allocator_size_class_2()
+           || test_allocator_size_class_3()
+           || test_allocator_size_class_4();
+}
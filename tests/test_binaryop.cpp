@@ -59,6 +59,27 @@ static int test_binaryop(const ncnn::Mat& _a, const ncnn::Mat& _b, int flag)
     if (ret != 0)
     {
         fprintf(stderr, "test_binaryop failed a.dims=%d a=(%d %d %d %d) b.dims=%d b=(%d %d %d %d) op_type=%d\n", a.dims, a.w, a.h, a.d, a.c, b.dims, b.w, b.h, b.d, b.c, op_type);
+        return ret;
+    }
+
+    {
+        // fp16 blobs on x86
+        ncnn::Option opt;
+        opt.num_threads = 1;
+        opt.use_packing_layout = true;
+        opt.use_fp16_packed = true;
+        opt.use_fp16_storage = true;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_packed = false;
+        opt.use_bf16_storage = false;
+        opt.use_x86_fp16_storage = true;
+
+        ret = test_layer_opt("BinaryOp", pd, weights, opt, ab, 1, 0.001, flag);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_binaryop x86 fp16 failed a.dims=%d a=(%d %d %d %d) b.dims=%d b=(%d %d %d %d) op_type=%d\n", a.dims, a.w, a.h, a.d, a.c, b.dims, b.w, b.h, b.d, b.c, op_type);
+            return ret;
+        }
     }
 
     return ret;
@@ -101,6 +122,27 @@ static int test_binaryop(const ncnn::Mat& _a, float b, int flag)
     if (ret != 0)
     {
         fprintf(stderr, "test_binaryop failed a.dims=%d a=(%d %d %d %d) b=%f op_type=%d\n", a.dims, a.w, a.h, a.d, a.c, b, op_type);
+        return ret;
+    }
+
+    {
+        // fp16 blobs on x86
+        ncnn::Option opt;
+        opt.num_threads = 1;
+        opt.use_packing_layout = true;
+        opt.use_fp16_packed = true;
+        opt.use_fp16_storage = true;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_packed = false;
+        opt.use_bf16_storage = false;
+        opt.use_x86_fp16_storage = true;
+
+        ret = test_layer_opt("BinaryOp", pd, weights, opt, a, 0.001, flag);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_binaryop x86 fp16 failed a.dims=%d a=(%d %d %d %d) b=%f op_type=%d\n", a.dims, a.w, a.h, a.d, a.c, b, op_type);
+            return ret;
+        }
     }
 
     return ret;
@@ -128,6 +128,67 @@ static int test_convolution_3()
     return 0;
 }
 
+static int test_convolution_bf16(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias)
+{
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, kernel);
+    pd.set(2, dilation);
+    pd.set(3, stride);
+    pd.set(4, pad);
+    pd.set(5, bias);
+    pd.set(6, outch * c * kernel * kernel);
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 2 : 1);
+    weights[0] = RandomMat(outch * c * kernel * kernel);
+    if (bias)
+        weights[1] = RandomMat(outch);
+
+    for (int i = 0; i < 4; i++)
+    {
+        ncnn::Option opt;
+        opt.num_threads = i < 2 ? 1 : 2;
+        opt.use_packing_layout = i % 2 == 1;
+        opt.use_fp16_packed = false;
+        opt.use_fp16_storage = false;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_packed = true;
+        opt.use_bf16_storage = true;
+
+        int ret = test_layer_opt("Convolution", pd, weights, opt, a);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_convolution_bf16 failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d act=%d actparams=[%f,%f] num_threads=%d\n", w, h, c, outch, kernel, dilation, stride, pad, bias, activation_type, activation_params[0], activation_params[1], opt.num_threads);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int test_convolution_4()
+{
+    // the im2col K tail and multiple tiles of the bf16 gemm, output channels split across threads on the last
+    return 0
+           || test_convolution_bf16(7, 6, 1, 1, 1, 1, 1, 0, 1)
+           || test_convolution_bf16(7, 6, 3, 5, 3, 1, 1, 1, 0)
+           || test_convolution_bf16(9, 7, 13, 17, 3, 1, 2, 1, 1)
+           || test_convolution_bf16(11, 9, 16, 32, 1, 1, 1, 0, 0)
+           || test_convolution_bf16(13, 11, 19, 37, 3, 2, 1, 2, 1)
+           || test_convolution_bf16(15, 15, 24, 48, 5, 1, 2, 2, 0)
+           || test_convolution_bf16(20, 19, 35, 67, 3, 1, 1, -233, 1)
+           || test_convolution_bf16(6, 5, 20, 40, 3, 1, 1, 1, 1);
+}
+
 #if NCNN_INT8
 static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias, bool requant = false)
 {
@@ -445,10 +506,12 @@ int main()
            || test_convolution_1()
            || test_convolution_1_2()
            || test_convolution_2()
-           || test_convolution_3();
+           || test_convolution_3()
+           || test_convolution_4();
 #else
     return 0
            || test_convolution_2()
-           || test_convolution_3();
+           || test_convolution_3()
+           || test_convolution_4();
 #endif
 }
@@ -83,6 +83,65 @@ static int test_convolutiondepthwise_2()
     return 0;
 }
 
+static int test_convolutiondepthwise_bf16(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias, int group)
+{
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, kernel);
+    pd.set(2, dilation);
+    pd.set(3, stride);
+    pd.set(4, pad);
+    pd.set(5, bias);
+    pd.set(6, outch / group * c / group * kernel * kernel * group);
+    pd.set(7, group);
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 2 : 1);
+    weights[0] = RandomMat(outch / group * c / group * kernel * kernel * group);
+    if (bias)
+        weights[1] = RandomMat(outch);
+
+    // group convolution runs bf16 Convolution per group on fp32 channel range views
+    for (int i = 0; i < 2; i++)
+    {
+        ncnn::Option opt;
+        opt.num_threads = 1;
+        opt.use_packing_layout = i == 1;
+        opt.use_fp16_packed = false;
+        opt.use_fp16_storage = false;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_packed = true;
+        opt.use_bf16_storage = true;
+
+        int ret = test_layer_opt("ConvolutionDepthWise", pd, weights, opt, a);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_convolutiondepthwise_bf16 failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d group=%d act=%d actparams=[%f,%f]\n", w, h, c, outch, kernel, dilation, stride, pad, bias, group, activation_type, activation_params[0], activation_params[1]);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int test_convolutiondepthwise_3()
+{
+    return 0
+           || test_convolutiondepthwise_bf16(9, 7, 8, 16, 3, 1, 1, 1, 1, 2)
+           || test_convolutiondepthwise_bf16(9, 7, 12, 24, 3, 1, 2, 1, 0, 3)
+           || test_convolutiondepthwise_bf16(11, 9, 16, 32, 1, 1, 1, 0, 1, 2)
+           || test_convolutiondepthwise_bf16(11, 9, 32, 64, 3, 2, 1, 2, 0, 4)
+           || test_convolutiondepthwise_bf16(13, 11, 15, 20, 3, 1, 1, 1, 1, 5);
+}
+
 #if NCNN_INT8
 static int test_convolutiondepthwise_int8(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias, int group, bool requant = false)
 {
@@ -217,8 +276,8 @@ int main()
     SRAND(7767517);
 
 #if NCNN_INT8
-    return test_convolutiondepthwise_1() || test_convolutiondepthwise_2();
+    return test_convolutiondepthwise_1() || test_convolutiondepthwise_2() || test_convolutiondepthwise_3();
 #else
-    return test_convolutiondepthwise_2();
+    return test_convolutiondepthwise_2() || test_convolutiondepthwise_3();
 #endif
 }
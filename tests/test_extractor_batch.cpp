@@ -0,0 +1,130 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// random weights, zero for the 4-byte flag tags
+class DataReaderFromRandom : public ncnn::DataReader
+{
+public:
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (size == 4)
+        {
+            memset(buf, 0, 4);
+            return 4;
+        }
+
+        float* p = (float*)buf;
+        for (size_t i = 0; i < size / 4; i++)
+        {
+            p[i] = RandomFloat(-0.2f, 0.2f);
+        }
+        return size;
+    }
+};
+
+static const char* batch_param = "7767517\n"
+                                 "7 8\n"
+                                 "Input            data         0 1 data 0=4 1=4 2=32\n"
+                                 "Convolution      conv         1 1 data conv 0=16 1=3 4=1 5=1 6=4608 9=1\n"
+                                 "InnerProduct     fc1          1 1 conv fc1 0=48 1=1 2=12288 9=1\n"
+                                 "InnerProduct     fc2          1 1 fc1 fc2 0=10 1=1 2=480\n"
+                                 "Input            seq          0 1 seq 0=24 1=7\n"
+                                 "Gemm             linear       1 1 seq linear 5=1 6=1 8=40 9=24 10=4\n"
+                                 "ReLU             relu         1 1 linear relu\n";
+
+static int test_extractor_batch(const ncnn::Option& opt, int batch)
+{
+    ncnn::Net net;
+    net.opt = opt;
+
+    net.load_param_mem(batch_param);
+
+    DataReaderFromRandom dr;
+    net.load_model(dr);
+
+    std::vector<ncnn::Mat> data(batch);
+    std::vector<ncnn::Mat> seq(batch);
+    for (int i = 0; i < batch; i++)
+    {
+        data[i] = RandomMat(4, 4, 32);
+        // samples may have a different number of rows, the tall one is not stacked
+        seq[i] = RandomMat(24, i == 1 ? 20 : 3 + i % 5);
+    }
+
+    // one sample at a time
+    std::vector<ncnn::Mat> fc2_ref(batch);
+    std::vector<ncnn::Mat> relu_ref(batch);
+    for (int i = 0; i < batch; i++)
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", data[i]);
+        ex.input("seq", seq[i]);
+        ex.extract("fc2", fc2_ref[i]);
+        ex.extract("relu", relu_ref[i]);
+    }
+
+    // all samples at once
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input_batch("data", data);
+    ex.input_batch("seq", seq);
+
+    std::vector<ncnn::Mat> fc2;
+    std::vector<ncnn::Mat> relu;
+    int ret = ex.extract_batch("fc2", fc2);
+    if (ret != 0 || (int)fc2.size() != batch)
+    {
+        fprintf(stderr, "test_extractor_batch extract fc2 failed batch=%d\n", batch);
+        return -1;
+    }
+
+    ret = ex.extract_batch("relu", relu);
+    if (ret != 0 || (int)relu.size() != batch)
+    {
+        fprintf(stderr, "test_extractor_batch extract relu failed batch=%d\n", batch);
+        return -1;
+    }
+
+    if (CompareMat(fc2, fc2_ref, 0.001) != 0 || CompareMat(relu, relu_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_extractor_batch failed batch=%d use_packing_layout=%d lightmode=%d\n", batch, opt.use_packing_layout, opt.lightmode);
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+
+    opts[1].use_packing_layout = true;
+
+    opts[2].use_packing_layout = true;
+    opts[2].lightmode = false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        opts[i].num_threads = 1;
+
+        int ret = 0
+                  || test_extractor_batch(opts[i], 1)
+                  || test_extractor_batch(opts[i], 3)
+                  || test_extractor_batch(opts[i], 8);
+
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// pseudo random weights, zero for the 4-byte flag tags, the same for every reader
+class DataReaderFromSeed : public ncnn::DataReader
+{
+public:
+    DataReaderFromSeed()
+        : seed(7767517)
+    {
+    }
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (size == 4)
+        {
+            memset(buf, 0, 4);
+            return 4;
+        }
+
+        float* p = (float*)buf;
+        for (size_t i = 0; i < size / 4; i++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            p[i] = ((seed >> 8) / 16777216.f - 0.5f) * 0.4f;
+        }
+        return size;
+    }
+
+public:
+    mutable unsigned int seed;
+};
+
+static const char* forwardplan_param = "7767517\n"
+                                       "7 8\n"
+                                       "Input            data         0 1 data 0=6 1=6 2=4\n"
+                                       "Convolution      conv         1 1 data conv 0=8 1=3 4=1 5=1 6=288\n"
+                                       "Split            split        1 2 conv conv_0 conv_1\n"
+                                       "ReLU             relu         1 1 conv_0 relu\n"
+                                       "Sigmoid          sigmoid      1 1 conv_1 sigmoid\n"
+                                       "BinaryOp         add          2 1 relu sigmoid add\n"
+                                       "Pooling          pool         1 1 add pool 0=1 1=2 2=2\n";
+
+static int load_net(ncnn::Net& net, const ncnn::Option& opt)
+{
+    net.opt = opt;
+    net.load_param_mem(forwardplan_param);
+
+    DataReaderFromSeed dr;
+    return net.load_model(dr);
+}
+
+// every extract of the reference resolves the required layers from scratch
+static int extract_ref(const ncnn::Option& opt, const char* input_name, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Net net;
+    if (load_net(net, opt) != 0)
+        return -1;
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input(input_name, in);
+    return ex.extract("pool", out);
+}
+
+static int test_forwardplan(const ncnn::Option& opt)
+{
+    const int count = 4;
+
+    std::vector<ncnn::Mat> data(count);
+    std::vector<ncnn::Mat> pool_ref(count);
+    for (int i = 0; i < count; i++)
+    {
+        data[i] = RandomMat(6, 6, 4);
+        if (extract_ref(opt, "data", data[i], pool_ref[i]) != 0)
+        {
+            fprintf(stderr, "test_forwardplan reference forward failed\n");
+            return -1;
+        }
+    }
+
+    ncnn::Mat add = RandomMat(6, 6, 8);
+    ncnn::Mat add_pool_ref;
+    if (extract_ref(opt, "add", add, add_pool_ref) != 0)
+    {
+        fprintf(stderr, "test_forwardplan reference forward failed\n");
+        return -1;
+    }
+
+    ncnn::Net net;
+    if (load_net(net, opt) != 0)
+        return -1;
+
+    // the first extract resolves the required layers and the next ones reuse them
+    for (int i = 0; i < count; i++)
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_parallel_branches(i % 2 == 0 ? 0 : 2);
+        ex.input("data", data[i]);
+
+        ncnn::Mat pool;
+        int ret = ex.extract("pool", pool);
+        if (ret != 0 || CompareMat(pool, pool_ref[i], 0.001) != 0)
+        {
+            fprintf(stderr, "test_forwardplan repeated extract %d mismatch\n", i);
+            return -1;
+        }
+    }
+
+    if (net.forward_plan_resolve_count() != 1 || net.forward_plan_reuse_count() != count - 1)
+    {
+        fprintf(stderr, "test_forwardplan expect 1 resolve and %d reuses but got %d and %d\n", count - 1, net.forward_plan_resolve_count(), net.forward_plan_reuse_count());
+        return -1;
+    }
+
+    // an intermediate blob already extracted changes the layers to run
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", data[0]);
+
+        ncnn::Mat relu;
+        ncnn::Mat pool;
+        int ret = ex.extract("relu", relu);
+        if (ret == 0)
+            ret = ex.extract("pool", pool);
+        if (ret != 0 || CompareMat(pool, pool_ref[0], 0.001) != 0)
+        {
+            fprintf(stderr, "test_forwardplan extract after intermediate blob mismatch\n");
+            return -1;
+        }
+    }
+
+    // so does an input fed at an intermediate blob
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("add", add);
+
+        ncnn::Mat pool;
+        int ret = ex.extract("pool", pool);
+        if (ret != 0 || CompareMat(pool, add_pool_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_forwardplan extract from intermediate input mismatch\n");
+            return -1;
+        }
+    }
+
+    // the cached layers of pool are still valid for a plain extract
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", data[1]);
+
+        ncnn::Mat pool;
+        int ret = ex.extract("pool", pool);
+        if (ret != 0 || CompareMat(pool, pool_ref[1], 0.001) != 0)
+        {
+            fprintf(stderr, "test_forwardplan extract after other plans mismatch\n");
+            return -1;
+        }
+    }
+
+    if (net.forward_plan_resolve_count() != 4 || net.forward_plan_reuse_count() != count)
+    {
+        fprintf(stderr, "test_forwardplan expect 4 resolves and %d reuses but got %d and %d\n", count, net.forward_plan_resolve_count(), net.forward_plan_reuse_count());
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+
+    opts[1].use_packing_layout = true;
+
+    opts[2].use_packing_layout = true;
+    opts[2].lightmode = false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        opts[i].num_threads = 1;
+
+        int ret = test_forwardplan(opts[i]);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_forwardplan failed use_packing_layout=%d lightmode=%d\n", opts[i].use_packing_layout, opts[i].lightmode);
+            return ret;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+static int test_gemm_weight_quant(int M, int N, int K, const ncnn::Mat& C, float alpha, float beta, int transA, int output_transpose, int constantC, int output_N1M, int bits, int group_size)
+{
+    int broadcast_type_C = -1;
+    if (!C.empty())
+    {
+        if (C.dims == 1 && C.w == 1)
+        {
+            // scalar
+            broadcast_type_C = 0;
+        }
+        if (C.dims == 1 && C.w == N)
+        {
+            // N
+            broadcast_type_C = 4;
+        }
+        if (C.dims == 2 && C.w == N && C.h == M)
+        {
+            // MxN
+            broadcast_type_C = 3;
+        }
+    }
+
+    ncnn::ParamDict pd;
+    pd.set(0, alpha);
+    pd.set(1, beta);
+    pd.set(2, transA);
+    pd.set(3, 1); // transB
+    pd.set(4, 0); // constantA
+    pd.set(5, 1); // constantB
+    pd.set(6, constantC);
+    pd.set(7, M);
+    pd.set(8, N);
+    pd.set(9, K);
+    pd.set(10, broadcast_type_C);
+    pd.set(11, output_N1M);
+    pd.set(14, output_transpose);
+    pd.set(23, bits);
+    pd.set(24, group_size);
+
+    std::vector<ncnn::Mat> weights;
+    weights.push_back(RandomMat(K, N));
+    if (constantC && broadcast_type_C != -1) weights.push_back(C);
+
+    std::vector<ncnn::Mat> a;
+    a.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (!constantC && !C.empty()) a.push_back(C);
+
+    int ret = test_layer("Gemm", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_gemm_weight_quant failed M=%d N=%d K=%d C.dims=%d C=(%d %d %d) alpha=%f beta=%f transA=%d output_transpose=%d constantC=%d output_N1M=%d bits=%d group_size=%d\n", M, N, K, C.dims, C.w, C.h, C.c, alpha, beta, transA, output_transpose, constantC, output_N1M, bits, group_size);
+    }
+
+    return ret;
+}
+
+static int test_gemm_0(int M, int N, int K, int bits, int group_size)
+{
+    return 0
+           || test_gemm_weight_quant(M, N, K, ncnn::Mat(), 1.f, 1.f, 0, 0, 1, 0, bits, group_size)
+           || test_gemm_weight_quant(M, N, K, RandomMat(N), 1.f, 1.f, 0, 0, 1, 0, bits, group_size)
+           || test_gemm_weight_quant(M, N, K, RandomMat(1), 0.5f, 2.f, 0, 0, 1, 1, bits, group_size)
+           || test_gemm_weight_quant(M, N, K, RandomMat(N), 2.1f, -0.5f, 0, 0, 1, 0, bits, group_size)
+
+           // fp32 path on the decoded weights
+           || test_gemm_weight_quant(M, N, K, RandomMat(N, M), 1.f, 0.8f, 0, 0, 1, 0, bits, group_size)
+           || test_gemm_weight_quant(M, N, K, RandomMat(N), 1.f, 1.f, 1, 0, 1, 0, bits, group_size)
+           || test_gemm_weight_quant(M, N, K, RandomMat(N), 1.f, 1.f, 0, 1, 1, 0, bits, group_size)
+           || test_gemm_weight_quant(M, N, K, RandomMat(N), 1.f, 1.f, 0, 0, 0, 0, bits, group_size);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_gemm_0(1, 16, 64, 4, 32)
+           || test_gemm_0(1, 13, 67, 8, 32)
+           || test_gemm_0(3, 24, 48, 4, 16)
+           || test_gemm_0(4, 7, 40, 8, 40)
+           || test_gemm_0(9, 32, 100, 4, 32)
+           || test_gemm_0(16, 20, 33, 8, 11)
+           || test_gemm_0(17, 5, 128, 4, 128);
+}
@@ -0,0 +1,115 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+static int test_gemm_bf16s(int M, int N, int K, const ncnn::Mat& C, float alpha, float beta, int transA, int transB, int constantA, int constantB, int output_elempack, int output_transpose)
+{
+    int broadcast_type_C = -1;
+    if (!C.empty())
+    {
+        if (C.dims == 1 && C.w == 1)
+        {
+            // scalar
+            broadcast_type_C = 0;
+        }
+        if (C.dims == 1 && C.w == M)
+        {
+            // M
+            broadcast_type_C = 1;
+        }
+        if (C.dims == 2 && C.w == 1 && C.h == M)
+        {
+            // Mx1
+            broadcast_type_C = 2;
+        }
+        if (C.dims == 2 && C.w == N && C.h == M)
+        {
+            // MxN
+            broadcast_type_C = 3;
+        }
+        if (C.dims == 2 && C.w == N && C.h == 1)
+        {
+            // 1xN
+            broadcast_type_C = 4;
+        }
+    }
+
+    ncnn::ParamDict pd;
+    pd.set(0, alpha);
+    pd.set(1, beta);
+    pd.set(2, transA);
+    pd.set(3, transB);
+    pd.set(4, constantA);
+    pd.set(5, constantB);
+    pd.set(6, 0); // constantC
+    pd.set(7, M);
+    pd.set(8, N);
+    pd.set(9, K);
+    pd.set(10, broadcast_type_C);
+    pd.set(12, output_elempack);
+    pd.set(14, output_transpose);
+
+    std::vector<ncnn::Mat> weights;
+    if (constantA) weights.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (constantB) weights.push_back(transB ? RandomMat(K, N) : RandomMat(N, K));
+
+    std::vector<ncnn::Mat> a;
+    if (!constantA) a.push_back(transA ? RandomMat(M, K) : RandomMat(K, M));
+    if (!constantB) a.push_back(transB ? RandomMat(K, N) : RandomMat(N, K));
+    if (!C.empty()) a.push_back(C);
+
+    for (int i = 0; i < 4; i++)
+    {
+        ncnn::Option opt;
+        opt.num_threads = i < 2 ? 1 : 2;
+        opt.use_packing_layout = i % 2 == 1;
+        opt.use_fp16_packed = false;
+        opt.use_fp16_storage = false;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_packed = true;
+        opt.use_bf16_storage = true;
+
+        int ret = test_layer_opt("Gemm", pd, weights, opt, a);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_gemm_bf16s failed M=%d N=%d K=%d C.dims=%d C=(%d %d %d) alpha=%f beta=%f transA=%d transB=%d constantA=%d constantB=%d output_elempack=%d output_transpose=%d num_threads=%d\n", M, N, K, C.dims, C.w, C.h, C.c, alpha, beta, transA, transB, constantA, constantB, output_elempack, output_transpose, opt.num_threads);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int test_gemm_0(int M, int N, int K)
+{
+    return 0
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), 1.f, 1.f, 0, 0, 0, 0, 0, 0)
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), 2.1f, 1.f, 0, 1, 0, 0, 0, 0)
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), -1.3f, 1.f, 1, 0, 0, 1, 0, 1)
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), 0.5f, 1.f, 1, 1, 1, 0, 0, 0)
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), 1.f, 1.f, 0, 1, 1, 0, 0, 1)
+           || test_gemm_bf16s(M, N, K, RandomMat(1), 1.f, 0.5f, 0, 1, 0, 1, 0, 0)
+           || test_gemm_bf16s(M, N, K, RandomMat(M), 3.1f, -0.6f, 1, 1, 0, 0, 0, 1)
+           || test_gemm_bf16s(M, N, K, RandomMat(1, M), 1.f, 1.f, 0, 0, 1, 0, 0, 0)
+           || test_gemm_bf16s(M, N, K, RandomMat(N, M), -2.1f, 0.8f, 0, 1, 0, 1, 0, 0)
+           || test_gemm_bf16s(M, N, K, RandomMat(N, 1), 1.f, 2.f, 1, 0, 0, 0, 0, 1)
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), 1.f, 1.f, 0, 1, 0, 1, 1, 0)
+           || test_gemm_bf16s(M, N, K, ncnn::Mat(), 1.f, 1.f, 0, 1, 0, 1, 4, 0)
+           || test_gemm_bf16s(M, N, K, RandomMat(N, 1), 1.f, 1.f, 1, 1, 0, 1, 4, 0);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    // K tails of the bf16 dot kernel and multiple tiles of M and N
+    return 0
+           || test_gemm_0(4, 4, 1)
+           || test_gemm_0(8, 4, 7)
+           || test_gemm_0(12, 13, 17)
+           || test_gemm_0(16, 24, 32)
+           || test_gemm_0(20, 33, 63)
+           || test_gemm_0(36, 40, 64)
+           || test_gemm_0(48, 37, 97);
+}
@@ -41,7 +41,8 @@ static int test_innerproduct_0()
            || test_innerproduct(RandomMat(4, 3, 15), 8, 1)
            || test_innerproduct(RandomMat(6, 2, 16), 16, 0)
            || test_innerproduct(RandomMat(6, 2, 16), 7, 1)
-           || test_innerproduct(RandomMat(6, 2, 5), 16, 1);
+           || test_innerproduct(RandomMat(6, 2, 5), 16, 1)
+           || test_innerproduct(RandomMat(7, 5, 19), 37, 1);
 }
 
 static int test_innerproduct_1()
@@ -191,7 +192,8 @@ static int test_innerproduct_4()
            || test_innerproduct_gemm(RandomMat(15, 32), 32, 1)
            || test_innerproduct_gemm(RandomMat(16, 24), 32, 1)
            || test_innerproduct_gemm(RandomMat(17, 20), 32, 1)
-           || test_innerproduct_gemm(RandomMat(18, 14), 32, 1);
+           || test_innerproduct_gemm(RandomMat(18, 14), 32, 1)
+           || test_innerproduct_gemm(RandomMat(67, 40), 37, 1);
 }
 
 #if NCNN_INT8
@@ -246,6 +248,115 @@ static int test_innerproduct_5()
 }
 #endif // NCNN_INT8
 
+// several 16 x 16 output tiles with k tails for the amx tile kernels, on more threads than some shapes have tiles
+static int test_innerproduct_tile(const ncnn::Mat& a, int outch, int int8)
+{
+    const int k = a.w;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, 1);
+    pd.set(2, outch * k);
+    pd.set(8, int8); // int8_scale_term
+
+    std::vector<ncnn::Mat> weights(int8 ? 4 : 2);
+    weights[0] = RandomMat(outch * k);
+    weights[1] = RandomMat(outch);
+    if (int8)
+    {
+        weights[2] = scales_mat(weights[0], outch, k, k);
+        weights[3] = scales_mat(a, 1, k, k);
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        ncnn::Option opt;
+        opt.num_threads = i < 2 ? 2 : 4;
+        opt.use_packing_layout = i % 2 == 1;
+        opt.use_fp16_packed = false;
+        opt.use_fp16_storage = false;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_packed = !int8;
+        opt.use_bf16_storage = !int8;
+
+        int ret = test_layer_opt("InnerProduct", pd, weights, opt, a, 0.001f, TEST_LAYER_DISABLE_GPU_TESTING);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_innerproduct_tile failed a.dims=%d a=(%d %d %d) outch=%d int8=%d num_threads=%d\n", a.dims, a.w, a.h, a.c, outch, int8, opt.num_threads);
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int test_innerproduct_8()
+{
+    return 0
+           || test_innerproduct_tile(RandomMat(300), 40, 0)
+           || test_innerproduct_tile(RandomMat(32, 16), 16, 0)
+           || test_innerproduct_tile(RandomMat(67, 35), 37, 0)
+           || test_innerproduct_tile(RandomMat(96, 48), 33, 0);
+}
+
+#if NCNN_INT8
+static int test_innerproduct_9()
+{
+    return 0
+           || test_innerproduct_tile(RandomMat(300), 40, 1)
+           || test_innerproduct_tile(RandomMat(64, 16), 16, 1)
+           || test_innerproduct_tile(RandomMat(67, 35), 37, 1)
+           || test_innerproduct_tile(RandomMat(200, 48), 33, 1);
+}
+#endif // NCNN_INT8
+
+static int test_innerproduct_weight_quant(const ncnn::Mat& a, int outch, int bias, int bits, int group_size)
+{
+    const int num_input = a.dims == 2 ? a.w : a.w * a.h * a.c;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, bias);
+    pd.set(2, outch * num_input);
+    pd.set(23, bits);
+    pd.set(24, group_size);
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 2 : 1);
+    weights[0] = RandomMat(outch * num_input);
+    if (bias)
+        weights[1] = RandomMat(outch);
+
+    int ret = test_layer("InnerProduct", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_innerproduct_weight_quant failed a.dims=%d a=(%d %d %d) outch=%d bias=%d bits=%d group_size=%d act=%d\n", a.dims, a.w, a.h, a.c, outch, bias, bits, group_size, activation_type);
+    }
+
+    return ret;
+}
+
+static int test_innerproduct_6()
+{
+    return 0
+           || test_innerproduct_weight_quant(RandomMat(64), 8, 1, 4, 32)
+           || test_innerproduct_weight_quant(RandomMat(67), 5, 0, 4, 32)
+           || test_innerproduct_weight_quant(RandomMat(6, 2, 16), 16, 1, 4, 16)
+           || test_innerproduct_weight_quant(RandomMat(5, 3, 7), 7, 1, 8, 6)
+           || test_innerproduct_weight_quant(RandomMat(130), 12, 1, 8, 128)
+           || test_innerproduct_weight_quant(RandomMat(96, 1), 11, 1, 4, 32)
+           || test_innerproduct_weight_quant(RandomMat(96, 3), 16, 0, 4, 32)
+           || test_innerproduct_weight_quant(RandomMat(45, 9), 8, 1, 4, 10)
+           || test_innerproduct_weight_quant(RandomMat(40, 13), 24, 1, 8, 32)
+           || test_innerproduct_weight_quant(RandomMat(33, 16), 7, 0, 8, 33);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -257,12 +368,17 @@ int main()
            || test_innerproduct_2()
            || test_innerproduct_3()
            || test_innerproduct_4()
-           || test_innerproduct_5();
+           || test_innerproduct_5()
+           || test_innerproduct_6()
+           || test_innerproduct_8()
+           || test_innerproduct_9();
 #else
     return 0
            || test_innerproduct_0()
            || test_innerproduct_1()
            || test_innerproduct_2()
-           || test_innerproduct_4();
+           || test_innerproduct_4()
+           || test_innerproduct_6()
+           || test_innerproduct_8();
 #endif
 }
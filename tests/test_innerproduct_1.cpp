@@ -0,0 +1,122 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "net.h"
+#include "testutil.h"
+
+#include <string.h>
+
+// group quantized weight storage in the model file
+static int test_innerproduct_weight_quant_model(int num_input, int num_output, int M, int bits, int group_size)
+{
+    const int num_group = (num_input + group_size - 1) / group_size;
+
+    ncnn::Mat scales = RandomMat(num_group * num_output, 0.001f, 0.1f);
+
+    std::vector<signed char> q(num_input * num_output);
+    ncnn::Mat weight(num_input * num_output);
+    const int qmax = bits == 8 ? 127 : 7;
+    for (int i = 0; i < num_input * num_output; i++)
+    {
+        // the absmax of every group is stored as qmax
+        q[i] = (signed char)(i % num_input % group_size == 0 ? qmax : RandomInt(-qmax, qmax));
+        weight[i] = q[i] * scales[i / num_input * num_group + i % num_input / group_size];
+    }
+
+    ncnn::Mat bias = RandomMat(num_output);
+
+    // the same weights stored as group quantized and as raw fp32
+    std::vector<unsigned char> model_quant;
+    std::vector<unsigned char> model_fp32;
+    {
+        const int header[2] = {0x0047A4B1, bits};
+        model_quant.resize(sizeof(header));
+        memcpy(&model_quant[0], header, sizeof(header));
+
+        if (bits == 8)
+        {
+            for (int i = 0; i < num_input * num_output; i++)
+                model_quant.push_back((unsigned char)q[i]);
+        }
+        else
+        {
+            // rows of an odd num_input start at half bytes
+            for (int i = 0; i < num_input * num_output; i += 2)
+            {
+                const int q1 = i + 1 < num_input * num_output ? q[i + 1] : 0;
+                model_quant.push_back((unsigned char)((q[i] & 15) | (q1 << 4)));
+            }
+        }
+
+        model_quant.resize((model_quant.size() + 3) / 4 * 4, 0);
+
+        model_fp32.resize(4 + weight.w * sizeof(float), 0);
+        memcpy(&model_fp32[4], weight.data, weight.w * sizeof(float));
+
+        // bias, then the group scales of the quantized weights
+        const size_t quant_size = model_quant.size();
+        const size_t fp32_size = model_fp32.size();
+        model_quant.resize(quant_size + bias.w * sizeof(float) + scales.w * sizeof(float), 0);
+        model_fp32.resize(fp32_size + bias.w * sizeof(float), 0);
+        memcpy(&model_quant[quant_size], bias.data, bias.w * sizeof(float));
+        memcpy(&model_quant[quant_size + bias.w * sizeof(float)], scales.data, scales.w * sizeof(float));
+        memcpy(&model_fp32[fp32_size], bias.data, bias.w * sizeof(float));
+    }
+
+    char param_quant[256];
+    char param_fp32[256];
+    sprintf(param_quant, "7767517\n2 2\nInput in 0 1 in\nInnerProduct fc 1 1 in out 0=%d 1=1 2=%d 23=%d 24=%d\n", num_output, num_input * num_output, bits, group_size);
+    sprintf(param_fp32, "7767517\n2 2\nInput in 0 1 in\nInnerProduct fc 1 1 in out 0=%d 1=1 2=%d\n", num_output, num_input * num_output);
+
+    ncnn::Mat a = M == 1 ? RandomMat(num_input) : RandomMat(num_input, M);
+
+    ncnn::Mat out_quant;
+    ncnn::Mat out_fp32;
+    {
+        ncnn::Net net;
+        net.opt.num_threads = 1;
+        net.opt.use_fp16_storage = false;
+        net.load_param_mem(param_quant);
+        net.load_model(&model_quant[0]);
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("in", a);
+        ex.extract("out", out_quant);
+    }
+    {
+        ncnn::Net net;
+        net.opt.num_threads = 1;
+        net.opt.use_fp16_storage = false;
+        net.load_param_mem(param_fp32);
+        net.load_model(&model_fp32[0]);
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("in", a);
+        ex.extract("out", out_fp32);
+    }
+
+    if (CompareMat(out_quant, out_fp32, 0.001) != 0)
+    {
+        fprintf(stderr, "test_innerproduct_weight_quant_model failed num_input=%d num_output=%d M=%d bits=%d group_size=%d\n", num_input, num_output, M, bits, group_size);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_innerproduct_0()
+{
+    return 0
+           || test_innerproduct_weight_quant_model(40, 6, 1, 4, 8)
+           || test_innerproduct_weight_quant_model(40, 6, 1, 8, 32)
+           || test_innerproduct_weight_quant_model(45, 7, 5, 4, 10)
+           || test_innerproduct_weight_quant_model(67, 5, 3, 4, 32)
+           || test_innerproduct_weight_quant_model(70, 9, 6, 8, 64);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return test_innerproduct_0();
+}
@@ -0,0 +1,204 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "kvcache.h"
+#include "net.h"
+#include "testutil.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// the last count rows of a
+static ncnn::Mat last_rows(const ncnn::Mat& a, int count)
+{
+    if (count == 0)
+        return ncnn::Mat();
+
+    ncnn::Mat b(a.w, count, a.c);
+    for (int q = 0; q < a.c; q++)
+    {
+        memcpy(b.channel(q), a.channel(q).row(a.h - count), count * a.w * sizeof(float));
+    }
+    return b;
+}
+
+static ncnn::Mat concat_rows(const ncnn::Mat& a, const ncnn::Mat& b)
+{
+    if (a.empty())
+        return b.clone();
+
+    ncnn::Mat c(b.w, a.h + b.h, b.c);
+    for (int q = 0; q < b.c; q++)
+    {
+        memcpy(c.channel(q).row(0), a.channel(q), a.h * a.w * sizeof(float));
+        memcpy(c.channel(q).row(a.h), b.channel(q), b.h * b.w * sizeof(float));
+    }
+    return c;
+}
+
+static int test_kvcache_0(int window)
+{
+    ncnn::KVCache cache(4, window);
+
+    // any stable pointer identifies the layer
+    const ncnn::Layer* layer = (const ncnn::Layer*)&cache;
+
+    ncnn::Mat key_ref;
+    ncnn::Mat value_ref;
+
+    const int steps[] = {3, 1, 1, 5, 1, 1, 1, 1, 2, 1, 1, 1, 1, 1, 1, 9, 1};
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++)
+    {
+        ncnn::Mat cur_key = RandomMat(5, steps[i], 2);
+        ncnn::Mat cur_value = RandomMat(3, steps[i], 2);
+
+        const int past_seqlen = key_ref.empty() ? 0 : window > 0 ? std::min(key_ref.h, window) : key_ref.h;
+        key_ref = concat_rows(last_rows(key_ref, past_seqlen), cur_key);
+        value_ref = concat_rows(last_rows(value_ref, past_seqlen), cur_value);
+
+        ncnn::Mat key;
+        ncnn::Mat value;
+        int ret = cache.append(layer, cur_key, cur_value, key, value);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_kvcache_0 append failed window=%d step=%d\n", window, (int)i);
+            return -1;
+        }
+
+        if (CompareMat(key, key_ref, 0.001) != 0 || CompareMat(value, value_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_kvcache_0 history mismatch window=%d step=%d\n", window, (int)i);
+            return -1;
+        }
+
+        const int seqlen = window > 0 ? std::min(key_ref.h, window) : key_ref.h;
+        if (cache.seqlen(layer) != seqlen)
+        {
+            fprintf(stderr, "test_kvcache_0 expect seqlen %d but got %d window=%d\n", seqlen, cache.seqlen(layer), window);
+            return -1;
+        }
+    }
+
+    // a new sequence reuses the memory
+    const size_t memory_bytes = cache.memory_bytes();
+
+    cache.clear();
+
+    ncnn::Mat key;
+    ncnn::Mat value;
+    cache.append(layer, RandomMat(5, 1, 2), RandomMat(3, 1, 2), key, value);
+    if (key.h != 1 || cache.seqlen(layer) != 1 || cache.memory_bytes() != memory_bytes)
+    {
+        fprintf(stderr, "test_kvcache_0 clear failed window=%d\n", window);
+        return -1;
+    }
+
+    // the same layer can not change shape within one sequence
+    if (cache.append(layer, RandomMat(6, 1, 2), RandomMat(3, 1, 2), key, value) == 0)
+    {
+        fprintf(stderr, "test_kvcache_0 accepted a different key shape window=%d\n", window);
+        return -1;
+    }
+
+    cache.release();
+    if (cache.memory_bytes() != 0 || cache.seqlen(layer) != 0)
+    {
+        fprintf(stderr, "test_kvcache_0 release failed window=%d\n", window);
+        return -1;
+    }
+
+    return 0;
+}
+
+static const char* decoder_param = "7767517\n"
+                                   "6 8\n"
+                                   "Input            q            0 1 q\n"
+                                   "Input            k            0 1 k\n"
+                                   "Input            v            0 1 v\n"
+                                   "Input            past_k       0 1 past_k\n"
+                                   "Input            past_v       0 1 past_v\n"
+                                   "SDPA             sdpa         5 3 q k v past_k past_v out out_k out_v 7=1 18=%d\n";
+
+static int test_kvcache_1(int window, int int8)
+{
+    char param[1024];
+    sprintf(param, decoder_param, int8 ? 2 : 0);
+
+    ncnn::Net net;
+    net.opt.num_threads = 1;
+    net.load_param_mem(param);
+    net.load_model((const unsigned char*)"");
+
+    ncnn::KVCache cache(8, window);
+
+    ncnn::Mat past_k;
+    ncnn::Mat past_v;
+
+    // prefill, then decode one token at a time
+    for (int i = 0; i < 24; i++)
+    {
+        const int cur_seqlen = i == 0 ? 5 : 1;
+
+        ncnn::Mat q = RandomMat(16, cur_seqlen, 4);
+        ncnn::Mat k = RandomMat(16, cur_seqlen, 2);
+        ncnn::Mat v = RandomMat(12, cur_seqlen, 2);
+
+        ncnn::Mat out_ref;
+        {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.input("q", q);
+            ex.input("k", k);
+            ex.input("v", v);
+            if (i > 0)
+            {
+                ex.input("past_k", past_k);
+                ex.input("past_v", past_v);
+            }
+
+            ncnn::Mat out_k;
+            ncnn::Mat out_v;
+            ex.extract("out", out_ref);
+            ex.extract("out_k", out_k);
+            ex.extract("out_v", out_v);
+
+            // the window drops the oldest tokens
+            const int seqlen = window > 0 ? std::min(out_k.h, window) : out_k.h;
+            past_k = last_rows(out_k, seqlen);
+            past_v = last_rows(out_v, seqlen);
+        }
+
+        ncnn::Mat out;
+        {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.set_kv_cache(&cache);
+            ex.input("q", q);
+            ex.input("k", k);
+            ex.input("v", v);
+            ex.extract("out", out);
+        }
+
+        if (CompareMat(out, out_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_kvcache_1 failed window=%d int8=%d step=%d\n", window, int8, i);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_kvcache_0(0)
+           || test_kvcache_0(6)
+           || test_kvcache_1(0, 0)
+           || test_kvcache_1(7, 0)
+#if NCNN_INT8
+           || test_kvcache_1(0, 1)
+           || test_kvcache_1(7, 1)
+#endif
+           ;
+}
@@ -0,0 +1,274 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// pseudo random weights, zero for the 4-byte flag tags, all bytes read are kept as the model data
+class DataReaderRecorder : public ncnn::DataReader
+{
+public:
+    DataReaderRecorder()
+        : seed(7767517)
+    {
+    }
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (size == 4)
+        {
+            memset(buf, 0, 4);
+        }
+        else
+        {
+            float* p = (float*)buf;
+            for (size_t i = 0; i < size / 4; i++)
+            {
+                seed = seed * 1664525 + 1013904223;
+                p[i] = ((seed >> 8) / 16777216.f - 0.5f) * 0.4f;
+            }
+        }
+
+        data.insert(data.end(), (const unsigned char*)buf, (const unsigned char*)buf + size);
+        return size;
+    }
+
+public:
+    mutable unsigned int seed;
+    mutable std::vector<unsigned char> data;
+};
+
+// two heads, the conv head and the gemm lstm head
+static const char* lazyloading_param = "7767517\n"
+                                       "8 8\n"
+                                       "Input            data         0 1 data 0=12 1=12 2=16\n"
+                                       "Convolution      conv3        1 1 data conv3 0=16 1=3 4=1 5=1 6=2304 9=1\n"
+                                       "ConvolutionDepthWise dw       1 1 conv3 dw 0=16 1=3 4=1 5=1 6=144 7=16\n"
+                                       "Convolution      conv1        1 1 dw conv1 0=8 1=1 5=1 6=128\n"
+                                       "InnerProduct     fc           1 1 conv1 fc 0=32 1=1 2=36864 9=1\n"
+                                       "Input            seq          0 1 seq 0=24 1=5\n"
+                                       "Gemm             linear       1 1 seq linear 5=1 6=1 8=40 9=24 10=4\n"
+                                       "LSTM             lstm         1 1 linear lstm 0=16 1=2560\n";
+
+// the layers preparing weights in create_pipeline on each head
+static const int lazyloading_fc_layer_count = 4;
+static const int lazyloading_lstm_layer_count = 2;
+
+static int extract_fc(const ncnn::Net& net, const ncnn::Mat& data, ncnn::Mat& fc)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", data);
+    return ex.extract("fc", fc);
+}
+
+static int extract_lstm(const ncnn::Net& net, const ncnn::Mat& seq, ncnn::Mat& lstm)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("seq", seq);
+    return ex.extract("lstm", lstm);
+}
+
+struct lazyloading_worker_args
+{
+    const ncnn::Net* net;
+    const ncnn::Mat* data;
+    const ncnn::Mat* seq;
+    const ncnn::Mat* fc_ref;
+    const ncnn::Mat* lstm_ref;
+    int ret;
+};
+
+static void* lazyloading_worker(void* args)
+{
+    lazyloading_worker_args* a = (lazyloading_worker_args*)args;
+
+    ncnn::Mat fc;
+    ncnn::Mat lstm;
+    int ret = extract_fc(*a->net, *a->data, fc);
+    if (ret == 0)
+        ret = extract_lstm(*a->net, *a->seq, lstm);
+    if (ret != 0 || CompareMat(fc, *a->fc_ref, 0.001) != 0 || CompareMat(lstm, *a->lstm_ref, 0.001) != 0)
+        a->ret = -1;
+
+    return 0;
+}
+
+static int test_lazyloading(const ncnn::Option& opt)
+{
+    ncnn::Mat data = RandomMat(12, 12, 16);
+    ncnn::Mat seq = RandomMat(24, 5);
+
+    // the model data and the reference outputs of loading everything up front
+    DataReaderRecorder dr;
+
+    ncnn::Mat fc_ref;
+    ncnn::Mat lstm_ref;
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        net.load_param_mem(lazyloading_param);
+        if (net.load_model(dr) != 0 || extract_fc(net, data, fc_ref) != 0 || extract_lstm(net, seq, lstm_ref) != 0)
+        {
+            fprintf(stderr, "test_lazyloading reference forward failed\n");
+            return -1;
+        }
+    }
+
+    const std::vector<unsigned char> model = dr.data;
+
+    // nothing is prepared before the first forward
+    ncnn::Net net;
+    net.opt = opt;
+    net.set_lazy_loading(true);
+    net.load_param_mem(lazyloading_param);
+    if (net.load_model(&model[0]) != model.size() || net.lazy_load_count() != 0 || net.lazy_memory_usage() != 0)
+    {
+        fprintf(stderr, "test_lazyloading load_model failed\n");
+        return -1;
+    }
+
+    // only the layers of the extracted head
+    ncnn::Mat fc;
+    int ret = extract_fc(net, data, fc);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || net.lazy_load_count() != lazyloading_fc_layer_count)
+    {
+        fprintf(stderr, "test_lazyloading fc head expect %d loads but got %d\n", lazyloading_fc_layer_count, net.lazy_load_count());
+        return -1;
+    }
+
+    ncnn::Mat lstm;
+    ret = extract_lstm(net, seq, lstm);
+    if (ret != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0 || net.lazy_load_count() != lazyloading_fc_layer_count + lazyloading_lstm_layer_count)
+    {
+        fprintf(stderr, "test_lazyloading lstm head expect %d loads but got %d\n", lazyloading_fc_layer_count + lazyloading_lstm_layer_count, net.lazy_load_count());
+        return -1;
+    }
+
+    // the prepared layers are kept without budget
+    const size_t usage = net.lazy_memory_usage();
+    ret = extract_fc(net, data, fc);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || net.lazy_load_count() != lazyloading_fc_layer_count + lazyloading_lstm_layer_count || net.lazy_evict_count() != 0 || usage == 0)
+    {
+        fprintf(stderr, "test_lazyloading prepared layers not kept\n");
+        return -1;
+    }
+
+    // a budget smaller than any layer evicts every layer once its forward is done
+    ncnn::Net net2;
+    net2.opt = opt;
+    net2.set_lazy_loading(true, 1);
+    net2.load_param_mem(lazyloading_param);
+    net2.load_model(&model[0]);
+
+    // layers whose prepared weights only reference the model data are never evicted
+    int evict_count = 0;
+    for (int i = 0; i < 2; i++)
+    {
+        ret = extract_fc(net2, data, fc);
+        if (ret == 0)
+            ret = extract_lstm(net2, seq, lstm);
+        if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_lazyloading evicted forward mismatch\n");
+            return -1;
+        }
+
+        // the evicted layers load again
+        const int load_count = lazyloading_fc_layer_count + lazyloading_lstm_layer_count + evict_count;
+        if (net2.lazy_load_count() != load_count || net2.lazy_evict_count() == evict_count || net2.lazy_memory_usage() != 0)
+        {
+            fprintf(stderr, "test_lazyloading expect %d loads but got %d\n", load_count, net2.lazy_load_count());
+            return -1;
+        }
+
+        evict_count = net2.lazy_evict_count();
+    }
+
+    // a budget for half of the prepared weights
+    ncnn::Net net3;
+    net3.opt = opt;
+    net3.set_lazy_loading(true, usage / 2);
+    net3.load_param_mem(lazyloading_param);
+    net3.load_model(&model[0]);
+
+    for (int i = 0; i < 2; i++)
+    {
+        ret = extract_fc(net3, data, fc);
+        if (ret == 0)
+            ret = extract_lstm(net3, seq, lstm);
+        if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0 || net3.lazy_memory_usage() > usage / 2)
+        {
+            fprintf(stderr, "test_lazyloading budget %d exceeded by %d\n", (int)(usage / 2), (int)net3.lazy_memory_usage());
+            return -1;
+        }
+    }
+
+    // concurrent first forwards load each layer once
+    ncnn::Net net4;
+    net4.opt = opt;
+    net4.set_lazy_loading(true);
+    net4.load_param_mem(lazyloading_param);
+    net4.load_model(&model[0]);
+
+    const int thread_count = 4;
+    lazyloading_worker_args args[thread_count];
+    ncnn::Thread* threads[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        args[i].net = &net4;
+        args[i].data = &data;
+        args[i].seq = &seq;
+        args[i].fc_ref = &fc_ref;
+        args[i].lstm_ref = &lstm_ref;
+        args[i].ret = 0;
+        threads[i] = new ncnn::Thread(lazyloading_worker, &args[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+
+        if (args[i].ret != 0)
+            ret = args[i].ret;
+    }
+
+    if (ret != 0 || net4.lazy_load_count() != lazyloading_fc_layer_count + lazyloading_lstm_layer_count)
+    {
+        fprintf(stderr, "test_lazyloading concurrent forward expect %d loads but got %d\n", lazyloading_fc_layer_count + lazyloading_lstm_layer_count, net4.lazy_load_count());
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+
+    opts[1].use_packing_layout = true;
+
+    opts[2].use_packing_layout = true;
+    opts[2].lightmode = false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        opts[i].num_threads = 1;
+
+        int ret = test_lazyloading(opts[i]);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_lazyloading failed use_packing_layout=%d lightmode=%d\n", opts[i].use_packing_layout, opts[i].lightmode);
+            return ret;
+        }
+    }
+
+    return 0;
+}
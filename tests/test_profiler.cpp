@@ -0,0 +1,202 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "profiler.h"
+#include "testutil.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// random weights, zero for the 4-byte flag tags
+class DataReaderFromRandom : public ncnn::DataReader
+{
+public:
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (size == 4)
+        {
+            memset(buf, 0, 4);
+            return 4;
+        }
+
+        float* p = (float*)buf;
+        for (size_t i = 0; i < size / 4; i++)
+        {
+            p[i] = RandomFloat(-0.2f, 0.2f);
+        }
+        return size;
+    }
+};
+
+static const char* profiler_param = "7767517\n"
+                                    "4 4\n"
+                                    "Input            data         0 1 data 0=12 1=10 2=8\n"
+                                    "Convolution      conv         1 1 data conv 0=16 1=3 4=1 5=1 6=1152\n"
+                                    "ReLU             relu         1 1 conv relu\n"
+                                    "InnerProduct     fc           1 1 relu fc 0=10 1=1 2=19200\n";
+
+static int test_profiler_0(const ncnn::Option& opt)
+{
+    ncnn::Net net;
+    net.opt = opt;
+
+    net.load_param_mem(profiler_param);
+
+    DataReaderFromRandom dr;
+    net.load_model(dr);
+
+    ncnn::Mat data = RandomMat(12, 10, 8);
+
+    ncnn::Profiler profiler;
+
+    // nothing is recorded without a profiler attached
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", data);
+
+        ncnn::Mat fc;
+        ex.extract("fc", fc);
+    }
+
+    if (profiler.event_count() != 0)
+    {
+        fprintf(stderr, "test_profiler_0 recorded without profiler\n");
+        return -1;
+    }
+
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_profiler(&profiler);
+        ex.input("data", data);
+
+        ncnn::Mat fc;
+        ex.extract("fc", fc);
+    }
+
+    // conv relu fc
+    if (profiler.event_count() != 3)
+    {
+        fprintf(stderr, "test_profiler_0 expect 3 events but got %d\n", profiler.event_count());
+        return -1;
+    }
+
+    const ncnn::ProfileEvent conv = profiler.event(0);
+    const ncnn::ProfileEvent relu = profiler.event(1);
+    const ncnn::ProfileEvent fc = profiler.event(2);
+
+    if (conv.layer_index != 1 || relu.layer_index != 2 || fc.layer_index != 3)
+    {
+        fprintf(stderr, "test_profiler_0 wrong layer order %d %d %d\n", conv.layer_index, relu.layer_index, fc.layer_index);
+        return -1;
+    }
+
+    if (conv.start > conv.end || conv.end > relu.start || relu.end > fc.start || fc.end > profiler.now())
+    {
+        fprintf(stderr, "test_profiler_0 events out of order\n");
+        return -1;
+    }
+
+    if (conv.bottom_shapes.size() != 1 || conv.top_shapes.size() != 1 || conv.bottom_shapes[0].data)
+    {
+        fprintf(stderr, "test_profiler_0 conv shapes missing\n");
+        return -1;
+    }
+
+    const ncnn::Mat& conv_in = conv.bottom_shapes[0];
+    const ncnn::Mat& conv_out = conv.top_shapes[0];
+    if (conv_in.w != 12 || conv_in.h != 10 || conv_in.c * conv_in.elempack != 8 || conv_out.w != 12 || conv_out.h != 10 || conv_out.c * conv_out.elempack != 16)
+    {
+        fprintf(stderr, "test_profiler_0 conv shapes wrong\n");
+        return -1;
+    }
+
+    if (conv.allocated_bytes != conv_out.total() * conv_out.elemsize)
+    {
+        fprintf(stderr, "test_profiler_0 conv allocated %zu bytes\n", conv.allocated_bytes);
+        return -1;
+    }
+
+    // relu runs inplace
+    if (relu.allocated_bytes != 0 || fc.allocated_bytes == 0)
+    {
+        fprintf(stderr, "test_profiler_0 relu allocated %zu bytes fc allocated %zu bytes\n", relu.allocated_bytes, fc.allocated_bytes);
+        return -1;
+    }
+
+#if NCNN_STRING
+    if (conv.type != "Convolution" || fc.name != "fc")
+    {
+        fprintf(stderr, "test_profiler_0 wrong layer names\n");
+        return -1;
+    }
+#endif
+
+    // paused profiler keeps its events
+    profiler.set_enabled(false);
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_profiler(&profiler);
+        ex.input("data", data);
+
+        ncnn::Mat fc;
+        ex.extract("fc", fc);
+    }
+
+    if (profiler.event_count() != 3)
+    {
+        fprintf(stderr, "test_profiler_0 recorded while disabled\n");
+        return -1;
+    }
+
+#if NCNN_STDIO
+    FILE* fp = tmpfile();
+    if (fp)
+    {
+        int ret = profiler.save_chrome_trace(fp);
+
+        char buf[4096] = {0};
+        rewind(fp);
+        size_t nread = fread(buf, 1, sizeof(buf) - 1, fp);
+        fclose(fp);
+
+        if (ret != 0 || nread == 0 || strncmp(buf, "{\"traceEvents\":[", 16) != 0 || !strstr(buf, "\"ph\":\"X\"") || !strstr(buf, "\"top_shapes\""))
+        {
+            fprintf(stderr, "test_profiler_0 bad chrome trace\n%s\n", buf);
+            return -1;
+        }
+    }
+#endif // NCNN_STDIO
+
+    profiler.clear();
+    if (profiler.event_count() != 0)
+    {
+        fprintf(stderr, "test_profiler_0 clear failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[2];
+
+    opts[0].use_packing_layout = false;
+
+    opts[1].use_packing_layout = true;
+
+    for (int i = 0; i < 2; i++)
+    {
+        opts[i].num_threads = 1;
+
+        int ret = test_profiler_0(opts[i]);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
@@ -50,6 +50,14 @@ static int test_sdpa_0()
            || test_sdpa(RandomMat(28, 17, 15), RandomMat(28, 32, 5), RandomMat(11, 32, 5), 1, -0.4f);
 }
 
+static int test_sdpa_2()
+{
+    // long sequences take the fused path on x86
+    return 0
+           || test_sdpa(RandomMat(16, 1024, 2), RandomMat(16, 1024, 1), RandomMat(20, 1024, 1), 0)
+           || test_sdpa(RandomMat(12, 1031, 2), RandomMat(12, 1531, 2), RandomMat(17, 1531, 2), 1);
+}
+
 #if NCNN_INT8
 static int test_sdpa_int8(const ncnn::Mat& q, const ncnn::Mat& k, const ncnn::Mat& v, int attn_mask, float scale = 0.f)
 {
@@ -98,6 +106,13 @@ static int test_sdpa_1()
            || test_sdpa_int8(RandomMat(28, 17, 15), RandomMat(28, 127, 5), RandomMat(32, 127, 5), 0, 0.1f)
            || test_sdpa_int8(RandomMat(28, 17, 15), RandomMat(28, 32, 5), RandomMat(11, 32, 5), 1, -0.4f);
 }
+
+static int test_sdpa_3()
+{
+    return 0
+           || test_sdpa_int8(RandomMat(16, 2048, 1), RandomMat(16, 2048, 1), RandomMat(20, 2048, 1), 0)
+           || test_sdpa_int8(RandomMat(12, 2053, 1), RandomMat(12, 2111, 1), RandomMat(17, 2111, 1), 1);
+}
 #endif
 
 int main()
@@ -105,8 +120,8 @@ int main()
     SRAND(7767517);
 
 #if NCNN_INT8
-    return test_sdpa_0() || test_sdpa_1();
+    return test_sdpa_0() || test_sdpa_1() || test_sdpa_2() || test_sdpa_3();
 #else
-    return test_sdpa_0();
+    return test_sdpa_0() || test_sdpa_2();
 #endif
 }
@@ -0,0 +1,150 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "layer.h"
+#include "layer_type.h"
+#include "modelbin.h"
+#include "shapecache.h"
+#include "testutil.h"
+
+#include <stdio.h>
+
+static int test_shapecache_0()
+{
+    ncnn::ShapeCache cache(2);
+
+    int key0[ncnn::ShapeCache::key_size] = {13, 11, 16};
+    int key1[ncnn::ShapeCache::key_size] = {20, 20, 16};
+    int key2[ncnn::ShapeCache::key_size] = {7, 5, 16};
+    int value0[ncnn::ShapeCache::value_size] = {1, 8, 16, 32};
+    int value1[ncnn::ShapeCache::value_size] = {4, 8, 48, 64};
+    int value2[ncnn::ShapeCache::value_size] = {0};
+
+    int value[ncnn::ShapeCache::value_size];
+    if (cache.find(key0, value) != -1)
+    {
+        fprintf(stderr, "test_shapecache_0 hit in empty cache\n");
+        return -1;
+    }
+
+    cache.insert(key0, value0);
+    cache.insert(key1, value1);
+
+    if (cache.find(key0, value) != 0 || value[0] != 1 || value[3] != 32)
+    {
+        fprintf(stderr, "test_shapecache_0 lost entry\n");
+        return -1;
+    }
+
+    // key1 is the least recently used one
+    cache.insert(key2, value2);
+
+    if (cache.find(key1, value) != -1 || cache.find(key0, value) != 0 || cache.find(key2, value) != 0)
+    {
+        fprintf(stderr, "test_shapecache_0 evicted the wrong entry\n");
+        return -1;
+    }
+
+    if (cache.size() != 2 || cache.hit_count() != 3 || cache.miss_count() != 2 || cache.eviction_count() != 1)
+    {
+        fprintf(stderr, "test_shapecache_0 unexpected stats size %d hit %zu miss %zu eviction %zu\n", cache.size(), cache.hit_count(), cache.miss_count(), cache.eviction_count());
+        return -1;
+    }
+
+    cache.set_capacity(1);
+    if (cache.size() != 1 || cache.find(key2, value) != 0)
+    {
+        fprintf(stderr, "test_shapecache_0 shrink kept the wrong entry\n");
+        return -1;
+    }
+
+    cache.clear();
+    if (cache.size() != 0)
+    {
+        fprintf(stderr, "test_shapecache_0 clear failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_shapecache_1(int kernel, int num_input, int num_output)
+{
+    // variable input resolution through one convolution
+    ncnn::ParamDict pd;
+    pd.set(0, num_output);
+    pd.set(1, kernel);
+    pd.set(4, kernel / 2);
+    pd.set(5, 1);
+    pd.set(6, num_output * num_input * kernel * kernel);
+
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = RandomMat(num_output * num_input * kernel * kernel);
+    weights[1] = RandomMat(num_output);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    ncnn::Layer* op = ncnn::create_layer_cpu(ncnn::LayerType::Convolution);
+    op->load_param(pd);
+    ncnn::ModelBinFromMatArray mb(weights.data());
+    op->load_model(mb);
+    op->create_pipeline(opt);
+
+    ncnn::Mat a0 = RandomMat(13, 11, num_input);
+    ncnn::Mat a1 = RandomMat(32, 24, num_input);
+
+    // the second round runs on cached specializations
+    const ncnn::Mat* inputs[4] = {&a0, &a1, &a0, &a1};
+
+    int ret = 0;
+    ncnn::Mat outs[4];
+    for (int i = 0; i < 4; i++)
+    {
+        ret = op->forward(*inputs[i], outs[i], opt);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_shapecache_1 forward failed kernel=%d\n", kernel);
+            break;
+        }
+    }
+
+    if (ret == 0 && (CompareMat(outs[0], outs[2], 0.001) != 0 || CompareMat(outs[1], outs[3], 0.001) != 0))
+    {
+        fprintf(stderr, "test_shapecache_1 cached forward mismatch kernel=%d\n", kernel);
+        ret = -1;
+    }
+
+    // only the optimized layers specialize per shape
+    if (ret == 0 && op->shape_cache)
+    {
+        if (op->shape_cache->size() != 2 || op->shape_cache->miss_count() != 2 || op->shape_cache->hit_count() != 2)
+        {
+            fprintf(stderr, "test_shapecache_1 unexpected stats kernel=%d size %d hit %zu miss %zu\n", kernel, op->shape_cache->size(), op->shape_cache->hit_count(), op->shape_cache->miss_count());
+            ret = -1;
+        }
+    }
+
+    op->destroy_pipeline(opt);
+
+    if (ret == 0 && op->shape_cache)
+    {
+        fprintf(stderr, "test_shapecache_1 cache outlives the pipeline\n");
+        ret = -1;
+    }
+
+    delete op;
+
+    return ret;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_shapecache_0()
+           || test_shapecache_1(1, 24, 32)
+           || test_shapecache_1(3, 24, 32)
+           || test_shapecache_1(3, 4, 8);
+}
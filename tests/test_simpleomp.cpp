@@ -0,0 +1,195 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "platform.h"
+#include "simpleomp.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// built with clang this goes through the llvm openmp abi (__kmpc_*)
+// built with gcc this goes through the gnu openmp abi (GOMP_*)
+
+static int check_hits(const char* name, const int* hits, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (hits[i] != 1)
+        {
+            fprintf(stderr, "test_simpleomp %s iteration %d ran %d times\n", name, i, hits[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_simpleomp_0()
+{
+    const int count = 1000;
+    int hits[count];
+
+    memset(hits, 0, sizeof(hits));
+    #pragma omp parallel for schedule(static) num_threads(4)
+    for (int i = 0; i < count; i++)
+    {
+        hits[i]++;
+    }
+    if (check_hits("static", hits, count) != 0)
+        return -1;
+
+    memset(hits, 0, sizeof(hits));
+    #pragma omp parallel for schedule(static, 7) num_threads(4)
+    for (int i = 0; i < count; i++)
+    {
+        hits[i]++;
+    }
+    if (check_hits("static chunk", hits, count) != 0)
+        return -1;
+
+    memset(hits, 0, sizeof(hits));
+    #pragma omp parallel for schedule(dynamic) num_threads(4)
+    for (int i = 0; i < count; i++)
+    {
+        hits[i]++;
+    }
+    if (check_hits("dynamic", hits, count) != 0)
+        return -1;
+
+    memset(hits, 0, sizeof(hits));
+    #pragma omp parallel for schedule(dynamic, 13) num_threads(3)
+    for (int i = count - 1; i >= 0; i -= 2)
+    {
+        hits[i]++;
+        hits[i - 1]++;
+    }
+    if (check_hits("dynamic descending", hits, count) != 0)
+        return -1;
+
+    memset(hits, 0, sizeof(hits));
+    #pragma omp parallel for schedule(guided, 4) num_threads(4)
+    for (int i = 0; i < count; i++)
+    {
+        hits[i]++;
+    }
+    if (check_hits("guided", hits, count) != 0)
+        return -1;
+
+    return 0;
+}
+
+static int test_simpleomp_1()
+{
+    // schedule(runtime) follows omp_set_schedule()
+    const omp_sched_t kinds[4] = {omp_sched_static, omp_sched_dynamic, omp_sched_guided, omp_sched_auto};
+    const int chunks[2] = {0, 5};
+
+    const int count = 777;
+    int hits[count];
+
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 2; j++)
+        {
+            omp_set_schedule(kinds[i], chunks[j]);
+
+            memset(hits, 0, sizeof(hits));
+            #pragma omp parallel for schedule(runtime) num_threads(4)
+            for (int k = 0; k < count; k++)
+            {
+                hits[k]++;
+            }
+
+            char name[32];
+            sprintf(name, "runtime %d,%d", (int)kinds[i], chunks[j]);
+            if (check_hits(name, hits, count) != 0)
+                return -1;
+        }
+    }
+
+    omp_set_schedule(omp_sched_dynamic, 0);
+
+    return 0;
+}
+
+static int test_simpleomp_2()
+{
+    // nowait loops run ahead and meet at the barrier
+    const int count = 500;
+    int hits0[count];
+    int hits1[count];
+    int sums[count];
+
+    memset(hits0, 0, sizeof(hits0));
+    memset(hits1, 0, sizeof(hits1));
+    memset(sums, 0, sizeof(sums));
+
+    #pragma omp parallel num_threads(4)
+    {
+        #pragma omp for schedule(dynamic, 3) nowait
+        for (int i = 0; i < count; i++)
+        {
+            hits0[i]++;
+        }
+
+        #pragma omp for schedule(guided) nowait
+        for (int i = 0; i < count; i++)
+        {
+            hits1[i]++;
+        }
+
+        #pragma omp barrier
+
+        #pragma omp for schedule(dynamic)
+        for (int i = 0; i < count; i++)
+        {
+            sums[i] = hits0[i] + hits1[i] - 1;
+        }
+    }
+
+    if (check_hits("nowait 0", hits0, count) != 0 || check_hits("nowait 1", hits1, count) != 0 || check_hits("barrier", sums, count) != 0)
+        return -1;
+
+    return 0;
+}
+
+static void orphaned_loop(int* hits, int count)
+{
+    #pragma omp for schedule(dynamic, 8)
+    for (int i = 0; i < count; i++)
+    {
+        hits[i]++;
+    }
+}
+
+static int test_simpleomp_3()
+{
+    // orphaned loops outside any parallel region run on the calling thread
+    const int count = 100;
+    int hits[count];
+
+    // leave the calling thread with a stale thread number
+    #pragma omp parallel for num_threads(2)
+    for (int i = 0; i < 3; i++)
+    {
+    }
+
+    for (int i = 0; i < 100; i++)
+    {
+        memset(hits, 0, sizeof(hits));
+        orphaned_loop(hits, count);
+        if (check_hits("orphaned", hits, count) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    return 0
+           || test_simpleomp_0()
+           || test_simpleomp_1()
+           || test_simpleomp_2()
+           || test_simpleomp_3();
+}
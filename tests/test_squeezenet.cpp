@@ -4,6 +4,7 @@
 #include "platform.h"
 #include "net.h"
 #include "testutil.h"
+#include "threadpool.h"
 
 #include <stdio.h>
 
@@ -404,6 +405,245 @@ static int test_squeezenet_overwrite_softmax(const ncnn::Option& opt, int load_m
     return check_top2(cls_scores, epsilon);
 }
 
+static int test_squeezenet_plan_memory(const ncnn::Option& opt, float epsilon = 0.001)
+{
+    ncnn::Net squeezenet;
+
+    squeezenet.opt = opt;
+
+#ifdef __EMSCRIPTEN__
+#define MODEL_DIR "/working"
+#else
+#define MODEL_DIR "../../examples"
+#endif
+
+    squeezenet.load_param(MODEL_DIR "/squeezenet_v1.1.param");
+    squeezenet.load_model(MODEL_DIR "/squeezenet_v1.1.bin");
+
+    std::vector<ncnn::Mat> input_shapes(1);
+    input_shapes[0] = ncnn::Mat(227, 227, 3);
+
+    size_t arena_size = squeezenet.plan_memory(input_shapes);
+    if (arena_size == 0)
+    {
+        fprintf(stderr, "plan_memory failed\n");
+        return -1;
+    }
+
+    ncnn::Mat in = generate_ncnn_logo(ncnn::Mat::PIXEL_BGR, 227, 227);
+
+    const float mean_vals[3] = {104.f, 117.f, 123.f};
+    in.substract_mean_normalize(mean_vals, 0);
+
+    // the arena is recycled across extractors
+    for (int i = 0; i < 3; i++)
+    {
+        ncnn::Extractor ex = squeezenet.create_extractor();
+
+        ex.input("data", in);
+
+        ncnn::Mat out;
+        ex.extract("prob", out);
+
+        std::vector<float> cls_scores;
+        cls_scores.resize(out.w);
+        for (int j = 0; j < out.w; j++)
+        {
+            cls_scores[j] = out[j];
+        }
+
+        int ret = check_top2(cls_scores, epsilon);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int test_squeezenet_parallel_branches(const ncnn::Option& opt, float epsilon = 0.001)
+{
+    ncnn::Net squeezenet;
+
+    squeezenet.opt = opt;
+
+#ifdef __EMSCRIPTEN__
+#define MODEL_DIR "/working"
+#else
+#define MODEL_DIR "../../examples"
+#endif
+
+    squeezenet.load_param(MODEL_DIR "/squeezenet_v1.1.param");
+    squeezenet.load_model(MODEL_DIR "/squeezenet_v1.1.bin");
+
+    ncnn::Mat in = generate_ncnn_logo(ncnn::Mat::PIXEL_BGR, 227, 227);
+
+    const float mean_vals[3] = {104.f, 117.f, 123.f};
+    in.substract_mean_normalize(mean_vals, 0);
+
+    // the expand1x1 and expand3x3 branches of fire modules run concurrently
+    for (int i = 2; i <= 4; i++)
+    {
+        ncnn::Extractor ex = squeezenet.create_extractor();
+        ex.set_parallel_branches(i);
+
+        ex.input("data", in);
+
+        ncnn::Mat out;
+        ex.extract("prob", out);
+
+        std::vector<float> cls_scores;
+        cls_scores.resize(out.w);
+        for (int j = 0; j < out.w; j++)
+        {
+            cls_scores[j] = out[j];
+        }
+
+        int ret = check_top2(cls_scores, epsilon);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int test_squeezenet_load_threads(const ncnn::Option& opt, float epsilon = 0.001)
+{
+    ncnn::Mat in = generate_ncnn_logo(ncnn::Mat::PIXEL_BGR, 227, 227);
+
+    const float mean_vals[3] = {104.f, 117.f, 123.f};
+    in.substract_mean_normalize(mean_vals, 0);
+
+    // the layers are prepared concurrently
+    for (int i = 2; i <= 4; i++)
+    {
+        ncnn::Net squeezenet;
+
+        squeezenet.opt = opt;
+        squeezenet.opt.num_load_threads = i;
+
+        squeezenet.load_param(MODEL_DIR "/squeezenet_v1.1.param");
+        int ret = squeezenet.load_model(MODEL_DIR "/squeezenet_v1.1.bin");
+        if (ret != 0)
+            return ret;
+
+        ncnn::Extractor ex = squeezenet.create_extractor();
+
+        ex.input("data", in);
+
+        ncnn::Mat out;
+        ex.extract("prob", out);
+
+        std::vector<float> cls_scores;
+        cls_scores.resize(out.w);
+        for (int j = 0; j < out.w; j++)
+        {
+            cls_scores[j] = out[j];
+        }
+
+        ret = check_top2(cls_scores, epsilon);
+        if (ret != 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+struct thread_pool_tenant
+{
+    const ncnn::Net* net;
+    const ncnn::Mat* in;
+    ncnn::ThreadPool* pool;
+    float epsilon;
+    int ret;
+};
+
+static void* thread_pool_tenant_worker(void* args)
+{
+    thread_pool_tenant* tenant = (thread_pool_tenant*)args;
+
+    for (int i = 0; i < 3; i++)
+    {
+        ncnn::Extractor ex = tenant->net->create_extractor();
+        ex.set_thread_pool(tenant->pool);
+
+        ex.input("data", *tenant->in);
+
+        ncnn::Mat out;
+        ex.extract("prob", out);
+
+        std::vector<float> cls_scores;
+        cls_scores.resize(out.w);
+        for (int j = 0; j < out.w; j++)
+        {
+            cls_scores[j] = out[j];
+        }
+
+        tenant->ret = check_top2(cls_scores, tenant->epsilon);
+        if (tenant->ret != 0)
+            break;
+    }
+
+    return 0;
+}
+
+static int test_squeezenet_thread_pool(const ncnn::Option& opt, float epsilon = 0.001)
+{
+    ncnn::Net squeezenet;
+
+    squeezenet.opt = opt;
+
+#ifdef __EMSCRIPTEN__
+#define MODEL_DIR "/working"
+#else
+#define MODEL_DIR "../../examples"
+#endif
+
+    squeezenet.load_param(MODEL_DIR "/squeezenet_v1.1.param");
+    squeezenet.load_model(MODEL_DIR "/squeezenet_v1.1.bin");
+
+    ncnn::Mat in = generate_ncnn_logo(ncnn::Mat::PIXEL_BGR, 227, 227);
+
+    const float mean_vals[3] = {104.f, 117.f, 123.f};
+    in.substract_mean_normalize(mean_vals, 0);
+
+    // three extractors share a budget of two threads
+    ncnn::ThreadPool pool(2);
+
+    const int tenant_count = 3;
+    std::vector<thread_pool_tenant> tenants(tenant_count);
+    std::vector<ncnn::Thread*> threads(tenant_count);
+    for (int i = 0; i < tenant_count; i++)
+    {
+        tenants[i].net = &squeezenet;
+        tenants[i].in = &in;
+        tenants[i].pool = &pool;
+        tenants[i].epsilon = epsilon;
+        tenants[i].ret = 0;
+        threads[i] = new ncnn::Thread(thread_pool_tenant_worker, &tenants[i]);
+    }
+
+    int ret = 0;
+    for (int i = 0; i < tenant_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+
+        if (tenants[i].ret != 0)
+            ret = tenants[i].ret;
+    }
+
+    if (ret != 0)
+        return ret;
+
+    if (pool.tenant_count() != 0 || pool.active_threads() != 0 || pool.peak_active_threads() > pool.num_threads())
+    {
+        fprintf(stderr, "thread pool tenant_count = %d active_threads = %d peak_active_threads = %d\n", pool.tenant_count(), pool.active_threads(), pool.peak_active_threads());
+        return -1;
+    }
+
+    return 0;
+}
+
 int main()
 {
     SRAND(7767517);
@@ -498,6 +738,37 @@ int main()
             return ret;
         }
 
+        ret = test_squeezenet_load_threads(opt_cpu, epsilon);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_squeezenet_load_threads cpu failed use_packing_layout=%d use_fp16_packed=%d use_fp16_storage=%d use_bf16_storage=%d\n", opt.use_packing_layout, opt.use_fp16_packed, opt.use_fp16_storage, opt.use_bf16_storage);
+            return ret;
+        }
+
+        if (opt_cpu.blob_allocator == 0)
+        {
+            ret = test_squeezenet_plan_memory(opt_cpu, epsilon);
+            if (ret != 0)
+            {
+                fprintf(stderr, "test_squeezenet_plan_memory cpu failed use_packing_layout=%d use_fp16_packed=%d use_fp16_storage=%d use_bf16_storage=%d\n", opt.use_packing_layout, opt.use_fp16_packed, opt.use_fp16_storage, opt.use_bf16_storage);
+                return ret;
+            }
+
+            ret = test_squeezenet_parallel_branches(opt_cpu, epsilon);
+            if (ret != 0)
+            {
+                fprintf(stderr, "test_squeezenet_parallel_branches cpu failed use_packing_layout=%d use_fp16_packed=%d use_fp16_storage=%d use_bf16_storage=%d\n", opt.use_packing_layout, opt.use_fp16_packed, opt.use_fp16_storage, opt.use_bf16_storage);
+                return ret;
+            }
+
+            ret = test_squeezenet_thread_pool(opt_cpu, epsilon);
+            if (ret != 0)
+            {
+                fprintf(stderr, "test_squeezenet_thread_pool cpu failed use_packing_layout=%d use_fp16_packed=%d use_fp16_storage=%d use_bf16_storage=%d\n", opt.use_packing_layout, opt.use_fp16_packed, opt.use_fp16_storage, opt.use_bf16_storage);
+                return ret;
+            }
+        }
+
 #if NCNN_VULKAN
         ret = test_squeezenet_overwrite_softmax(opt_gpu, load_model_types[i], epsilon);
         if (ret != 0)
@@ -0,0 +1,175 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "layer.h"
+#include "layer_type.h"
+#include "modelbin.h"
+#include "testutil.h"
+#include "tuningcache.h"
+
+#include <stdio.h>
+
+static int test_tuningcache_0()
+{
+    ncnn::TuningCache cache;
+
+    int key0[ncnn::TuningCache::key_size] = {6, 24, 32, 3, 3, 1, 1, 1, 1, 8, 15, 13, 8, 1, 63};
+    int key1[ncnn::TuningCache::key_size] = {6, 24, 32, 3, 3, 1, 1, 1, 1, 8, 34, 26, 8, 1, 63};
+    int key2[ncnn::TuningCache::key_size] = {6, 16, 16, 1, 1, 1, 1, 1, 1, 8, 20, 20, 8, 1, 63};
+
+    cache.insert(key0, 2, 0.5f);
+    cache.insert(key1, 3, 1.5f);
+    cache.insert(key2, 4, 0.25f);
+    cache.insert(key1, 1, 1.25f);
+
+    int kernel = -1;
+    if (cache.size() != 3 || cache.find(key1, kernel) != 0 || kernel != 1)
+    {
+        fprintf(stderr, "test_tuningcache_0 insert failed\n");
+        return -1;
+    }
+
+    // both shapes of the first layer config
+    if (cache.find_kernels(key0) != ((1 << 2) | (1 << 1)))
+    {
+        fprintf(stderr, "test_tuningcache_0 find_kernels failed %x\n", cache.find_kernels(key0));
+        return -1;
+    }
+
+#if NCNN_STDIO
+    FILE* fp = tmpfile();
+    if (!fp)
+    {
+        // no writable temp dir, skip the file round trip
+        return 0;
+    }
+
+    int ret = cache.save(fp);
+    rewind(fp);
+
+    ncnn::TuningCache cache2;
+    if (ret == 0)
+        ret = cache2.load(fp);
+
+    fclose(fp);
+
+    if (ret != 0 || cache2.size() != 3 || cache2.autotune())
+    {
+        fprintf(stderr, "test_tuningcache_0 save load failed\n");
+        return -1;
+    }
+
+    if (cache2.find(key0, kernel) != 0 || kernel != 2 || cache2.find(key2, kernel) != 0 || kernel != 4)
+    {
+        fprintf(stderr, "test_tuningcache_0 loaded wrong entries\n");
+        return -1;
+    }
+#endif // NCNN_STDIO
+
+    return 0;
+}
+
+static int forward_convolution(int kernel, int num_input, int num_output, const std::vector<ncnn::Mat>& weights, ncnn::TuningCache* tuning_cache, const std::vector<ncnn::Mat>& inputs, std::vector<ncnn::Mat>& outputs)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, num_output);
+    pd.set(1, kernel);
+    pd.set(4, kernel / 2);
+    pd.set(5, 1);
+    pd.set(6, num_output * num_input * kernel * kernel);
+    pd.set(9, 1);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.tuning_cache = tuning_cache;
+
+    ncnn::Layer* op = ncnn::create_layer_cpu(ncnn::LayerType::Convolution);
+    op->load_param(pd);
+    ncnn::ModelBinFromMatArray mb(weights.data());
+    op->load_model(mb);
+    op->create_pipeline(opt);
+
+    int ret = 0;
+    outputs.resize(inputs.size());
+    for (size_t i = 0; i < inputs.size() && ret == 0; i++)
+    {
+        ret = op->forward(inputs[i], outputs[i], opt);
+    }
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    return ret;
+}
+
+static int test_tuningcache_1(int kernel, int num_input, int num_output)
+{
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = RandomMat(num_output * num_input * kernel * kernel);
+    weights[1] = RandomMat(num_output);
+
+    std::vector<ncnn::Mat> inputs(3);
+    inputs[0] = RandomMat(13, 11, num_input);
+    inputs[1] = RandomMat(32, 24, num_input);
+    inputs[2] = RandomMat(13, 11, num_input);
+
+    std::vector<ncnn::Mat> outputs_ref;
+    int ret = forward_convolution(kernel, num_input, num_output, weights, 0, inputs, outputs_ref);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_tuningcache_1 reference forward failed kernel=%d\n", kernel);
+        return -1;
+    }
+
+    // tuning run
+    ncnn::TuningCache cache;
+    cache.set_autotune(true);
+
+    std::vector<ncnn::Mat> outputs;
+    ret = forward_convolution(kernel, num_input, num_output, weights, &cache, inputs, outputs);
+    if (ret != 0 || CompareMat(outputs, outputs_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_tuningcache_1 autotune forward mismatch kernel=%d\n", kernel);
+        return -1;
+    }
+
+    // only the optimized layers autotune
+    if (cache.size() == 0)
+        return 0;
+
+    if (cache.size() != 2)
+    {
+        fprintf(stderr, "test_tuningcache_1 expect 2 tuned shapes but got %d kernel=%d\n", cache.size(), kernel);
+        return -1;
+    }
+
+    // production run with the recorded choices
+    cache.set_autotune(false);
+
+    ret = forward_convolution(kernel, num_input, num_output, weights, &cache, inputs, outputs);
+    if (ret != 0 || CompareMat(outputs, outputs_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_tuningcache_1 tuned forward mismatch kernel=%d\n", kernel);
+        return -1;
+    }
+
+    if (cache.size() != 2)
+    {
+        fprintf(stderr, "test_tuningcache_1 tuned run recorded new shapes kernel=%d\n", kernel);
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_tuningcache_0()
+           || test_tuningcache_1(1, 24, 32)
+           || test_tuningcache_1(3, 24, 32)
+           || test_tuningcache_1(3, 4, 8)
+           || test_tuningcache_1(5, 16, 16);
+}
@@ -0,0 +1,520 @@
+// Copyright 2026 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "datareader.h"
+#include "net.h"
+#include "testutil.h"
+#include "weightcache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// the same pseudo random weights for the same seed, zero for the 4-byte flag tags
+class DataReaderFromSeed : public ncnn::DataReader
+{
+public:
+    DataReaderFromSeed(unsigned int _seed)
+        : seed(_seed)
+    {
+    }
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (size == 4)
+        {
+            memset(buf, 0, 4);
+            return 4;
+        }
+
+        float* p = (float*)buf;
+        for (size_t i = 0; i < size / 4; i++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            p[i] = ((seed >> 8) / 16777216.f - 0.5f) * 0.4f;
+        }
+        return size;
+    }
+
+private:
+    mutable unsigned int seed;
+};
+
+static const char* weightcache_param = "7767517\n"
+                                       "8 8\n"
+                                       "Input            data         0 1 data 0=12 1=12 2=16\n"
+                                       "Convolution      conv3        1 1 data conv3 0=16 1=3 4=1 5=1 6=2304 9=1\n"
+                                       "ConvolutionDepthWise dw       1 1 conv3 dw 0=16 1=3 4=1 5=1 6=144 7=16\n"
+                                       "Convolution      conv1        1 1 dw conv1 0=8 1=1 5=1 6=128\n"
+                                       "InnerProduct     fc           1 1 conv1 fc 0=32 1=1 2=36864 9=1\n"
+                                       "Input            seq          0 1 seq 0=24 1=5\n"
+                                       "Gemm             linear       1 1 seq linear 5=1 6=1 8=40 9=24 10=4\n"
+                                       "LSTM             lstm         1 1 linear lstm 0=16 1=2560\n";
+
+// the layers preparing weights in create_pipeline
+static const int weightcache_layer_count = 6;
+
+static int load_net(ncnn::Net& net, const ncnn::Option& opt, unsigned int seed, ncnn::WeightCache* weight_cache)
+{
+    net.opt = opt;
+    net.opt.weight_cache = weight_cache;
+
+    net.load_param_mem(weightcache_param);
+
+    DataReaderFromSeed dr(seed);
+    return net.load_model(dr);
+}
+
+static int extract_net(const ncnn::Net& net, const ncnn::Mat& data, const ncnn::Mat& seq, ncnn::Mat& fc, ncnn::Mat& lstm)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", data);
+    ex.input("seq", seq);
+
+    int ret = ex.extract("fc", fc);
+    if (ret != 0)
+        return ret;
+
+    return ex.extract("lstm", lstm);
+}
+
+static int forward_net(const ncnn::Option& opt, unsigned int seed, ncnn::WeightCache* weight_cache, const ncnn::Mat& data, const ncnn::Mat& seq, ncnn::Mat& fc, ncnn::Mat& lstm)
+{
+    ncnn::Net net;
+    int ret = load_net(net, opt, seed, weight_cache);
+    if (ret != 0)
+        return ret;
+
+    return extract_net(net, data, seq, fc, lstm);
+}
+
+// the prepared weights referencing memory the net does not own, and all the prepared weights
+static void count_external_weights(const ncnn::Net& net, int& external_count, int& count)
+{
+    external_count = 0;
+    count = 0;
+
+    const std::vector<ncnn::Layer*>& layers = net.layers();
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        std::vector<ncnn::Mat*> weights;
+        layers[i]->get_pipeline_weights(weights);
+
+        for (size_t j = 0; j < weights.size(); j++)
+        {
+            if (weights[j]->empty())
+                continue;
+
+            external_count += weights[j]->refcount ? 0 : 1;
+            count++;
+        }
+    }
+}
+
+static int test_weightcache_0()
+{
+    ncnn::WeightCache cache;
+
+    int key0[ncnn::WeightCache::key_size] = {0, 6, 1234, 5678};
+    int key1[ncnn::WeightCache::key_size] = {1, 14, 4321, 8765};
+
+    std::vector<ncnn::Mat> weights0(3);
+    weights0[0] = RandomMat(40, 24);
+    weights0[2] = RandomMat(5, 7, 9);
+    weights0[2] = weights0[2].channel_range(2, 3);
+
+    std::vector<ncnn::Mat> weights1(1);
+    weights1[0] = RandomMat(17);
+
+    cache.insert(key0, weights0);
+    cache.insert(key1, weights1);
+
+    std::vector<ncnn::Mat> weights;
+    if (cache.size() != 2 || cache.find(key0, weights) != 0 || weights.size() != 3 || weights[0].data != weights0[0].data)
+    {
+        fprintf(stderr, "test_weightcache_0 insert failed\n");
+        return -1;
+    }
+
+    int key2[ncnn::WeightCache::key_size] = {2};
+    if (cache.find(key2, weights) != -1 || cache.hit_count() != 1 || cache.miss_count() != 1)
+    {
+        fprintf(stderr, "test_weightcache_0 find failed\n");
+        return -1;
+    }
+
+    {
+        ncnn::Mat a = RandomMat(33, 5);
+        ncnn::Mat b = a.clone();
+        ncnn::Mat c = RandomMat(33, 5);
+
+        const size_t usage = cache.memory_usage();
+
+        ncnn::Mat a_shared = cache.share(a);
+        ncnn::Mat b_shared = cache.share(b);
+        ncnn::Mat c_shared = cache.share(c);
+        if (a_shared.data != a.data || b_shared.data != a.data || c_shared.data != c.data)
+        {
+            fprintf(stderr, "test_weightcache_0 share failed\n");
+            return -1;
+        }
+
+        a.release();
+        a_shared.release();
+        b_shared.release();
+        c_shared.release();
+
+        // only c is still referenced
+        cache.release_unused();
+        if (cache.memory_usage() != usage + c.total() * c.elemsize)
+        {
+            fprintf(stderr, "test_weightcache_0 release_unused failed\n");
+            return -1;
+        }
+    }
+
+#if NCNN_STDIO
+    const char* path = "test_weightcache_0.bin";
+    if (cache.save(path) != 0)
+    {
+        // no writable working directory, skip the file round trip
+        return 0;
+    }
+
+    ncnn::WeightCache cache2;
+    int ret = cache2.load(path);
+    if (ret != 0 || cache2.size() != 2 || cache2.find(key0, weights) != 0 || weights.size() != 3)
+    {
+        fprintf(stderr, "test_weightcache_0 save load failed\n");
+        cache2.clear();
+        remove(path);
+        return -1;
+    }
+
+    ret = !weights[1].empty() || CompareMat(weights[0], weights0[0], 0) != 0 || CompareMat(weights[2], weights0[2], 0) != 0;
+
+    cache2.clear();
+    remove(path);
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_weightcache_0 loaded wrong weights\n");
+        return -1;
+    }
+#endif // NCNN_STDIO
+
+    return 0;
+}
+
+static int test_weightcache_1(const ncnn::Option& opt)
+{
+    ncnn::Mat data = RandomMat(12, 12, 16);
+    ncnn::Mat seq = RandomMat(24, 5);
+
+    ncnn::Mat fc_ref;
+    ncnn::Mat lstm_ref;
+    int ret = forward_net(opt, 7767517, 0, data, seq, fc_ref, lstm_ref);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_weightcache_1 reference forward failed\n");
+        return -1;
+    }
+
+    // the first load prepares and records every layer
+    ncnn::WeightCache cache;
+
+    ncnn::Mat fc;
+    ncnn::Mat lstm;
+    ret = forward_net(opt, 7767517, &cache, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_weightcache_1 recording forward mismatch\n");
+        return -1;
+    }
+
+    if (cache.size() != weightcache_layer_count || cache.hit_count() != 0 || cache.miss_count() != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_1 expect %d recorded layers but got %d\n", weightcache_layer_count, cache.size());
+        return -1;
+    }
+
+    // the second load restores every layer
+    ret = forward_net(opt, 7767517, &cache, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_weightcache_1 restored forward mismatch\n");
+        return -1;
+    }
+
+    if (cache.hit_count() != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_1 expect %d restored layers but got %d\n", weightcache_layer_count, cache.hit_count());
+        return -1;
+    }
+
+    // other model data never picks up the recorded weights
+    ncnn::Mat fc_other;
+    ncnn::Mat lstm_other;
+    ret = forward_net(opt, 7767518, 0, data, seq, fc_other, lstm_other);
+    if (ret == 0)
+        ret = forward_net(opt, 7767518, &cache, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_other, 0.001) != 0 || CompareMat(lstm, lstm_other, 0.001) != 0 || cache.hit_count() != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_1 stale weights used\n");
+        return -1;
+    }
+
+#if NCNN_STDIO
+    const char* path = "test_weightcache_1.bin";
+    if (cache.save(path) != 0)
+    {
+        // no writable working directory, skip the file round trip
+        return 0;
+    }
+
+    // a fresh process loads the saved weights
+    ncnn::WeightCache cache2;
+    ncnn::Net net;
+    ret = cache2.load(path);
+    if (ret == 0)
+        ret = load_net(net, opt, 7767517, &cache2);
+    if (ret == 0)
+        ret = extract_net(net, data, seq, fc, lstm);
+
+    const int hit_count = cache2.hit_count();
+
+    // and the layers use them in place
+    int external_count = 0;
+    int weight_count = 0;
+    count_external_weights(net, external_count, weight_count);
+
+    net.clear();
+    cache2.clear();
+    remove(path);
+
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_weightcache_1 loaded forward mismatch\n");
+        return -1;
+    }
+
+    if (hit_count != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_1 expect %d loaded layers but got %d\n", weightcache_layer_count, hit_count);
+        return -1;
+    }
+
+    if (weight_count == 0 || external_count != weight_count)
+    {
+        fprintf(stderr, "test_weightcache_1 expect the %d loaded weights in place but got %d\n", weight_count, external_count);
+        return -1;
+    }
+#endif // NCNN_STDIO
+
+    return 0;
+}
+
+static int test_weightcache_2(bool lightmode)
+{
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.lightmode = lightmode;
+
+    ncnn::Mat data = RandomMat(12, 12, 16);
+    ncnn::Mat seq = RandomMat(24, 5);
+
+    ncnn::Mat fc_ref;
+    ncnn::Mat lstm_ref;
+    int ret = forward_net(opt, 7767517, 0, data, seq, fc_ref, lstm_ref);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_weightcache_2 reference forward failed\n");
+        return -1;
+    }
+
+    ncnn::WeightCache cache;
+
+    ncnn::Net net0;
+    ret = load_net(net0, opt, 7767517, &cache);
+    if (ret != 0)
+        return -1;
+
+    const size_t usage = cache.memory_usage();
+
+    // a replica takes every weight from the first one
+    ncnn::Net net1;
+    ret = load_net(net1, opt, 7767517, &cache);
+    if (ret != 0)
+        return -1;
+
+    if (cache.memory_usage() != usage || cache.hit_count() != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_2 replica stored %d more bytes\n", (int)(cache.memory_usage() - usage));
+        return -1;
+    }
+
+    ncnn::Mat fc;
+    ncnn::Mat lstm;
+    ret = extract_net(net1, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_weightcache_2 replica forward mismatch\n");
+        return -1;
+    }
+
+    net0.clear();
+
+    ret = extract_net(net1, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0.001) != 0 || CompareMat(lstm, lstm_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_weightcache_2 forward mismatch after the first net is gone\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_weightcache_3(const ncnn::Option& opt)
+{
+    ncnn::Mat data = RandomMat(12, 12, 16);
+    ncnn::Mat seq = RandomMat(24, 5);
+
+    ncnn::Option opt_serial = opt;
+    opt_serial.num_load_threads = 1;
+
+    ncnn::Option opt_parallel = opt;
+    opt_parallel.num_load_threads = 4;
+
+    ncnn::Mat fc_ref;
+    ncnn::Mat lstm_ref;
+    int ret = forward_net(opt_serial, 7767517, 0, data, seq, fc_ref, lstm_ref);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_weightcache_3 reference forward failed\n");
+        return -1;
+    }
+
+    // preparing the layers concurrently gives the same weights
+    ncnn::WeightCache cache;
+
+    ncnn::Mat fc;
+    ncnn::Mat lstm;
+    ret = forward_net(opt_parallel, 7767517, &cache, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0) != 0 || CompareMat(lstm, lstm_ref, 0) != 0)
+    {
+        fprintf(stderr, "test_weightcache_3 parallel load forward mismatch\n");
+        return -1;
+    }
+
+    if (cache.size() != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_3 expect %d recorded layers but got %d\n", weightcache_layer_count, cache.size());
+        return -1;
+    }
+
+    // and records the weights a serial load picks up
+    ret = forward_net(opt_serial, 7767517, &cache, data, seq, fc, lstm);
+    if (ret != 0 || CompareMat(fc, fc_ref, 0) != 0 || CompareMat(lstm, lstm_ref, 0) != 0 || cache.hit_count() != weightcache_layer_count)
+    {
+        fprintf(stderr, "test_weightcache_3 restored forward mismatch\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+// the same weight bytes under different params
+static int test_weightcache_4()
+{
+    static const char* params[2] = {
+        "7767517\n"
+        "2 2\n"
+        "Input            data         0 1 data 0=12 1=12 2=16\n"
+        "Convolution      conv         1 1 data conv 0=16 1=3 11=1 4=1 14=0 5=1 6=768\n",
+        "7767517\n"
+        "2 2\n"
+        "Input            data         0 1 data 0=12 1=12 2=16\n"
+        "Convolution      conv         1 1 data conv 0=16 1=1 11=3 4=0 14=1 5=1 6=768\n"
+    };
+
+    ncnn::Mat data = RandomMat(12, 12, 16);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    ncnn::WeightCache cache;
+
+    for (int i = 0; i < 2; i++)
+    {
+        ncnn::Mat outs[2];
+        for (int j = 0; j < 2; j++)
+        {
+            ncnn::Net net;
+            net.opt = opt;
+            net.opt.weight_cache = j == 0 ? 0 : &cache;
+            net.load_param_mem(params[i]);
+
+            DataReaderFromSeed dr(7767517);
+            if (net.load_model(dr) != 0)
+            {
+                fprintf(stderr, "test_weightcache_4 load_model failed\n");
+                return -1;
+            }
+
+            ncnn::Extractor ex = net.create_extractor();
+            ex.input("data", data);
+            if (ex.extract("conv", outs[j]) != 0)
+            {
+                fprintf(stderr, "test_weightcache_4 extract failed\n");
+                return -1;
+            }
+        }
+
+        // the second kernel shape must not pick up the weights prepared for the first
+        if (CompareMat(outs[1], outs[0], 0) != 0 || cache.hit_count() != 0 || cache.size() != i + 1)
+        {
+            fprintf(stderr, "test_weightcache_4 param %d reused a stale entry, hit %d size %d\n", i, cache.hit_count(), cache.size());
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Option opts[3];
+
+    opts[0].use_packing_layout = false;
+
+    opts[1].use_packing_layout = true;
+
+    opts[2].use_packing_layout = true;
+    opts[2].lightmode = false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        opts[i].num_threads = 1;
+
+        int ret = test_weightcache_1(opts[i]);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_weightcache_1 failed use_packing_layout=%d lightmode=%d\n", opts[i].use_packing_layout, opts[i].lightmode);
+            return ret;
+        }
+
+        ret = test_weightcache_3(opts[i]);
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_weightcache_3 failed use_packing_layout=%d lightmode=%d\n", opts[i].use_packing_layout, opts[i].lightmode);
+            return ret;
+        }
+    }
+
+    return 0
+           || test_weightcache_0()
+           || test_weightcache_2(false)
+           || test_weightcache_2(true)
+           || test_weightcache_4();
+}
@@ -107,6 +107,8 @@
 #include "layer/yolodetectionoutput.h"
 #include "layer/yolov3detectionoutput.h"
 
+#include "layer/weight_quant.h"
+
 // for gen_random_weight
 #include "../tests/prng.h"
 
@@ -239,6 +241,7 @@ public:
 
     int fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a = -1.2f, float b = 1.2f);
     int fwrite_weight_data(const ncnn::Mat& data, FILE* bp, float a = -1.2f, float b = 1.2f);
+    int fwrite_weight_group_quant_data(const ncnn::Mat& data, ncnn::Mat& scales, FILE* bp, int bits, int group_size, int row_size);
 
     int save(const char* parampath, const char* binpath);
 };
@@ -658,6 +661,34 @@ int ModelWriter::fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a
     return 0;
 }
 
+int ModelWriter::fwrite_weight_group_quant_data(const ncnn::Mat& data, ncnn::Mat& scales, FILE* bp, int bits, int group_size, int row_size)
+{
+    int p0 = ftell(bp);
+
+    // fp32 weights are quantized here, packed weights are written as loaded
+    ncnn::Mat qdata = data;
+    if (data.elemsize == 4u)
+    {
+        ncnn::Mat data_flattened = data.reshape(data.w * data.h * data.d * data.c);
+        if (gen_random_weight)
+            Randomize(data_flattened, -1.2f, 1.2f);
+
+        weight_quant_pack(data_flattened, qdata, scales, row_size, group_size, bits);
+    }
+
+    const int header[2] = {0x0047A4B1, bits}; // group quant magic
+    fwrite(header, sizeof(int), 2, bp);
+    fwrite(qdata.data, 1, qdata.w, bp);
+
+    // padding to 32bit align
+    int nwrite = ftell(bp) - p0;
+    size_t nalign = alignSize(nwrite, 4);
+    unsigned char padding[4] = {0x00, 0x00, 0x00, 0x00};
+    fwrite(padding, sizeof(unsigned char), nalign - nwrite, bp);
+
+    return 0;
+}
+
 int ModelWriter::fwrite_weight_data(const ncnn::Mat& data, FILE* bp, float a, float b)
 {
     int p0 = ftell(bp);
@@ -1786,19 +1817,29 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             fprintf_param_value(" 20=%d", constant_TILE_M)
             fprintf_param_value(" 21=%d", constant_TILE_N)
             fprintf_param_value(" 22=%d", constant_TILE_K)
+            fprintf_param_value(" 23=%d", weight_quant_bits)
+            fprintf_param_value(" 24=%d", weight_quant_group_size)
 
             if (op->constantA == 1)
             {
                 fwrite_weight_tag_data(op->A_data, bp);
             }
+            ncnn::Mat B_data_quant_scales = op->B_data_quant_scales;
             if (op->constantB == 1)
             {
-                fwrite_weight_tag_data(op->B_data, bp);
+                if (op->weight_quant_bits)
+                    fwrite_weight_group_quant_data(op->B_data, B_data_quant_scales, bp, op->weight_quant_bits, op->weight_quant_group_size, op->constantK);
+                else
+                    fwrite_weight_tag_data(op->B_data, bp);
             }
             if (op->constantC == 1 && op->constant_broadcast_type_C != -1)
             {
                 fwrite_weight_tag_data(op->C_data, bp);
             }
+            if (op->weight_quant_bits)
+            {
+                fwrite_weight_data(B_data_quant_scales, bp, 0.001, 0.1);
+            }
 
 #if NCNN_INT8
             // write int8_scale data
@@ -1899,9 +1940,17 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             {
                 if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
             }
+            fprintf_param_value(" 23=%d", weight_quant_bits)
+            fprintf_param_value(" 24=%d", weight_quant_group_size)
 
-            fwrite_weight_tag_data(op->weight_data, bp);
+            ncnn::Mat weight_data_quant_scales = op->weight_data_quant_scales;
+            if (op->weight_quant_bits)
+                fwrite_weight_group_quant_data(op->weight_data, weight_data_quant_scales, bp, op->weight_quant_bits, op->weight_quant_group_size, op->weight_data_size / op->num_output);
+            else
+                fwrite_weight_tag_data(op->weight_data, bp);
             fwrite_weight_data(op->bias_data, bp);
+            if (op->weight_quant_bits)
+                fwrite_weight_data(weight_data_quant_scales, bp, 0.001, 0.1);
 
 #if NCNN_INT8
             // write int8_scale data
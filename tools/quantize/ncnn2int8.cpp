@@ -6,6 +6,7 @@
 #endif
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <map>
 #include <set>
@@ -118,6 +119,9 @@ public:
     int quantize_convolutiondepthwise();
     int quantize_innerproduct();
 
+    // weight-only int4 / int8 for InnerProduct and linear Gemm, activations stay fp32
+    int quantize_weight_only(int bits, int group_size);
+
     int quantize_rnn();
     int quantize_lstm();
     int quantize_gru();
@@ -310,6 +314,40 @@ int NetQuantize::quantize_innerproduct()
     return 0;
 }
 
+int NetQuantize::quantize_weight_only(int bits, int group_size)
+{
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (layers[i]->type == "InnerProduct")
+        {
+            ncnn::InnerProduct* fc = (ncnn::InnerProduct*)layers[i];
+            if (fc->int8_scale_term)
+                continue;
+
+            fprintf(stderr, "quantize_weight_only %s\n", fc->name.c_str());
+
+            fc->weight_quant_bits = bits;
+            fc->weight_quant_group_size = group_size;
+        }
+
+        if (layers[i]->type == "Gemm")
+        {
+            ncnn::Gemm* gemm = (ncnn::Gemm*)layers[i];
+
+            // groups run along K, the rows of B when transB enabled
+            if (!gemm->constantB || !gemm->transB || gemm->int8_scale_term)
+                continue;
+
+            fprintf(stderr, "quantize_weight_only %s\n", gemm->name.c_str());
+
+            gemm->weight_quant_bits = bits;
+            gemm->weight_quant_group_size = group_size;
+        }
+    }
+
+    return 0;
+}
+
 int NetQuantize::quantize_rnn()
 {
     for (size_t i = 0; i < layers.size(); i++)
@@ -1067,9 +1105,10 @@ int NetQuantize::fuse_requantize()
 
 int main(int argc, char** argv)
 {
-    if (argc != 5 && argc != 6)
+    if (argc != 5 && argc != 6 && argc != 7)
     {
         fprintf(stderr, "usage: %s [inparam] [inbin] [outparam] [outbin] [calibration table]\n", argv[0]);
+        fprintf(stderr, "       %s [inparam] [inbin] [outparam] [outbin] [int4 / int8] [group size]\n", argv[0]);
         return -1;
     }
 
@@ -1077,7 +1116,30 @@ int main(int argc, char** argv)
     const char* inbin = argv[2];
     const char* outparam = argv[3];
     const char* outbin = argv[4];
-    const char* int8scale_table_path = argc == 6 ? argv[5] : NULL;
+    const char* int8scale_table_path = argc >= 6 ? argv[5] : NULL;
+
+    // weight-only quantization needs no calibration table
+    int weight_only_bits = 0;
+    if (int8scale_table_path && strcmp(int8scale_table_path, "int4") == 0)
+        weight_only_bits = 4;
+    if (int8scale_table_path && strcmp(int8scale_table_path, "int8") == 0)
+        weight_only_bits = 8;
+
+    if (argc == 7 && !weight_only_bits)
+    {
+        fprintf(stderr, "group size only applies to int4 / int8 weight-only quantization\n");
+        return -1;
+    }
+
+    const int weight_only_group_size = argc == 7 ? atoi(argv[6]) : 32;
+    if (weight_only_bits && (weight_only_group_size <= 0 || (weight_only_bits == 4 && weight_only_group_size % 2 != 0)))
+    {
+        fprintf(stderr, "group size must be positive and even for int4\n");
+        return -1;
+    }
+
+    if (weight_only_bits)
+        int8scale_table_path = NULL;
 
     NetQuantize quantizer;
     quantizer.storage_type = 1; // use fp16 where int8 not applied
@@ -1103,6 +1165,15 @@ int main(int argc, char** argv)
     else
         quantizer.load_model(inbin);
 
+    if (weight_only_bits)
+    {
+        quantizer.quantize_weight_only(weight_only_bits, weight_only_group_size);
+
+        quantizer.save(outparam, outbin);
+
+        return 0;
+    }
+
     quantizer.quantize_convolution();
     quantizer.quantize_convolutiondepthwise();
     quantizer.quantize_innerproduct();